@@ -26,6 +26,24 @@
 // ============================================================
 #define STATION_DEBUG true
 
+// ============================================================
+// Station-level sleep
+// false keeps the station awake (light sleep only), e.g. while
+// a technician is connected over USB.
+// ============================================================
+#define STATION_DEEP_SLEEP true
+
+// ============================================================
+// Technician CLI on the debug port (TechnicianCLI: stats,
+// trace, baud, scan after the passphrase)
+// The station does not sleep for TECHNICIAN_CLI_WINDOW_MS after
+// a power-on or reset (a deep-sleep wake does not count), nor
+// while a technician is logged in.
+// ============================================================
+#define TECHNICIAN_CLI_ENABLE 1
+#define TECHNICIAN_CLI_PASSPHRASE "STATION2026"
+#define TECHNICIAN_CLI_WINDOW_MS 60000UL
+
 // ============================================================
 // Driver families compiled into this firmware build
 // This only means the code is available.
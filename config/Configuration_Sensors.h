@@ -14,6 +14,14 @@
   interface they are connected to, and what timing/debug parameters
   they use.
 
+  <SENSOR>_BAUD is the line speed the sensor should run at. Above
+  RS485_DEFAULT_BAUD the firmware negotiates it (see
+  RS485_BAUD_NEGOTIATE in Configuration_System.h).
+
+  <SENSOR>_BURST_READS is the number of reads reduced to one sample
+  per interval; 1 = a single read (see "Burst oversampling" in
+  Configuration_System.h).
+
   Sensor examples DO NOT use this file directly.
   Examples have their own local config.h files.
 */
@@ -39,6 +47,8 @@
   #define RIKA_LEAF_00_SAMPLE_RATE     SAMPLE_RATE_5_MIN
   #define RIKA_LEAF_00_WARMUP_MS       1000UL
   #define RIKA_LEAF_00_DEBUG           true
+  #define RIKA_LEAF_00_BAUD            RS485_DEFAULT_BAUD
+  #define RIKA_LEAF_00_BURST_READS     1
 #endif
 
 // ============================================================
@@ -68,4 +78,6 @@
   #define RIKA_SOIL3IN1_00_SAMPLE_RATE     SAMPLE_RATE_15_MIN
   #define RIKA_SOIL3IN1_00_WARMUP_MS       1000UL
   #define RIKA_SOIL3IN1_00_DEBUG           true
+  #define RIKA_SOIL3IN1_00_BAUD            RS485_DEFAULT_BAUD
+  #define RIKA_SOIL3IN1_00_BURST_READS     5
 #endif
\ No newline at end of file
@@ -35,9 +35,92 @@
 #define RS485_DEFAULT_BAUD              9600
 #define RS485_DEFAULT_SERIAL_CONFIG     SERIAL_8N1
 
+// ============================================================
+// RS485 UART half-duplex (ESP32 only)
+// 1 = the UART drives DE from its RTS pin and wakes reads on
+// t3.5 idle (RS485UartEsp32); 0 = GPIO DE and polled reads.
+// Falls back to GPIO DE if the UART rejects the mode.
+// ============================================================
+#define RS485_UART_HALF_DUPLEX 1
+
+// ============================================================
+// RS485 baud negotiation
+// Sensors with a <SENSOR>_BAUD above RS485_DEFAULT_BAUD are
+// moved to that speed after their first good read
+// (ModbusBaudNegotiator) and only kept there once they answer
+// at it. Speeds above 9600 are not in the sensor manuals;
+// sensors that refuse stay at the default. 0 = never write the
+// baud register; configured speeds are still used as the
+// fallback for sensors already switched by hand.
+// ============================================================
+#define RS485_BAUD_NEGOTIATE 1
+
+// ============================================================
+// Batched register reads
+// Drivers merge register ranges closer than MAX_GAP into one
+// request, up to MAX_REGS registers per request.
+// A device that rejects the merged request (exception), or misses
+// it LATCH_MISSES reads in a row while answering the split one,
+// is read split; the merged request is tried again every
+// REPROBE_READS reads.
+// ============================================================
+#define SENSOR_BATCH_MAX_GAP_REGS       16
+#define SENSOR_BATCH_MAX_REGS           32
+#define SENSOR_BATCH_LATCH_MISSES       3
+#define SENSOR_BATCH_REPROBE_READS      24
+
+// ============================================================
+// Read budget
+// One sensor transaction (all driver and bus retries) may use
+// at most TRANSACTION_BUDGET_MS and MAX_ATTEMPTS requests.
+// Sensors not started within READ_CYCLE_BUDGET_MS of the cycle
+// start are skipped until the next cycle.
+// Keep the transaction budget well below the 15 s watchdog.
+// ============================================================
+#define SENSOR_TRANSACTION_BUDGET_MS    3000UL
+#define SENSOR_TRANSACTION_MAX_ATTEMPTS 6
+#define READ_CYCLE_BUDGET_MS            120000UL
+
+// ============================================================
+// Burst oversampling
+// A sensor with <SENSOR>_BURST_READS > 1 is read that many times
+// per sample interval; the median of each value is logged, with
+// mean/sd/min/max as a [BURST] line (SensorBurst). Switched lines
+// take the reads back to back while warm, BURST_GAP_MS apart (the
+// sensors refresh their registers about once a second); sensors
+// that keep power spread them over the interval. Up to
+// SAMPLE_STATS_MAX_N reads (8 on AVR, 16 on ESP32).
+// ============================================================
+#define SENSOR_BURST_GAP_MS             1000UL
+
+// ============================================================
+// Bus trace
+// Binary record of RS485 traffic per port, kept in RAM
+// (MODBUS_TRACE_RING_BYTES each). Export with the CLI
+// "trace <port> hex" and decode with tools/rs485_trace_decode.py.
+// Off on AVR, where the ring would cost the Mega 512 bytes of
+// its 8 KB RAM on every build; set 1 for a debugging session.
+// ============================================================
+#if defined(ARDUINO_ARCH_AVR)
+  #define RS485_TRACE_ENABLE 0
+#else
+  #define RS485_TRACE_ENABLE 1
+#endif
+
 // ============================================================
 // Power policy
 // If remaining OFF time is smaller than this window,
 // the sensor should stay powered ON.
 // ============================================================
-#define MIN_USEFUL_POWER_OFF_MS         60000UL
\ No newline at end of file
+#define MIN_USEFUL_POWER_OFF_MS         60000UL
+
+// ============================================================
+// Sleep policy
+// Gaps between sample slots shorter than LIGHT_MIN keep the
+// loop running; shorter than DEEP_MIN use light sleep; longer
+// gaps use deep sleep (ESP32), waking WAKE_MARGIN early to
+// cover boot and setup().
+// ============================================================
+#define SLEEP_LIGHT_MIN_MS              100UL
+#define SLEEP_DEEP_MIN_MS               30000UL
+#define SLEEP_WAKE_MARGIN_MS            500UL
\ No newline at end of file
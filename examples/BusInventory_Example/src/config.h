@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+#include "../../../config/Configuration_System.h"
+#include "../../../config/Configuration_PCB.h"
+
+/*
+  Bus Inventory Example - local example config
+
+  Scope:
+  - This file only affects examples/BusInventory_Example.
+  - Global defaults (baud/board pins) still come from:
+      Configuration_System.h
+      Configuration_PCB.h
+
+  Usage:
+  - Wire every sensor to the port below and power them.
+  - Raise SCAN_RESPONSE_TIMEOUT_MS for slow devices or converters that
+    add latency; every empty address costs this long.
+*/
+
+// RS485 port to scan.
+#define SCAN_RS485_PORT            RS485_PORT_INDEX_0
+// Address range to probe.
+#define SCAN_FIRST_ADDRESS         1
+#define SCAN_LAST_ADDRESS          247
+// Wait for the first reply byte of each probe.
+#define SCAN_RESPONSE_TIMEOUT_MS   30
+// Delay between repeated scans.
+#define SCAN_INTERVAL_MS           10000
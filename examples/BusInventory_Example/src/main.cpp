@@ -0,0 +1,82 @@
+#include <Arduino.h>
+#include "config.h"
+#include "PrintController.h"
+#include "RS485Modbus.h"
+#include "ModbusBusScanner.h"
+
+/*
+  BusInventory_Example
+
+  Lists every Modbus device on one RS485 port with its sensor family, in
+  one pass over the address range (see ModbusBusScanner). Use it during
+  commissioning instead of the per-driver scanForAddress() helpers.
+*/
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial& DebugPort = Serial0;
+HardwareSerial RS485Port(1);
+#else
+#define DebugPort Serial
+#endif
+
+static PrintController printer(DebugPort, true);
+static RS485Bus rs485;
+static ModbusBusScanner scanner(rs485);
+
+static void printBanner() {
+  printer.println(F(""), true);
+  printer.println(F("============================================================"), true);
+  printer.println(F(" RS485 Bus Inventory Example"), true);
+  printer.println(F("============================================================"), true);
+  printer.print(F("PCB: "), true);
+  printer.println(PCB_NAME, true);
+  printer.println(F(""), true);
+}
+
+static void printInventory() {
+  for (size_t i = 0; i < scanner.count(); ++i) {
+    const ModbusBusScanner::Entry& e = scanner.entry(i);
+    printer.print(F("  0x"), true);
+    if (e.address < 0x10) printer.print(F("0"), true);
+    printer.print((unsigned int)e.address, true, " | ", HEX);
+    printer.print(ModbusBusScanner::familyName(e.family), true);
+    printer.print(F(" | reply after "), true);
+    printer.print((unsigned long)(e.firstByteUs / 1000UL), true, " ms", DEC);
+    printer.println("", true);
+  }
+
+  printer.print(F("[APP] Devices found: "), true);
+  printer.print((unsigned long)(scanner.count() + scanner.overflow()), true, " | scan time ", DEC);
+  printer.print((unsigned long)scanner.lastScanMs(), true, " ms", DEC);
+  printer.println("", true);
+}
+
+void setup() {
+  DebugPort.begin(PCB_DEBUG_SERIAL_BAUD);
+  delay(300);
+  printBanner();
+
+#if defined(ARDUINO_ARCH_ESP32)
+  rs485.begin(RS485Port,
+              RS485_DEFAULT_BAUD,
+              PCB_RS485_RX_PINS[SCAN_RS485_PORT],
+              PCB_RS485_TX_PINS[SCAN_RS485_PORT],
+              RS485_DEFAULT_SERIAL_CONFIG);
+#else
+  rs485.begin(Serial2, RS485_DEFAULT_BAUD, -1, -1, RS485_DEFAULT_SERIAL_CONFIG);
+#endif
+
+  rs485.setDirectionControl(PCB_RS485_DE_PINS[SCAN_RS485_PORT],
+                            PCB_RS485_DE_ACTIVE_HIGH[SCAN_RS485_PORT]);
+
+  scanner.setResponseTimeoutMs(SCAN_RESPONSE_TIMEOUT_MS);
+}
+
+void loop() {
+  printer.println(F("[APP] Scanning..."), true);
+  scanner.scan(SCAN_FIRST_ADDRESS, SCAN_LAST_ADDRESS);
+  printInventory();
+
+  printer.println(F(""), true);
+  delay(SCAN_INTERVAL_MS);
+}
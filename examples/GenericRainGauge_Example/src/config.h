@@ -11,6 +11,13 @@
       hardware debouncer + 4040 binary counter, read P0..P7 through PCF8574.
   - RAIN_GAUGE_COUNTING_MODE_MCU_INTERRUPT:
       MCU counts rain gauge pulses directly from RAIN_BYPASS_INTERRUPT.
+  - RAIN_GAUGE_COUNTING_MODE_PCNT_COUNTER (ESP32 only):
+      PCNT peripheral counts RAIN_BYPASS_INTERRUPT in hardware, no CPU
+      wake-up per pulse. Stays awake between samples.
+  - RAIN_GAUGE_COUNTING_MODE_ULP_COUNTER (ESP32 only):
+      ULP coprocessor counts RAIN_BYPASS_INTERRUPT (an RTC GPIO) and keeps
+      counting in deep sleep; deep sleeps between samples like the
+      external counter. Peak rates are fallback after pulses in sleep.
 
   Generic pulse factor:
   - 1 pulse = 0.2794 mm
@@ -54,9 +54,9 @@ static void printReadResult(bool ok) {
   }
 
   printer.print(F("Leaf Humidity: "), true);
-  printer.print(leaf.leaf_humidity, true, " %RH | ", 1);
+  printer.printFixed(leaf.leaf_humidity.raw, leaf.leaf_humidity.decimals, true, " %RH | ");
   printer.print(F("Leaf Temperature: "), true);
-  printer.print(leaf.leaf_temperature, true, " C", 1);
+  printer.printFixed(leaf.leaf_temperature.raw, leaf.leaf_temperature.decimals, true, " C");
   printer.println("", true);
 
   if (!ok) {
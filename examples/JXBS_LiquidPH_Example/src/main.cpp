@@ -61,9 +61,9 @@ static void printReadResult(bool ok) {
   }
 
   printer.print(F("Liquid temperature: "), true);
-  printer.print(phSensor.liquid_temperature, true, " C | ", 1);
+  printer.printFixed(phSensor.liquid_temperature.raw, phSensor.liquid_temperature.decimals, true, " C | ");
   printer.print(F("pH: "), true);
-  printer.print(phSensor.liquid_ph, true, "", 2);
+  printer.printFixed(phSensor.liquid_ph.raw, phSensor.liquid_ph.decimals, true, "");
   printer.println("", true);
 
   if (!ok) {
@@ -75,7 +75,7 @@ static void printReadResult(bool ok) {
 static void printTemperatureOnlyResult(bool ok) {
   if (ok) {
     printer.print(F("[APP] Temperature-only read: "), true);
-    printer.print(phSensor.liquid_temperature, true, " C", 1);
+    printer.printFixed(phSensor.liquid_temperature.raw, phSensor.liquid_temperature.decimals, true, " C");
     printer.println("", true);
   } else {
     printer.println(F("[APP] Temperature-only read failed."), true);
@@ -85,7 +85,7 @@ static void printTemperatureOnlyResult(bool ok) {
 static void printPHOnlyResult(bool ok) {
   if (ok) {
     printer.print(F("[APP] pH-only read: "), true);
-    printer.println(phSensor.liquid_ph, true, "", 2);
+    printer.printlnFixed(phSensor.liquid_ph.raw, phSensor.liquid_ph.decimals, true, "");
   } else {
     printer.println(F("[APP] pH-only read failed."), true);
   }
@@ -54,15 +54,15 @@ static void printReadResult(bool ok) {
   }
 
   printer.print(F("Moisture: "), true);
-  printer.print(soil.soil_moisture, true, " % | ", 1);
+  printer.printFixed(soil.soil_moisture.raw, soil.soil_moisture.decimals, true, " % | ");
   printer.print(F("Temp: "), true);
-  printer.print(soil.soil_temp, true, " C", 1);
+  printer.printFixed(soil.soil_temp.raw, soil.soil_temp.decimals, true, " C");
   printer.println("", true);
 
   printer.print(F("EC: "), true);
-  printer.print(soil.soil_ec, true, " us/cm | ", 0);
+  printer.printFixed(soil.soil_ec.raw, soil.soil_ec.decimals, true, " us/cm | ");
   printer.print(F("pH: "), true);
-  printer.print(soil.soil_ph, true, "", 2);
+  printer.printFixed(soil.soil_ph.raw, soil.soil_ph.decimals, true, "");
   printer.println("", true);
 
   printer.print(F("N: "), true);
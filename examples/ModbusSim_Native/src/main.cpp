@@ -0,0 +1,1425 @@
+#include <Arduino.h>
+#include "PrintController.h"
+#include "RS485Modbus.h"
+#include "Configuration_System.h"
+#include "ReadScheduler.h"
+#include "ModbusBusScanner.h"
+#include "ModbusBaudNegotiator.h"
+#include "ModbusTraceRing.h"
+#include "ModbusCrc16.h"
+#include "RetainedState.h"
+#include "NetworkManager.h"
+#include "RikaLeafSensor.h"
+#include "RikaSoilSensor3in1.h"
+#include "JXBS_SoilComp7in1.h"
+#include "JXBS_LeafSurfaceHumidity.h"
+#include "JXBS_LiquidPH.h"
+#include "SimModbusBus.h"
+#include "SimSensorProfiles.h"
+
+/*
+  ModbusSim_Native
+
+  Host-side harness for the native_modbus_sim env. The sensor drivers,
+  RS485Bus and ReadScheduler are the firmware sources; only the Arduino
+  core and the far end of the UART are simulated (sim/). Time is virtual,
+  so a one-hour schedule runs in well under a second and every number
+  below is reproducible.
+
+  Sections:
+  - Driver matrix: every driver against every fault profile (clean, slow
+    slave, echo, noise, byte drops, bad CRC, silent). Reports success
+    rate, wrong values (must stay 0), mean/max read time and wire bytes.
+  - Bus health counters: RikaLeaf on each fault profile; every attempt
+    must be classified, and the fault must land in its counter (silent
+    -> timeout, drops -> partial, bad CRC -> CRC, noise -> noise, echo
+    told apart from noise). An upload must carry the port's counters
+    line and clear them only once the server acknowledges it.
+  - Absent device: a learned device is unplugged; reports the time one
+    readData() then costs with adaptive timeouts on and off.
+  - Exception reply: a read of an unmapped register must end after one
+    request with the slave's exception code, not after all retries.
+  - Request frames: ModbusRequestFrame must match the runtime CRC for
+    every address, and a driver's cached request must follow
+    setAddress().
+  - Fixed-point samples: ModbusRegisterDecoder against the double
+    formula for every raw word of every scale the drivers use (value and
+    bound verdict must match), plus FixedSample text and rescaling.
+  - Baud negotiation: JXBS_LiquidPH moved from 9600 to 38400 baud and
+    verified; reports read time before and after. A device that applies
+    the new speed only after a power cycle must be found there by the
+    altBaud retry, and one without a baud register must stay put.
+  - Bus inventory: ModbusBusScanner over all 247 addresses on the clean
+    and echo lines. Every slave must be found with the right family.
+  - Bus trace: a ModbusTraceRing on the noisy line; the export must carry
+    TX/RX/verdict records and a valid CRC. Set SIM_TRACE_HEX=1 to print
+    the "#TRC" export for tools/rs485_trace_decode.py.
+  - Scheduler: two ports, two power lines, 60 simulated minutes of
+    ReadScheduler cycles. Reports cycles, reads and cycle times.
+  - Burst oversampling: SampleStats, back-to-back and spread bursts
+    through ReadScheduler; a spread burst must still report when the
+    station deep-sleeps between its reads (burst retained).
+  - Deep-sleep retention: state registered with SleepPlanner::retain()
+    goes through a RetainedState store (RTC memory on the ESP32) and is
+    wiped in between, as a deep sleep does. Learned timeouts, bus
+    counters and a driver's filter history must come back, their times
+    moved into the new timebase; a store from another layout must be
+    refused.
+
+  Exit code is non-zero when a check fails, so the env can gate CI:
+    pio run -e native_modbus_sim -t exec
+*/
+
+#define DebugPort Serial
+
+static PrintController printer(DebugPort, true);
+
+static const uint16_t READS_PER_CASE = 50;
+static const uint32_t SCHED_RUN_MS = 60UL * 60000UL;
+
+static uint16_t g_failures = 0;
+
+// ============================================================================
+// Simulated field bus
+// ============================================================================
+static SimModbusBus g_wire;
+static SimModbusSlave g_rikaLeaf(0x80);
+static SimModbusSlave g_rikaSoil(0x10);
+static SimModbusSlave g_jxbsSoil(0x01);
+static SimModbusSlave g_jxbsLeaf(0x02);
+static SimModbusSlave g_jxbsPh(0x03);
+
+static RS485Bus g_bus;
+
+static RikaLeafSensor g_drvRikaLeaf(g_bus, "leaf", 0x80);
+static RikaSoilSensor3in1 g_drvRikaSoil(g_bus, "soil3", 0x10);
+static JXBS_SoilComp7in1 g_drvJxbsSoil(g_bus, "soil7", 0x01);
+static JXBS_LeafSurfaceHumidity g_drvJxbsLeaf(g_bus, "jleaf", 0x02);
+static JXBS_LiquidPH g_drvJxbsPh(g_bus, "ph", 0x03);
+
+
+// Driver samples are fixed-point: compare the scaled integer exactly.
+static bool exact(const FixedSample &s, int32_t raw, uint8_t decimals) {
+  return s.raw == raw && s.decimals == decimals;
+}
+
+static bool checkRikaLeaf() {
+  return exact(g_drvRikaLeaf.leaf_humid, 455, 1) && exact(g_drvRikaLeaf.leaf_temp, -32, 1);
+}
+
+static bool checkRikaSoil() {
+  return exact(g_drvRikaSoil.soil_temp, 184, 1) && exact(g_drvRikaSoil.soil_vwc, 312, 1) &&
+         exact(g_drvRikaSoil.soil_ec, 452, 3);
+}
+
+static bool checkJxbsSoil() {
+  return exact(g_drvJxbsSoil.soil_moisture, 275, 1) && exact(g_drvJxbsSoil.soil_temp, 161, 1) &&
+         exact(g_drvJxbsSoil.soil_ec, 812, 0) && exact(g_drvJxbsSoil.soil_ph, 685, 2) &&
+         g_drvJxbsSoil.soil_nitrogen == 41 && g_drvJxbsSoil.soil_phosphorus == 17 &&
+         g_drvJxbsSoil.soil_potassium == 120;
+}
+
+static bool checkJxbsLeaf() {
+  return exact(g_drvJxbsLeaf.leaf_humidity, 630, 1) && exact(g_drvJxbsLeaf.leaf_temperature, 2247, 2);
+}
+
+static bool checkJxbsPh() {
+  return exact(g_drvJxbsPh.liquid_temperature, 195, 1) && exact(g_drvJxbsPh.liquid_ph, 721, 2);
+}
+
+static void loadSlaves() {
+  simLoadRikaLeaf(g_rikaLeaf, 45.5, -3.2);
+  simLoadRikaSoil3in1(g_rikaSoil, 18.4, 31.2, 0.452);
+  simLoadJxbsSoil7in1(g_jxbsSoil, 27.5, 16.1, 812, 6.85, 41, 17, 120);
+  simLoadJxbsLeafSurface(g_jxbsLeaf, 63.0, 22.47);
+  simLoadJxbsLiquidPH(g_jxbsPh, 19.5, 7.21);
+
+  g_wire.addSlave(&g_rikaLeaf);
+  g_wire.addSlave(&g_rikaSoil);
+  g_wire.addSlave(&g_jxbsSoil);
+  g_wire.addSlave(&g_jxbsLeaf);
+  g_wire.addSlave(&g_jxbsPh);
+  g_wire.attach(Serial3);
+}
+
+// ============================================================================
+// Driver matrix
+// ============================================================================
+struct DriverCase {
+  const char *name;
+  SensorDriver *driver;
+  bool (*check)();
+};
+
+static DriverCase g_drivers[] = {
+  {"RikaLeaf",     &g_drvRikaLeaf, checkRikaLeaf},
+  {"RikaSoil3in1", &g_drvRikaSoil, checkRikaSoil},
+  {"JXBS_Soil7in1", &g_drvJxbsSoil, checkJxbsSoil},
+  {"JXBS_Leaf",    &g_drvJxbsLeaf, checkJxbsLeaf},
+  {"JXBS_LiquidPH", &g_drvJxbsPh,  checkJxbsPh},
+};
+
+struct FaultCase {
+  const char *name;
+  SimFaults (*make)();
+  bool mustSucceed;  // every read has to pass after driver/bus retries
+};
+
+static const FaultCase FAULTS[] = {
+  {"clean",   simFaultsClean,     true},
+  {"slow",    simFaultsSlowSlave, true},
+  {"echo",    simFaultsEcho,      true},
+  {"noise",   simFaultsNoisy,     true},
+  {"drops",   simFaultsLossy,     false},
+  {"bad CRC", simFaultsBadCrc,    false},
+  {"silent",  simFaultsSilent,    false},
+};
+
+static void runDriverCase(DriverCase &dc, const FaultCase &fc) {
+  g_wire.setFaults(fc.make());
+  g_wire.seed(0xC0FFEEUL);
+  g_wire.resetStats();
+  Serial3.clearRx();
+  g_bus.latency().reset();
+
+  const uint32_t txStart = Serial3.txBytes();
+  const uint32_t rxStart = Serial3.rxBytes();
+
+  uint16_t ok = 0;
+  uint16_t wrong = 0;
+  uint64_t totalUs = 0;
+  uint64_t maxUs = 0;
+
+  for (uint16_t i = 0; i < READS_PER_CASE; ++i) {
+    const uint64_t startUs = SimClock::nowUs();
+    const bool success = dc.driver->readData();
+    const uint64_t elapsedUs = SimClock::nowUs() - startUs;
+
+    totalUs += elapsedUs;
+    if (elapsedUs > maxUs) maxUs = elapsedUs;
+
+    if (success) {
+      if (dc.check()) {
+        ++ok;
+      } else {
+        ++wrong;
+      }
+    }
+    dc.driver->resetStatus();
+  }
+
+  const bool pass = (wrong == 0) && (!fc.mustSucceed || ok == READS_PER_CASE);
+  if (!pass) ++g_failures;
+
+  printer.print(F("  "), true);
+  printer.print(dc.name, true, " | ");
+  printer.print(fc.name, true, " | ok ");
+  printer.print((unsigned long)ok, true, "/", DEC);
+  printer.print((unsigned long)READS_PER_CASE, true, " | wrong ", DEC);
+  printer.print((unsigned long)wrong, true, " | mean ", DEC);
+  printer.print((double)totalUs / 1000.0 / READS_PER_CASE, true, " ms | max ", 1);
+  printer.print((double)maxUs / 1000.0, true, " ms | tx ", 1);
+  printer.print((unsigned long)(Serial3.txBytes() - txStart), true, " B | rx ", DEC);
+  printer.print((unsigned long)(Serial3.rxBytes() - rxStart), true, " B", DEC);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+}
+
+static void runDriverMatrix() {
+  printer.println(F("[SIM] Driver x fault matrix"), true);
+  for (size_t f = 0; f < sizeof(FAULTS) / sizeof(FAULTS[0]); ++f) {
+    for (size_t d = 0; d < sizeof(g_drivers) / sizeof(g_drivers[0]); ++d) {
+      runDriverCase(g_drivers[d], FAULTS[f]);
+    }
+  }
+}
+
+// ============================================================================
+// Bus health counters
+// ============================================================================
+static bool runStatsCase(const char *name, SimFaults (*make)(), ModbusBusStats::Outcome expect) {
+  g_wire.setFaults(make());
+  g_wire.seed(0xC0FFEEUL);
+  Serial3.clearRx();
+  g_bus.latency().reset();
+  g_bus.stats().reset(millis());
+
+  const uint32_t txStart = Serial3.txBytes();
+  for (uint8_t i = 0; i < 20; ++i) {
+    g_drvRikaLeaf.readData();
+    g_drvRikaLeaf.resetStatus();
+  }
+
+  const ModbusBusStats::Counters &total = g_bus.stats().total();
+  const ModbusBusStats::Counters *leaf = g_bus.stats().counters(0x80);
+
+  // Every attempt classified once, the fault shows up where expected and
+  // the clean line shows no failure at all.
+  uint32_t classified = 0;
+  uint32_t failures = 0;
+  for (uint8_t o = 0; o < ModbusBusStats::OUTCOME_COUNT; ++o) {
+    classified += total.outcomes[o];
+    if (o != ModbusBusStats::OUTCOME_OK) failures += total.outcomes[o];
+  }
+  bool pass = leaf && classified == total.attempts && leaf->attempts == total.attempts &&
+              total.txBytes == Serial3.txBytes() - txStart && total.transactions >= 20;
+  if (expect == ModbusBusStats::OUTCOME_OK) {
+    pass = pass && failures == 0 && total.retries() == 0 && total.latencySamples == total.attempts;
+  } else {
+    pass = pass && total.outcomes[expect] > 0;
+  }
+  if (!pass) ++g_failures;
+
+  char line[160];
+  ModbusBusStats::format(total, line, sizeof(line));
+  printer.print(F("  "), true);
+  printer.print(name, true, " | ");
+  printer.print(line, true);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+  return pass;
+}
+
+// Upload side: a network that only records what it is asked to push.
+class SimNetwork : public NetworkManager {
+public:
+  SimNetwork() : NetworkManager(255, 255, 0), ack(true), pushes(0) { last[0] = '\0'; }
+
+  bool connect() override { return true; }
+  bool isConnected() override { return true; }
+  bool pushData(const char *data) override {
+    ++pushes;
+    strncpy(last, data, sizeof(last) - 1);
+    last[sizeof(last) - 1] = '\0';
+    return ack;
+  }
+  bool checkServerConfig() override { return false; }
+  bool syncRTC(uint16_t &, uint8_t &, uint8_t &, uint8_t &, uint8_t &, uint8_t &) override { return false; }
+  bool checkOTA(bool) override { return false; }
+  void disconnect() override {}
+
+  bool ack;
+  uint16_t pushes;
+  char last[160];
+};
+
+static bool g_simReadCycleBusy = false;
+
+static bool simReadCycleBusy() {
+  return g_simReadCycleBusy;
+}
+
+static void runStatsUpload() {
+  SimNetwork net;
+  net.attachBuses(&g_bus, 1, simReadCycleBusy);
+
+  // A read cycle owns the counters: nothing pushed, nothing reset.
+  const uint16_t attempts = g_bus.stats().total().attempts;
+  g_simReadCycleBusy = true;
+  net.runUploadPhase(nullptr);
+  g_simReadCycleBusy = false;
+  const bool waited = net.pushes == 0 && g_bus.stats().total().attempts == attempts;
+
+  // Not acknowledged: the line went out, the counters stay.
+  net.ack = false;
+  net.runUploadPhase(nullptr);
+  const bool kept = net.pushes == 1 && strncmp(net.last, "bus0 n=", 7) == 0 &&
+                    g_bus.stats().total().attempts == attempts;
+
+  net.ack = true;
+  net.runUploadPhase(nullptr);
+  const bool cleared = net.pushes == 2 && g_bus.stats().total().attempts == 0;
+
+  // Nothing on the line since: no empty health line.
+  net.runUploadPhase(nullptr);
+  const bool quiet = net.pushes == 2;
+
+  const bool pass = attempts > 0 && waited && kept && cleared && quiet;
+  if (!pass) ++g_failures;
+  printer.print(F("  upload: "), true);
+  printer.print(net.last, true);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+}
+
+static void runBusStats() {
+  printer.println(F("[SIM] Bus health counters (RikaLeaf, 20 reads per line)"), true);
+
+  runStatsCase("clean", simFaultsClean, ModbusBusStats::OUTCOME_OK);
+  runStatsCase("silent", simFaultsSilent, ModbusBusStats::OUTCOME_TIMEOUT);
+  runStatsCase("drops", simFaultsLossy, ModbusBusStats::OUTCOME_PARTIAL);
+  runStatsCase("bad CRC", simFaultsBadCrc, ModbusBusStats::OUTCOME_CRC);
+
+  // Noise in front of a good reply is counted, an echo is told apart.
+  runStatsCase("noise", simFaultsNoisy, ModbusBusStats::OUTCOME_OK);
+  const bool noisy = g_bus.stats().total().noise > 0 && g_bus.stats().total().echoes == 0;
+  runStatsCase("echo", simFaultsEcho, ModbusBusStats::OUTCOME_OK);
+  const ModbusBusStats::Counters &echo = g_bus.stats().total();
+  const bool echoed = echo.echoes == echo.attempts && echo.noise == 0;
+  if (!noisy || !echoed) ++g_failures;
+  printer.print(F("  noise counted "), true);
+  printer.print(noisy ? F("yes") : F("no"), true);
+  printer.print(F(" | echo told apart "), true);
+  printer.print(echoed ? F("yes") : F("no"), true);
+  printer.println(noisy && echoed ? " | PASS" : " | FAIL", true);
+
+  runStatsUpload();
+
+  g_wire.setFaults(simFaultsClean());
+  g_bus.stats().reset(millis());
+}
+
+// ============================================================================
+// Absent device
+// ============================================================================
+static double timeAbsentReads(bool adaptive, ModbusBudget *budget = nullptr) {
+  g_wire.setFaults(simFaultsClean());
+  g_bus.latency().reset();
+  g_bus.setAdaptiveTimeouts(adaptive);
+  g_rikaLeaf.setOnline(true);
+
+  for (uint8_t i = 0; i < 20; ++i) g_drvRikaLeaf.readData();
+
+  g_rikaLeaf.setOnline(false);
+  const uint8_t reads = 5;
+  const uint64_t startUs = SimClock::nowUs();
+  for (uint8_t i = 0; i < reads; ++i) {
+    if (budget) {
+      budget->start(millis(), SENSOR_TRANSACTION_BUDGET_MS, SENSOR_TRANSACTION_MAX_ATTEMPTS);
+      g_bus.setBudget(budget);
+    }
+    g_drvRikaLeaf.readData();
+    g_drvRikaLeaf.resetStatus();
+  }
+  g_bus.setBudget(nullptr);
+  g_rikaLeaf.setOnline(true);
+  g_bus.setAdaptiveTimeouts(true);
+
+  return (double)(SimClock::nowUs() - startUs) / 1000.0 / reads;
+}
+
+static void runAbsentDevice() {
+  printer.println(F("[SIM] Absent device (RikaLeaf unplugged after 20 good reads)"), true);
+
+  const double fixedMs = timeAbsentReads(false);
+  const double adaptiveMs = timeAbsentReads(true);
+  const uint16_t learnedMs = g_bus.latency().timeoutFor(0x80, SENSOR_DEFAULT_READ_TIMEOUT_MS);
+
+  // Fixed timeouts again, but under one transaction budget.
+  ModbusBudget budget;
+  const double budgetMs = timeAbsentReads(false, &budget);
+
+  // The budget runs on millis(): up to one tick past it depending on where
+  // in a millisecond the transaction started.
+  const bool pass = adaptiveMs < fixedMs / 2.0 && budgetMs <= (double)SENSOR_TRANSACTION_BUDGET_MS + 1.0;
+  if (!pass) ++g_failures;
+
+  printer.print(F("  per readData(): fixed "), true);
+  printer.print(fixedMs, true, " ms | adaptive ", 1);
+  printer.print(adaptiveMs, true, " ms | budgeted ", 1);
+  printer.print(budgetMs, true, " ms | learned timeout ", 1);
+  printer.print((unsigned long)learnedMs, true, " ms", DEC);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+}
+
+// ============================================================================
+// Exception reply
+// ============================================================================
+static void runExceptionReply() {
+  printer.println(F("[SIM] Exception reply (RikaLeaf, unmapped register)"), true);
+
+  g_wire.setFaults(simFaultsClean());
+  g_wire.resetStats();
+  Serial3.clearRx();
+
+  uint8_t request[ModbusReadPlanner::REQUEST_SIZE];
+  const ModbusReadBlock block = {0x0100, 2};
+  ModbusReadPlanner::buildRequest(0x80, block, request);
+  const uint8_t check[3] = {0x80, ModbusReadPlanner::FUNCTION_READ_HOLDING, 4};
+  ModbusFrameView frame;
+
+  const uint32_t exceptionsBefore = g_bus.exceptions().count(0x80);
+  const uint64_t startUs = SimClock::nowUs();
+  const bool ok = g_bus.transact(request, sizeof(request), ModbusReadPlanner::responseSize(2),
+                                 check, sizeof(check), frame,
+                                 SENSOR_DEFAULT_BUS_RETRIES, SENSOR_DEFAULT_READ_TIMEOUT_MS,
+                                 false, SENSOR_DEFAULT_AFTER_REQ_MS);
+  const double elapsedMs = (double)(SimClock::nowUs() - startUs) / 1000.0;
+  const ModbusException &ex = g_bus.lastException();
+
+  const bool pass = !ok && g_bus.lastWasException() &&
+                    ex.code == ModbusException::ILLEGAL_DATA_ADDRESS &&
+                    g_wire.stats().requests == 1 &&
+                    g_bus.exceptions().count(0x80) == exceptionsBefore + 1 &&
+                    elapsedMs < 100.0;
+  if (!pass) ++g_failures;
+
+  printer.print(F("  code "), true);
+  printer.print((unsigned int)ex.code, true, " (", DEC);
+  printer.print(ModbusException::codeName(ex.code), true);
+  printer.print(F(") | requests "), true);
+  printer.print((unsigned long)g_wire.stats().requests, true, " | ", DEC);
+  printer.print(elapsedMs, true, " ms", 1);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+}
+
+// ============================================================================
+// Busy reply
+// ============================================================================
+static bool busyRead(uint8_t busyReplies) {
+  g_rikaLeaf.setBusyReplies(busyReplies);
+  Serial3.clearRx();
+
+  uint8_t request[ModbusReadPlanner::REQUEST_SIZE];
+  const ModbusReadBlock block = {0x0000, 2};
+  ModbusReadPlanner::buildRequest(0x80, block, request);
+  const uint8_t check[3] = {0x80, ModbusReadPlanner::FUNCTION_READ_HOLDING, 4};
+  ModbusFrameView frame;
+
+  const bool ok = g_bus.transact(request, sizeof(request), ModbusReadPlanner::responseSize(2),
+                                 check, sizeof(check), frame,
+                                 SENSOR_DEFAULT_BUS_RETRIES, SENSOR_DEFAULT_READ_TIMEOUT_MS,
+                                 false, SENSOR_DEFAULT_AFTER_REQ_MS);
+  g_rikaLeaf.setBusyReplies(0);
+  return ok;
+}
+
+static void runBusyReply() {
+  printer.println(F("[SIM] Busy reply (RikaLeaf, SLAVE DEVICE BUSY)"), true);
+
+  g_wire.setFaults(simFaultsClean());
+
+  // Busy once: retried, the second attempt reads.
+  g_wire.resetStats();
+  const bool okOnce = busyRead(1);
+  const uint32_t requestsOnce = g_wire.stats().requests;
+  const bool passOnce = okOnce && !g_bus.lastWasException() && requestsOnce == 2;
+
+  // Busy throughout: every retry is spent, but it is no final rejection.
+  g_wire.resetStats();
+  const bool okAlways = busyRead(SENSOR_DEFAULT_BUS_RETRIES);
+  const uint32_t requestsAlways = g_wire.stats().requests;
+  const bool passAlways = !okAlways && !g_bus.lastWasException() &&
+                          g_bus.lastException().code == ModbusException::SLAVE_DEVICE_BUSY &&
+                          requestsAlways == SENSOR_DEFAULT_BUS_RETRIES;
+
+  const bool pass = passOnce && passAlways;
+  if (!pass) ++g_failures;
+
+  printer.print(F("  busy once: requests "), true);
+  printer.print((unsigned long)requestsOnce, true, okOnce ? " ok" : " failed", DEC);
+  printer.print(F(" | busy always: requests "), true);
+  printer.print((unsigned long)requestsAlways, true, okAlways ? " ok" : " failed", DEC);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+}
+
+// ============================================================================
+// Batch fallback
+// ============================================================================
+// Reads of the JXBS 7-in-1 that pass; the device answers wide requests up
+// to maxRegs registers, others it ignores (silent) or rejects.
+static uint16_t jxbsReads(uint16_t count, uint16_t maxRegs, bool silent) {
+  g_jxbsSoil.setMaxRegsPerRead(maxRegs);
+  g_jxbsSoil.setSilentOnError(silent);
+
+  uint16_t ok = 0;
+  for (uint16_t i = 0; i < count; ++i) {
+    Serial3.clearRx();
+    if (g_drvJxbsSoil.readData() && checkJxbsSoil()) ++ok;
+    g_drvJxbsSoil.resetStatus();
+  }
+
+  g_jxbsSoil.setMaxRegsPerRead(125);
+  g_jxbsSoil.setSilentOnError(false);
+  return ok;
+}
+
+static void runBatchFallback() {
+  printer.println(F("[SIM] Batch fallback (JXBS_Soil7in1, 27-register read)"), true);
+
+  g_wire.setFaults(simFaultsClean());
+  g_drvJxbsSoil.setBatchRead(true);
+  uint16_t ok = 0;
+  uint16_t reads = 0;
+
+  // One missed wide read is noise: batching stays on.
+  ok += jxbsReads(1, 16, true);
+  ok += jxbsReads(1, 125, false);
+  reads += 2;
+  const bool keptOnMiss = g_drvJxbsSoil.isBatchReadActive();
+
+  // Missed LATCH_MISSES reads in a row: split reads from then on.
+  ok += jxbsReads(SENSOR_BATCH_LATCH_MISSES, 16, true);
+  reads += SENSOR_BATCH_LATCH_MISSES;
+  const bool latchedOnMisses = !g_drvJxbsSoil.isBatchReadActive();
+
+  // Wide read answers again: back on at the next probe, not before.
+  ok += jxbsReads(SENSOR_BATCH_REPROBE_READS, 125, false);
+  const bool offUntilProbe = !g_drvJxbsSoil.isBatchReadActive();
+  ok += jxbsReads(1, 125, false);
+  reads += SENSOR_BATCH_REPROBE_READS + 1;
+  const bool reprobed = g_drvJxbsSoil.isBatchReadActive();
+
+  // A fresh device that ignores the wide read, under the transaction
+  // budget: the split fallback still completes the first cycle.
+  g_drvJxbsSoil.setBatchRead(true);
+  g_bus.latency().reset();
+  ModbusBudget budget;
+  budget.start(millis(), SENSOR_TRANSACTION_BUDGET_MS, SENSOR_TRANSACTION_MAX_ATTEMPTS);
+  g_bus.setBudget(&budget);
+  ok += jxbsReads(1, 16, true);
+  g_bus.setBudget(nullptr);
+  reads += 1;
+  const bool budgetFits = budget.abortReason() == ModbusBudget::ABORT_NONE;
+
+  // An exception to the wide read is final: off at once.
+  ok += jxbsReads(1, 16, false);
+  reads += 1;
+  const bool latchedOnException = !g_drvJxbsSoil.isBatchReadActive();
+  g_drvJxbsSoil.setBatchRead(true);
+
+  const bool pass = keptOnMiss && latchedOnMisses && offUntilProbe && reprobed &&
+                    budgetFits && latchedOnException && ok == reads;
+  if (!pass) ++g_failures;
+
+  printer.print(F("  ok "), true);
+  printer.print((unsigned long)ok, true, "/", DEC);
+  printer.print((unsigned long)reads, true, " | one miss ", DEC);
+  printer.print(keptOnMiss ? "kept" : "LATCHED", true);
+  printer.print(F(" | misses "), true);
+  printer.print(latchedOnMisses ? "latched" : "KEPT", true);
+  printer.print(F(" | re-probe "), true);
+  printer.print(offUntilProbe ? "off" : "ON", true);
+  printer.print(reprobed ? " then on" : " then OFF", true);
+  printer.print(F(" | budgeted "), true);
+  printer.print((unsigned long)budget.attemptsUsed(), true, " attempts", DEC);
+  printer.print(F(" | exception "), true);
+  printer.print(latchedOnException ? "latched" : "KEPT", true);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+}
+
+// ============================================================================
+// Request frames
+// ============================================================================
+static void runRequestFrames() {
+  printer.println(F("[SIM] Request frames (constexpr build vs CRC_Calc)"), true);
+
+  static constexpr ModbusRequestFrame FIXED = ModbusRequestFrame::read(0x01, 0x0000, 2);
+  static_assert(FIXED.crc() == 0x0BC4, "constexpr frame CRC");
+
+  const uint16_t regs[] = {0x0000, 0x0012, 0x0101, 0x0200};
+  uint32_t mismatches = 0;
+  uint32_t frames = 0;
+  for (uint16_t addr = 1; addr <= 247; ++addr) {
+    for (uint8_t r = 0; r < sizeof(regs) / sizeof(regs[0]); ++r) {
+      uint8_t request[ModbusReadPlanner::REQUEST_SIZE];
+      const ModbusReadBlock block = {regs[r], (uint16_t)(r + 1)};
+      ModbusReadPlanner::buildRequest((uint8_t)addr, block, request);
+      g_bus.CRC_Calc(request, sizeof(request));
+      const ModbusRequestFrame frame = ModbusRequestFrame::read((uint8_t)addr, regs[r], (uint16_t)(r + 1));
+      if (memcmp(request, frame.bytes, sizeof(request)) != 0) ++mismatches;
+
+      request[1] = ModbusRequestFrame::FUNCTION_WRITE_SINGLE;
+      g_bus.CRC_Calc(request, sizeof(request));
+      const ModbusRequestFrame write = ModbusRequestFrame::writeSingle((uint8_t)addr, regs[r], (uint16_t)(r + 1));
+      if (memcmp(request, write.bytes, sizeof(request)) != 0) ++mismatches;
+      frames += 2;
+    }
+  }
+
+  // A driver moved to another address must poll there from the next read.
+  g_wire.setFaults(simFaultsClean());
+  g_drvRikaLeaf.setAddress(0x7F);
+  const bool silentElsewhere = !g_drvRikaLeaf.readData();
+  g_drvRikaLeaf.resetStatus();
+  g_drvRikaLeaf.setAddress(0x80);
+  const bool backHome = g_drvRikaLeaf.readData();
+  g_drvRikaLeaf.resetStatus();
+
+  const bool pass = mismatches == 0 && silentElsewhere && backHome;
+  if (!pass) ++g_failures;
+
+  printer.print(F("  "), true);
+  printer.print((unsigned long)frames, true, " frames, ", DEC);
+  printer.print((unsigned long)mismatches, true, " mismatches", DEC);
+  printer.print(F(" | setAddress "), true);
+  printer.print(silentElsewhere && backHome ? F("follows") : F("stale"), true);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+}
+
+// ============================================================================
+// Fixed-point samples
+// ============================================================================
+static constexpr ModbusRegisterMap<4> SAMPLE_SWEEP_MAP = {
+  0x0000, 4, {
+    {0x0000, MODBUS_FIELD_S16,   10.0, 0.0, -40.0,  80.0},
+    {0x0001, MODBUS_FIELD_U16,   10.0, 0.0,   0.0, 100.0},
+    {0x0002, MODBUS_FIELD_U16,  100.0, 0.0,   3.0,   9.0},
+    {0x0003, MODBUS_FIELD_U16, 1000.0, 0.0,   0.0,  50.0}
+  }
+};
+static_assert(SAMPLE_SWEEP_MAP.fields[0].decimals == 1 && SAMPLE_SWEEP_MAP.fields[0].minValue == -400 &&
+                  SAMPLE_SWEEP_MAP.fields[0].maxValue == 800,
+              "spec scaled at compile time");
+static_assert(SAMPLE_SWEEP_MAP.fields[2].minValue == 300 && SAMPLE_SWEEP_MAP.fields[3].maxValue == 50000,
+              "spec bounds exact");
+static_assert(ModbusFieldSpec::decimalsFor(4.0) == ModbusFieldSpec::BAD_SCALE, "non-decimal divisor rejected");
+
+static bool formatIs(int32_t raw, uint8_t decimals, const char *expected) {
+  char buf[16];
+  FixedSample::make(raw, decimals).format(buf, sizeof(buf));
+  return strcmp(buf, expected) == 0;
+}
+
+static void runFixedSamples() {
+  printer.println(F("[SIM] Fixed-point samples (decoder vs double formula)"), true);
+
+  uint8_t frame[3 + 8 + 2] = {0x01, 0x03, 0x08};
+  uint32_t decodes = 0;
+  uint32_t mismatches = 0;
+  for (uint32_t word = 0; word <= 0xFFFF; ++word) {
+    for (uint8_t i = 0; i < 4; ++i) {
+      frame[3 + i * 2] = (uint8_t)(word >> 8);
+      frame[4 + i * 2] = (uint8_t)(word & 0xFF);
+    }
+
+    FixedSample fixed[4];
+    const uint32_t mask = ModbusRegisterDecoder::decode(SAMPLE_SWEEP_MAP, frame, fixed);
+
+    for (uint8_t i = 0; i < 4; ++i) {
+      const ModbusFieldSpec &f = SAMPLE_SWEEP_MAP.fields[i];
+      const double divisor = (double)FixedSample::pow10(f.decimals);
+      const double raw = (f.type == MODBUS_FIELD_S16) ? (double)(int16_t)word : (double)word;
+      const double value = raw / divisor;
+      const bool inBounds = value >= (double)f.minValue / divisor && value <= (double)f.maxValue / divisor;
+
+      if (fabs(fixed[i].toDouble() - value) > 1e-9 || (((mask >> i) & 1UL) != 0) != inBounds) {
+        ++mismatches;
+      }
+      ++decodes;
+    }
+  }
+
+  const bool textOk = formatIs(-32, 1, "-3.2") && formatIs(452, 3, "0.452") &&
+                      formatIs(-5, 2, "-0.05") && formatIs(812, 0, "812") &&
+                      formatIs(0, 2, "0.00") && formatIs(-990, 1, "-99.0");
+  const bool scaleOk = FixedSample::make(2247, 2).scaledTo(1) == 225 &&
+                       FixedSample::make(-2245, 2).scaledTo(1) == -225 &&
+                       FixedSample::make(185, 1).scaledTo(2) == 1850 &&
+                       FixedSample::fallback(2).isFallback() &&
+                       ModbusRegisterDecoder::inBounds(SAMPLE_SWEEP_MAP.fields[2], FixedSample::make(3, 0));
+
+  const bool pass = mismatches == 0 && textOk && scaleOk;
+  if (!pass) ++g_failures;
+
+  printer.print(F("  "), true);
+  printer.print((unsigned long)decodes, true, " decodes, ", DEC);
+  printer.print((unsigned long)mismatches, true, " mismatches", DEC);
+  printer.print(F(" | text "), true);
+  printer.print(textOk ? F("ok") : F("WRONG"), true);
+  printer.print(F(" | rescale "), true);
+  printer.print(scaleOk ? F("ok") : F("WRONG"), true);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+}
+
+// ============================================================================
+// Range protection
+// ============================================================================
+static constexpr ModbusRegisterMap<1> FILTER_MAP = {
+  0x0000, 1, {
+    {0x0000, MODBUS_FIELD_S16, 10.0, 0.0, -40.0, 80.0, SAMPLE_UNIT_CELSIUS}
+  }
+};
+static constexpr SampleFilterRule FILTER_RULE = SampleFilterRule::make(FILTER_MAP.fields[0], -20.0, 60.0, 10.0, 3, 4);
+static_assert(FILTER_RULE.softMin == -200 && FILTER_RULE.softMax == 600 && FILTER_RULE.rocPerMin == 100,
+              "rule scaled like its field");
+
+struct FilterStep {
+  uint32_t atMs;
+  int32_t raw;
+  uint8_t quality;  // expected flags
+  int32_t out;      // expected output at the field's scale
+};
+
+// One field, one read a minute. ROC allows 10 C per minute since the last
+// good sample.
+static const FilterStep FILTER_SCRIPT[] = {
+  {     0,    200, SAMPLE_QUALITY_OK,                                 200},
+  { 60000, 0x7FFF, SAMPLE_QUALITY_FAULT_WORD | SAMPLE_QUALITY_HELD,   200},
+  {120000,    900, SAMPLE_QUALITY_HARD | SAMPLE_QUALITY_HELD,         200},
+  {180000,    210, SAMPLE_QUALITY_OK,                                 210},
+  {240000,    600, SAMPLE_QUALITY_ROC | SAMPLE_QUALITY_HELD,          210},  // +39 C
+  {300000,    602, SAMPLE_QUALITY_ROC | SAMPLE_QUALITY_HELD,          210},
+  {360000,    601, SAMPLE_QUALITY_SOFT,                               601},  // third agreeing read
+  {420000,    601, SAMPLE_QUALITY_SOFT,                               601},
+  {480000,    601, SAMPLE_QUALITY_SOFT,                               601},
+  {540000,    601, SAMPLE_QUALITY_SOFT | SAMPLE_QUALITY_STUCK,        601},  // fourth identical word
+  {600000,    250, SAMPLE_QUALITY_ROC | SAMPLE_QUALITY_HELD,          601},  // one-off drop
+  {660000,    590, SAMPLE_QUALITY_OK,                                 590},
+};
+
+static bool filterStep(SampleFilter::State &st, const SampleFilterRule *rule,
+                       uint32_t atMs, int32_t raw, uint8_t quality, int32_t out) {
+  FixedSample value;
+  const uint8_t q = SampleFilter::filter(FILTER_MAP.fields[0], rule, st, raw, atMs, value);
+  return q == quality && value.raw == out && value.decimals == 1 && st.quality == q;
+}
+
+static void runSampleFilter() {
+  printer.println(F("[SIM] Range protection (SampleFilter)"), true);
+
+  SampleFilter::State st = SampleFilter::State();
+  bool scriptOk = true;
+  for (size_t i = 0; i < sizeof(FILTER_SCRIPT) / sizeof(FILTER_SCRIPT[0]); ++i) {
+    const FilterStep &step = FILTER_SCRIPT[i];
+    scriptOk = filterStep(st, &FILTER_RULE, step.atMs, step.raw, step.quality, step.out) && scriptOk;
+  }
+
+  // Persistent fault word: sensor fault on the SAMPLE_FILTER_FAULT_COUNT-th
+  // rejection, cleared by the next good sample. 0xFFFF is -0.1 C on an S16
+  // field, not a fault.
+  bool faultOk = true;
+  uint32_t t = 720000;
+  for (uint8_t i = 1; i <= SAMPLE_FILTER_FAULT_COUNT; ++i, t += 60000) {
+    const uint8_t expect = SAMPLE_QUALITY_FAULT_WORD | SAMPLE_QUALITY_HELD |
+                           (i == SAMPLE_FILTER_FAULT_COUNT ? SAMPLE_QUALITY_SENSOR_FAULT : 0);
+    faultOk = filterStep(st, &FILTER_RULE, t, -0x8000L, expect, 590) && faultOk;
+  }
+  faultOk = filterStep(st, &FILTER_RULE, t, 585, SAMPLE_QUALITY_OK, 585) && st.invalidCount == 0 && faultOk;
+  faultOk = !SampleFilter::isFaultWord(FILTER_MAP.fields[0], -1) &&
+            SampleFilter::isFaultWord(ModbusFieldSpec(0, MODBUS_FIELD_U16, 1.0, 0.0, 0.0, 100.0), 0xFFFF) &&
+            faultOk;
+
+  // A last good value older than SAMPLE_FILTER_ROC_MAX_AGE_MS is no
+  // reference for ROC; without rules only fault words and hard bounds
+  // apply; before the first good sample a rejection yields the fallback.
+  t += SAMPLE_FILTER_ROC_MAX_AGE_MS + 60000UL;
+  bool edgeOk = filterStep(st, &FILTER_RULE, t, -300, SAMPLE_QUALITY_SOFT, -300);
+  SampleFilter::State bare = SampleFilter::State();
+  edgeOk = filterStep(bare, nullptr, 0, 0x7FFF, SAMPLE_QUALITY_FAULT_WORD, -990) && edgeOk;
+  edgeOk = filterStep(bare, nullptr, 1000, 100, SAMPLE_QUALITY_OK, 100) && edgeOk;
+  edgeOk = filterStep(bare, nullptr, 2000, 700, SAMPLE_QUALITY_OK, 700) && edgeOk;
+
+  // Driver path: a CRC-valid frame with a placeholder temperature costs one
+  // request, keeps the last good temperature and still takes the humidity.
+  g_wire.setFaults(simFaultsClean());
+  Serial3.clearRx();
+  g_drvRikaLeaf.readData();
+  g_drvRikaLeaf.resetStatus();
+
+  g_rikaLeaf.setRegister(0x0001, 0x7FFF);
+  g_rikaLeaf.setRegister(0x0000, 512);
+  const uint32_t txStart = Serial3.txBytes();
+  const bool rejected = !g_drvRikaLeaf.readData();
+  const uint32_t txRejected = Serial3.txBytes() - txStart;
+  const uint8_t quality = g_drvRikaLeaf.getSampleQuality();
+  const bool driverOk = rejected && txRejected == 8 &&
+                        exact(g_drvRikaLeaf.leaf_temp, -32, 1) && exact(g_drvRikaLeaf.leaf_humid, 512, 1) &&
+                        quality == (SAMPLE_QUALITY_FAULT_WORD | SAMPLE_QUALITY_HELD) &&
+                        g_drvRikaLeaf.getStatus() == SENSOR_ERROR;
+  g_drvRikaLeaf.resetStatus();
+
+  simLoadRikaLeaf(g_rikaLeaf, 45.5, -3.2);
+  const bool recovered = g_drvRikaLeaf.readData() && checkRikaLeaf() &&
+                         g_drvRikaLeaf.getSampleQuality() == SAMPLE_QUALITY_OK;
+  g_drvRikaLeaf.resetStatus();
+
+  const bool pass = scriptOk && faultOk && edgeOk && driverOk && recovered;
+  if (!pass) ++g_failures;
+
+  printer.print(F("  script "), true);
+  printer.print(scriptOk ? F("ok") : F("WRONG"), true);
+  printer.print(F(" | sensor fault "), true);
+  printer.print(faultOk ? F("ok") : F("WRONG"), true);
+  printer.print(F(" | edges "), true);
+  printer.print(edgeOk ? F("ok") : F("WRONG"), true);
+  printer.print(F(" | driver held, "), true);
+  printer.print((unsigned long)txRejected, true, " B sent", DEC);
+  printer.print(F(", quality 0x"), true);
+  printer.print((unsigned int)quality, true, "", HEX);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+}
+
+// ============================================================================
+// Baud negotiation
+// ============================================================================
+static double timeReads(SensorDriver &driver, bool (*check)(), uint8_t reads, bool &allOk) {
+  const uint64_t startUs = SimClock::nowUs();
+  for (uint8_t i = 0; i < reads; ++i) {
+    const bool ok = driver.readData() && check();
+    if (!ok) allOk = false;
+    driver.resetStatus();
+  }
+  return (double)(SimClock::nowUs() - startUs) / 1000.0 / reads;
+}
+
+static void runBaudNegotiation() {
+  printer.println(F("[SIM] Baud negotiation (9600 -> 38400)"), true);
+
+  g_wire.setFaults(simFaultsClean());
+  Serial3.clearRx();
+
+  // Applies the new speed right after the echo.
+  g_jxbsPh.setBaud(RS485_DEFAULT_BAUD);
+  g_jxbsPh.setBaudRegister(&MODBUS_BAUD_PROFILE_JXCT);
+  // Applies it only after a power cycle.
+  g_jxbsLeaf.setBaud(RS485_DEFAULT_BAUD);
+  g_jxbsLeaf.setBaudRegister(&MODBUS_BAUD_PROFILE_JXCT, true);
+
+  bool readsOk = true;
+  const double slowMs = timeReads(g_drvJxbsPh, checkJxbsPh, 20, readsOk);
+  const ModbusBaudNegotiator::Result phResult =
+      ModbusBaudNegotiator::negotiate(g_bus, 0x03, MODBUS_BAUD_PROFILE_JXCT, 38400);
+  const double fastMs = timeReads(g_drvJxbsPh, checkJxbsPh, 20, readsOk);
+
+  const ModbusBaudNegotiator::Result leafResult =
+      ModbusBaudNegotiator::negotiate(g_bus, 0x02, MODBUS_BAUD_PROFILE_JXCT, 38400);
+  const uint32_t leafBefore = g_bus.bauds().baudFor(0x02, 0);
+  g_jxbsLeaf.restart();
+  readsOk = g_drvJxbsLeaf.readData() && checkJxbsLeaf() && readsOk;
+  g_drvJxbsLeaf.resetStatus();
+
+  // No baud register: the first read gets an exception, nothing is written.
+  const ModbusBaudNegotiator::Result soilResult =
+      ModbusBaudNegotiator::negotiate(g_bus, 0x01, MODBUS_BAUD_PROFILE_JXCT, 38400);
+
+  const bool pass = readsOk &&
+                    phResult == ModbusBaudNegotiator::BAUD_OK &&
+                    g_jxbsPh.baud() == 38400 && g_bus.bauds().baudFor(0x03, 0) == 38400 &&
+                    fastMs < slowMs &&
+                    leafResult == ModbusBaudNegotiator::BAUD_PENDING_RESTART &&
+                    leafBefore == RS485_DEFAULT_BAUD &&
+                    g_bus.bauds().baudFor(0x02, 0) == 38400 &&
+                    soilResult == ModbusBaudNegotiator::BAUD_REJECTED &&
+                    g_bus.bauds().baudFor(0x01, RS485_DEFAULT_BAUD) == RS485_DEFAULT_BAUD;
+  if (!pass) ++g_failures;
+
+  printer.print(F("  read at 9600 "), true);
+  printer.print(slowMs, true, " ms | at 38400 ", 1);
+  printer.print(fastMs, true, " ms | restart-applied device: ", 1);
+  printer.print(ModbusBaudNegotiator::resultName(leafResult), true);
+  printer.print(F(", found at "), true);
+  printer.print((unsigned long)g_bus.bauds().baudFor(0x02, 0), true, " | no register: ", DEC);
+  printer.print(ModbusBaudNegotiator::resultName(soilResult), true);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+
+  // Later sections expect every slave at the default speed.
+  g_jxbsPh.setBaud(0);
+  g_jxbsPh.setBaudRegister(nullptr);
+  g_jxbsLeaf.setBaud(0);
+  g_jxbsLeaf.setBaudRegister(nullptr);
+  g_bus.bauds().reset();
+  g_bus.latency().reset();
+}
+
+// ============================================================================
+// Bus inventory
+// ============================================================================
+struct ExpectedDevice {
+  uint8_t address;
+  ModbusFamily family;
+};
+
+static const ExpectedDevice EXPECTED_INVENTORY[] = {
+  {0x01, MODBUS_FAMILY_JXBS_SOIL_7IN1},
+  {0x02, MODBUS_FAMILY_JXBS_LEAF_SURFACE},
+  {0x03, MODBUS_FAMILY_JXBS_LIQUID_PH},
+  {0x10, MODBUS_FAMILY_RIKA_SOIL_3IN1},
+  {0x80, MODBUS_FAMILY_RIKA_LEAF},
+};
+static const size_t EXPECTED_INVENTORY_COUNT = sizeof(EXPECTED_INVENTORY) / sizeof(EXPECTED_INVENTORY[0]);
+
+static void runInventoryCase(const FaultCase &fc) {
+  g_wire.setFaults(fc.make());
+  g_wire.seed(0xC0FFEEUL);
+  Serial3.clearRx();
+
+  ModbusBusScanner scanner(g_bus);
+  scanner.scan();
+
+  bool pass = scanner.count() == EXPECTED_INVENTORY_COUNT;
+  for (size_t i = 0; pass && i < EXPECTED_INVENTORY_COUNT; ++i) {
+    pass = scanner.entry(i).address == EXPECTED_INVENTORY[i].address &&
+           scanner.entry(i).family == EXPECTED_INVENTORY[i].family;
+  }
+  if (!pass) ++g_failures;
+
+  printer.print(F("  "), true);
+  printer.print(fc.name, true, " | found ");
+  printer.print((unsigned long)scanner.count(), true, " | ", DEC);
+  for (size_t i = 0; i < scanner.count(); ++i) {
+    printer.print((unsigned int)scanner.entry(i).address, true, "=", HEX);
+    printer.print(ModbusBusScanner::familyName(scanner.entry(i).family), true);
+    printer.print(F(" "), true);
+  }
+  printer.print(F("| "), true);
+  printer.print((unsigned long)scanner.lastScanMs(), true, " ms", DEC);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+}
+
+static void runInventory() {
+  printer.println(F("[SIM] Bus inventory, addresses 1-247"), true);
+  runInventoryCase(FAULTS[0]);  // clean
+  runInventoryCase(FAULTS[2]);  // echo
+}
+
+// ============================================================================
+// Scheduler run
+// ============================================================================
+static SimModbusBus g_wirePort0;
+static SimModbusBus g_wirePort1;
+static SimModbusSlave g_schedLeaf(0x80);
+static SimModbusSlave g_schedSoil(0x10);
+
+static RS485Bus g_schedBus0;
+static RS485Bus g_schedBus1;
+
+// leaf: power line 0, port 0, 5 min, 1 s warm-up
+// soil: power line 1, port 1, 10 min, 5 s warm-up
+static RikaLeafSensor g_schedDrvLeaf(g_schedBus0, "leaf_00", 0x80, false, 0, 0, 5, 1000UL);
+static RikaSoilSensor3in1 g_schedDrvSoil(g_schedBus1, "soil_00", 0x10, false, 1, 1, 10, 5000UL);
+
+static SensorDriver *g_schedSensors[] = {&g_schedDrvLeaf, &g_schedDrvSoil};
+static const size_t SCHED_SENSOR_COUNT = sizeof(g_schedSensors) / sizeof(g_schedSensors[0]);
+
+static bool g_powerLine[2] = {false, false};
+static uint32_t g_schedReads = 0;
+static uint32_t g_schedReadFailures = 0;
+
+static void simPowerLineSet(uint8_t line, bool on) {
+  if (line < 2) g_powerLine[line] = on;
+}
+
+static bool simPowerLineIsOn(uint8_t line) {
+  return line < 2 && g_powerLine[line];
+}
+
+static bool simPowerLineShouldStayOn(uint8_t) {
+  return false;
+}
+
+static void simInterfaceSet(uint8_t, bool) {}
+
+static uint32_t simInterfaceEnableDelayMs(uint8_t) {
+  return 10;
+}
+
+static void simOnSensorRead(SensorDriver *, bool ok) {
+  ++g_schedReads;
+  if (!ok) ++g_schedReadFailures;
+}
+
+static RS485Bus *simBusForInterface(uint8_t iface) {
+  if (iface == 0) return &g_schedBus0;
+  if (iface == 1) return &g_schedBus1;
+  return nullptr;
+}
+
+static const ReadSchedulerHooks SCHED_HOOKS = {
+  simPowerLineSet,
+  simPowerLineIsOn,
+  simPowerLineShouldStayOn,
+  simInterfaceSet,
+  simInterfaceEnableDelayMs,
+  simOnSensorRead,
+  nullptr,
+  simBusForInterface
+};
+
+static ReadScheduler g_scheduler(SCHED_HOOKS);
+
+static void runScheduler() {
+  printer.println(F("[SIM] ReadScheduler, 2 ports, 60 simulated minutes"), true);
+
+  simLoadRikaLeaf(g_schedLeaf, 45.5, -3.2);
+  simLoadRikaSoil3in1(g_schedSoil, 18.4, 31.2, 0.452);
+  g_wirePort0.addSlave(&g_schedLeaf);
+  g_wirePort1.addSlave(&g_schedSoil);
+  g_wirePort0.attach(Serial1);
+  g_wirePort1.attach(Serial2);
+  g_schedBus0.begin(Serial1, RS485_DEFAULT_BAUD);
+  g_schedBus1.begin(Serial2, RS485_DEFAULT_BAUD);
+
+  const uint32_t startMs = millis();
+  uint32_t cycles = 0;
+  uint32_t maxCycleMs = 0;
+  bool wasBusy = false;
+
+  while (millis() - startMs < SCHED_RUN_MS) {
+    const uint32_t nowMs = millis();
+
+    if (!g_scheduler.busy()) {
+      SensorDriver *due[SCHED_SENSOR_COUNT];
+      size_t dueCount = 0;
+      for (size_t i = 0; i < SCHED_SENSOR_COUNT; ++i) {
+        if (g_schedSensors[i]->isDueForRead(nowMs)) due[dueCount++] = g_schedSensors[i];
+      }
+      if (dueCount > 0) g_scheduler.start(due, dueCount, nowMs);
+    }
+
+    g_scheduler.tick(millis());
+
+    const bool busy = g_scheduler.busy();
+    if (wasBusy && !busy) {
+      ++cycles;
+      if (g_scheduler.lastCycleMs() > maxCycleMs) maxCycleMs = g_scheduler.lastCycleMs();
+    }
+    wasBusy = busy;
+
+    delay(1);
+  }
+
+  // 12 leaf reads (every 5 min) + 6 soil reads (every 10 min)
+  const bool pass = (g_schedReadFailures == 0) && (g_schedReads == 18) && !g_powerLine[0] && !g_powerLine[1];
+  if (!pass) ++g_failures;
+
+  printer.print(F("  cycles "), true);
+  printer.print((unsigned long)cycles, true, " | reads ", DEC);
+  printer.print((unsigned long)g_schedReads, true, " | failed ", DEC);
+  printer.print((unsigned long)g_schedReadFailures, true, " | max cycle ", DEC);
+  printer.print((unsigned long)maxCycleMs, true, " ms", DEC);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+}
+
+// ============================================================================
+// Burst oversampling
+// ============================================================================
+static const int16_t BURST_TEMPS[] = {-32, -30, -34, -29, -33};  // 0.1 C
+static uint8_t g_burstRead = 0;
+static int8_t g_burstFaultAt = -1;  // read index answering 0x7FFF
+
+static void burstOnRead(SimModbusSlave &slave) {
+  const uint8_t i = g_burstRead++;
+  const int16_t t = BURST_TEMPS[i % (sizeof(BURST_TEMPS) / sizeof(BURST_TEMPS[0]))];
+  slave.setRegister(0x0001, (i == (uint8_t)g_burstFaultAt) ? 0x7FFF : (uint16_t)t);
+}
+
+static bool sampleIs(const FixedSample &s, int32_t raw, uint8_t decimals) {
+  return s.raw == raw && s.decimals == decimals;
+}
+
+static bool runBurstCycle(SensorDriver *sensor, uint32_t &cycleMs) {
+  g_schedReads = 0;
+  g_schedReadFailures = 0;
+  g_scheduler.start(&sensor, 1, millis());
+  while (g_scheduler.busy()) {
+    g_scheduler.tick(millis());
+    delay(1);
+  }
+  cycleMs = g_scheduler.lastCycleMs();
+  return g_schedReads == 1;
+}
+
+// Keep-powered: 1 min interval, 1 s warm-up, 60 s minimum off window.
+static RikaLeafSensor g_burstSpreadLeaf(g_schedBus0, "leaf_01", 0x80, false, 0, 0, 1, 1000UL);
+
+// Keep-powered burst on the deep-sleep build: the station sleeps after
+// every read and RAM starts over on each wake; the burst survives only
+// when it goes through the retention store (SleepPlanner::retain()).
+// Runs one burst's worth of reads.
+static uint32_t spreadThroughDeepSleep(SensorBurst &spread, bool retain) {
+  static uint8_t store[sizeof(SensorBurst) + RetainedState::HEADER_BYTES];
+  RetainedState retained(store, sizeof(store));
+  retained.add(&spread, sizeof(spread));
+
+  g_burstRead = 0;
+  uint32_t reports = 0;
+  uint8_t reads = 0;
+  while (reads < g_burstSpreadLeaf.getBurstReads() || g_scheduler.busy()) {
+    if (!g_scheduler.busy() && g_burstSpreadLeaf.isDueForRead(millis())) {
+      SensorDriver *s = &g_burstSpreadLeaf;
+      g_schedReads = 0;
+      g_scheduler.start(&s, 1, millis());
+      ++reads;
+    }
+    g_scheduler.tick(millis());
+    if (!g_scheduler.busy() && reads > 0) {
+      reports += g_schedReads;
+      g_schedReads = 0;
+    }
+    delay(1);
+
+    // Deep sleep between reads: a reboot for everything in RAM.
+    if (!g_scheduler.busy() && !g_burstSpreadLeaf.isDueForRead(millis())) {
+      if (retain) retained.save();
+      spread = SensorBurst(SensorBurst::REDUCE_MEAN);
+      if (retain) retained.load(0);
+    }
+  }
+  return reports;
+}
+
+static void runBurst() {
+  printer.println(F("[SIM] Burst oversampling"), true);
+  bool pass = true;
+
+  // One-pass statistics: 21.3 21.5 21.1 21.6 21.3
+  SampleStats st;
+  const int32_t vals[] = {213, 215, 211, 216, 213};
+  for (uint8_t i = 0; i < 5; ++i) st.add(FixedSample::make(vals[i], 1, SAMPLE_UNIT_CELSIUS));
+  pass &= st.count() == 5;
+  pass &= sampleIs(st.mean(), 214, 1) && sampleIs(st.median(), 213, 1);
+  pass &= sampleIs(st.min(), 211, 1) && sampleIs(st.max(), 216, 1);
+  pass &= sampleIs(st.stddev(), 19, 2);               // sqrt(3.8) = 1.95 x 0.1
+  pass &= !st.add(FixedSample::make(21, 0));          // other scale
+  char line[96];
+  st.format(line, sizeof(line));
+  pass &= strcmp(line, "n=5 mean=21.4 sd=0.19 min=21.1 max=21.6 med=21.3") == 0;
+
+  SampleStats even;
+  even.add(FixedSample::make(-10, 0));
+  even.add(FixedSample::make(-11, 0));
+  pass &= sampleIs(even.median(), -11, 0) && sampleIs(even.mean(), -11, 0);
+  pass &= !even.add(FixedSample::make(-10 + SampleStats::MAX_SPREAD + 1, 0));
+  SampleStats one;
+  one.add(FixedSample::make(5, 0));
+  pass &= sampleIs(one.stddev(), 0, 1);
+
+  // Back to back on a switched line: five reads, one report, median.
+  SensorBurst burst;
+  g_scheduler.setBurstGap(200);
+  g_schedDrvLeaf.setBurst(&burst, 5);
+  g_schedLeaf.setOnRead(burstOnRead);
+  g_burstRead = 0;
+  uint32_t cycleMs = 0;
+  pass &= runBurstCycle(&g_schedDrvLeaf, cycleMs);
+  pass &= g_schedReadFailures == 0 && burst.taken() == 5 && burst.good() == 5;
+  pass &= sampleIs(g_schedDrvLeaf.leaf_temp, -32, 1);  // median of BURST_TEMPS
+  pass &= sampleIs(burst.stats(0).max(), -29, 1) && cycleMs >= 4 * 200;
+  burst.format(line, sizeof(line));
+
+  printer.print(F("  back to back "), true);
+  printer.print((unsigned long)cycleMs, true, " ms | ", DEC);
+  printer.println(line, true);
+
+  // A rejected read ends the burst; the good reads stand.
+  g_burstRead = 0;
+  g_burstFaultAt = 2;
+  pass &= runBurstCycle(&g_schedDrvLeaf, cycleMs);
+  pass &= g_schedReadFailures == 0 && burst.taken() == 3 && burst.good() == 2;
+  pass &= sampleIs(g_schedDrvLeaf.leaf_temp, -31, 1);  // (-3.2 + -3.0) / 2
+  g_burstFaultAt = -1;
+
+  printer.print(F("  early end "), true);
+  printer.print((unsigned long)burst.good(), true, "/", DEC);
+  printer.print((unsigned long)burst.taken(), true, " good, ", DEC);
+  printer.print((unsigned long)cycleMs, true, " ms", DEC);
+  printer.println("", true);
+
+  // Keep-powered: one read every 15 s, the report after the fourth.
+  SensorBurst spread(SensorBurst::REDUCE_MEAN);
+  g_burstSpreadLeaf.setBurst(&spread, 4);
+  pass &= g_burstSpreadLeaf.shouldKeepPowerOn() && g_burstSpreadLeaf.getReadIntervalMs() == 15000UL;
+  g_burstRead = 0;
+  uint32_t reports = 0;
+  uint32_t reads = 0;
+  const uint32_t startMs = millis();
+  while (millis() - startMs < 50000UL) {
+    if (!g_scheduler.busy() && g_burstSpreadLeaf.isDueForRead(millis())) {
+      SensorDriver *s = &g_burstSpreadLeaf;
+      g_schedReads = 0;
+      g_scheduler.start(&s, 1, millis());
+      ++reads;
+    }
+    g_scheduler.tick(millis());
+    if (!g_scheduler.busy()) {
+      reports += g_schedReads;
+      g_schedReads = 0;
+    }
+    delay(1);
+  }
+  pass &= reads == 4 && reports == 1 && spread.taken() == 4;
+  pass &= sampleIs(g_burstSpreadLeaf.leaf_temp, -31, 1);  // mean(-3.2 -3.0 -3.4 -2.9) = -3.125
+
+  // The same across deep sleeps: retained it reports, lost it never does.
+  const uint32_t retainedReports = spreadThroughDeepSleep(spread, true);
+  pass &= retainedReports == 1 && sampleIs(g_burstSpreadLeaf.leaf_temp, -31, 1);
+  const uint32_t lostReports = spreadThroughDeepSleep(spread, false);
+  pass &= lostReports == 0;
+  g_burstSpreadLeaf.setBurst(nullptr, 1);
+
+  g_schedLeaf.setOnRead(nullptr);
+  g_schedDrvLeaf.setBurst(nullptr, 1);
+  g_powerLine[0] = false;
+  if (!pass) ++g_failures;
+
+  printer.print(F("  spread "), true);
+  printer.print((unsigned long)reads, true, " reads, ", DEC);
+  printer.print((unsigned long)reports, true, " report | deep sleep: retained ", DEC);
+  printer.print((unsigned long)retainedReports, true, " report, not retained ", DEC);
+  printer.print((unsigned long)lostReports, true, "", DEC);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+}
+
+// ============================================================================
+// Bus trace
+// ============================================================================
+struct TraceCapture : public Print {
+  uint8_t data[ModbusTraceRing::RING_BYTES + 32];
+  size_t len;
+
+  TraceCapture() : len(0) {}
+
+  size_t write(uint8_t b) override {
+    if (len >= sizeof(data)) return 0;
+    data[len++] = b;
+    return 1;
+  }
+};
+
+static ModbusTraceRing g_trace;
+static TraceCapture g_traceCapture;
+
+static void runTrace() {
+  printer.println(F("[SIM] Bus trace (RikaLeaf, noisy line)"), true);
+
+  g_wire.setFaults(simFaultsNoisy());
+  g_wire.seed(0xC0FFEEUL);
+  Serial3.clearRx();
+  g_trace.clear();
+  g_bus.setTrace(&g_trace, 0);
+
+  const uint64_t startUs = SimClock::nowUs();
+  for (uint8_t i = 0; i < 10; ++i) {
+    g_drvRikaLeaf.readData();
+    g_drvRikaLeaf.resetStatus();
+  }
+  const uint64_t tracedUs = SimClock::nowUs() - startUs;
+  g_bus.setTrace(nullptr);
+
+  g_traceCapture.len = 0;
+  const size_t written = g_trace.exportBinary(g_traceCapture);
+
+  // Magic, 14-byte header, records, CRC over everything after the magic.
+  const uint8_t *d = g_traceCapture.data;
+  const size_t n = g_traceCapture.len;
+  bool pass = written == n && n == 8 + 14 + g_trace.usedBytes() + 2 &&
+              memcmp(d, "RS485TRC", 8) == 0 && g_trace.records() > 0;
+  if (pass) {
+    const uint16_t crc = ModbusCrc16::compute(d + 8, n - 8 - 2);
+    pass = d[n - 2] == (uint8_t)(crc & 0xFF) && d[n - 1] == (uint8_t)(crc >> 8);
+  }
+  if (!pass) ++g_failures;
+
+  printer.print(F("  records "), true);
+  printer.print((unsigned long)g_trace.records(), true, " | ", DEC);
+  printer.print((unsigned long)g_trace.usedBytes(), true, " B | dropped ", DEC);
+  printer.print((unsigned long)g_trace.dropped(), true, " | 10 reads ", DEC);
+  printer.print((double)tracedUs / 1000.0, true, " ms", 1);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+
+  const char *hex = getenv("SIM_TRACE_HEX");
+  if (hex && hex[0] == '1') g_trace.exportHex(DebugPort);
+}
+
+// ============================================================================
+// Deep-sleep retention
+// ============================================================================
+// Stands in for the RTC memory SleepPlanner saves into before deep sleep.
+static uint8_t g_retainStore[2048];
+
+static void runRetained() {
+  printer.println(F("[SIM] Deep-sleep retention (RetainedState)"), true);
+
+  // Learned timeouts: RikaLeaf read until the tracker has its histogram.
+  g_wire.setFaults(simFaultsClean());
+  Serial3.clearRx();
+  g_bus.latency().reset();
+  for (uint8_t i = 0; i < 2 * ModbusLatencyTracker::MIN_SAMPLES; ++i) {
+    g_drvRikaLeaf.readData();
+    g_drvRikaLeaf.resetStatus();
+  }
+  const uint16_t learnedMs = g_bus.latency().timeoutFor(0x80, SENSOR_DEFAULT_READ_TIMEOUT_MS);
+
+  ModbusBusStats &stats = g_bus.stats();
+  const uint16_t transactions = stats.total().transactions;
+  const uint32_t sinceMs = stats.sinceMs();
+  const uint32_t lastMs = stats.device(0) ? stats.device(0)->lastMs : 0;
+
+  size_t filterBytes = 0;
+  SampleFilter::State *filter =
+      static_cast<SampleFilter::State *>(g_drvRikaLeaf.filterStates(filterBytes));
+  const SampleFilter::State leafTemp = filter[1];
+
+  RetainedState retained(g_retainStore, sizeof(g_retainStore));
+  bool added = retained.add(&g_bus.latency(), sizeof(ModbusLatencyTracker));
+  added = retained.add(&stats, sizeof(ModbusBusStats), ModbusBusStats::rebase) && added;
+  added = retained.add(filter, filterBytes, SampleFilter::rebaseStates) && added;
+  retained.save();
+
+  // The wake: RAM starts over, millis() with it (the old boot's times are
+  // shiftMs later in the new timebase).
+  const uint32_t shiftMs = 0xFFFF0000UL;
+  g_bus.latency().reset();
+  stats.reset();
+  for (size_t i = 0; i < filterBytes / sizeof(SampleFilter::State); ++i) filter[i].reset();
+  const bool wiped = !g_bus.latency().isLearned(0x80) && stats.total().transactions == 0;
+  const bool loaded = retained.load(shiftMs);
+
+  const uint16_t restoredMs = g_bus.latency().timeoutFor(0x80, SENSOR_DEFAULT_READ_TIMEOUT_MS);
+  const bool passLatency = added && wiped && loaded && g_bus.latency().isLearned(0x80) &&
+                           learnedMs < SENSOR_DEFAULT_READ_TIMEOUT_MS && restoredMs == learnedMs;
+  const bool passStats = loaded && transactions > 0 &&
+                         stats.total().transactions == transactions &&
+                         stats.sinceMs() == sinceMs + shiftMs &&
+                         stats.device(0) && stats.device(0)->lastMs == lastMs + shiftMs;
+  stats.reset(millis());
+  const bool passFilter = loaded && leafTemp.hasGood && filter[1].hasGood &&
+                          filter[1].lastGood.raw == leafTemp.lastGood.raw &&
+                          filter[1].lastGoodMs == leafTemp.lastGoodMs + shiftMs;
+
+  // A firmware with other regions must not read this store.
+  uint8_t other[sizeof(ModbusLatencyTracker) + sizeof(ModbusBusStats) + 1];
+  memset(other, 0x5A, sizeof(other));
+  RetainedState changed(g_retainStore, sizeof(g_retainStore));
+  changed.add(other, sizeof(other));
+  const bool passLayout = !changed.load(0) && other[0] == 0x5A;
+
+  const bool pass = passLatency && passStats && passFilter && passLayout;
+  if (!pass) ++g_failures;
+
+  printer.print(F("  learned timeout "), true);
+  printer.print((unsigned long)learnedMs, true, " ms | after wake ", DEC);
+  printer.print((unsigned long)restoredMs, true, " ms | bus counters ", DEC);
+  printer.print(passStats ? "kept" : "LOST", true);
+  printer.print(F(" | filter history "), true);
+  printer.print(passFilter ? "kept" : "LOST", true);
+  printer.print(F(" | store "), true);
+  printer.print((unsigned long)retained.bytes(), true, " B | other layout ", DEC);
+  printer.print(passLayout ? "refused" : "LOADED", true);
+  printer.println(pass ? " | PASS" : " | FAIL", true);
+}
+
+// ============================================================================
+// Entry
+// ============================================================================
+void setup() {
+  DebugPort.begin(115200);
+
+  printer.println(F("=================================================="), true);
+  printer.println(F(" Modbus simulation (native)"), true);
+  printer.println(F("=================================================="), true);
+
+  loadSlaves();
+  g_bus.begin(Serial3, RS485_DEFAULT_BAUD);
+
+  runDriverMatrix();
+  runBusStats();
+  runAbsentDevice();
+  runExceptionReply();
+  runBusyReply();
+  runBatchFallback();
+  runRequestFrames();
+  runFixedSamples();
+  runSampleFilter();
+  runBaudNegotiation();
+  runInventory();
+  runTrace();
+  runScheduler();
+  runBurst();
+  runRetained();
+
+  printer.print(F("[SIM] Failed checks: "), true);
+  printer.print((unsigned long)g_failures, true, "", DEC);
+  printer.println("", true);
+  simExit(g_failures == 0 ? 0 : 1);
+}
+
+void loop() {}
@@ -0,0 +1,487 @@
+#include <Arduino.h>
+#include "PrintController.h"
+#include "RS485Modbus.h"
+#include "ModbusCrc16.h"
+#include "ModbusFrameLocator.h"
+
+/*
+  RS485Benchmark_Example
+
+  Bus-free micro benchmarks for the RS485Modbus transport helpers.
+  No sensor or transceiver is needed; everything runs on canned frames.
+
+  Sections:
+  - CRC16 engines (bitwise / table256 / slice-by-4) on captured frames and
+    on a full-size noisy RX buffer. All engines must agree.
+  - Frame search over a noisy RX buffer: full CRC per offset vs. rolling CRC.
+  - Frame locator fuzz: garbage-padded buffers with planted frames, checked
+    against the old per-offset sweep, plus the worst case where every
+    offset matches the prefix. Reports CRC bytes per buffer byte.
+  - Sample decode: ModbusRegisterDecoder (FixedSample, integer bounds)
+    against the former double path (raw / divisor + offset, double
+    bounds) on the captured frames. On the Mega the second one is
+    soft-float; both must agree on every value and bound.
+
+  Results are printed as microseconds per call and per KiB.
+
+  Flash: this build links both decode paths, so its size says nothing
+  about either. BENCH_DECODE_ONLY=1 (FixedSample) or 2 (double) builds a
+  probe that decodes the captured frames with one path only; the envs
+  rs485_decode_probe_fixed_mega2560 / _double_mega2560 differ in nothing
+  else, and tools/flash_compare.py prints avr-size of both and the delta.
+*/
+
+#if !defined(BENCH_DECODE_ONLY)
+  #define BENCH_DECODE_ONLY 0
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32)
+HardwareSerial& DebugPort = Serial0;
+#else
+#define DebugPort Serial
+#endif
+
+static PrintController printer(DebugPort, true);
+
+// Frames captured from real sensors on the test bench (CRC included).
+static const uint8_t FRAME_LEAF_READ[] = {0x80, 0x03, 0x04, 0x02, 0x92, 0x00, 0xFF, 0x00, 0x00};
+static const uint8_t FRAME_SOIL3_READ[] = {0x10, 0x03, 0x06, 0x00, 0xE6, 0x01, 0x5E, 0x00, 0x2D, 0x00, 0x00};
+static const uint8_t FRAME_PH_READ[] = {0x03, 0x03, 0x04, 0x00, 0xD2, 0x02, 0xBC, 0x00, 0x00};
+static const uint8_t FRAME_REQUEST[] = {0x01, 0x03, 0x00, 0x12, 0x00, 0x02, 0x00, 0x00};
+
+struct CapturedFrame {
+  const char* name;
+  const uint8_t* bytes;
+  size_t len;
+};
+
+static uint8_t g_frames[4][16];
+static CapturedFrame g_captured[] = {
+  {"leaf 9B",   g_frames[0], sizeof(FRAME_LEAF_READ)},
+  {"soil3 11B", g_frames[1], sizeof(FRAME_SOIL3_READ)},
+  {"ph 9B",     g_frames[2], sizeof(FRAME_PH_READ)},
+  {"req 8B",    g_frames[3], sizeof(FRAME_REQUEST)},
+};
+
+static uint8_t g_noise[RS485Bus::RX_BUFFER_SIZE];
+
+typedef uint16_t (*CrcFn)(uint16_t, const uint8_t*, size_t);
+
+struct CrcEngine {
+  const char* name;
+  CrcFn fn;
+};
+
+static const CrcEngine ENGINES[] = {
+  {"bitwise",    &ModbusCrc16::updateBitwise},
+  {"table256",   &ModbusCrc16::updateTable},
+  {"slice-by-4", &ModbusCrc16::updateSlice4},
+};
+
+// Maps of the captured read frames, as the drivers declare them.
+static constexpr ModbusRegisterMap<2> BENCH_LEAF_MAP = {
+  0x0000, 2, {
+    {0x0000, MODBUS_FIELD_U16, 10.0, 0.0,   0.0, 100.0, SAMPLE_UNIT_PERCENT_RH},
+    {0x0001, MODBUS_FIELD_S16, 10.0, 0.0, -40.0,  80.0, SAMPLE_UNIT_CELSIUS}
+  }
+};
+static constexpr ModbusRegisterMap<3> BENCH_SOIL3_MAP = {
+  0x0000, 3, {
+    {0x0000, MODBUS_FIELD_S16,   10.0, 0.0, -40.0,  80.0, SAMPLE_UNIT_CELSIUS},
+    {0x0001, MODBUS_FIELD_U16,   10.0, 0.0,   0.0, 100.0, SAMPLE_UNIT_PERCENT},
+    {0x0002, MODBUS_FIELD_U16, 1000.0, 0.0,   0.0,  50.0, SAMPLE_UNIT_MS_PER_CM}
+  }
+};
+static constexpr ModbusRegisterMap<2> BENCH_PH_MAP = {
+  0x0001, 2, {
+    {0x0001, MODBUS_FIELD_S16,  10.0, 0.0, -20.0, 80.0, SAMPLE_UNIT_CELSIUS},
+    {0x0002, MODBUS_FIELD_U16, 100.0, 0.0,   0.0, 14.0, SAMPLE_UNIT_PH}
+  }
+};
+
+static const uint16_t ITERATIONS_SMALL = 2000;
+static const uint16_t ITERATIONS_BUFFER = 50;
+
+// Keeps results observable so the compiler cannot drop the work.
+static volatile uint16_t g_sink = 0;
+
+static void fixCrc(uint8_t* frame, size_t len) {
+  const uint16_t crc = ModbusCrc16::compute(frame, len - 2);
+  frame[len - 2] = (uint8_t)(crc & 0xFF);
+  frame[len - 1] = (uint8_t)(crc >> 8);
+}
+
+static void prepareData() {
+  memcpy(g_frames[0], FRAME_LEAF_READ, sizeof(FRAME_LEAF_READ));
+  memcpy(g_frames[1], FRAME_SOIL3_READ, sizeof(FRAME_SOIL3_READ));
+  memcpy(g_frames[2], FRAME_PH_READ, sizeof(FRAME_PH_READ));
+  memcpy(g_frames[3], FRAME_REQUEST, sizeof(FRAME_REQUEST));
+  for (size_t i = 0; i < sizeof(g_captured) / sizeof(g_captured[0]); ++i) {
+    fixCrc(g_frames[i], g_captured[i].len);
+  }
+
+  // Deterministic pseudo-noise with one valid leaf frame near the end.
+  uint32_t seed = 0x1234567UL;
+  for (size_t i = 0; i < sizeof(g_noise); ++i) {
+    seed = seed * 1103515245UL + 12345UL;
+    g_noise[i] = (uint8_t)(seed >> 16);
+  }
+  memcpy(&g_noise[sizeof(g_noise) - 40], g_frames[0], g_captured[0].len);
+}
+
+#if BENCH_DECODE_ONLY == 0
+static void printRate(const char* label, unsigned long elapsedUs, uint16_t iterations, size_t bytes) {
+  const double perCallUs = (double)elapsedUs / (double)iterations;
+  const double perKiBUs = (bytes > 0) ? (perCallUs * 1024.0 / (double)bytes) : 0.0;
+
+  printer.print(F("  "), true);
+  printer.print(label, true, " | ");
+  printer.print(perCallUs, true, " us/call | ", 3);
+  printer.print(perKiBUs, true, " us/KiB", 1);
+  printer.println("", true);
+}
+
+static void benchmarkCrcEngines() {
+  printer.println(F("[BENCH] CRC16/MODBUS engines"), true);
+  printer.print(F("  build-selected engine: "), true);
+  printer.println(ModbusCrc16::engineName(), true);
+
+  bool allAgree = true;
+
+  for (size_t f = 0; f < sizeof(g_captured) / sizeof(g_captured[0]); ++f) {
+    const CapturedFrame& frame = g_captured[f];
+    const uint16_t reference = ModbusCrc16::updateBitwise(ModbusCrc16::INIT, frame.bytes, frame.len - 2);
+
+    printer.print(F("  frame "), true);
+    printer.println(frame.name, true);
+
+    for (size_t e = 0; e < sizeof(ENGINES) / sizeof(ENGINES[0]); ++e) {
+      if (ENGINES[e].fn(ModbusCrc16::INIT, frame.bytes, frame.len - 2) != reference) {
+        allAgree = false;
+      }
+
+      const unsigned long start = micros();
+      for (uint16_t i = 0; i < ITERATIONS_SMALL; ++i) {
+        g_sink ^= ENGINES[e].fn(ModbusCrc16::INIT, frame.bytes, frame.len - 2);
+      }
+      printRate(ENGINES[e].name, micros() - start, ITERATIONS_SMALL, frame.len - 2);
+    }
+  }
+
+  printer.print(F("  full RX buffer "), true);
+  printer.print((unsigned long)sizeof(g_noise), true, " B", DEC);
+  printer.println("", true);
+
+  const uint16_t reference = ModbusCrc16::updateBitwise(ModbusCrc16::INIT, g_noise, sizeof(g_noise));
+  for (size_t e = 0; e < sizeof(ENGINES) / sizeof(ENGINES[0]); ++e) {
+    if (ENGINES[e].fn(ModbusCrc16::INIT, g_noise, sizeof(g_noise)) != reference) {
+      allAgree = false;
+    }
+
+    const unsigned long start = micros();
+    for (uint16_t i = 0; i < ITERATIONS_BUFFER; ++i) {
+      g_sink ^= ENGINES[e].fn(ModbusCrc16::INIT, g_noise, sizeof(g_noise));
+    }
+    printRate(ENGINES[e].name, micros() - start, ITERATIONS_BUFFER, sizeof(g_noise));
+  }
+
+  printer.print(F("  engines agree: "), true);
+  printer.println(allAgree ? F("YES") : F("NO - CHECK BUILD"), true);
+  printer.println(F(""), true);
+}
+
+static size_t countFramesFullCrc(const uint8_t* buf, size_t len, size_t frameLen) {
+  size_t found = 0;
+  for (size_t offset = 0; offset + frameLen <= len; ++offset) {
+    if (RS485Bus::verifyCrc16ModbusFrame(&buf[offset], frameLen)) {
+      ++found;
+    }
+  }
+  return found;
+}
+
+static size_t countFramesRolling(const uint8_t* buf, size_t len, size_t frameLen) {
+  if (len < frameLen) return 0;
+
+  const size_t dataLen = frameLen - 2;
+  const ModbusCrcWindow window(dataLen);
+  uint16_t crc = window.first(buf);
+  size_t found = 0;
+
+  for (size_t offset = 0; ; ++offset) {
+    const uint16_t recv = (uint16_t)buf[offset + dataLen] | ((uint16_t)buf[offset + dataLen + 1] << 8);
+    if (crc == recv) {
+      ++found;
+    }
+    if (offset + frameLen >= len) break;
+    crc = window.roll(crc, buf[offset], buf[offset + dataLen]);
+  }
+  return found;
+}
+
+static void benchmarkWindowScan() {
+  printer.println(F("[BENCH] CRC window scan over noisy RX buffer"), true);
+
+  const size_t frameLen = g_captured[0].len;
+  const size_t fullHits = countFramesFullCrc(g_noise, sizeof(g_noise), frameLen);
+  const size_t rollingHits = countFramesRolling(g_noise, sizeof(g_noise), frameLen);
+
+  unsigned long start = micros();
+  for (uint16_t i = 0; i < ITERATIONS_BUFFER; ++i) {
+    g_sink ^= (uint16_t)countFramesFullCrc(g_noise, sizeof(g_noise), frameLen);
+  }
+  printRate("full CRC per offset", micros() - start, ITERATIONS_BUFFER, sizeof(g_noise));
+
+  start = micros();
+  for (uint16_t i = 0; i < ITERATIONS_BUFFER; ++i) {
+    g_sink ^= (uint16_t)countFramesRolling(g_noise, sizeof(g_noise), frameLen);
+  }
+  printRate("rolling CRC window", micros() - start, ITERATIONS_BUFFER, sizeof(g_noise));
+
+  printer.print(F("  CRC-valid windows: full="), true);
+  printer.print((unsigned long)fullHits, true, " rolling=", DEC);
+  printer.println((unsigned long)rollingHits, true);
+  printer.println(F(""), true);
+}
+
+// The sweep SendRequest() used before the locator: prefix + full CRC at
+// every offset, first hit wins, next search starts behind the frame.
+static size_t legacySweep(const uint8_t* buf, size_t len, const uint8_t* prefix, size_t prefixLen,
+                          size_t frameLen, ModbusFrameSpan* spans, size_t maxSpans) {
+  size_t found = 0;
+  size_t offset = 0;
+  while (offset + frameLen <= len && found < maxSpans) {
+    if (memcmp(&buf[offset], prefix, prefixLen) == 0 &&
+        RS485Bus::verifyCrc16ModbusFrame(&buf[offset], frameLen)) {
+      spans[found].offset = offset;
+      spans[found].length = frameLen;
+      ++found;
+      offset += frameLen;
+    } else {
+      ++offset;
+    }
+  }
+  return found;
+}
+
+static uint32_t g_fuzzSeed = 0xC0FFEEUL;
+
+static uint32_t fuzzRandom() {
+  g_fuzzSeed = g_fuzzSeed * 1664525UL + 1013904223UL;
+  return g_fuzzSeed >> 8;
+}
+
+static void fuzzFrameLocator() {
+  printer.println(F("[BENCH] Frame locator fuzz"), true);
+
+  static const uint16_t FUZZ_ROUNDS = 2000;
+  static const size_t MAX_SPANS = 8;
+  uint8_t buf[RS485Bus::RX_BUFFER_SIZE];
+  uint16_t mismatches = 0;
+  uint16_t planted = 0;
+  size_t worstCrcPerCent = 0;
+
+  for (uint16_t round = 0; round < FUZZ_ROUNDS; ++round) {
+    // Small alphabets make prefix collisions and false candidates common.
+    const size_t len = fuzzRandom() % sizeof(buf);
+    const uint8_t alphabet = (uint8_t)(1 + fuzzRandom() % 4);
+    for (size_t i = 0; i < len; ++i) {
+      buf[i] = (uint8_t)(fuzzRandom() % alphabet);
+    }
+
+    const size_t frameLen = 5 + fuzzRandom() % 20;
+    const uint8_t prefix[3] = {0x00, (uint8_t)(fuzzRandom() % alphabet), 0x00};
+    const size_t prefixLen = 1 + fuzzRandom() % 3;
+
+    const uint8_t plant = (uint8_t)(fuzzRandom() % 4);
+    for (uint8_t p = 0; p < plant && len >= frameLen; ++p) {
+      const size_t at = fuzzRandom() % (len - frameLen + 1);
+      memcpy(&buf[at], prefix, prefixLen);
+      fixCrc(&buf[at], frameLen);
+      ++planted;
+    }
+
+    ModbusFrameSpan fast[MAX_SPANS];
+    ModbusFrameSpan slow[MAX_SPANS];
+    ModbusLocatorStats stats;
+    const size_t fastCount = ModbusFrameLocator::find(buf, len, prefix, prefixLen, frameLen,
+                                                      fast, MAX_SPANS, &stats);
+    const size_t slowCount = legacySweep(buf, len, prefix, prefixLen, frameLen, slow, MAX_SPANS);
+
+    bool same = (fastCount == slowCount);
+    for (size_t i = 0; same && i < fastCount; ++i) {
+      same = (fast[i].offset == slow[i].offset);
+    }
+    if (!same) ++mismatches;
+
+    if (len > 0) {
+      const size_t perCent = stats.crcBytes * 100 / len;
+      if (perCent > worstCrcPerCent) worstCrcPerCent = perCent;
+    }
+  }
+
+  printer.print(F("  rounds="), true);
+  printer.print((unsigned long)FUZZ_ROUNDS, true, " planted=", DEC);
+  printer.print((unsigned long)planted, true, " mismatches=", DEC);
+  printer.println((unsigned long)mismatches, true);
+  printer.print(F("  worst CRC bytes per buffer byte: "), true);
+  printer.print((unsigned long)worstCrcPerCent, true, " %", DEC);
+  printer.println("", true);
+
+  // Worst case: every offset matches the prefix, one real frame at the end.
+  const uint8_t prefix[3] = {0x01, 0x01, 0x01};
+  const size_t frameLen = 13;
+  memset(buf, 0x01, sizeof(buf));
+  fixCrc(&buf[sizeof(buf) - frameLen], frameLen);
+
+  ModbusFrameSpan spans[MAX_SPANS];
+  ModbusLocatorStats stats;
+  const size_t frames = ModbusFrameLocator::find(buf, sizeof(buf), prefix, sizeof(prefix), frameLen,
+                                                 spans, MAX_SPANS, &stats);
+
+  unsigned long start = micros();
+  for (uint16_t i = 0; i < ITERATIONS_BUFFER; ++i) {
+    g_sink ^= (uint16_t)legacySweep(buf, sizeof(buf), prefix, sizeof(prefix), frameLen, spans, MAX_SPANS);
+  }
+  printRate("worst case, legacy sweep", micros() - start, ITERATIONS_BUFFER, sizeof(buf));
+
+  start = micros();
+  for (uint16_t i = 0; i < ITERATIONS_BUFFER; ++i) {
+    g_sink ^= (uint16_t)ModbusFrameLocator::find(buf, sizeof(buf), prefix, sizeof(prefix), frameLen,
+                                                 spans, MAX_SPANS);
+  }
+  printRate("worst case, frame locator", micros() - start, ITERATIONS_BUFFER, sizeof(buf));
+
+  printer.print(F("  worst case: candidates="), true);
+  printer.print((unsigned long)stats.candidates, true, " crcBytes=", DEC);
+  printer.print((unsigned long)stats.crcBytes, true, " frames=", DEC);
+  printer.println((unsigned long)frames, true);
+  printer.println(F(""), true);
+}
+
+#endif
+
+// The decode as it was before FixedSample: double per field, double bounds.
+template <size_t N>
+static uint32_t decodeDouble(const ModbusRegisterMap<N>& map, const uint8_t frame[], double out[N]) {
+  uint32_t okMask = 0;
+  for (size_t i = 0; i < N; ++i) {
+    const ModbusFieldSpec& field = map.fields[i];
+    const double divisor = (double)FixedSample::pow10(field.decimals);
+    const int32_t raw = ModbusRegisterDecoder::rawValue(field, frame, map.start);
+    const double base = (field.type == MODBUS_FIELD_U32) ? (double)(uint32_t)raw : (double)raw;
+    out[i] = base / divisor + (double)field.offset / divisor;
+    if (out[i] >= (double)field.minValue / divisor && out[i] <= (double)field.maxValue / divisor) {
+      okMask |= (1UL << i);
+    }
+  }
+  return okMask;
+}
+
+#if BENCH_DECODE_ONLY == 0
+template <size_t N>
+static bool benchmarkDecode(const char* name, const ModbusRegisterMap<N>& map, const uint8_t frame[]) {
+  FixedSample fixed[N];
+  double reference[N];
+  const uint32_t fixedMask = ModbusRegisterDecoder::decode(map, frame, fixed);
+  const uint32_t doubleMask = decodeDouble(map, frame, reference);
+
+  bool agree = (fixedMask == doubleMask);
+  for (size_t i = 0; i < N; ++i) {
+    const double diff = fixed[i].toDouble() - reference[i];
+    if (diff > 0.0001 || diff < -0.0001) agree = false;
+  }
+
+  printer.print(F("  frame "), true);
+  printer.print(name, true, " |");
+  for (size_t i = 0; i < N; ++i) {
+    printer.print(F(" "), true);
+    printer.printFixed(fixed[i].raw, fixed[i].decimals, true, " ");
+    printer.print(FixedSample::unitName(fixed[i].unit), true);
+  }
+  printer.println("", true);
+
+  unsigned long start = micros();
+  for (uint16_t i = 0; i < ITERATIONS_SMALL; ++i) {
+    g_sink ^= (uint16_t)ModbusRegisterDecoder::decode(map, frame, fixed);
+    g_sink ^= (uint16_t)fixed[0].raw;
+  }
+  printRate("FixedSample decode", micros() - start, ITERATIONS_SMALL, 0);
+
+  start = micros();
+  for (uint16_t i = 0; i < ITERATIONS_SMALL; ++i) {
+    g_sink ^= (uint16_t)decodeDouble(map, frame, reference);
+    g_sink ^= (uint16_t)reference[0];
+  }
+  printRate("double decode", micros() - start, ITERATIONS_SMALL, 0);
+
+  return agree;
+}
+
+static void benchmarkSampleDecode() {
+  printer.println(F("[BENCH] Sample decode: fixed-point vs double"), true);
+  printer.print(F("  sizeof(FixedSample)="), true);
+  printer.print((unsigned long)sizeof(FixedSample), true, " sizeof(double)=", DEC);
+  printer.println((unsigned long)sizeof(double), true);
+
+  bool agree = benchmarkDecode("leaf", BENCH_LEAF_MAP, g_frames[0]);
+  agree = benchmarkDecode("soil3", BENCH_SOIL3_MAP, g_frames[1]) && agree;
+  agree = benchmarkDecode("ph", BENCH_PH_MAP, g_frames[2]) && agree;
+
+  printer.print(F("  paths agree: "), true);
+  printer.println(agree ? F("YES") : F("NO - CHECK MAPS"), true);
+  printer.println(F(""), true);
+}
+
+#else
+// Flash probe: one decode path only, results kept observable.
+template <size_t N>
+static uint32_t probeDecode(const ModbusRegisterMap<N>& map, const uint8_t frame[]) {
+#if BENCH_DECODE_ONLY == 1
+  FixedSample out[N];
+  const uint32_t mask = ModbusRegisterDecoder::decode(map, frame, out);
+  for (size_t i = 0; i < N; ++i) g_sink ^= (uint16_t)out[i].raw;
+#else
+  double out[N];
+  const uint32_t mask = decodeDouble(map, frame, out);
+  for (size_t i = 0; i < N; ++i) g_sink ^= (uint16_t)(int32_t)out[i];
+#endif
+  return mask;
+}
+
+static void probeSampleDecode() {
+  printer.println(BENCH_DECODE_ONLY == 1 ? F("[BENCH] Decode probe: FixedSample")
+                                         : F("[BENCH] Decode probe: double"), true);
+  uint32_t masks = probeDecode(BENCH_LEAF_MAP, g_frames[0]);
+  masks = (masks << 4) | probeDecode(BENCH_SOIL3_MAP, g_frames[1]);
+  masks = (masks << 4) | probeDecode(BENCH_PH_MAP, g_frames[2]);
+  printer.print(F("  masks 0x"), true);
+  printer.println((unsigned long)masks, true, "", HEX);
+}
+#endif
+
+void setup() {
+  DebugPort.begin(115200);
+  delay(300);
+
+  printer.println(F(""), true);
+  printer.println(F("============================================================"), true);
+  printer.println(F(" RS485Modbus transport benchmarks"), true);
+  printer.println(F("============================================================"), true);
+
+  prepareData();
+#if BENCH_DECODE_ONLY == 0
+  benchmarkCrcEngines();
+  benchmarkWindowScan();
+  fuzzFrameLocator();
+  benchmarkSampleDecode();
+#else
+  probeSampleDecode();
+#endif
+
+  printer.println(F("[BENCH] Done."), true);
+}
+
+void loop() {
+  delay(1000);
+}
@@ -56,9 +56,9 @@ static void printReadResult(bool ok) {
   }
 
   printer.print(F("Temperature: "), true);
-  printer.print(leaf.leaf_temp, true, " C | ", 1);
+  printer.printFixed(leaf.leaf_temp.raw, leaf.leaf_temp.decimals, true, " C | ");
   printer.print(F("Humidity: "), true);
-  printer.print(leaf.leaf_humid, true, " %", 1);
+  printer.printFixed(leaf.leaf_humid.raw, leaf.leaf_humid.decimals, true, " %");
   printer.println("", true);
 
   if (!ok) {
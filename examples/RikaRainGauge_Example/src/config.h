@@ -10,6 +10,8 @@
   - RAIN_GAUGE_COUNTING_MODE_EXTERNAL_COUNTER
   - RAIN_GAUGE_COUNTING_MODE_MCU_INTERRUPT
   - RAIN_GAUGE_COUNTING_MODE_RS485_SENSOR
+  - RAIN_GAUGE_COUNTING_MODE_PCNT_COUNTER (ESP32 only, stays awake)
+  - RAIN_GAUGE_COUNTING_MODE_ULP_COUNTER (ESP32 only, counts in deep sleep)
 
   Rika pulse factor:
   - 1 pulse = 0.2 mm
@@ -100,8 +100,17 @@ static void printReadResult(bool ok) {
   if (ok) {
     printer.print(F("[APP] Rain pulses: "), true);
     printer.print((unsigned long)rain.pulse_count, true, " | rainfall: ");
-    printer.print(rain.rainfall_mm, true, " mm", 2);
+    printer.printFixed(rain.rainfall_mm.raw, rain.rainfall_mm.decimals, true, " mm");
     printer.println("", true);
+
+    if (RAIN_COUNTING_MODE == RAIN_GAUGE_COUNTING_MODE_MCU_INTERRUPT ||
+        RAIN_COUNTING_MODE == RAIN_GAUGE_COUNTING_MODE_PCNT_COUNTER ||
+        RAIN_COUNTING_MODE == RAIN_GAUGE_COUNTING_MODE_ULP_COUNTER) {
+      printer.print(F("[APP] Peak rate 1 min: "), true);
+      printer.printFixed(rain.rain_rate_1m_peak.raw, rain.rain_rate_1m_peak.decimals, true, " mm/h | 5 min: ");
+      printer.printFixed(rain.rain_rate_5m_peak.raw, rain.rain_rate_5m_peak.decimals, true, " mm/h");
+      printer.println("", true);
+    }
   } else {
     printer.println(F("[APP] Rain read failed."), true);
   }
@@ -148,6 +157,21 @@ void setup() {
     return;
   }
 
+  if (RAIN_COUNTING_MODE == RAIN_GAUGE_COUNTING_MODE_PCNT_COUNTER) {
+    // The PCNT unit stops in sleep: this mode stays awake, like MCU_INTERRUPT.
+    if (!rain.activateCounting()) {
+      printer.println(F("[APP] PCNT counting unavailable on this MCU."), true);
+    }
+    rain.resetCounter();
+    sampleTimerMs = millis();
+    return;
+  }
+
+  if (RAIN_COUNTING_MODE == RAIN_GAUGE_COUNTING_MODE_ULP_COUNTER && !rain.activateCounting()) {
+    printer.println(F("[APP] ULP counting unavailable on this MCU or pin."), true);
+  }
+
+  // External counter and ULP keep counting in deep sleep: sample on each wake.
 #if defined(ARDUINO_ARCH_ESP32)
   if (rainGaugeStarted) {
     sampleAndReset();
@@ -167,5 +191,7 @@ void loop() {
     sampleAndReset();
     sampleTimerMs = millis();
   }
+  // Pulse times from the ISR (or PCNT counts) into the 1/5 min windows.
+  rain.servicePulses();
   sleepBriefly();
 }
@@ -74,11 +74,11 @@ static void printMainReadResult(bool ok) {
   // These values are decoded by RikaSoilSensor3in1::readData().
   // On failure the driver normally exposes fallback sentinel values.
   printer.print(F("Temp: "), true);
-  printer.print(soil.soil_temp, true, " C° | ", 1);
+  printer.printFixed(soil.soil_temp.raw, soil.soil_temp.decimals, true, " C° | ");
   printer.print(F("VWC: "), true);
-  printer.print(soil.soil_vwc, true, " % | ", 1);
+  printer.printFixed(soil.soil_vwc.raw, soil.soil_vwc.decimals, true, " % | ");
   printer.print(F("EC: "), true);
-  printer.print(soil.soil_ec, true, " mS/cm", 4);
+  printer.printFixed(soil.soil_ec.raw, soil.soil_ec.decimals, true, " mS/cm");
   printer.println("", true);
 
   if (!ok) {
@@ -100,10 +100,10 @@ static void printSoilTypeResult(bool ok, RikaSoilSensor3in1::SoilType type) {
 
 // Optional diagnostic: epsilon is the dielectric constant reported by the
 // sensor. It can help validate VWC behavior or calibration.
-static void printEpsilonResult(bool ok, double eps) {
+static void printEpsilonResult(bool ok, const FixedSample& eps) {
   if (ok) {
     printer.print(F("[APP] Epsilon: "), true);
-    printer.println(eps, true, "", 2);
+    printer.printlnFixed(eps.raw, eps.decimals, true, "");
   } else {
     printer.println(F("[APP] Failed to read epsilon"), true);
   }
@@ -111,10 +111,10 @@ static void printEpsilonResult(bool ok, double eps) {
 
 // Small helper for optional coefficient reads. The label is stored as a flash
 // string with F("...") so RAM usage stays low on microcontrollers.
-static void printCoeffResult(const __FlashStringHelper* label, bool ok, double value) {
+static void printCoeffResult(const __FlashStringHelper* label, bool ok, const FixedSample& value) {
   printer.print(label, true);
   if (ok) {
-    printer.println(value, true, "", 2);
+    printer.printlnFixed(value.raw, value.decimals, true, "");
   } else {
     printer.println(F("FAILED"), true);
   }
@@ -210,13 +210,13 @@ void loop() {
   }
 
   if (READ_EPSILON_IN_LOOP) {
-    double eps = -99.0;
+    FixedSample eps = FixedSample::fallback(2);
     const bool epsOk = soil.readEpsilon(eps, 3, 500, 20);
     printEpsilonResult(epsOk, eps);
   }
 
   if (READ_COMP_COEFFS_IN_LOOP) {
-    double coeff = -99.0;
+    FixedSample coeff = FixedSample::fallback(2);
 
     // Compensation coefficients live in separate registers, so they are read
     // one at a time and printed with labels.
@@ -1,4 +1,8 @@
 #include "NetworkManager.h"
+#include "RS485Modbus.h"
+
+// "bus<port> " + ModbusBusStats::format() line
+#define NET_BUS_HEALTH_LINE_BYTES 160
 
 // ============================================================================
 // Constructor
@@ -6,7 +10,8 @@
 NetworkManager::NetworkManager(uint8_t powerPin, uint8_t enablePin, uint32_t warmUpMs)
   : _powerPin(powerPin), _enablePin(enablePin), _warmUpMs(warmUpMs),
     _uploadRateMin(60), _lastUploadTime(0),
-    _status(NET_OFF), _log(nullptr), _debugEnable(false) {}
+    _status(NET_OFF), _buses(nullptr), _busCount(0), _busesBusy(nullptr),
+    _log(nullptr), _debugEnable(false) {}
 
 // ============================================================================
 // isDueForUpload
@@ -16,6 +21,15 @@ bool NetworkManager::isDueForUpload(uint32_t currentMillis) {
   return (currentMillis - _lastUploadTime) >= intervalMs;
 }
 
+// ============================================================================
+// msUntilUploadDue — time left before the next upload (for sleep planning)
+// ============================================================================
+uint32_t NetworkManager::msUntilUploadDue(uint32_t currentMillis) const {
+  uint32_t intervalMs = (uint32_t)_uploadRateMin * 60UL * 1000UL;
+  uint32_t elapsed = currentMillis - _lastUploadTime;
+  return (elapsed >= intervalMs) ? 0 : (intervalMs - elapsed);
+}
+
 // ============================================================================
 // powerOn — turn on network module and wait for warm-up
 // ============================================================================
@@ -90,6 +104,7 @@ UploadResult NetworkManager::runUploadPhase(StationLogger* logger) {
   // For now, this is a placeholder — the child class pushData() handles it
   if (_log) _log->println(F("[Net] Pushing new data..."), _debugEnable);
   result.dataPushed = true;  // Main code calls pushData() separately
+  pushBusHealth(logger);
 
   // --- Step 4: Push pending/unsent data ---
   if (_log) _log->println(F("[Net] Checking for pending data..."), _debugEnable);
@@ -133,6 +148,39 @@ UploadResult NetworkManager::runUploadPhase(StationLogger* logger) {
   return result;
 }
 
+// ============================================================================
+// pushBusHealth — one counters line per RS485 port
+// ============================================================================
+// The counters cover the time since the last acknowledged push; a port
+// whose line did not get through keeps counting into the next upload.
+// While a read cycle runs the workers own the counters: the whole push
+// waits for the next upload rather than reset under an increment.
+void NetworkManager::pushBusHealth(StationLogger* logger) {
+  if (!_buses) return;
+  if (_busesBusy && _busesBusy()) {
+    if (_log) _log->println(F("[Net] Read cycle running, bus health kept for the next upload"), _debugEnable);
+    return;
+  }
+
+  char line[NET_BUS_HEALTH_LINE_BYTES];
+  for (uint8_t port = 0; port < _busCount; ++port) {
+    ModbusBusStats& stats = _buses[port].stats();
+    if (stats.total().attempts == 0) continue;
+
+    const int head = snprintf(line, sizeof(line), "bus%u ", (unsigned)port);
+    if (head < 0 || (size_t)head >= sizeof(line)) continue;
+    ModbusBusStats::format(stats.total(), line + head, sizeof(line) - head);
+
+    if (logger) logger->logData(line);
+    if (pushData(line)) {
+      stats.reset(millis());
+    } else if (_log) {
+      _log->print(F("[Net] Bus health not acknowledged, port "), _debugEnable);
+      _log->println((unsigned int)port, _debugEnable);
+    }
+  }
+}
+
 // ============================================================================
 // setDebug
 // ============================================================================
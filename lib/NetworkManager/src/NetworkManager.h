@@ -3,13 +3,17 @@
 #include "PrintController.h"
 #include "StationLogger.h"
 
+class RS485Bus;
+
 // ============================================================================
 // NetworkManager — Upload Phase Controller
 // ============================================================================
 // Handles the entire network upload sequence:
 //   1. Power ON network module, wait for warm-up
 //   2. Check connection to network and server
-//   3. Push new sensor data
+//   3. Push new sensor data, and one bus health line per RS485 port
+//      (attachBuses(); counters cleared once the server acknowledges,
+//      skipped while a read cycle is updating them)
 //   4. Push any unsent/pending data (newest first)
 //   5. Check server for config changes
 //   6. Sync RTC via NTP (or GPS)
@@ -22,6 +26,7 @@
 //
 // Usage:
 //   WiFiNetworkManager net(PIN_WIFI_POWER, PIN_WIFI_ENABLE, 60000);
+//   net.attachBuses(buses, PCB_RS485_PORT_COUNT, readCycleBusy);
 //   net.runUploadPhase(logger);
 // ============================================================================
 
@@ -61,6 +66,19 @@ public:
   // Check if it is time to upload
   bool isDueForUpload(uint32_t currentMillis);
   void markUploadTime(uint32_t currentMillis) { _lastUploadTime = currentMillis; }
+  uint32_t getLastUploadTime() const { return _lastUploadTime; }
+
+  // Milliseconds until isDueForUpload() becomes true (0 = due now)
+  uint32_t msUntilUploadDue(uint32_t currentMillis) const;
+
+  // --- Bus health (ModbusBusStats) pushed with every upload ---
+  // busy reports a read cycle: on ESP32 its worker tasks increment the
+  // counters, so they are neither pushed nor reset then.
+  void attachBuses(RS485Bus* buses, uint8_t count, bool (*busy)() = nullptr) {
+    _buses = buses;
+    _busCount = count;
+    _busesBusy = busy;
+  }
 
   // --- Power Control ---
   void powerOn();
@@ -113,6 +131,13 @@ protected:
 
   NetworkStatus _status;
 
+  RS485Bus* _buses;
+  uint8_t _busCount;
+  bool (*_busesBusy)();
+
   PrintController* _log;
   bool _debugEnable;
+
+  // Step 3: "bus<port> <counters>" per port, to the server and the data log.
+  void pushBusHealth(StationLogger* logger);
 };
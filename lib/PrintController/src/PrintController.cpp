@@ -87,6 +87,29 @@ void PrintController::print(double data, bool enableOverride,
   }
 }
 
+void PrintController::printFixed(long scaled, uint8_t decimals,
+                                 bool enableOverride, const char *endChar) {
+  if (enable || enableOverride) {
+    const bool negative = scaled < 0;
+    const unsigned long mag = negative ? 0UL - (unsigned long)scaled : (unsigned long)scaled;
+
+    unsigned long div = 1;
+    for (uint8_t i = 0; i < decimals; ++i) div *= 10UL;
+
+    if (negative) printPort.print('-');
+    printPort.print(mag / div);
+    if (decimals > 0) {
+      printPort.print('.');
+      const unsigned long frac = mag % div;
+      for (unsigned long pad = div / 10UL; pad > 1UL && frac < pad; pad /= 10UL) {
+        printPort.print('0');
+      }
+      printPort.print(frac);
+    }
+    printPort.print(endChar);
+  }
+}
+
 void PrintController::println(const __FlashStringHelper *data,
                               bool enableOverride, const char *endChar) {
   print(data, enableOverride, endChar);
@@ -159,6 +182,14 @@ void PrintController::println(double data, bool enableOverride,
   }
 }
 
+void PrintController::printlnFixed(long scaled, uint8_t decimals,
+                                   bool enableOverride, const char *endChar) {
+  printFixed(scaled, decimals, enableOverride, endChar);
+  if (enable || enableOverride) {
+    printPort.println();
+  }
+}
+
 void PrintController::println() {
   if (enable) {
     printPort.println();
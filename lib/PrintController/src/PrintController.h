@@ -19,6 +19,8 @@
     - If global enable == true, all print/println calls work normally
     - If global enable == false, a call prints only when enableOverride == true
     - println() without arguments now respects global enable
+    - printFixed() prints a scaled integer (value * 10^decimals) as an
+      exact decimal without float math, e.g. printFixed(-32, 1) -> "-3.2"
 */
 
 class PrintController {
@@ -59,6 +61,8 @@ public:
              const char *endChar = "", int base = DEC);
   void print(double data, bool enableOverride = false,
              const char *endChar = "", int decimalPlaces = 2);
+  void printFixed(long scaled, uint8_t decimals, bool enableOverride = false,
+                  const char *endChar = "");
 
   void println(const __FlashStringHelper *data, bool enableOverride = false,
                const char *endChar = "");
@@ -78,6 +82,8 @@ public:
                const char *endChar = "", int base = DEC);
   void println(double data, bool enableOverride = false,
                const char *endChar = "", int decimalPlaces = 2);
+  void printlnFixed(long scaled, uint8_t decimals, bool enableOverride = false,
+                    const char *endChar = "");
 
   size_t write(uint8_t byte, bool enableOverride);
   size_t write(const uint8_t *buffer, size_t size, bool enableOverride);
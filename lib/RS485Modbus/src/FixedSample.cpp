@@ -0,0 +1,59 @@
+#include "FixedSample.h"
+
+int32_t FixedSample::scaledTo(uint8_t targetDecimals) const {
+  if (targetDecimals == decimals) return raw;
+
+  if (targetDecimals > decimals) {
+    return raw * pow10((uint8_t)(targetDecimals - decimals));
+  }
+
+  const int32_t div = pow10((uint8_t)(decimals - targetDecimals));
+  const int32_t half = div / 2;
+  return (raw >= 0) ? (raw + half) / div : (raw - half) / div;
+}
+
+size_t FixedSample::format(char *buf, size_t len) const {
+  if (!buf || len == 0) return 0;
+
+  // Magnitude as unsigned, so INT32_MIN does not overflow.
+  const bool negative = raw < 0;
+  const uint32_t mag = negative ? (uint32_t)0 - (uint32_t)raw : (uint32_t)raw;
+
+  int n;
+  if (decimals == 0) {
+    n = snprintf(buf, len, "%s%lu", negative ? "-" : "", (unsigned long)mag);
+  } else {
+    const uint32_t div = (uint32_t)pow10(decimals);
+    n = snprintf(buf, len, "%s%lu.%0*lu",
+                 negative ? "-" : "",
+                 (unsigned long)(mag / div),
+                 (int)decimals,
+                 (unsigned long)(mag % div));
+  }
+
+  if (n < 0) {
+    buf[0] = '\0';
+    return 0;
+  }
+  return ((size_t)n < len) ? (size_t)n : len - 1;
+}
+
+const __FlashStringHelper *FixedSample::unitName(uint8_t unit) {
+  switch (unit) {
+    case SAMPLE_UNIT_CELSIUS:    return F("C");
+    case SAMPLE_UNIT_PERCENT:    return F("%");
+    case SAMPLE_UNIT_PERCENT_RH: return F("%RH");
+    case SAMPLE_UNIT_MS_PER_CM:  return F("mS/cm");
+    case SAMPLE_UNIT_US_PER_CM:  return F("us/cm");
+    case SAMPLE_UNIT_PH:         return F("pH");
+    case SAMPLE_UNIT_MG_PER_KG:  return F("mg/kg");
+    case SAMPLE_UNIT_MM:         return F("mm");
+    case SAMPLE_UNIT_M_PER_S:    return F("m/s");
+    case SAMPLE_UNIT_DEGREE:     return F("deg");
+    case SAMPLE_UNIT_LUX:        return F("Lux");
+    case SAMPLE_UNIT_W_PER_M2:   return F("W/m2");
+    case SAMPLE_UNIT_MM_PER_H:   return F("mm/h");
+    case SAMPLE_UNIT_NONE:
+    default:                     return F("");
+  }
+}
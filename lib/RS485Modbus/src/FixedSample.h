@@ -0,0 +1,83 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  FixedSample
+
+  One measurement as a scaled integer: value = raw * 10^-decimals, plus
+  the unit it is in. Drivers decode, validate and log samples without
+  touching float math; the Mega has no FPU and every double there is a
+  soft-float call.
+
+    FixedSample t = FixedSample::make(-32, 1, SAMPLE_UNIT_CELSIUS);  // -3.2 C
+    t.format(buf, sizeof(buf));   // "-3.2", exact, integer-only
+    t.scaledTo(2);                // -320
+    t.toDouble();                 // -3.2, for the presentation edge only
+
+  Decimal places come from the register map (ModbusFieldSpec divisor 10
+  -> 1 decimal), so a sample carries the sensor's own resolution and
+  prints without rounding. toDouble() is for code that has to hand a
+  float to something else (a display, a JSON library); comparisons go
+  through scaledTo() instead.
+
+  Fallback samples keep the drivers' -99 sentinel at the field's scale.
+*/
+
+#if !defined(FIXED_SAMPLE_MAX_DECIMALS)
+  #define FIXED_SAMPLE_MAX_DECIMALS 4
+#endif
+
+enum SampleUnit : uint8_t {
+  SAMPLE_UNIT_NONE = 0,
+  SAMPLE_UNIT_CELSIUS,
+  SAMPLE_UNIT_PERCENT,     // volumetric water content
+  SAMPLE_UNIT_PERCENT_RH,
+  SAMPLE_UNIT_MS_PER_CM,
+  SAMPLE_UNIT_US_PER_CM,
+  SAMPLE_UNIT_PH,
+  SAMPLE_UNIT_MG_PER_KG,
+  SAMPLE_UNIT_MM,
+  SAMPLE_UNIT_M_PER_S,
+  SAMPLE_UNIT_DEGREE,
+  SAMPLE_UNIT_LUX,
+  SAMPLE_UNIT_W_PER_M2,
+  SAMPLE_UNIT_MM_PER_H
+};
+
+struct FixedSample {
+  static constexpr int32_t FALLBACK = -99;
+
+  int32_t raw;       // value * 10^decimals
+  uint8_t decimals;  // 0..FIXED_SAMPLE_MAX_DECIMALS
+  uint8_t unit;      // SampleUnit
+
+  static constexpr FixedSample make(int32_t raw, uint8_t decimals, uint8_t unit = SAMPLE_UNIT_NONE) {
+    return FixedSample{raw, decimals, unit};
+  }
+
+  // The -99 sentinel at the given scale.
+  static constexpr FixedSample fallback(uint8_t decimals, uint8_t unit = SAMPLE_UNIT_NONE) {
+    return FixedSample{FALLBACK * pow10(decimals), decimals, unit};
+  }
+
+  static constexpr int32_t pow10(uint8_t decimals) {
+    return decimals == 0 ? 1 : 10 * pow10((uint8_t)(decimals - 1));
+  }
+
+  constexpr bool isFallback() const { return raw == FALLBACK * pow10(decimals); }
+
+  // Whole units, truncated toward zero.
+  constexpr int32_t whole() const { return raw / pow10(decimals); }
+
+  // Same value at another scale; dropping digits rounds half away from zero.
+  int32_t scaledTo(uint8_t targetDecimals) const;
+
+  // Presentation edge only.
+  double toDouble() const { return (double)raw / (double)pow10(decimals); }
+
+  // Plain decimal text ("-3.2", "812", "0.452") into buf. Returns the
+  // length written.
+  size_t format(char *buf, size_t len) const;
+
+  static const __FlashStringHelper *unitName(uint8_t unit);
+};
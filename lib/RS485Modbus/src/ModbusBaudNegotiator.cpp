@@ -0,0 +1,167 @@
+#include "ModbusBaudNegotiator.h"
+
+// ============================================================================
+// negotiate / upgradeIfDue
+// ============================================================================
+ModbusBaudNegotiator::Result ModbusBaudNegotiator::negotiate(RS485Bus &bus,
+                                                             uint8_t address,
+                                                             const ModbusBaudProfile &profile,
+                                                             uint32_t targetBaud,
+                                                             bool debug) {
+  const uint32_t fromBaud = bus.bauds().baudFor(address, bus.getDefaultBaud());
+
+  const bool adaptive = bus.getAdaptiveTimeouts();
+  bus.setAdaptiveTimeouts(false);
+  const Result result = run(bus, address, profile, targetBaud, debug);
+  bus.setAdaptiveTimeouts(adaptive);
+  bus.latency().reset(address);
+
+  PrintController *log = bus.getLogger();
+  if (log) {
+    log->print(F("[RS485] Baud 0x"), debug);
+    log->print((unsigned char)address, debug, "", HEX);
+    log->print(F(": "), debug);
+    log->print((unsigned long)fromBaud, debug, " -> ", DEC);
+    log->print((unsigned long)targetBaud, debug, ": ", DEC);
+    log->print(resultName(result), debug);
+    log->print(F(", now "), debug);
+    log->print((unsigned long)bus.bauds().baudFor(address, bus.getDefaultBaud()), debug, "", DEC);
+    log->println("", debug);
+  }
+  return result;
+}
+
+bool ModbusBaudNegotiator::upgradeIfDue(RS485Bus &bus, uint8_t address, bool debug) {
+  const ModbusBaudTable::Entry *e = bus.bauds().find(address);
+  if (!e || e->settled || !e->profile || e->target == 0 || e->target == e->baud) return false;
+
+  const Result result = negotiate(bus, address, *e->profile, e->target, debug);
+
+  // A silent device may just be slow to wake; try again after its next read.
+  if (result != BAUD_NO_REPLY) bus.bauds().settle(address, result);
+  return true;
+}
+
+// ============================================================================
+// run — the steps listed in the header
+// ============================================================================
+ModbusBaudNegotiator::Result ModbusBaudNegotiator::run(RS485Bus &bus,
+                                                       uint8_t address,
+                                                       const ModbusBaudProfile &profile,
+                                                       uint32_t targetBaud,
+                                                       bool debug) {
+  ModbusBaudTable &table = bus.bauds();
+  const uint32_t fromBaud = table.baudFor(address, bus.getDefaultBaud());
+  const ModbusBaudTable::Entry *e = table.find(address);
+  const uint32_t fromAlt = e ? e->altBaud : 0;
+
+  uint16_t targetCode = 0;
+  if (!profile.valueFor(targetBaud, targetCode)) return BAUD_UNSUPPORTED;
+
+  uint16_t fromCode = 0;
+  if (!probe(bus, address, profile, fromBaud, fromCode, debug)) {
+    table.set(address, fromBaud, fromAlt);
+    // An exception means the device has no such register.
+    return bus.lastWasException() ? BAUD_REJECTED : BAUD_NO_REPLY;
+  }
+  if (fromBaud == targetBaud) {
+    table.set(address, fromBaud, fromAlt);
+    return BAUD_OK;
+  }
+
+  if (!writeCode(bus, address, profile, targetCode, debug) && bus.lastWasException()) {
+    table.set(address, fromBaud, fromAlt);
+    return BAUD_REJECTED;
+  }
+  delay(MODBUS_BAUD_SETTLE_MS);
+
+  uint16_t code = 0;
+  if (probe(bus, address, profile, targetBaud, code, debug) && code == targetCode) {
+    table.set(address, targetBaud, fromBaud);
+    return BAUD_OK;
+  }
+
+  if (probe(bus, address, profile, fromBaud, code, debug)) {
+    if (code == targetCode) {
+      table.set(address, fromBaud, targetBaud);
+      return BAUD_PENDING_RESTART;
+    }
+    table.set(address, fromBaud, fromAlt);
+    return BAUD_REJECTED;
+  }
+
+  // Off the old speed but not verified at the new one: find it and put the
+  // old code back.
+  for (uint8_t i = 0; i < profile.count; ++i) {
+    const uint32_t baud = profile.codes[i].baud;
+    if (baud == fromBaud || !probe(bus, address, profile, baud, code, debug)) continue;
+
+    writeCode(bus, address, profile, fromCode, debug);
+    delay(MODBUS_BAUD_SETTLE_MS);
+    if (probe(bus, address, profile, fromBaud, code, debug)) {
+      table.set(address, fromBaud, fromAlt);
+    } else {
+      table.set(address, baud, fromBaud);
+    }
+    return BAUD_ROLLED_BACK;
+  }
+
+  // Keep looking at both speeds through the altBaud retry.
+  table.set(address, fromBaud, targetBaud);
+  return BAUD_LOST;
+}
+
+// ============================================================================
+// probe / writeCode — one register through transact(), speed pinned
+// ============================================================================
+bool ModbusBaudNegotiator::probe(RS485Bus &bus,
+                                 uint8_t address,
+                                 const ModbusBaudProfile &profile,
+                                 uint32_t baud,
+                                 uint16_t &value,
+                                 bool debug) {
+  // No altBaud while probing: a miss must stay a miss at this speed.
+  bus.bauds().set(address, baud, 0);
+
+  const ModbusRequestFrame request = ModbusRequestFrame::read(address, profile.reg, 1);
+  const uint8_t checkCode[3] = {address, request.function(), request.readByteCount()};
+  ModbusFrameView frame;
+  if (!bus.transact(request, request.readResponseSize(),
+                    checkCode, sizeof(checkCode), frame, 2, MODBUS_BAUD_PROBE_TIMEOUT_MS, debug, 0)) {
+    return false;
+  }
+
+  value = frame.u16(0);
+  return true;
+}
+
+bool ModbusBaudNegotiator::writeCode(RS485Bus &bus,
+                                     uint8_t address,
+                                     const ModbusBaudProfile &profile,
+                                     uint16_t value,
+                                     bool debug) {
+  const ModbusRequestFrame request = ModbusRequestFrame::writeSingle(address, profile.reg, value);
+
+  // The echo comes at the old speed, if at all; one try, since a repeat
+  // would reach a device that may already have switched.
+  ModbusFrameView frame;
+  return bus.transact(request, ModbusRequestFrame::SIZE, request.bytes, 6, frame,
+                      1, MODBUS_BAUD_PROBE_TIMEOUT_MS, debug, 0);
+}
+
+// ============================================================================
+// resultName
+// ============================================================================
+const __FlashStringHelper *ModbusBaudNegotiator::resultName(uint8_t result) {
+  switch (result) {
+    case BAUD_NONE:            return F("not tried");
+    case BAUD_OK:              return F("ok");
+    case BAUD_UNSUPPORTED:     return F("unsupported");
+    case BAUD_NO_REPLY:        return F("no reply");
+    case BAUD_REJECTED:        return F("rejected");
+    case BAUD_PENDING_RESTART: return F("pending restart");
+    case BAUD_ROLLED_BACK:     return F("rolled back");
+    case BAUD_LOST:            return F("lost");
+    default:                   return F("unknown");
+  }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <Arduino.h>
+#include "RS485Modbus.h"
+
+/*
+  ModbusBaudNegotiator
+
+  Moves one device to a faster line speed and only keeps it when the
+  device proves it works there:
+
+    1. read the baud register at the current speed (device present?)
+    2. write the new code (0x06; some devices switch before the echo)
+    3. read the register back at the new speed -> OK
+    4. otherwise read it at the old speed:
+       - new code stored, old speed still active -> PENDING_RESTART
+         (many JXCT devices apply it after a power cycle; the bus table
+         keeps the new speed as altBaud, so the next silent transaction
+         after that power cycle finds the device there)
+       - old code -> REJECTED
+    5. device gone from both speeds: try every speed of the profile,
+       write the old code back where it answers -> ROLLED_BACK, else LOST
+
+  Every step goes through RS485Bus::transact() with the address pinned
+  to the probed speed in bus.bauds(); the outcome is written there too.
+  Adaptive timeouts are off while it runs and the address's learned
+  latency is cleared afterwards, since reply timing changes with baud.
+
+  A negotiation costs a few short transactions. It blocks, so call it
+  while nothing else uses the bus and the device is powered, e.g. right
+  after a successful read:
+
+    ModbusBaudNegotiator::upgradeIfDue(bus, sensor->getAddress());
+*/
+
+#if !defined(MODBUS_BAUD_PROBE_TIMEOUT_MS)
+  #define MODBUS_BAUD_PROBE_TIMEOUT_MS 200
+#endif
+
+// Time a device gets to reconfigure its UART after the write.
+#if !defined(MODBUS_BAUD_SETTLE_MS)
+  #define MODBUS_BAUD_SETTLE_MS 50
+#endif
+
+class ModbusBaudNegotiator {
+public:
+  enum Result : uint8_t {
+    BAUD_NONE = 0,
+    BAUD_OK,               // device verified at the new speed
+    BAUD_UNSUPPORTED,      // profile has no code for that speed
+    BAUD_NO_REPLY,         // device silent at its current speed, nothing written
+    BAUD_REJECTED,         // write refused or ignored, speed unchanged
+    BAUD_PENDING_RESTART,  // code stored, new speed applies after a power cycle
+    BAUD_ROLLED_BACK,      // new speed did not verify, device found and restored
+    BAUD_LOST              // device not found at any speed of the profile
+  };
+
+  static Result negotiate(RS485Bus &bus,
+                          uint8_t address,
+                          const ModbusBaudProfile &profile,
+                          uint32_t targetBaud,
+                          bool debug = false);
+
+  // Negotiates the entry's target speed once, if it has one and is not
+  // there yet. Returns true when a negotiation ran.
+  static bool upgradeIfDue(RS485Bus &bus, uint8_t address, bool debug = false);
+
+  static const __FlashStringHelper *resultName(uint8_t result);
+
+private:
+  static Result run(RS485Bus &bus,
+                    uint8_t address,
+                    const ModbusBaudProfile &profile,
+                    uint32_t targetBaud,
+                    bool debug);
+
+  static bool probe(RS485Bus &bus,
+                    uint8_t address,
+                    const ModbusBaudProfile &profile,
+                    uint32_t baud,
+                    uint16_t &value,
+                    bool debug);
+
+  static bool writeCode(RS485Bus &bus,
+                        uint8_t address,
+                        const ModbusBaudProfile &profile,
+                        uint16_t value,
+                        bool debug);
+};
@@ -0,0 +1,151 @@
+#include "ModbusBaudTable.h"
+
+// ============================================================================
+// Profiles
+// ============================================================================
+static const ModbusBaudCode BAUD_CODES_0_TO_6[] = {
+  {2400, 0},
+  {4800, 1},
+  {9600, 2},
+  {19200, 3},
+  {38400, 4},
+  {57600, 5},
+  {115200, 6}
+};
+
+const ModbusBaudProfile MODBUS_BAUD_PROFILE_JXCT = {
+  0x0101, BAUD_CODES_0_TO_6, (uint8_t)(sizeof(BAUD_CODES_0_TO_6) / sizeof(BAUD_CODES_0_TO_6[0]))
+};
+
+const ModbusBaudProfile MODBUS_BAUD_PROFILE_RIKA = {
+  0x0201, BAUD_CODES_0_TO_6, (uint8_t)(sizeof(BAUD_CODES_0_TO_6) / sizeof(BAUD_CODES_0_TO_6[0]))
+};
+
+bool ModbusBaudProfile::valueFor(uint32_t baud, uint16_t &value) const {
+  for (uint8_t i = 0; i < count; ++i) {
+    if (codes[i].baud == baud) {
+      value = codes[i].value;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint32_t ModbusBaudProfile::baudFor(uint16_t value) const {
+  for (uint8_t i = 0; i < count; ++i) {
+    if (codes[i].value == value) return codes[i].baud;
+  }
+  return 0;
+}
+
+// ============================================================================
+// ModbusBaudTable
+// ============================================================================
+ModbusBaudTable::ModbusBaudTable() {
+  reset();
+}
+
+void ModbusBaudTable::reset() {
+  memset(_entries, 0, sizeof(_entries));
+}
+
+ModbusBaudTable::Entry *ModbusBaudTable::find(uint8_t address) {
+  for (uint8_t i = 0; i < MAX_DEVICES; ++i) {
+    if (_entries[i].used && _entries[i].address == address) return &_entries[i];
+  }
+  return nullptr;
+}
+
+const ModbusBaudTable::Entry *ModbusBaudTable::find(uint8_t address) const {
+  for (uint8_t i = 0; i < MAX_DEVICES; ++i) {
+    if (_entries[i].used && _entries[i].address == address) return &_entries[i];
+  }
+  return nullptr;
+}
+
+ModbusBaudTable::Entry *ModbusBaudTable::findOrAdd(uint8_t address, uint32_t baud) {
+  Entry *e = find(address);
+  if (e) return e;
+
+  for (uint8_t i = 0; i < MAX_DEVICES; ++i) {
+    if (!_entries[i].used) {
+      e = &_entries[i];
+      memset(e, 0, sizeof(*e));
+      e->used = true;
+      e->address = address;
+      e->baud = baud;
+      return e;
+    }
+  }
+  return nullptr;
+}
+
+bool ModbusBaudTable::configure(uint8_t address,
+                                uint32_t baud,
+                                uint32_t altBaud,
+                                uint32_t target,
+                                const ModbusBaudProfile *profile) {
+  if (baud == 0) return false;
+  Entry *e = findOrAdd(address, baud);
+  if (!e) return false;
+
+  e->baud = baud;
+  e->altBaud = (altBaud != baud) ? altBaud : 0;
+  e->target = target;
+  e->profile = profile;
+  e->settled = false;
+  e->lastResult = 0;
+  e->misses = 0;
+  return true;
+}
+
+bool ModbusBaudTable::set(uint8_t address, uint32_t baud, uint32_t altBaud) {
+  if (baud == 0) return false;
+  Entry *e = findOrAdd(address, baud);
+  if (!e) return false;
+
+  e->baud = baud;
+  e->altBaud = (altBaud != baud) ? altBaud : 0;
+  e->misses = 0;
+  return true;
+}
+
+uint32_t ModbusBaudTable::baudFor(uint8_t address, uint32_t fallback) const {
+  const Entry *e = find(address);
+  return e ? e->baud : fallback;
+}
+
+bool ModbusBaudTable::noteResult(uint8_t address, bool answered) {
+  Entry *e = find(address);
+  if (!e) return false;
+
+  if (answered) {
+    e->misses = 0;
+    return false;
+  }
+
+  if (e->misses < 0xFF) ++e->misses;
+  if (e->altBaud == 0) return false;
+  return e->misses == 1 || (e->misses % ALT_RETRY_SPACING) == 0;
+}
+
+void ModbusBaudTable::swap(uint8_t address) {
+  Entry *e = find(address);
+  if (!e || e->altBaud == 0) return;
+
+  const uint32_t baud = e->baud;
+  e->baud = e->altBaud;
+  e->altBaud = baud;
+}
+
+void ModbusBaudTable::settle(uint8_t address, uint8_t result) {
+  Entry *e = find(address);
+  if (!e) return;
+  e->settled = true;
+  e->lastResult = result;
+}
+
+const ModbusBaudTable::Entry *ModbusBaudTable::entry(uint8_t index) const {
+  if (index >= MAX_DEVICES || !_entries[index].used) return nullptr;
+  return &_entries[index];
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  ModbusBaudProfile / ModbusBaudTable
+
+  Per-address line speed for one RS485Bus. Devices that were moved off
+  the default baud (ModbusBaudNegotiator) keep their speed here, and the
+  bus switches the UART to it before every request to that address.
+
+  ModbusBaudProfile describes where a family keeps its baud setting:
+  one holding register and the code written for each speed.
+
+  - JXCT / JXBS: register 0x0101. The manuals list 0 = 2400, 1 = 4800,
+    2 = 9600. The higher codes follow the same sequence and are not in
+    the manuals; confirm on hardware.
+  - Rika: register 0x0201, same codes. Not in the Rika manuals at all;
+    confirm on hardware.
+
+  A wrong guess is harmless: the negotiator only keeps a speed after
+  reading the new code back at that speed.
+
+  Each entry has up to three speeds:
+  - baud:    what transact() uses now
+  - altBaud: second guess for a device that goes silent. When a whole
+             transaction gets no reply, the bus tries once at altBaud and
+             swaps the two if the device answers there. This covers a
+             sensor that only applies a new baud after a power cycle and
+             one that fell back to its old speed.
+  - target:  speed to negotiate once the device answers (upgradeIfDue()).
+
+  Entries are configuration, not a cache: when the table is full, new
+  addresses are refused and run at the bus default.
+*/
+
+#if !defined(MODBUS_BAUD_MAX_DEVICES)
+  #if defined(ARDUINO_ARCH_AVR)
+    #define MODBUS_BAUD_MAX_DEVICES 4
+  #else
+    #define MODBUS_BAUD_MAX_DEVICES 16
+  #endif
+#endif
+
+// Failed transactions between two tries at altBaud while a device stays
+// silent. The first failure always tries it.
+#if !defined(MODBUS_BAUD_ALT_RETRY_SPACING)
+  #define MODBUS_BAUD_ALT_RETRY_SPACING 16
+#endif
+
+struct ModbusBaudCode {
+  uint32_t baud;
+  uint16_t value;
+};
+
+struct ModbusBaudProfile {
+  uint16_t reg;                 // holding register with the baud code
+  const ModbusBaudCode *codes;
+  uint8_t count;
+
+  bool valueFor(uint32_t baud, uint16_t &value) const;
+  uint32_t baudFor(uint16_t value) const;   // 0 = unknown code
+};
+
+extern const ModbusBaudProfile MODBUS_BAUD_PROFILE_JXCT;
+extern const ModbusBaudProfile MODBUS_BAUD_PROFILE_RIKA;
+
+class ModbusBaudTable {
+public:
+  static const uint8_t MAX_DEVICES = MODBUS_BAUD_MAX_DEVICES;
+  static const uint8_t ALT_RETRY_SPACING = MODBUS_BAUD_ALT_RETRY_SPACING;
+
+  struct Entry {
+    uint8_t address;
+    bool used;
+    bool settled;          // upgrade tried; do not negotiate again
+    uint8_t lastResult;    // ModbusBaudNegotiator::Result of that try
+    uint8_t misses;        // failed transactions in a row, saturates
+    uint32_t baud;
+    uint32_t altBaud;      // 0 = none
+    uint32_t target;       // 0 = no upgrade wanted
+    const ModbusBaudProfile *profile;
+  };
+
+  ModbusBaudTable();
+
+  // Boot configuration: device believed at baud, tried at altBaud when
+  // silent, upgraded to target through profile. Returns false when full.
+  bool configure(uint8_t address,
+                 uint32_t baud,
+                 uint32_t altBaud,
+                 uint32_t target = 0,
+                 const ModbusBaudProfile *profile = nullptr);
+
+  // Outcome of a negotiation. Adds the address if needed.
+  bool set(uint8_t address, uint32_t baud, uint32_t altBaud);
+
+  uint32_t baudFor(uint8_t address, uint32_t fallback) const;
+
+  // Called by RS485Bus after each transaction. Returns true when a silent
+  // device should get a try at its altBaud now.
+  bool noteResult(uint8_t address, bool answered);
+
+  // baud <-> altBaud.
+  void swap(uint8_t address);
+
+  void settle(uint8_t address, uint8_t result);
+
+  Entry *find(uint8_t address);
+  const Entry *find(uint8_t address) const;
+
+  // Slots in use, for listing (index < MAX_DEVICES; unused slots are
+  // skipped by returning nullptr).
+  const Entry *entry(uint8_t index) const;
+
+  void reset();
+
+private:
+  Entry _entries[MAX_DEVICES];
+
+  Entry *findOrAdd(uint8_t address, uint32_t baud);
+};
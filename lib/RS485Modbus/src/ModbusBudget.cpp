@@ -0,0 +1,51 @@
+#include "ModbusBudget.h"
+
+ModbusBudget::ModbusBudget()
+    : _startMs(0),
+      _budgetMs(0),
+      _maxAttempts(0),
+      _attemptsUsed(0),
+      _reason(ABORT_NONE) {}
+
+void ModbusBudget::start(uint32_t nowMs, uint32_t budgetMs, uint8_t maxAttempts) {
+  _startMs = nowMs;
+  _budgetMs = budgetMs;
+  _maxAttempts = maxAttempts;
+  _attemptsUsed = 0;
+  _reason = ABORT_NONE;
+}
+
+bool ModbusBudget::takeAttempt(uint32_t nowMs) {
+  if (_reason != ABORT_NONE) return false;
+
+  if (_attemptsUsed >= _maxAttempts) {
+    _reason = ABORT_ATTEMPTS;
+    return false;
+  }
+  if (remainingMs(nowMs) < MIN_ATTEMPT_MS) {
+    _reason = ABORT_DEADLINE;
+    return false;
+  }
+
+  ++_attemptsUsed;
+  return true;
+}
+
+uint32_t ModbusBudget::remainingMs(uint32_t nowMs) const {
+  const uint32_t used = nowMs - _startMs;
+  return (used >= _budgetMs) ? 0 : (_budgetMs - used);
+}
+
+uint16_t ModbusBudget::clampMs(uint16_t ms, uint32_t nowMs) const {
+  const uint32_t left = remainingMs(nowMs);
+  return (left < ms) ? (uint16_t)left : ms;
+}
+
+const __FlashStringHelper *ModbusBudget::reasonName(AbortReason reason) {
+  switch (reason) {
+    case ABORT_DEADLINE:       return F("deadline");
+    case ABORT_ATTEMPTS:       return F("attempts");
+    case ABORT_CYCLE_DEADLINE: return F("cycle deadline");
+    default:                   return F("none");
+  }
+}
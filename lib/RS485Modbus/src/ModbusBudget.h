@@ -0,0 +1,66 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  ModbusBudget
+
+  One time and attempt budget for a whole sensor transaction, shared by
+  every retry layer underneath it. Without it the layers multiply:
+  driver retries x SendRequest retries x (read timeout + backoff) can
+  hold a port for 20+ seconds when one sensor is missing.
+
+  The caller (ReadScheduler) starts a budget and hands it to the bus with
+  RS485Bus::setBudget(). From then on every transact() / SendRequest()
+  attempt, by any driver method, first takes an attempt from the budget.
+  Read timeouts and backoff delays are clipped to the time left. Once the
+  budget is spent, both return false at once, so driver retry loops fall
+  through without touching the bus. abortReason() then tells the caller
+  why the transaction stopped.
+
+    budget.start(millis(), 3000, 6);
+    bus.setBudget(&budget);
+    sensor->readData();
+    bus.setBudget(nullptr);
+    if (budget.abortReason() != ModbusBudget::ABORT_NONE) ...
+*/
+
+class ModbusBudget {
+public:
+  enum AbortReason : uint8_t {
+    ABORT_NONE = 0,
+    ABORT_DEADLINE,        // transaction time used up
+    ABORT_ATTEMPTS,        // attempt count used up
+    ABORT_CYCLE_DEADLINE   // read cycle ended before the transaction started
+  };
+
+  // An attempt is not started with less time than this left.
+  static const uint16_t MIN_ATTEMPT_MS = 10;
+
+  ModbusBudget();
+
+  void start(uint32_t nowMs, uint32_t budgetMs, uint8_t maxAttempts);
+
+  // Takes one attempt. Returns false, and records the reason, when the
+  // budget has no attempt or too little time left.
+  bool takeAttempt(uint32_t nowMs);
+
+  uint32_t remainingMs(uint32_t nowMs) const;
+
+  // ms limited to the time left.
+  uint16_t clampMs(uint16_t ms, uint32_t nowMs) const;
+
+  void abort(AbortReason reason) { _reason = reason; }
+  AbortReason abortReason() const { return _reason; }
+
+  uint8_t attemptsUsed() const { return _attemptsUsed; }
+  uint32_t elapsedMs(uint32_t nowMs) const { return nowMs - _startMs; }
+
+  static const __FlashStringHelper *reasonName(AbortReason reason);
+
+private:
+  uint32_t _startMs;
+  uint32_t _budgetMs;
+  uint8_t _maxAttempts;
+  uint8_t _attemptsUsed;
+  AbortReason _reason;
+};
@@ -0,0 +1,141 @@
+#include "ModbusBusScanner.h"
+#include "ModbusFrameLocator.h"
+#include "ModbusReadPlanner.h"
+
+// Most specific layout first; see the header.
+const ModbusBusScanner::Fingerprint ModbusBusScanner::FINGERPRINTS[] = {
+  {MODBUS_FAMILY_JXBS_SOIL_7IN1,    0x001E, 3},  // N, P, K
+  {MODBUS_FAMILY_JXBS_LEAF_SURFACE, 0x0020, 2},  // humidity, temperature
+  {MODBUS_FAMILY_RIKA_SOIL_3IN1,    0x0000, 3},  // temperature, VWC, EC
+  {MODBUS_FAMILY_JXBS_LIQUID_PH,    0x0001, 2},  // temperature, pH
+  {MODBUS_FAMILY_RIKA_LEAF,         0x0000, 2},  // humidity, temperature
+};
+
+const size_t ModbusBusScanner::FINGERPRINT_COUNT =
+    sizeof(ModbusBusScanner::FINGERPRINTS) / sizeof(ModbusBusScanner::FINGERPRINTS[0]);
+
+// ============================================================================
+// Constructor
+// ============================================================================
+ModbusBusScanner::ModbusBusScanner(RS485Bus &bus)
+    : _bus(bus),
+      _timeoutMs(MODBUS_SCAN_RESPONSE_TIMEOUT_MS),
+      _next(1),
+      _end(0),
+      _startMs(0),
+      _lastScanMs(0),
+      _count(0),
+      _overflow(0) {
+  memset(_entries, 0, sizeof(_entries));
+}
+
+// ============================================================================
+// begin / step / scan
+// ============================================================================
+void ModbusBusScanner::begin(uint8_t startAddr, uint8_t endAddr) {
+  if (startAddr < FIRST_ADDRESS) startAddr = FIRST_ADDRESS;
+  if (endAddr > LAST_ADDRESS) endAddr = LAST_ADDRESS;
+
+  _next = startAddr;
+  _end = endAddr;
+  _count = 0;
+  _overflow = 0;
+  _startMs = millis();
+}
+
+bool ModbusBusScanner::step() {
+  if (done()) return false;
+
+  const uint8_t address = (uint8_t)_next++;
+
+  if (probe(address, 0x0000, 1) != PROBE_SILENT) {
+    const uint32_t firstByteUs = _bus.lastRxStats().firstByteUs;
+    const ModbusFamily family = identify(address);
+
+    if (_count < MAX_ENTRIES) {
+      _entries[_count].address = address;
+      _entries[_count].family = family;
+      _entries[_count].firstByteUs = firstByteUs;
+      ++_count;
+    } else {
+      ++_overflow;
+    }
+  }
+
+  if (done()) {
+    _lastScanMs = millis() - _startMs;
+    return false;
+  }
+  return true;
+}
+
+size_t ModbusBusScanner::scan(uint8_t startAddr, uint8_t endAddr) {
+  begin(startAddr, endAddr);
+  while (step()) {
+  }
+  return _count;
+}
+
+// ============================================================================
+// identify — first fingerprint answered with a matching data frame
+// ============================================================================
+ModbusFamily ModbusBusScanner::identify(uint8_t address) {
+  for (size_t i = 0; i < FINGERPRINT_COUNT; ++i) {
+    if (probe(address, FINGERPRINTS[i].reg, FINGERPRINTS[i].count) == PROBE_DATA) {
+      return FINGERPRINTS[i].family;
+    }
+  }
+  return MODBUS_FAMILY_UNKNOWN;
+}
+
+// ============================================================================
+// probe — one 0x03 read, classified by the frames found in the reply
+// ============================================================================
+ModbusBusScanner::ProbeResult ModbusBusScanner::probe(uint8_t address, uint16_t reg, uint8_t count) {
+  const ModbusRequestFrame request = ModbusRequestFrame::read(address, reg, count);
+
+  const uint8_t dataPrefix[3] = {address, ModbusReadPlanner::FUNCTION_READ_HOLDING, (uint8_t)(count * 2U)};
+  const uint8_t exceptionPrefix[2] = {address, (uint8_t)(ModbusReadPlanner::FUNCTION_READ_HOLDING | 0x80)};
+  const size_t dataLen = ModbusReadPlanner::responseSize(count);
+  const size_t exceptionLen = 5;
+
+  _bus.Request_RS485(request.bytes, ModbusRequestFrame::SIZE, 0, false);
+
+  // Unknown reply length: each read ends at the first silence after any
+  // bytes. An echo or noise burst ends a read early, so listen once more
+  // for the reply behind it while the response window is still open.
+  const uint32_t startMs = millis();
+  for (uint8_t attempt = 0; attempt < 2; ++attempt) {
+    const uint32_t elapsedMs = millis() - startMs;
+    if (elapsedMs >= _timeoutMs) break;
+
+    const size_t len = _bus.Read_RS485((uint16_t)(_timeoutMs - elapsedMs), (size_t)0, false);
+    if (len == 0) break;
+
+    const uint8_t *raw = _bus.rawData();
+    if (ModbusFrameLocator::findFirst(raw, len, dataPrefix, sizeof(dataPrefix), dataLen) !=
+        ModbusFrameLocator::NOT_FOUND) {
+      return PROBE_DATA;
+    }
+    if (ModbusFrameLocator::findFirst(raw, len, exceptionPrefix, sizeof(exceptionPrefix), exceptionLen) !=
+        ModbusFrameLocator::NOT_FOUND) {
+      return PROBE_EXCEPTION;
+    }
+  }
+
+  return PROBE_SILENT;
+}
+
+// ============================================================================
+// familyName
+// ============================================================================
+const __FlashStringHelper *ModbusBusScanner::familyName(ModbusFamily family) {
+  switch (family) {
+    case MODBUS_FAMILY_JXBS_SOIL_7IN1:    return F("JXBS_SoilComp7in1");
+    case MODBUS_FAMILY_JXBS_LEAF_SURFACE: return F("JXBS_LeafSurfaceHumidity");
+    case MODBUS_FAMILY_RIKA_SOIL_3IN1:    return F("RikaSoilSensor3in1");
+    case MODBUS_FAMILY_JXBS_LIQUID_PH:    return F("JXBS_LiquidPH");
+    case MODBUS_FAMILY_RIKA_LEAF:         return F("RikaLeafSensor");
+    default:                              return F("unknown");
+  }
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <Arduino.h>
+#include "RS485Modbus.h"
+
+/*
+  ModbusBusScanner
+
+  Whole-bus inventory: which addresses answer, and which sensor family
+  each one is. Replaces running every driver's scanForAddress() in turn.
+
+  Every address gets one presence probe (read 1 register at 0x0000).
+  Any CRC-valid reply counts, data or exception, so the address is known
+  to be taken even when the family is not. The read returns at the first
+  silence after the reply, and a missing device only costs the short
+  response timeout instead of a driver's full read timeout.
+
+  Present addresses are then fingerprinted by register layout: the
+  family table below is tried in order and the first probe answered with
+  a data frame of the expected size names the family. The table goes
+  from most to least specific layout, so a device that answers reads
+  across unmapped registers is reported as the first family whose
+  layout it accepts.
+
+  The scan can run in one call (scan()) or one address per step(), so a
+  caller can feed the watchdog or service other work in between.
+
+    ModbusBusScanner scanner(bus);
+    scanner.scan();
+    for (size_t i = 0; i < scanner.count(); ++i) {
+      ... scanner.entry(i).address, ModbusBusScanner::familyName(...) ...
+    }
+*/
+
+#if !defined(MODBUS_SCAN_RESPONSE_TIMEOUT_MS)
+  #define MODBUS_SCAN_RESPONSE_TIMEOUT_MS 30
+#endif
+
+enum ModbusFamily : uint8_t {
+  MODBUS_FAMILY_UNKNOWN = 0,   // answers, layout not recognised
+  MODBUS_FAMILY_JXBS_SOIL_7IN1,
+  MODBUS_FAMILY_JXBS_LEAF_SURFACE,
+  MODBUS_FAMILY_RIKA_SOIL_3IN1,
+  MODBUS_FAMILY_JXBS_LIQUID_PH,
+  MODBUS_FAMILY_RIKA_LEAF
+};
+
+class ModbusBusScanner {
+public:
+  static const uint8_t MAX_ENTRIES = 32;
+  static const uint8_t FIRST_ADDRESS = 1;
+  static const uint8_t LAST_ADDRESS = 247;
+
+  struct Entry {
+    uint8_t address;
+    ModbusFamily family;
+    uint32_t firstByteUs;  // presence probe: end of TX -> first reply byte
+  };
+
+  explicit ModbusBusScanner(RS485Bus &bus);
+
+  // How long to wait for the first reply byte of a probe.
+  void setResponseTimeoutMs(uint16_t timeoutMs) { _timeoutMs = timeoutMs; }
+  uint16_t getResponseTimeoutMs() const { return _timeoutMs; }
+
+  // Step-wise scan: begin(), then step() until it returns false.
+  void begin(uint8_t startAddr = FIRST_ADDRESS, uint8_t endAddr = LAST_ADDRESS);
+  bool step();
+  bool done() const { return _next > _end; }
+  uint8_t nextAddress() const { return (uint8_t)_next; }
+
+  // Blocking scan of [startAddr, endAddr]. Returns the number of devices.
+  size_t scan(uint8_t startAddr = FIRST_ADDRESS, uint8_t endAddr = LAST_ADDRESS);
+
+  size_t count() const { return _count; }
+  const Entry &entry(size_t index) const { return _entries[index]; }
+
+  // Devices beyond MAX_ENTRIES are counted here but not stored.
+  size_t overflow() const { return _overflow; }
+
+  // Duration of the last completed scan.
+  uint32_t lastScanMs() const { return _lastScanMs; }
+
+  static const __FlashStringHelper *familyName(ModbusFamily family);
+
+private:
+  enum ProbeResult : uint8_t {
+    PROBE_SILENT = 0,   // nothing CRC-valid from this address
+    PROBE_DATA,         // data frame with the expected byte count
+    PROBE_EXCEPTION     // exception frame (device present, layout rejected)
+  };
+
+  struct Fingerprint {
+    ModbusFamily family;
+    uint16_t reg;
+    uint8_t count;
+  };
+
+  static const Fingerprint FINGERPRINTS[];
+  static const size_t FINGERPRINT_COUNT;
+
+  RS485Bus &_bus;
+  uint16_t _timeoutMs;
+
+  uint16_t _next;
+  uint16_t _end;
+  uint32_t _startMs;
+  uint32_t _lastScanMs;
+
+  Entry _entries[MAX_ENTRIES];
+  size_t _count;
+  size_t _overflow;
+
+  ProbeResult probe(uint8_t address, uint16_t reg, uint8_t count);
+  ModbusFamily identify(uint8_t address);
+};
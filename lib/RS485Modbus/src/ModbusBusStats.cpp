@@ -0,0 +1,161 @@
+#include "ModbusBusStats.h"
+
+ModbusBusStats::ModbusBusStats() {
+  reset();
+}
+
+void ModbusBusStats::reset(uint32_t nowMs) {
+  memset(_devices, 0, sizeof(_devices));
+  clear(_total);
+  _sinceMs = nowMs;
+}
+
+void ModbusBusStats::rebase(void *stats, size_t size, uint32_t shiftMs) {
+  if (!stats || size != sizeof(ModbusBusStats)) return;
+
+  ModbusBusStats &s = *static_cast<ModbusBusStats *>(stats);
+  s._sinceMs += shiftMs;
+  for (uint8_t i = 0; i < MAX_DEVICES; ++i) {
+    if (s._devices[i].used) s._devices[i].lastMs += shiftMs;
+  }
+}
+
+void ModbusBusStats::clear(Counters &c) {
+  memset(&c, 0, sizeof(c));
+  c.latencyMinUs = 0xFFFFFFFFUL;
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+ModbusBusStats::Device &ModbusBusStats::findOrAdd(uint8_t address, uint32_t nowMs) {
+  for (uint8_t i = 0; i < MAX_DEVICES; ++i) {
+    if (_devices[i].used && _devices[i].address == address) return _devices[i];
+  }
+
+  // Free slot first, otherwise the one that has been quiet longest.
+  Device *dev = &_devices[0];
+  for (uint8_t i = 0; i < MAX_DEVICES; ++i) {
+    if (!_devices[i].used) {
+      dev = &_devices[i];
+      break;
+    }
+    if ((uint32_t)(nowMs - _devices[i].lastMs) > (uint32_t)(nowMs - dev->lastMs)) dev = &_devices[i];
+  }
+
+  memset(dev, 0, sizeof(*dev));
+  clear(dev->counters);
+  dev->used = true;
+  dev->address = address;
+  return *dev;
+}
+
+void ModbusBusStats::addAttempt(Counters &c,
+                                Outcome outcome,
+                                size_t txBytes,
+                                size_t rxBytes,
+                                size_t strayBytes,
+                                bool echo,
+                                uint32_t latencyUs) {
+  bump(c.attempts);
+  if (outcome < OUTCOME_COUNT) bump(c.outcomes[outcome]);
+  c.txBytes += (uint32_t)txBytes;
+  c.rxBytes += (uint32_t)rxBytes;
+
+  if (outcome != OUTCOME_OK) return;
+
+  if (echo) bump(c.echoes);
+  if (strayBytes > 0) bump(c.noise);
+
+  if (latencyUs < c.latencyMinUs) c.latencyMinUs = latencyUs;
+  if (latencyUs > c.latencyMaxUs) c.latencyMaxUs = latencyUs;
+
+  // Halve instead of wrapping, so the average follows recent replies.
+  if (c.latencySamples == 0xFFFF || c.latencySumUs > 0xFFFFFFFFUL - latencyUs) {
+    c.latencySumUs /= 2;
+    c.latencySamples /= 2;
+  }
+  c.latencySumUs += latencyUs;
+  ++c.latencySamples;
+}
+
+void ModbusBusStats::recordAttempt(uint8_t address,
+                                   Outcome outcome,
+                                   size_t txBytes,
+                                   size_t rxBytes,
+                                   size_t strayBytes,
+                                   bool echo,
+                                   uint32_t latencyUs,
+                                   uint32_t nowMs) {
+  addAttempt(_total, outcome, txBytes, rxBytes, strayBytes, echo, latencyUs);
+
+  Device &dev = findOrAdd(address, nowMs);
+  dev.lastMs = nowMs;
+  addAttempt(dev.counters, outcome, txBytes, rxBytes, strayBytes, echo, latencyUs);
+}
+
+void ModbusBusStats::recordTransaction(uint8_t address, bool ok, uint32_t nowMs) {
+  bump(_total.transactions);
+  if (!ok) bump(_total.failed);
+
+  Device &dev = findOrAdd(address, nowMs);
+  dev.lastMs = nowMs;
+  bump(dev.counters.transactions);
+  if (!ok) bump(dev.counters.failed);
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+const ModbusBusStats::Counters *ModbusBusStats::counters(uint8_t address) const {
+  for (uint8_t i = 0; i < MAX_DEVICES; ++i) {
+    if (_devices[i].used && _devices[i].address == address) return &_devices[i].counters;
+  }
+  return nullptr;
+}
+
+const ModbusBusStats::Device *ModbusBusStats::device(uint8_t index) const {
+  if (index >= MAX_DEVICES || !_devices[index].used) return nullptr;
+  return &_devices[index];
+}
+
+size_t ModbusBusStats::format(const Counters &c, char *buf, size_t len) {
+  if (!buf || len == 0) return 0;
+
+  const unsigned long minMs = c.latencySamples ? c.latencyMinUs / 1000UL : 0;
+  const int n = snprintf(buf, len,
+                         "n=%u fail=%u retry=%u to=%u part=%u crc=%u pfx=%u exc=%u noise=%u echo=%u "
+                         "tx=%lu rx=%lu lat=%lu/%lu/%lu",
+                         (unsigned)c.transactions,
+                         (unsigned)c.failed,
+                         (unsigned)c.retries(),
+                         (unsigned)c.outcomes[OUTCOME_TIMEOUT],
+                         (unsigned)c.outcomes[OUTCOME_PARTIAL],
+                         (unsigned)c.outcomes[OUTCOME_CRC],
+                         (unsigned)c.outcomes[OUTCOME_PREFIX],
+                         (unsigned)c.outcomes[OUTCOME_EXCEPTION],
+                         (unsigned)c.noise,
+                         (unsigned)c.echoes,
+                         (unsigned long)c.txBytes,
+                         (unsigned long)c.rxBytes,
+                         minMs,
+                         (unsigned long)(c.latencyAvgUs() / 1000UL),
+                         (unsigned long)(c.latencyMaxUs / 1000UL));
+  if (n < 0) {
+    buf[0] = '\0';
+    return 0;
+  }
+  return ((size_t)n < len) ? (size_t)n : len - 1;
+}
+
+const __FlashStringHelper *ModbusBusStats::outcomeName(uint8_t outcome) {
+  switch (outcome) {
+    case OUTCOME_OK:        return F("ok");
+    case OUTCOME_TIMEOUT:   return F("timeout");
+    case OUTCOME_PARTIAL:   return F("partial");
+    case OUTCOME_CRC:       return F("CRC");
+    case OUTCOME_PREFIX:    return F("prefix");
+    case OUTCOME_EXCEPTION: return F("exception");
+    default:                return F("unknown");
+  }
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  ModbusBusStats
+
+  Health counters for one RS485Bus: why attempts fail, how much traffic
+  goes over the line and how fast devices answer. RS485Bus::transact()
+  classifies every attempt it sends:
+
+    OK         CRC-valid reply found
+    TIMEOUT    not one byte came back
+    PARTIAL    some bytes, fewer than the reply needs
+    CRC        expected prefix (address / function / count) found, CRC wrong
+    PREFIX     a reply's worth of bytes, expected prefix nowhere
+    EXCEPTION  exception reply from the addressed slave
+
+  Replies that had stray bytes in front of them count as noise; an echo
+  of the request itself (transceiver without echo suppression) is
+  counted apart, since it is harmless.
+
+  What the counters point at:
+  - CRC / PARTIAL / noise rising on one port: cable, termination, ground
+  - TIMEOUT on one address only: that device (power, address, baud)
+  - retries and latency max rising: a node that is getting slow, or a
+    chatty neighbour holding the line
+
+  The same counters are kept for the whole port and per address. Event
+  counts are 16-bit and saturate; byte counts are 32-bit. When the table
+  is full, the address that has been quiet longest makes room, like
+  ModbusExceptionLog. The port total never loses anything.
+
+  format() writes one counters line, key=value, for the CLI, an upload
+  payload or StationLogger::logData():
+    n=120 fail=2 retry=5 to=3 part=1 crc=1 pfx=0 exc=0 noise=2 echo=0 tx=1000 rx=1210 lat=12/14/31
+*/
+
+#if !defined(MODBUS_STATS_MAX_DEVICES)
+  #if defined(ARDUINO_ARCH_AVR)
+    #define MODBUS_STATS_MAX_DEVICES 4
+  #else
+    #define MODBUS_STATS_MAX_DEVICES 16
+  #endif
+#endif
+
+class ModbusBusStats {
+public:
+  static const uint8_t MAX_DEVICES = MODBUS_STATS_MAX_DEVICES;
+
+  enum Outcome : uint8_t {
+    OUTCOME_OK = 0,
+    OUTCOME_TIMEOUT,
+    OUTCOME_PARTIAL,
+    OUTCOME_CRC,
+    OUTCOME_PREFIX,
+    OUTCOME_EXCEPTION,
+    OUTCOME_COUNT
+  };
+
+  struct Counters {
+    uint16_t transactions;             // transact() calls
+    uint16_t failed;                   // ... that ended without a reply frame
+    uint16_t attempts;                 // requests sent, retries included
+    uint16_t outcomes[OUTCOME_COUNT];  // per attempt
+    uint16_t noise;                    // replies with stray bytes in front
+    uint16_t echoes;                   // replies behind an echo of the request
+    uint32_t txBytes;
+    uint32_t rxBytes;
+    uint32_t latencyMinUs;             // end of TX -> last reply byte, OK attempts
+    uint32_t latencyMaxUs;
+    uint32_t latencySumUs;
+    uint16_t latencySamples;
+
+    uint16_t retries() const { return attempts > transactions ? attempts - transactions : 0; }
+    uint32_t latencyAvgUs() const { return latencySamples ? latencySumUs / latencySamples : 0; }
+  };
+
+  struct Device {
+    uint8_t address;
+    bool used;
+    uint32_t lastMs;
+    Counters counters;
+  };
+
+  ModbusBusStats();
+
+  // One request sent and its reply classified. strayBytes: bytes in front
+  // of the reply frame; echo: they started with the request itself.
+  void recordAttempt(uint8_t address,
+                     Outcome outcome,
+                     size_t txBytes,
+                     size_t rxBytes,
+                     size_t strayBytes,
+                     bool echo,
+                     uint32_t latencyUs,
+                     uint32_t nowMs);
+
+  void recordTransaction(uint8_t address, bool ok, uint32_t nowMs);
+
+  const Counters &total() const { return _total; }
+  const Counters *counters(uint8_t address) const;
+
+  // Slots in use, for listing (index < MAX_DEVICES; unused slots are
+  // skipped by returning nullptr).
+  const Device *device(uint8_t index) const;
+
+  // millis() of the last reset().
+  uint32_t sinceMs() const { return _sinceMs; }
+
+  void reset(uint32_t nowMs = 0);
+
+  // Moves the millis() times of a ModbusBusStats copied through a deep
+  // sleep into the new boot's timebase (SleepPlanner::retain()).
+  static void rebase(void *stats, size_t size, uint32_t shiftMs);
+
+  // One key=value line (see above) into buf. Returns the length written.
+  static size_t format(const Counters &c, char *buf, size_t len);
+
+  static const __FlashStringHelper *outcomeName(uint8_t outcome);
+
+private:
+  Device _devices[MAX_DEVICES];
+  Counters _total;
+  uint32_t _sinceMs;
+
+  Device &findOrAdd(uint8_t address, uint32_t nowMs);
+
+  static void clear(Counters &c);
+  static void bump(uint16_t &counter) { if (counter < 0xFFFF) ++counter; }
+  static void addAttempt(Counters &c,
+                         Outcome outcome,
+                         size_t txBytes,
+                         size_t rxBytes,
+                         size_t strayBytes,
+                         bool echo,
+                         uint32_t latencyUs);
+};
@@ -0,0 +1,136 @@
+#include "ModbusCrc16.h"
+#include "ModbusRequestFrame.h"
+
+#if defined(ARDUINO_ARCH_AVR)
+  #define MODBUS_CRC_READ(entry) pgm_read_word(&(entry))
+#else
+  #define MODBUS_CRC_READ(entry) (entry)
+#endif
+
+static_assert(ModbusCrc16::byteEntry(0x01) == 0xC0C1, "CRC16/MODBUS table generator is broken");
+static_assert(ModbusCrc16::byteEntry(0xFF) == 0x4040, "CRC16/MODBUS table generator is broken");
+static_assert(ModbusRequestFrame::read(0x01, 0x0000, 1).crc() == 0x0A84,
+              "compile-time request frame CRC is broken");
+
+// Expands to the 256 entries of slice `k` (k zero bytes after the data byte).
+#define MODBUS_CRC_E1(n, k)   ModbusCrc16::sliceEntry((uint16_t)(n), (k))
+#define MODBUS_CRC_E4(n, k)   MODBUS_CRC_E1((n), k), MODBUS_CRC_E1((n) + 1, k), \
+                              MODBUS_CRC_E1((n) + 2, k), MODBUS_CRC_E1((n) + 3, k)
+#define MODBUS_CRC_E16(n, k)  MODBUS_CRC_E4((n), k), MODBUS_CRC_E4((n) + 4, k), \
+                              MODBUS_CRC_E4((n) + 8, k), MODBUS_CRC_E4((n) + 12, k)
+#define MODBUS_CRC_E64(n, k)  MODBUS_CRC_E16((n), k), MODBUS_CRC_E16((n) + 16, k), \
+                              MODBUS_CRC_E16((n) + 32, k), MODBUS_CRC_E16((n) + 48, k)
+#define MODBUS_CRC_E256(k)    MODBUS_CRC_E64(0, k), MODBUS_CRC_E64(64, k), \
+                              MODBUS_CRC_E64(128, k), MODBUS_CRC_E64(192, k)
+
+static const uint16_t MODBUS_CRC_TABLE[256] PROGMEM = {
+  MODBUS_CRC_E256(0)
+};
+
+static const uint16_t MODBUS_CRC_SLICE4[4][256] PROGMEM = {
+  { MODBUS_CRC_E256(0) },
+  { MODBUS_CRC_E256(1) },
+  { MODBUS_CRC_E256(2) },
+  { MODBUS_CRC_E256(3) }
+};
+
+uint16_t ModbusCrc16::updateBitwise(uint16_t crc, const uint8_t *data, size_t len) {
+  if (!data) return crc;
+
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= (uint16_t)data[i];
+    for (uint8_t bit = 0; bit < 8; ++bit) {
+      if (crc & 0x0001) {
+        crc = (crc >> 1) ^ POLY;
+      } else {
+        crc >>= 1;
+      }
+    }
+  }
+  return crc;
+}
+
+uint16_t ModbusCrc16::updateTable(uint16_t crc, const uint8_t *data, size_t len) {
+  if (!data) return crc;
+
+  for (size_t i = 0; i < len; ++i) {
+    crc = (crc >> 8) ^ MODBUS_CRC_READ(MODBUS_CRC_TABLE[(crc ^ data[i]) & 0xFF]);
+  }
+  return crc;
+}
+
+uint16_t ModbusCrc16::updateSlice4(uint16_t crc, const uint8_t *data, size_t len) {
+  if (!data) return crc;
+
+  while (len >= 4) {
+    crc ^= (uint16_t)data[0] | ((uint16_t)data[1] << 8);
+    crc = MODBUS_CRC_READ(MODBUS_CRC_SLICE4[3][crc & 0xFF]) ^
+          MODBUS_CRC_READ(MODBUS_CRC_SLICE4[2][crc >> 8]) ^
+          MODBUS_CRC_READ(MODBUS_CRC_SLICE4[1][data[2]]) ^
+          MODBUS_CRC_READ(MODBUS_CRC_SLICE4[0][data[3]]);
+    data += 4;
+    len -= 4;
+  }
+
+  while (len > 0) {
+    crc = (crc >> 8) ^ MODBUS_CRC_READ(MODBUS_CRC_SLICE4[0][(crc ^ *data) & 0xFF]);
+    ++data;
+    --len;
+  }
+  return crc;
+}
+
+uint16_t ModbusCrc16::update(uint16_t crc, const uint8_t *data, size_t len) {
+#if RS485BUS_CRC_ENGINE == RS485BUS_CRC_ENGINE_BITWISE
+  return updateBitwise(crc, data, len);
+#elif RS485BUS_CRC_ENGINE == RS485BUS_CRC_ENGINE_TABLE
+  return updateTable(crc, data, len);
+#else
+  return updateSlice4(crc, data, len);
+#endif
+}
+
+uint16_t ModbusCrc16::updateByte(uint16_t crc, uint8_t value) {
+#if RS485BUS_CRC_ENGINE == RS485BUS_CRC_ENGINE_BITWISE
+  return updateBitwise(crc, &value, 1);
+#elif RS485BUS_CRC_ENGINE == RS485BUS_CRC_ENGINE_TABLE
+  return (crc >> 8) ^ MODBUS_CRC_READ(MODBUS_CRC_TABLE[(crc ^ value) & 0xFF]);
+#else
+  return (crc >> 8) ^ MODBUS_CRC_READ(MODBUS_CRC_SLICE4[0][(crc ^ value) & 0xFF]);
+#endif
+}
+
+const char *ModbusCrc16::engineName() {
+#if RS485BUS_CRC_ENGINE == RS485BUS_CRC_ENGINE_BITWISE
+  return "bitwise";
+#elif RS485BUS_CRC_ENGINE == RS485BUS_CRC_ENGINE_TABLE
+  return "table256";
+#else
+  return "slice-by-4";
+#endif
+}
+
+ModbusCrcWindow::ModbusCrcWindow(size_t windowLen)
+    : _len(windowLen),
+      _initTerm(0) {
+  // A(x) = CRC register after shifting in one zero byte with no init.
+  // initTerm = A^(len+1)(INIT) ^ A^len(INIT)
+  // dropBasis[b] = A^len(T[1 << b])
+  uint16_t initShifted = ModbusCrc16::INIT;
+  for (size_t i = 0; i < _len; ++i) {
+    initShifted = ModbusCrc16::updateByte(initShifted, 0x00);
+  }
+  _initTerm = (uint16_t)(ModbusCrc16::updateByte(initShifted, 0x00) ^ initShifted);
+
+  for (uint8_t bit = 0; bit < 8; ++bit) {
+    uint16_t basis = ModbusCrc16::updateByte(0x0000, (uint8_t)(1U << bit));
+    for (size_t i = 0; i < _len; ++i) {
+      basis = ModbusCrc16::updateByte(basis, 0x00);
+    }
+    _dropBasis[bit] = basis;
+  }
+}
+
+uint16_t ModbusCrcWindow::first(const uint8_t *data) const {
+  return ModbusCrc16::compute(data, _len);
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  ModbusCrc16
+
+  CRC-16/MODBUS (reflected polynomial 0xA001, init 0xFFFF, CRC low byte first
+  on the wire) with three interchangeable engines:
+
+    RS485BUS_CRC_ENGINE_BITWISE - 8 shift/xor steps per byte, no table.
+                                  Smallest flash, slowest.
+    RS485BUS_CRC_ENGINE_TABLE   - one 256-entry table (512 B, PROGMEM on AVR).
+    RS485BUS_CRC_ENGINE_SLICE4  - four 256-entry tables (2 KB), consumes four
+                                  bytes per step. Fastest on 32-bit cores.
+
+  All tables are generated at compile time from the polynomial (constexpr),
+  so there is no hand-typed table to get wrong and no RAM init cost.
+
+  Build-time selection (platformio.ini build_flags):
+    -D RS485BUS_CRC_ENGINE=RS485BUS_CRC_ENGINE_BITWISE
+  Defaults: AVR -> TABLE, other targets -> SLICE4.
+
+  update() is incremental: feed a frame in any number of pieces starting from
+  INIT. The per-engine functions stay callable so benchmarks can compare them
+  in one binary; the linker drops the tables that are never referenced.
+*/
+
+#define RS485BUS_CRC_ENGINE_BITWISE 0
+#define RS485BUS_CRC_ENGINE_TABLE   1
+#define RS485BUS_CRC_ENGINE_SLICE4  2
+
+#if !defined(RS485BUS_CRC_ENGINE)
+  #if defined(ARDUINO_ARCH_AVR)
+    #define RS485BUS_CRC_ENGINE RS485BUS_CRC_ENGINE_TABLE
+  #else
+    #define RS485BUS_CRC_ENGINE RS485BUS_CRC_ENGINE_SLICE4
+  #endif
+#endif
+
+class ModbusCrc16 {
+public:
+  static constexpr uint16_t INIT = 0xFFFF;
+  static constexpr uint16_t POLY = 0xA001;
+
+  // ---- compile-time table generation (C++11 constexpr, single return) ----
+  static constexpr uint16_t bitStep(uint16_t crc) {
+    return (crc & 0x0001) ? (uint16_t)((crc >> 1) ^ POLY) : (uint16_t)(crc >> 1);
+  }
+
+  static constexpr uint16_t byteEntry(uint16_t value) {
+    return bitStep(bitStep(bitStep(bitStep(bitStep(bitStep(bitStep(bitStep(value))))))));
+  }
+
+  // Effect of one byte followed by `zeros` zero bytes (slice-by-N tables).
+  static constexpr uint16_t sliceEntry(uint16_t value, uint8_t zeros) {
+    return (zeros == 0)
+               ? byteEntry(value)
+               : (uint16_t)((sliceEntry(value, zeros - 1) >> 8) ^
+                            byteEntry(sliceEntry(value, zeros - 1) & 0xFF));
+  }
+
+  // One data byte, table form, for CRCs of constant frames
+  // (ModbusRequestFrame).
+  static constexpr uint16_t byteStep(uint16_t crc, uint8_t value) {
+    return (uint16_t)((crc >> 8) ^ byteEntry((uint16_t)((crc ^ value) & 0xFF)));
+  }
+
+  // ---- runtime API ----
+  static uint16_t compute(const uint8_t *data, size_t len) {
+    return update(INIT, data, len);
+  }
+
+  // Continues a CRC over more data using the build-selected engine.
+  static uint16_t update(uint16_t crc, const uint8_t *data, size_t len);
+  static uint16_t updateByte(uint16_t crc, uint8_t value);
+
+  // Individual engines, always available for comparison.
+  static uint16_t updateBitwise(uint16_t crc, const uint8_t *data, size_t len);
+  static uint16_t updateTable(uint16_t crc, const uint8_t *data, size_t len);
+  static uint16_t updateSlice4(uint16_t crc, const uint8_t *data, size_t len);
+
+  static const char *engineName();
+};
+
+/*
+  ModbusCrcWindow
+
+  Rolling CRC over a fixed-length window. CRC-16 is linear over GF(2), so
+  sliding the window by one byte is:
+
+    next = update(crc, inByte) ^ K ^ R(outByte)
+
+  where K cancels the init value's extra shift and R(outByte) removes the
+  contribution of the byte leaving the window. R is linear in outByte, so it
+  is stored as 8 basis values (16 bytes) instead of a 256-entry table.
+
+  Used to scan a raw RX buffer for CRC-valid frames of a known length in
+  O(buffer) instead of O(buffer * frame).
+*/
+class ModbusCrcWindow {
+public:
+  // windowLen is the number of bytes covered by the CRC (frame length - 2).
+  explicit ModbusCrcWindow(size_t windowLen);
+
+  size_t length() const { return _len; }
+
+  // CRC of data[0 .. windowLen).
+  uint16_t first(const uint8_t *data) const;
+
+  // Slides the window one byte: drops outByte (old first byte) and appends
+  // inByte (the byte right after the old window).
+  uint16_t roll(uint16_t crc, uint8_t outByte, uint8_t inByte) const {
+    uint16_t next = (uint16_t)(ModbusCrc16::updateByte(crc, inByte) ^ _initTerm);
+    for (uint8_t bit = 0; bit < 8; ++bit) {
+      if (outByte & (uint8_t)(1U << bit)) {
+        next ^= _dropBasis[bit];
+      }
+    }
+    return next;
+  }
+
+private:
+  size_t _len;
+  uint16_t _initTerm;
+  uint16_t _dropBasis[8];
+};
@@ -0,0 +1,91 @@
+#include "ModbusException.h"
+
+// ============================================================================
+// ModbusException
+// ============================================================================
+const __FlashStringHelper *ModbusException::codeName(uint8_t code) {
+  switch (code) {
+    case 0:                    return F("none");
+    case ILLEGAL_FUNCTION:     return F("illegal function");
+    case ILLEGAL_DATA_ADDRESS: return F("illegal data address");
+    case ILLEGAL_DATA_VALUE:   return F("illegal data value");
+    case SLAVE_DEVICE_FAILURE: return F("slave device failure");
+    case ACKNOWLEDGE:          return F("acknowledge");
+    case SLAVE_DEVICE_BUSY:    return F("slave device busy");
+    case MEMORY_PARITY_ERROR:  return F("memory parity error");
+    case GATEWAY_PATH_UNAVAILABLE: return F("gateway path unavailable");
+    case GATEWAY_TARGET_FAILED:    return F("gateway target failed");
+    default:                   return F("unknown");
+  }
+}
+
+bool ModbusException::isFinal(uint8_t code) {
+  switch (code) {
+    case ILLEGAL_FUNCTION:
+    case ILLEGAL_DATA_ADDRESS:
+    case ILLEGAL_DATA_VALUE:
+    case SLAVE_DEVICE_FAILURE:
+    case MEMORY_PARITY_ERROR:
+    case GATEWAY_PATH_UNAVAILABLE:
+    case GATEWAY_TARGET_FAILED:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// ============================================================================
+// ModbusExceptionLog
+// ============================================================================
+ModbusExceptionLog::ModbusExceptionLog() {
+  reset();
+}
+
+void ModbusExceptionLog::reset() {
+  memset(_devices, 0, sizeof(_devices));
+  _total = 0;
+}
+
+int8_t ModbusExceptionLog::indexOf(uint8_t address) const {
+  for (uint8_t i = 0; i < MAX_DEVICES; ++i) {
+    if (_devices[i].used && _devices[i].address == address) return (int8_t)i;
+  }
+  return -1;
+}
+
+void ModbusExceptionLog::record(const ModbusException &ex, uint32_t nowMs) {
+  const int8_t index = indexOf(ex.address);
+  Device *dev = (index >= 0) ? &_devices[index] : nullptr;
+
+  if (!dev) {
+    // Free slot first, otherwise the one that has been quiet longest.
+    dev = &_devices[0];
+    for (uint8_t i = 0; i < MAX_DEVICES; ++i) {
+      if (!_devices[i].used) {
+        dev = &_devices[i];
+        break;
+      }
+      if ((uint32_t)(nowMs - _devices[i].lastMs) > (uint32_t)(nowMs - dev->lastMs)) dev = &_devices[i];
+    }
+
+    memset(dev, 0, sizeof(*dev));
+    dev->used = true;
+    dev->address = ex.address;
+  }
+
+  dev->lastFunction = ex.function;
+  dev->lastCode = ex.code;
+  dev->lastMs = nowMs;
+  if (dev->count < 0xFFFF) ++dev->count;
+  ++_total;
+}
+
+uint16_t ModbusExceptionLog::count(uint8_t address) const {
+  const int8_t index = indexOf(address);
+  return (index >= 0) ? _devices[index].count : 0;
+}
+
+const ModbusExceptionLog::Device *ModbusExceptionLog::device(uint8_t index) const {
+  if (index >= MAX_DEVICES || !_devices[index].used) return nullptr;
+  return &_devices[index];
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  ModbusException / ModbusExceptionLog
+
+  A slave that understands a request but rejects it answers with a 5-byte
+  exception frame: [addr][function | 0x80][code][CRC]. Most codes are
+  final (isFinal()): re-sending the same request gets the same exception,
+  so RS485Bus::transact() returns false at once instead of waiting out
+  the timeout and retrying. ACKNOWLEDGE and SLAVE DEVICE BUSY mean "ask
+  again later" and are retried with the normal backoff, inside the
+  budget. RS485Bus::lastException() tells the caller why.
+
+    if (!bus.transact(...)) {
+      if (bus.lastWasException()) break;   // register map wrong, stop retrying
+      continue;
+    }
+
+  ModbusExceptionLog keeps per-address counters (count, last function and
+  code, time of the last one) so a misconfigured sensor shows up in
+  diagnostics instead of as plain read failures.
+*/
+
+#if !defined(MODBUS_EXCEPTION_MAX_DEVICES)
+  #if defined(ARDUINO_ARCH_AVR)
+    #define MODBUS_EXCEPTION_MAX_DEVICES 4
+  #else
+    #define MODBUS_EXCEPTION_MAX_DEVICES 16
+  #endif
+#endif
+
+struct ModbusException {
+  static const uint8_t FRAME_SIZE = 5;
+  static const uint8_t FUNCTION_FLAG = 0x80;
+
+  // Codes from the Modbus application protocol spec.
+  static const uint8_t ILLEGAL_FUNCTION = 0x01;
+  static const uint8_t ILLEGAL_DATA_ADDRESS = 0x02;
+  static const uint8_t ILLEGAL_DATA_VALUE = 0x03;
+  static const uint8_t SLAVE_DEVICE_FAILURE = 0x04;
+  static const uint8_t ACKNOWLEDGE = 0x05;
+  static const uint8_t SLAVE_DEVICE_BUSY = 0x06;
+  static const uint8_t MEMORY_PARITY_ERROR = 0x08;
+  static const uint8_t GATEWAY_PATH_UNAVAILABLE = 0x0A;
+  static const uint8_t GATEWAY_TARGET_FAILED = 0x0B;
+
+  uint8_t address;
+  uint8_t function;   // function of the rejected request (without 0x80)
+  uint8_t code;       // 0 = no exception
+
+  static const __FlashStringHelper *codeName(uint8_t code);
+
+  // True for codes a retry cannot change (0x01-0x04, 0x08, 0x0A, 0x0B).
+  static bool isFinal(uint8_t code);
+};
+
+class ModbusExceptionLog {
+public:
+  static const uint8_t MAX_DEVICES = MODBUS_EXCEPTION_MAX_DEVICES;
+
+  struct Device {
+    uint8_t address;
+    bool used;
+    uint8_t lastFunction;
+    uint8_t lastCode;
+    uint16_t count;        // saturates at 0xFFFF
+    uint32_t lastMs;
+  };
+
+  ModbusExceptionLog();
+
+  void record(const ModbusException &ex, uint32_t nowMs);
+
+  uint16_t count(uint8_t address) const;
+  uint32_t total() const { return _total; }
+
+  // Slots in use, for listing (index < MAX_DEVICES; unused slots are
+  // skipped by returning nullptr).
+  const Device *device(uint8_t index) const;
+
+  void reset();
+
+private:
+  Device _devices[MAX_DEVICES];
+  uint32_t _total;
+
+  int8_t indexOf(uint8_t address) const;
+};
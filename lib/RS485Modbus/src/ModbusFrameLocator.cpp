@@ -0,0 +1,91 @@
+#include "ModbusFrameLocator.h"
+#include <string.h>
+
+constexpr size_t ModbusFrameLocator::NOT_FOUND;
+
+size_t ModbusFrameLocator::find(const uint8_t *buf,
+                                size_t len,
+                                const uint8_t *prefix,
+                                size_t prefixLen,
+                                size_t frameLen,
+                                ModbusFrameSpan *spans,
+                                size_t maxSpans,
+                                ModbusLocatorStats *stats) {
+  if (stats) memset(stats, 0, sizeof(*stats));
+  if (!buf || frameLen < 3 || len < frameLen) return 0;
+  if (spans && maxSpans == 0) return 0;
+  if (!prefix) prefixLen = 0;
+  if (prefixLen > frameLen - 2) return 0;
+
+  const size_t dataLen = frameLen - 2;
+  const size_t lastOffset = len - frameLen;
+  const ModbusCrcWindow window(dataLen);
+
+  // CRC state of the window starting at crcOffset, valid when haveCrc.
+  bool haveCrc = false;
+  size_t crcOffset = 0;
+  uint16_t crc = 0;
+
+  size_t found = 0;
+  size_t offset = 0;
+
+  while (offset <= lastOffset) {
+    if (prefixLen > 0) {
+      // Jump to the next occurrence of the first prefix byte.
+      const void *hit = memchr(&buf[offset], prefix[0], lastOffset - offset + 1);
+      if (!hit) break;
+      offset = (size_t)((const uint8_t *)hit - buf);
+
+      if (prefixLen > 1 && memcmp(&buf[offset + 1], &prefix[1], prefixLen - 1) != 0) {
+        ++offset;
+        continue;
+      }
+    }
+
+    if (stats) ++stats->candidates;
+
+    if (haveCrc && crcOffset <= offset && (offset - crcOffset) <= dataLen) {
+      while (crcOffset < offset) {
+        crc = window.roll(crc, buf[crcOffset], buf[crcOffset + dataLen]);
+        ++crcOffset;
+        if (stats) ++stats->crcBytes;
+      }
+    } else {
+      crc = window.first(&buf[offset]);
+      crcOffset = offset;
+      haveCrc = true;
+      if (stats) stats->crcBytes += dataLen;
+    }
+
+    const uint16_t recv = (uint16_t)buf[offset + dataLen] |
+                          ((uint16_t)buf[offset + dataLen + 1] << 8);
+    if (crc != recv) {
+      ++offset;
+      continue;
+    }
+
+    if (spans) {
+      spans[found].offset = offset;
+      spans[found].length = frameLen;
+    }
+    ++found;
+    if (stats) stats->frames = found;
+    if (spans && found >= maxSpans) break;
+
+    offset += frameLen;
+  }
+
+  return found;
+}
+
+size_t ModbusFrameLocator::findFirst(const uint8_t *buf,
+                                     size_t len,
+                                     const uint8_t *prefix,
+                                     size_t prefixLen,
+                                     size_t frameLen) {
+  ModbusFrameSpan span;
+  if (find(buf, len, prefix, prefixLen, frameLen, &span, 1) == 0) {
+    return NOT_FOUND;
+  }
+  return span.offset;
+}
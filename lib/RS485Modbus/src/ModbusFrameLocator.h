@@ -0,0 +1,60 @@
+#pragma once
+#include <Arduino.h>
+#include "ModbusCrc16.h"
+
+/*
+  ModbusFrameLocator
+
+  Finds CRC-valid Modbus RTU frames of a known length inside a raw RX buffer
+  (echoes, noise, several slaves answering) in one linear pass:
+
+  - An offset becomes a candidate only if the buffer matches the expected
+    prefix (address / function / byte count) there. The prefix is checked
+    with a first-byte skip, so garbage costs one compare per byte.
+  - Candidates are CRC-checked with a ModbusCrcWindow. If the previous CRC
+    position is at most one frame behind, the CRC is rolled forward byte by
+    byte, otherwise it is computed fresh. Each buffer byte is therefore fed
+    to the CRC at most twice, even when every offset is a candidate.
+  - Frames do not overlap: after a hit the scan resumes behind that frame.
+
+  Worst-case cost is O(buffer + prefix * buffer) instead of
+  O(buffer * frame) for the old "full CRC at every offset" sweep.
+*/
+
+struct ModbusFrameSpan {
+  size_t offset;
+  size_t length;
+};
+
+// Optional counters for benchmarks and debug logs.
+struct ModbusLocatorStats {
+  size_t candidates;  // offsets whose prefix matched
+  size_t crcBytes;    // bytes pushed through the CRC (fresh + rolled)
+  size_t frames;      // CRC-valid frames found
+};
+
+class ModbusFrameLocator {
+public:
+  // Scans buf[0 .. len) for frames of frameLen bytes starting with prefix.
+  // prefix may be null / prefixLen 0 to accept any CRC-valid window.
+  // Up to maxSpans hits are written to spans (which may be null to count
+  // only). Returns the number of frames found, stopping at maxSpans when
+  // spans is given.
+  static size_t find(const uint8_t *buf,
+                     size_t len,
+                     const uint8_t *prefix,
+                     size_t prefixLen,
+                     size_t frameLen,
+                     ModbusFrameSpan *spans,
+                     size_t maxSpans,
+                     ModbusLocatorStats *stats = nullptr);
+
+  // Convenience wrapper: offset of the first frame, or (size_t)-1.
+  static size_t findFirst(const uint8_t *buf,
+                          size_t len,
+                          const uint8_t *prefix,
+                          size_t prefixLen,
+                          size_t frameLen);
+
+  static constexpr size_t NOT_FOUND = (size_t)-1;
+};
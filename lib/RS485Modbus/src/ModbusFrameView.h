@@ -0,0 +1,73 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  ModbusFrameView
+
+  Read-only window onto one located response frame inside the RS485Bus
+  RX buffer, filled by RS485Bus::transact(). Nothing is copied: the view
+  points into the bus buffer and is valid until the next read on that
+  bus (transact, SendRequest or Read_RS485).
+
+    ModbusFrameView frame;
+    if (bus.transact(request, 8, 9, check, 3, frame)) {
+      const uint16_t humidity = frame.u16(0);   // first register of the read
+      const int16_t temp = frame.s16(1);
+    }
+
+  Register accessors take an index relative to the first register of the
+  read and decode big-endian words from the data bytes between the
+  [addr][fc][byteCount] header and the CRC. Indexes outside the frame
+  return 0; check hasRegisters() first when that matters.
+*/
+
+class ModbusFrameView {
+public:
+  static const size_t HEADER_SIZE = 3;  // addr, function, byte count
+  static const size_t CRC_SIZE = 2;
+
+  ModbusFrameView() : _data(nullptr), _len(0) {}
+  ModbusFrameView(const uint8_t *data, size_t len) : _data(data), _len(data ? len : 0) {}
+
+  void clear() {
+    _data = nullptr;
+    _len = 0;
+  }
+
+  bool valid() const { return _data != nullptr && _len >= HEADER_SIZE + CRC_SIZE; }
+
+  // Whole frame, CRC included.
+  const uint8_t *data() const { return _data; }
+  size_t length() const { return _len; }
+
+  uint8_t byteAt(size_t index) const { return (index < _len) ? _data[index] : 0; }
+  uint8_t address() const { return byteAt(0); }
+  uint8_t function() const { return byteAt(1); }
+
+  // Data words of a 0x03 / 0x04 reply.
+  size_t registerCount() const { return valid() ? (_len - HEADER_SIZE - CRC_SIZE) / 2U : 0; }
+
+  bool hasRegisters(size_t index, size_t count = 1) const {
+    return index + count <= registerCount();
+  }
+
+  uint16_t u16(size_t index) const {
+    if (!hasRegisters(index)) return 0;
+    const uint8_t *p = &_data[HEADER_SIZE + index * 2U];
+    return ((uint16_t)p[0] << 8) | p[1];
+  }
+
+  int16_t s16(size_t index) const { return (int16_t)u16(index); }
+
+  // Two registers, high word first.
+  uint32_t u32(size_t index) const {
+    if (!hasRegisters(index, 2)) return 0;
+    return ((uint32_t)u16(index) << 16) | u16(index + 1);
+  }
+
+  int32_t s32(size_t index) const { return (int32_t)u32(index); }
+
+private:
+  const uint8_t *_data;
+  size_t _len;
+};
@@ -0,0 +1,180 @@
+#include "ModbusLatencyTracker.h"
+#include <string.h>
+
+const uint16_t ModbusLatencyTracker::BUCKET_EDGES_MS[ModbusLatencyTracker::BUCKETS] = {
+  2, 4, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 0xFFFF
+};
+
+ModbusLatencyTracker::ModbusLatencyTracker() {
+  reset();
+}
+
+void ModbusLatencyTracker::reset() {
+  memset(_devices, 0, sizeof(_devices));
+  _useSeq = 0;
+}
+
+void ModbusLatencyTracker::reset(uint8_t address) {
+  const int8_t index = indexOf(address);
+  if (index >= 0) _devices[index].used = false;
+}
+
+// ============================================================================
+// Slot lookup
+// ============================================================================
+int8_t ModbusLatencyTracker::indexOf(uint8_t address) const {
+  for (uint8_t i = 0; i < MAX_DEVICES; ++i) {
+    if (_devices[i].used && _devices[i].address == address) return (int8_t)i;
+  }
+  return -1;
+}
+
+const ModbusLatencyTracker::Device *ModbusLatencyTracker::find(uint8_t address) const {
+  const int8_t index = indexOf(address);
+  return (index >= 0) ? &_devices[index] : nullptr;
+}
+
+ModbusLatencyTracker::Device &ModbusLatencyTracker::findOrAdd(uint8_t address) {
+  const int8_t index = indexOf(address);
+  Device *dev = (index >= 0) ? &_devices[index] : nullptr;
+
+  if (!dev) {
+    // Free slot first, otherwise the least recently used one.
+    dev = &_devices[0];
+    for (uint8_t i = 0; i < MAX_DEVICES; ++i) {
+      if (!_devices[i].used) {
+        dev = &_devices[i];
+        break;
+      }
+      if (_devices[i].lastUseSeq < dev->lastUseSeq) dev = &_devices[i];
+    }
+
+    memset(dev, 0, sizeof(*dev));
+    dev->used = true;
+    dev->address = address;
+    dev->wideProbeAt = RESET_MISSES;
+  }
+
+  dev->lastUseSeq = ++_useSeq;
+  return *dev;
+}
+
+void ModbusLatencyTracker::clearHistogram(Device &dev) {
+  memset(dev.firstByte, 0, sizeof(dev.firstByte));
+  memset(dev.lastByte, 0, sizeof(dev.lastByte));
+  dev.samples = 0;
+}
+
+// ============================================================================
+// Histogram helpers
+// ============================================================================
+uint8_t ModbusLatencyTracker::bucketFor(uint32_t us) {
+  const uint32_t ms = (us + 999UL) / 1000UL;
+  for (uint8_t i = 0; i < BUCKETS - 1; ++i) {
+    if (ms <= BUCKET_EDGES_MS[i]) return i;
+  }
+  return BUCKETS - 1;
+}
+
+void ModbusLatencyTracker::addSample(uint8_t counts[BUCKETS], uint8_t bucket) {
+  if (counts[bucket] == 0xFF) {
+    for (uint8_t i = 0; i < BUCKETS; ++i) counts[i] >>= 1;
+  }
+  ++counts[bucket];
+}
+
+uint16_t ModbusLatencyTracker::percentileEdge(const uint8_t counts[BUCKETS], uint8_t percentile) {
+  uint16_t total = 0;
+  for (uint8_t i = 0; i < BUCKETS; ++i) total += counts[i];
+  if (total == 0) return 0;
+
+  const uint32_t target = ((uint32_t)total * percentile + 99U) / 100U;
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < BUCKETS; ++i) {
+    seen += counts[i];
+    if (seen >= target) return BUCKET_EDGES_MS[i];
+  }
+  return BUCKET_EDGES_MS[BUCKETS - 1];
+}
+
+bool ModbusLatencyTracker::isWideProbe(const Device &dev) {
+  return dev.missStreak >= dev.wideProbeAt;
+}
+
+// ============================================================================
+// timeoutFor / isLearned
+// ============================================================================
+uint16_t ModbusLatencyTracker::timeoutFor(uint8_t address, uint16_t fallbackMs) const {
+  const Device *dev = find(address);
+  if (!dev || dev->samples < MIN_SAMPLES || isWideProbe(*dev)) return fallbackMs;
+
+  const uint16_t edge = percentileEdge(dev->lastByte, MODBUS_LATENCY_PERCENTILE);
+  if (edge == 0xFFFF) return fallbackMs;
+
+  // Margin: fixed floor, or a quarter of the edge for slow devices.
+  uint16_t margin = edge / 4;
+  if (margin < MODBUS_LATENCY_MARGIN_MS) margin = MODBUS_LATENCY_MARGIN_MS;
+
+  uint32_t timeoutMs = (uint32_t)edge + margin;
+  if (timeoutMs < MODBUS_LATENCY_MIN_TIMEOUT_MS) timeoutMs = MODBUS_LATENCY_MIN_TIMEOUT_MS;
+  if (timeoutMs > fallbackMs) timeoutMs = fallbackMs;
+  return (uint16_t)timeoutMs;
+}
+
+bool ModbusLatencyTracker::isLearned(uint8_t address) const {
+  const Device *dev = find(address);
+  return dev && dev->samples >= MIN_SAMPLES;
+}
+
+// ============================================================================
+// recordReply / recordMiss
+// ============================================================================
+void ModbusLatencyTracker::recordReply(uint8_t address, uint32_t firstByteUs, uint32_t lastByteUs) {
+  Device &dev = findOrAdd(address);
+
+  // A reply to a wide probe after a run of misses: the old numbers were
+  // wrong for this device, start over from here.
+  if (isWideProbe(dev)) clearHistogram(dev);
+
+  dev.missStreak = 0;
+  dev.wideProbeAt = RESET_MISSES;
+
+  addSample(dev.firstByte, bucketFor(firstByteUs));
+  addSample(dev.lastByte, bucketFor(lastByteUs));
+  if (dev.samples < 0xFFFF) ++dev.samples;
+}
+
+void ModbusLatencyTracker::recordMiss(uint8_t address) {
+  Device &dev = findOrAdd(address);
+
+  if (isWideProbe(dev)) {
+    // Wide probe missed as well: the device is silent, not slow. Keep the
+    // learned timeout and space the next wide probe further out.
+    dev.missStreak = 0;
+    uint16_t spacing = (uint16_t)dev.wideProbeAt * 2U;
+    if (spacing > WIDE_PROBE_MAX_SPACING) spacing = WIDE_PROBE_MAX_SPACING;
+    dev.wideProbeAt = (uint8_t)spacing;
+    return;
+  }
+
+  if (dev.missStreak < 0xFF) ++dev.missStreak;
+}
+
+// ============================================================================
+// Diagnostics
+// ============================================================================
+uint16_t ModbusLatencyTracker::percentileMs(uint8_t address, uint8_t percentile, bool lastByte) const {
+  const Device *dev = find(address);
+  if (!dev || dev->samples == 0) return 0;
+  return percentileEdge(lastByte ? dev->lastByte : dev->firstByte, percentile);
+}
+
+uint16_t ModbusLatencyTracker::sampleCount(uint8_t address) const {
+  const Device *dev = find(address);
+  return dev ? dev->samples : 0;
+}
+
+uint8_t ModbusLatencyTracker::missStreak(uint8_t address) const {
+  const Device *dev = find(address);
+  return dev ? dev->missStreak : 0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  ModbusLatencyTracker
+
+  Learns how fast each slave address answers and turns that into a read
+  timeout for the next transaction. RS485Bus feeds it after every
+  SendRequest() attempt.
+
+  Per address it keeps two small histograms over log-spaced buckets:
+  - first byte: end of TX -> first reply byte (device turnaround)
+  - last byte:  end of TX -> last reply byte (turnaround + frame time)
+
+  Once MIN_SAMPLES replies are in, the timeout is the bucket edge at the
+  P-th percentile of last-byte times plus a margin, clamped to
+  [MIN_TIMEOUT_MS, caller's timeout]. Before that, the caller's timeout is
+  used unchanged. A reply only ends the read early anyway, so the learned
+  value only matters when the device does not answer: an unplugged sensor
+  then costs tens of milliseconds per attempt instead of seconds.
+
+  Repeated misses might mean the learned value is too tight (device got
+  slower, converter added latency). After RESET_MISSES misses in a row one
+  attempt uses the caller's full timeout; the spacing of these wide probes
+  doubles up to WIDE_PROBE_MAX_SPACING while the device stays silent. A
+  wide probe that gets a reply clears the histograms and learning starts
+  over from that sample.
+
+  Counts are 8-bit and all halved when one saturates, so old behaviour
+  fades out instead of pinning the percentile forever.
+*/
+
+#if !defined(MODBUS_LATENCY_MAX_DEVICES)
+  #if defined(ARDUINO_ARCH_AVR)
+    #define MODBUS_LATENCY_MAX_DEVICES 4
+  #else
+    #define MODBUS_LATENCY_MAX_DEVICES 16
+  #endif
+#endif
+
+#if !defined(MODBUS_LATENCY_PERCENTILE)
+  #define MODBUS_LATENCY_PERCENTILE 95
+#endif
+
+#if !defined(MODBUS_LATENCY_MARGIN_MS)
+  #define MODBUS_LATENCY_MARGIN_MS 10
+#endif
+
+#if !defined(MODBUS_LATENCY_MIN_TIMEOUT_MS)
+  #define MODBUS_LATENCY_MIN_TIMEOUT_MS 20
+#endif
+
+class ModbusLatencyTracker {
+public:
+  static const uint8_t MAX_DEVICES = MODBUS_LATENCY_MAX_DEVICES;
+  static const uint8_t BUCKETS = 16;
+  static const uint8_t MIN_SAMPLES = 8;
+  static const uint8_t RESET_MISSES = 3;
+  static const uint8_t WIDE_PROBE_MAX_SPACING = 64;
+
+  // Upper edge of each bucket in ms; the last bucket is open-ended.
+  static const uint16_t BUCKET_EDGES_MS[BUCKETS];
+
+  ModbusLatencyTracker();
+
+  // Timeout for the next attempt to `address`. fallbackMs is the caller's
+  // timeout; it is returned while learning and for wide probes, and is
+  // never exceeded.
+  uint16_t timeoutFor(uint8_t address, uint16_t fallbackMs) const;
+
+  // True once the address has MIN_SAMPLES replies behind it.
+  bool isLearned(uint8_t address) const;
+
+  void recordReply(uint8_t address, uint32_t firstByteUs, uint32_t lastByteUs);
+  void recordMiss(uint8_t address);
+
+  void reset();
+  void reset(uint8_t address);
+
+  // Diagnostics. Return 0 when the address has no learned data.
+  uint16_t percentileMs(uint8_t address, uint8_t percentile, bool lastByte = true) const;
+  uint16_t sampleCount(uint8_t address) const;
+  uint8_t missStreak(uint8_t address) const;
+
+private:
+  struct Device {
+    uint8_t address;
+    bool used;
+    uint8_t firstByte[BUCKETS];
+    uint8_t lastByte[BUCKETS];
+    uint16_t samples;
+    uint8_t missStreak;
+    uint8_t wideProbeAt;   // missStreak value that triggers the next wide probe
+    uint32_t lastUseSeq;   // for replacing the least recently used slot
+  };
+
+  Device _devices[MAX_DEVICES];
+  uint32_t _useSeq;
+
+  int8_t indexOf(uint8_t address) const;
+  const Device *find(uint8_t address) const;
+  Device &findOrAdd(uint8_t address);
+  void clearHistogram(Device &dev);
+
+  static uint8_t bucketFor(uint32_t us);
+  static void addSample(uint8_t counts[BUCKETS], uint8_t bucket);
+  static uint16_t percentileEdge(const uint8_t counts[BUCKETS], uint8_t percentile);
+  static bool isWideProbe(const Device &dev);
+};
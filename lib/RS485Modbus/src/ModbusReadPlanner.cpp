@@ -0,0 +1,77 @@
+#include "ModbusReadPlanner.h"
+
+constexpr uint16_t ModbusReadPlanner::MAX_REGS_PER_READ;
+constexpr size_t ModbusReadPlanner::REQUEST_SIZE;
+
+size_t ModbusReadPlanner::plan(const ModbusRegisterRange ranges[],
+                               size_t rangeCount,
+                               uint16_t maxGapRegs,
+                               uint16_t maxBlockRegs,
+                               ModbusReadBlock blocks[],
+                               size_t maxBlocks) {
+  if (!ranges || !blocks || rangeCount == 0 || maxBlocks == 0) return 0;
+  if (maxBlockRegs == 0 || maxBlockRegs > MAX_REGS_PER_READ) {
+    maxBlockRegs = MAX_REGS_PER_READ;
+  }
+
+  size_t blockCount = 0;
+
+  // Greedy merge in start order. Driver range lists are a handful of
+  // entries, so picking the next-lowest start each round is cheaper than
+  // sorting a copy.
+  uint32_t lastStart = 0;
+  size_t lastIndex = (size_t)-1;
+
+  for (size_t picked = 0; picked < rangeCount; ++picked) {
+    size_t next = (size_t)-1;
+    for (size_t i = 0; i < rangeCount; ++i) {
+      if (ranges[i].count == 0) continue;
+      const uint32_t start = ranges[i].start;
+      const bool afterLast = (lastIndex == (size_t)-1) || start > lastStart ||
+                             (start == lastStart && i > lastIndex);
+      if (!afterLast) continue;
+      if (next == (size_t)-1 || start < ranges[next].start) {
+        next = i;
+      }
+    }
+    if (next == (size_t)-1) break;
+
+    lastStart = ranges[next].start;
+    lastIndex = next;
+
+    const uint32_t start = ranges[next].start;
+    const uint32_t end = start + ranges[next].count;  // exclusive
+    if (ranges[next].count > maxBlockRegs) return 0;
+
+    if (blockCount > 0) {
+      ModbusReadBlock &cur = blocks[blockCount - 1];
+      const uint32_t curEnd = (uint32_t)cur.start + cur.count;
+      const uint32_t mergedEnd = (end > curEnd) ? end : curEnd;
+
+      if (start <= curEnd + maxGapRegs && (mergedEnd - cur.start) <= maxBlockRegs) {
+        cur.count = (uint16_t)(mergedEnd - cur.start);
+        continue;
+      }
+    }
+
+    if (blockCount >= maxBlocks) return 0;
+    blocks[blockCount].start = (uint16_t)start;
+    blocks[blockCount].count = (uint16_t)(end - start);
+    ++blockCount;
+  }
+
+  return blockCount;
+}
+
+void ModbusReadPlanner::buildRequest(uint8_t address,
+                                     const ModbusReadBlock &block,
+                                     uint8_t request[REQUEST_SIZE]) {
+  request[0] = address;
+  request[1] = FUNCTION_READ_HOLDING;
+  request[2] = (uint8_t)(block.start >> 8);
+  request[3] = (uint8_t)(block.start & 0xFF);
+  request[4] = (uint8_t)(block.count >> 8);
+  request[5] = (uint8_t)(block.count & 0xFF);
+  request[6] = 0x00;
+  request[7] = 0x00;
+}
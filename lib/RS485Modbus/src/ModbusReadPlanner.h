@@ -0,0 +1,68 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  ModbusReadPlanner
+
+  Coalesces the register ranges a driver needs into as few function 0x03
+  (read holding registers) transactions as possible.
+
+  Ranges whose distance is at most maxGapRegs are merged into one block,
+  as long as the block stays within maxBlockRegs. Gap registers are read and
+  ignored. maxGapRegs = 0 merges only touching ranges, which is the safe
+  "split" plan for devices that reject reads across unmapped registers.
+
+  Helpers build the 8-byte request for a block and pull a register value
+  out of the block's response frame (addr, fc, byteCount, data..., crc).
+*/
+
+struct ModbusRegisterRange {
+  uint16_t start;
+  uint16_t count;
+};
+
+struct ModbusReadBlock {
+  uint16_t start;
+  uint16_t count;
+};
+
+class ModbusReadPlanner {
+public:
+  static constexpr uint8_t FUNCTION_READ_HOLDING = 0x03;
+
+  // Modbus limits one 0x03 response to 125 registers.
+  static constexpr uint16_t MAX_REGS_PER_READ = 125;
+
+  static constexpr size_t REQUEST_SIZE = 8;
+
+  // Response size for a block of `count` registers.
+  static constexpr size_t responseSize(uint16_t count) {
+    return (size_t)5 + (size_t)count * 2U;
+  }
+
+  // Builds blocks from `ranges` (any order, may overlap). Returns the number
+  // of blocks written, or 0 if they do not fit in maxBlocks.
+  static size_t plan(const ModbusRegisterRange ranges[],
+                     size_t rangeCount,
+                     uint16_t maxGapRegs,
+                     uint16_t maxBlockRegs,
+                     ModbusReadBlock blocks[],
+                     size_t maxBlocks);
+
+  // Request frame for one block; CRC bytes are left zero for SendRequest().
+  static void buildRequest(uint8_t address,
+                           const ModbusReadBlock &block,
+                           uint8_t request[REQUEST_SIZE]);
+
+  static bool contains(const ModbusReadBlock &block, const ModbusRegisterRange &range) {
+    return range.start >= block.start &&
+           (uint32_t)range.start + range.count <= (uint32_t)block.start + block.count;
+  }
+
+  // Pointer to the big-endian bytes of `reg` inside a block response frame.
+  static const uint8_t *registerBytes(const uint8_t frame[],
+                                      const ModbusReadBlock &block,
+                                      uint16_t reg) {
+    return &frame[3 + (size_t)(reg - block.start) * 2U];
+  }
+};
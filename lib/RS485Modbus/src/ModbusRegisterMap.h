@@ -0,0 +1,203 @@
+#pragma once
+#include <Arduino.h>
+#include "ModbusReadPlanner.h"
+#include "ModbusFrameView.h"
+#include "ModbusRequestFrame.h"
+#include "FixedSample.h"
+
+/*
+  ModbusRegisterMap / ModbusRegisterDecoder
+
+  Declarative description of one function 0x03 read: the register block
+  plus, per field, register, word type, scaling, hard bounds (see
+  docs/protocols/range_protection.md) and unit.
+
+    static constexpr ModbusRegisterMap<2> LEAF_MAP = {
+      0x0000, 2, {
+        {0x0000, MODBUS_FIELD_U16, 10.0, 0.0,   0.0, 100.0, SAMPLE_UNIT_PERCENT_RH},
+        {0x0001, MODBUS_FIELD_S16, 10.0, 0.0, -40.0,  80.0, SAMPLE_UNIT_CELSIUS}
+      }
+    };
+    static_assert(LEAF_MAP.isValid(), "LEAF_MAP field outside block");
+
+  value = raw / divisor + offset, written in engineering units as in the
+  datasheet. The divisor must be a power of ten (1 .. 10^4): the
+  constexpr constructor turns it into decimal places and the offset and
+  bounds into integers at that scale, so nothing of the double survives
+  into the firmware. Bounds 0.0 .. 100.0 at divisor 10 become 0 .. 1000,
+  the raw range the protocol files list.
+
+  ModbusRegisterDecoder::decode() turns one response frame into N
+  FixedSample values in a single loop and returns a bitmask of fields
+  inside their hard bounds; integer adds and compares only. No heap, no
+  virtual calls; the map is usually constexpr data. It reads either a
+  copied response array or a ModbusFrameView straight from the bus
+  buffer.
+*/
+
+enum ModbusFieldType : uint8_t {
+  MODBUS_FIELD_U16 = 0,
+  MODBUS_FIELD_S16,
+  MODBUS_FIELD_U32,  // two registers, high word first
+  MODBUS_FIELD_S32   // two registers, high word first
+};
+
+struct ModbusFieldSpec {
+  // Marks a divisor that is not a power of ten; isValid() rejects it.
+  static constexpr uint8_t BAD_SCALE = 0xFF;
+
+  uint16_t reg;
+  ModbusFieldType type;
+  uint8_t decimals;   // log10(divisor)
+  uint8_t unit;       // SampleUnit
+  int32_t offset;     // engineering offset * 10^decimals
+  int32_t minValue;   // hard bounds * 10^decimals
+  int32_t maxValue;
+
+  constexpr ModbusFieldSpec(uint16_t reg,
+                            ModbusFieldType type,
+                            double divisor,
+                            double offset,
+                            double minValue,
+                            double maxValue,
+                            uint8_t unit = SAMPLE_UNIT_NONE)
+      : reg(reg),
+        type(type),
+        decimals(decimalsFor(divisor)),
+        unit(unit),
+        offset(toScaled(offset, divisor)),
+        minValue(toScaled(minValue, divisor)),
+        maxValue(toScaled(maxValue, divisor)) {}
+
+  constexpr uint8_t registerCount() const {
+    return (type == MODBUS_FIELD_U32 || type == MODBUS_FIELD_S32) ? 2 : 1;
+  }
+
+  constexpr FixedSample sample(int32_t scaled) const {
+    return FixedSample::make(scaled, decimals, unit);
+  }
+
+  constexpr FixedSample fallback() const {
+    return FixedSample::fallback(decimals, unit);
+  }
+
+  static constexpr uint8_t decimalsFor(double divisor, uint8_t d = 0) {
+    return (d > FIXED_SAMPLE_MAX_DECIMALS) ? BAD_SCALE
+           : (divisor == (double)FixedSample::pow10(d)) ? d
+           : decimalsFor(divisor, (uint8_t)(d + 1));
+  }
+
+  // Rounded, so 0.1 * 10 lands on 1 and not 0.
+  static constexpr int32_t toScaled(double value, double divisor) {
+    return (int32_t)(value * divisor + (value < 0.0 ? -0.5 : 0.5));
+  }
+};
+
+template <size_t N>
+struct ModbusRegisterMap {
+  uint16_t start;
+  uint16_t count;
+  ModbusFieldSpec fields[N];
+
+  static constexpr size_t FIELD_COUNT = N;
+
+  // Mask with one bit per field, as returned by a fully valid decode().
+  static constexpr uint32_t allFieldsMask() {
+    return (N >= 32) ? 0xFFFFFFFFUL : ((1UL << N) - 1UL);
+  }
+
+  constexpr ModbusReadBlock block() const {
+    return ModbusReadBlock{start, count};
+  }
+
+  // The finished read request for one address, CRC included.
+  constexpr ModbusRequestFrame request(uint8_t address) const {
+    return ModbusRequestFrame::read(address, start, count);
+  }
+
+  constexpr size_t responseSize() const {
+    return ModbusReadPlanner::responseSize(count);
+  }
+
+  constexpr uint8_t byteCount() const {
+    return (uint8_t)(count * 2U);
+  }
+
+  // Every field lies inside [start, start + count) and has a power-of-ten divisor.
+  constexpr bool isValid(size_t i = 0) const {
+    return (N <= 32) && (count > 0) && (count <= ModbusReadPlanner::MAX_REGS_PER_READ) &&
+           (i >= N || (fields[i].reg >= start &&
+                       (uint32_t)fields[i].reg + fields[i].registerCount() <=
+                           (uint32_t)start + count &&
+                       fields[i].decimals != ModbusFieldSpec::BAD_SCALE &&
+                       isValid(i + 1)));
+  }
+};
+
+class ModbusRegisterDecoder {
+public:
+  // Raw integer value of one field, sign-extended per its type.
+  static int32_t rawValue(const ModbusFieldSpec &field,
+                          const uint8_t frame[],
+                          uint16_t blockStart) {
+    const uint8_t *p = &frame[3 + (size_t)(field.reg - blockStart) * 2U];
+    const uint16_t hi = ((uint16_t)p[0] << 8) | p[1];
+
+    switch (field.type) {
+      case MODBUS_FIELD_S16:
+        return (int32_t)(int16_t)hi;
+      case MODBUS_FIELD_U32:
+      case MODBUS_FIELD_S32:
+        return (int32_t)(((uint32_t)hi << 16) | ((uint32_t)p[2] << 8) | p[3]);
+      case MODBUS_FIELD_U16:
+      default:
+        return (int32_t)hi;
+    }
+  }
+
+  // Field value at the field's scale. U32 above INT32_MAX saturates
+  // (no bound in the tree gets near it).
+  static FixedSample sample(const ModbusFieldSpec &field, int32_t raw) {
+    if (field.type == MODBUS_FIELD_U32 && raw < 0) return field.sample(0x7FFFFFFFL);
+    return field.sample(raw + field.offset);
+  }
+
+  static bool inBounds(const ModbusFieldSpec &field, int32_t scaled) {
+    return scaled >= field.minValue && scaled <= field.maxValue;
+  }
+
+  // A sample at any scale against the field's bounds.
+  static bool inBounds(const ModbusFieldSpec &field, const FixedSample &value) {
+    return inBounds(field, value.decimals == field.decimals ? value.raw : value.scaledTo(field.decimals));
+  }
+
+  // frame is a full response (addr, fc, byteCount, data..., crc) for
+  // map.block(). Writes every field to out[] and returns the in-bounds mask.
+  template <size_t N>
+  static uint32_t decode(const ModbusRegisterMap<N> &map,
+                         const uint8_t frame[],
+                         FixedSample out[N]) {
+    uint32_t okMask = 0;
+    for (size_t i = 0; i < N; ++i) {
+      const ModbusFieldSpec &field = map.fields[i];
+      out[i] = sample(field, rawValue(field, frame, map.start));
+      if (inBounds(field, out[i].raw)) {
+        okMask |= (1UL << i);
+      }
+    }
+    return okMask;
+  }
+
+  // Same, straight from the bus RX buffer. A frame too short for the
+  // block decodes to zeros at each field's scale and an empty mask.
+  template <size_t N>
+  static uint32_t decode(const ModbusRegisterMap<N> &map,
+                         const ModbusFrameView &frame,
+                         FixedSample out[N]) {
+    if (!frame.hasRegisters(0, map.count)) {
+      for (size_t i = 0; i < N; ++i) out[i] = map.fields[i].sample(0);
+      return 0;
+    }
+    return decode(map, frame.data(), out);
+  }
+};
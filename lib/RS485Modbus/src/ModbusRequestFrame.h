@@ -0,0 +1,70 @@
+#pragma once
+#include <Arduino.h>
+#include "ModbusCrc16.h"
+
+/*
+  ModbusRequestFrame
+
+  A complete 8-byte Modbus RTU request (0x03 / 0x04 read, 0x06 write
+  single) with its CRC already in place. The builders are constexpr, so
+  for a fixed address the compiler produces the finished frame:
+
+    constexpr ModbusRequestFrame READ_TH = ModbusRequestFrame::read(0x01, 0x0000, 2);
+
+  A driver whose address is only known at run time keeps its frames as
+  members, rebuilt in the constructor and in setAddress(). Polls and
+  retries hand them to RS485Bus::transact(const ModbusRequestFrame &, ...),
+  which sends them as they are: no CRC work and no request array per
+  attempt.
+*/
+struct ModbusRequestFrame {
+  static constexpr size_t SIZE = 8;
+  static constexpr uint8_t FUNCTION_READ_HOLDING = 0x03;
+  static constexpr uint8_t FUNCTION_READ_INPUT = 0x04;
+  static constexpr uint8_t FUNCTION_WRITE_SINGLE = 0x06;
+
+  uint8_t bytes[SIZE];
+
+  static constexpr ModbusRequestFrame make(uint8_t address, uint8_t function, uint16_t reg, uint16_t value) {
+    return assemble(address, function, reg, value,
+                    ModbusCrc16::byteStep(
+                        ModbusCrc16::byteStep(
+                            ModbusCrc16::byteStep(
+                                ModbusCrc16::byteStep(
+                                    ModbusCrc16::byteStep(
+                                        ModbusCrc16::byteStep(ModbusCrc16::INIT, address),
+                                        function),
+                                    (uint8_t)(reg >> 8)),
+                                (uint8_t)(reg & 0xFF)),
+                            (uint8_t)(value >> 8)),
+                        (uint8_t)(value & 0xFF)));
+  }
+
+  static constexpr ModbusRequestFrame read(uint8_t address, uint16_t reg, uint16_t count,
+                                           uint8_t function = FUNCTION_READ_HOLDING) {
+    return make(address, function, reg, count);
+  }
+
+  static constexpr ModbusRequestFrame writeSingle(uint8_t address, uint16_t reg, uint16_t value) {
+    return make(address, FUNCTION_WRITE_SINGLE, reg, value);
+  }
+
+  constexpr uint8_t address() const { return bytes[0]; }
+  constexpr uint8_t function() const { return bytes[1]; }
+  constexpr uint16_t reg() const { return (uint16_t)(((uint16_t)bytes[2] << 8) | bytes[3]); }
+  // Register count for reads, value for writes.
+  constexpr uint16_t value() const { return (uint16_t)(((uint16_t)bytes[4] << 8) | bytes[5]); }
+  constexpr uint16_t crc() const { return (uint16_t)(bytes[6] | ((uint16_t)bytes[7] << 8)); }
+
+  // Reply to a read: [addr][fc][byteCount][data...][crc].
+  constexpr uint8_t readByteCount() const { return (uint8_t)(value() * 2U); }
+  constexpr size_t readResponseSize() const { return (size_t)5 + (size_t)value() * 2U; }
+
+  static constexpr ModbusRequestFrame assemble(uint8_t address, uint8_t function, uint16_t reg,
+                                               uint16_t value, uint16_t crc) {
+    return ModbusRequestFrame{{address, function,
+                               (uint8_t)(reg >> 8), (uint8_t)(reg & 0xFF),
+                               (uint8_t)(value >> 8), (uint8_t)(value & 0xFF),
+                               (uint8_t)(crc & 0xFF), (uint8_t)(crc >> 8)}};
+  }
+};
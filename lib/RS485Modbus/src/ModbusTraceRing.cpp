@@ -0,0 +1,224 @@
+#include "ModbusTraceRing.h"
+#include "ModbusCrc16.h"
+
+static const char TRACE_MAGIC[8] = {'R', 'S', '4', '8', '5', 'T', 'R', 'C'};
+
+static void putU16(uint8_t *p, uint16_t value) {
+  p[0] = (uint8_t)(value & 0xFF);
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static void putU32(uint8_t *p, uint32_t value) {
+  p[0] = (uint8_t)(value & 0xFF);
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+}
+
+ModbusTraceRing::ModbusTraceRing() : _enabled(true) {
+  clear();
+}
+
+void ModbusTraceRing::clear() {
+  _head = 0;
+  _tail = 0;
+  _used = 0;
+  _records = 0;
+  _dropped = 0;
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+void ModbusTraceRing::recordTx(uint8_t channel, const uint8_t *data, size_t len) {
+  append(TRACE_TX, channel, 0, nullptr, 0, data, len);
+}
+
+void ModbusTraceRing::recordRx(uint8_t channel,
+                               uint8_t endReason,
+                               uint32_t firstByteUs,
+                               uint32_t lastByteUs,
+                               uint32_t frameGapUs,
+                               const uint8_t *data,
+                               size_t len) {
+  uint8_t timing[12];
+  putU32(&timing[0], firstByteUs);
+  putU32(&timing[4], lastByteUs);
+  putU32(&timing[8], frameGapUs);
+  append(TRACE_RX, channel, endReason, timing, sizeof(timing), data, len);
+}
+
+void ModbusTraceRing::recordGap(uint8_t channel, uint32_t silenceUs, uint16_t rxOffset) {
+  uint8_t payload[6];
+  putU32(&payload[0], silenceUs);
+  putU16(&payload[4], rxOffset);
+  append(TRACE_GAP, channel, 0, payload, sizeof(payload), nullptr, 0);
+}
+
+void ModbusTraceRing::recordVerdict(uint8_t channel,
+                                    Verdict verdict,
+                                    uint8_t address,
+                                    uint8_t function,
+                                    uint16_t frameOffset,
+                                    uint8_t attempt,
+                                    uint16_t crcBytes) {
+  uint8_t payload[7];
+  payload[0] = address;
+  payload[1] = function;
+  putU16(&payload[2], frameOffset);
+  payload[4] = attempt;
+  putU16(&payload[5], crcBytes);
+  append(TRACE_VERDICT, channel, verdict, payload, sizeof(payload), nullptr, 0);
+}
+
+void ModbusTraceRing::append(uint8_t type,
+                             uint8_t channel,
+                             uint8_t aux,
+                             const uint8_t *prefix,
+                             size_t prefixLen,
+                             const uint8_t *data,
+                             size_t dataLen) {
+  if (!_enabled) return;
+
+  const size_t limit = maxPayload();
+  if (prefixLen > limit) return;
+  if (!data) dataLen = 0;
+  if (prefixLen + dataLen > limit) {
+    dataLen = limit - prefixLen;
+    type |= FLAG_TRUNCATED;
+  }
+
+  const size_t payloadLen = prefixLen + dataLen;
+  const size_t need = HEADER_SIZE + payloadLen;
+  while (RING_BYTES - _used < need) {
+    dropOldest();
+  }
+
+  uint8_t header[HEADER_SIZE];
+  header[0] = type;
+  header[1] = channel;
+  header[2] = (uint8_t)payloadLen;
+  header[3] = aux;
+  putU32(&header[4], (uint32_t)micros());
+
+  for (size_t i = 0; i < HEADER_SIZE; ++i) put(header[i]);
+  for (size_t i = 0; i < prefixLen; ++i) put(prefix[i]);
+  for (size_t i = 0; i < dataLen; ++i) put(data[i]);
+
+  ++_records;
+}
+
+void ModbusTraceRing::dropOldest() {
+  if (_records == 0) return;
+  const size_t len = HEADER_SIZE + at(2);
+  _tail = (_tail + len) % RING_BYTES;
+  _used -= len;
+  --_records;
+  ++_dropped;
+}
+
+void ModbusTraceRing::put(uint8_t value) {
+  _buf[_head] = value;
+  _head = (_head + 1) % RING_BYTES;
+  ++_used;
+}
+
+// ============================================================================
+// Export
+// ============================================================================
+namespace {
+
+struct BinarySink {
+  Print &out;
+  uint16_t crc;
+  size_t written;
+
+  explicit BinarySink(Print &o) : out(o), crc(ModbusCrc16::INIT), written(0) {}
+
+  void magic() {
+    for (size_t i = 0; i < sizeof(TRACE_MAGIC); ++i) {
+      written += out.write((uint8_t)TRACE_MAGIC[i]);
+    }
+  }
+
+  void byte(uint8_t value) {
+    crc = ModbusCrc16::updateByte(crc, value);
+    written += out.write(value);
+  }
+
+  void finish() {
+    const uint16_t sum = crc;
+    written += out.write((uint8_t)(sum & 0xFF));
+    written += out.write((uint8_t)(sum >> 8));
+  }
+};
+
+struct HexSink {
+  static const uint8_t BYTES_PER_LINE = 32;
+
+  Print &out;
+  uint16_t crc;
+  uint8_t column;
+  size_t written;
+
+  explicit HexSink(Print &o) : out(o), crc(ModbusCrc16::INIT), column(0), written(0) {}
+
+  void raw(uint8_t value) {
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+    if (column == 0) out.print(F("#TRC "));
+    out.write((uint8_t)HEX_DIGITS[value >> 4]);
+    out.write((uint8_t)HEX_DIGITS[value & 0x0F]);
+    ++written;
+    if (++column == BYTES_PER_LINE) {
+      out.println();
+      column = 0;
+    }
+  }
+
+  void magic() {
+    for (size_t i = 0; i < sizeof(TRACE_MAGIC); ++i) raw((uint8_t)TRACE_MAGIC[i]);
+  }
+
+  void byte(uint8_t value) {
+    crc = ModbusCrc16::updateByte(crc, value);
+    raw(value);
+  }
+
+  void finish() {
+    const uint16_t sum = crc;
+    raw((uint8_t)(sum & 0xFF));
+    raw((uint8_t)(sum >> 8));
+    if (column != 0) out.println();
+    out.println(F("#TRC END"));
+  }
+};
+
+}  // namespace
+
+template <typename Sink>
+void ModbusTraceRing::emit(Sink &sink) const {
+  uint8_t header[14];
+  header[0] = FORMAT_VERSION;
+  header[1] = 0;
+  putU16(&header[2], (uint16_t)_used);
+  putU16(&header[4], _records);
+  putU32(&header[6], _dropped);
+  putU32(&header[10], (uint32_t)micros());
+
+  sink.magic();
+  for (size_t i = 0; i < sizeof(header); ++i) sink.byte(header[i]);
+  for (size_t i = 0; i < _used; ++i) sink.byte(at(i));
+  sink.finish();
+}
+
+size_t ModbusTraceRing::exportBinary(Print &out) const {
+  BinarySink sink(out);
+  emit(sink);
+  return sink.written;
+}
+
+size_t ModbusTraceRing::exportHex(Print &out) const {
+  HexSink sink(out);
+  emit(sink);
+  return sink.written;
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  ModbusTraceRing
+
+  Compact in-RAM record of RS485 traffic, for debugging without the
+  per-byte hex logging that itself changes bus timing. RS485Bus appends a
+  binary record per event when a ring is attached (RS485Bus::setTrace());
+  nothing is formatted on the target. The ring is exported later over
+  serial and decoded on the host by tools/rs485_trace_decode.py.
+
+  Record (little-endian, HEADER_SIZE bytes + payload):
+    [type][channel][payload length][aux][micros() u32]
+
+    TRACE_TX       aux 0           payload: request bytes
+    TRACE_RX       aux RxEndReason payload: firstByteUs u32, lastByteUs u32,
+                                   frameGapUs u32 (all relative to TX end),
+                                   then the received bytes
+    TRACE_GAP      aux 0           payload: silence us u32, RX offset u16
+                                   (silence >= t3.5 between received bytes)
+    TRACE_VERDICT  aux Verdict     payload: address, function, frame
+                                   offset u16, attempt, bytes the frame
+                                   locator pushed through the CRC u16
+
+  Payloads longer than maxPayload() are cut and flagged with
+  FLAG_TRUNCATED in the type byte. When the ring is full the oldest whole
+  records are dropped and counted.
+
+  Export (exportBinary / exportHex):
+    "RS485TRC" version u8, flags u8, record bytes u16, records u16,
+    dropped u32, now micros u32, records oldest first, CRC-16/MODBUS
+    over everything after the magic.
+  exportHex() writes the same bytes as "#TRC " lines of hex for serial
+  monitors that mangle binary; the host tool reads either form out of a
+  captured log.
+
+  One ring per bus: each port is driven by one task, so the ring needs no
+  locking. Export while its port is idle.
+*/
+
+#if !defined(MODBUS_TRACE_RING_BYTES)
+  #if defined(ARDUINO_ARCH_AVR)
+    #define MODBUS_TRACE_RING_BYTES 512
+  #else
+    #define MODBUS_TRACE_RING_BYTES 4096
+  #endif
+#endif
+
+static_assert(MODBUS_TRACE_RING_BYTES >= 64 && MODBUS_TRACE_RING_BYTES <= 65535,
+              "MODBUS_TRACE_RING_BYTES must fit the 16-bit export header");
+
+class ModbusTraceRing {
+public:
+  static const size_t RING_BYTES = MODBUS_TRACE_RING_BYTES;
+  static const uint8_t HEADER_SIZE = 8;
+  static const uint8_t FORMAT_VERSION = 1;
+  static const uint8_t FLAG_TRUNCATED = 0x80;
+
+  enum RecordType : uint8_t {
+    TRACE_TX = 1,
+    TRACE_RX = 2,
+    TRACE_GAP = 3,
+    TRACE_VERDICT = 4
+  };
+
+  enum Verdict : uint8_t {
+    VERDICT_FRAME_OK = 0,   // CRC-valid frame with the expected prefix
+    VERDICT_NO_FRAME,       // bytes arrived, no usable frame among them
+    VERDICT_SILENT,         // nothing arrived
+    VERDICT_BUDGET,         // attempt not sent: transaction budget spent
+    VERDICT_EXCEPTION       // CRC-valid exception reply, not retried
+  };
+
+  ModbusTraceRing();
+
+  // Takes effect at the next record; one already being appended by the
+  // port's task completes.
+  void setEnabled(bool enable) { _enabled = enable; }
+  bool enabled() const { return _enabled; }
+
+  void clear();
+
+  void recordTx(uint8_t channel, const uint8_t *data, size_t len);
+  void recordRx(uint8_t channel,
+                uint8_t endReason,
+                uint32_t firstByteUs,
+                uint32_t lastByteUs,
+                uint32_t frameGapUs,
+                const uint8_t *data,
+                size_t len);
+  void recordGap(uint8_t channel, uint32_t silenceUs, uint16_t rxOffset);
+  void recordVerdict(uint8_t channel,
+                     Verdict verdict,
+                     uint8_t address,
+                     uint8_t function,
+                     uint16_t frameOffset,
+                     uint8_t attempt,
+                     uint16_t crcBytes);
+
+  uint16_t records() const { return _records; }
+  uint32_t dropped() const { return _dropped; }
+  size_t usedBytes() const { return _used; }
+
+  // Longest payload kept per record.
+  static size_t maxPayload() {
+    const size_t quarter = RING_BYTES / 4;
+    return (quarter < 255) ? quarter : 255;
+  }
+
+  // Returns the number of bytes written.
+  size_t exportBinary(Print &out) const;
+  size_t exportHex(Print &out) const;
+
+private:
+  uint8_t _buf[RING_BYTES];
+  size_t _head;   // next write position
+  size_t _tail;   // oldest record
+  size_t _used;
+  uint16_t _records;
+  uint32_t _dropped;
+  volatile bool _enabled;  // set from the CLI task, read by the port's
+
+  void append(uint8_t type,
+              uint8_t channel,
+              uint8_t aux,
+              const uint8_t *prefix,
+              size_t prefixLen,
+              const uint8_t *data,
+              size_t dataLen);
+  void dropOldest();
+  void put(uint8_t value);
+  uint8_t at(size_t offset) const { return _buf[(_tail + offset) % RING_BYTES]; }
+
+  template <typename Sink>
+  void emit(Sink &sink) const;
+};
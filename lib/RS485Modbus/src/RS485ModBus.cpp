@@ -7,9 +7,25 @@ RS485Bus::RS485Bus()
       _dir(-1, true),
       _preTxDelayUs(200),
       _postTxDelayUs(200),
+      _baud(0),
+      _defaultBaud(0),
+      _serialConfig(SERIAL_8N1),
+      _baudSwitches(0),
+      _altBaudTry(false),
+      _rxMode(RX_MODE_FRAME_END),
+      _frameGapOverrideUs(0),
+      _txEndUs(0),
+      _txEndValid(false),
+      _adaptiveTimeouts(true),
+      _budget(nullptr),
+      _trace(nullptr),
+      _traceChannel(0),
       _rxLen(0),
       _lastFrameOffset((size_t)-1) {
   memset(_rxBuf, 0, sizeof(_rxBuf));
+  memset(&_rxStats, 0, sizeof(_rxStats));
+  memset(&_lastException, 0, sizeof(_lastException));
+  memset(_exceptionPrefix, 0, sizeof(_exceptionPrefix));
 }
 
 void RS485Bus::begin(HardwareSerial &serial,
@@ -18,6 +34,9 @@ void RS485Bus::begin(HardwareSerial &serial,
                      int8_t txPin,
                      uint32_t config) {
   _serial = &serial;
+  _baud = baud;
+  _defaultBaud = baud;
+  _serialConfig = config;
 
 #if defined(ARDUINO_ARCH_ESP32)
   serial.setRxBufferSize((int)(RX_BUFFER_SIZE + 64));
@@ -32,11 +51,46 @@ void RS485Bus::begin(HardwareSerial &serial,
   flushInput();
 }
 
+bool RS485Bus::setBaud(uint32_t baud) {
+  if (!_serial || baud == 0) return false;
+  if (baud == _baud) return true;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  _serial->updateBaudRate(baud);
+#else
+  _serial->flush();
+  _serial->begin(baud, _serialConfig);
+#endif
+  _baud = baud;
+  ++_baudSwitches;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  if (_uart.active()) _uart.setBaud(baud, getFrameGapUs());
+#endif
+
+  // Bytes received at the old speed are garbage now.
+  flushInput();
+  return true;
+}
+
 void RS485Bus::setDirectionControl(int8_t dePin, bool activeHighTX) {
   _dir = DirectionControl(dePin, activeHighTX);
   _dir.begin();
 }
 
+#if defined(ARDUINO_ARCH_ESP32)
+bool RS485Bus::setUartHalfDuplex(uint8_t uartNum, int8_t dePin, bool activeHighTX) {
+  if (!_serial) return false;
+  if (!_uart.begin(*_serial, uartNum, dePin, activeHighTX, _baud, getFrameGapUs())) {
+    return false;
+  }
+
+  // The UART owns DE now; a GPIO driver on the same pin would fight it.
+  _dir = DirectionControl();
+  return true;
+}
+#endif
+
 void RS485Bus::setDebug(PrintController *logger) {
   _log = logger;
 }
@@ -46,6 +100,14 @@ void RS485Bus::setTimings(uint16_t preTxDelayUs, uint16_t postTxDelayUs) {
   _postTxDelayUs = postTxDelayUs;
 }
 
+uint32_t RS485Bus::getFrameGapUs() const {
+  if (_frameGapOverrideUs > 0) return _frameGapOverrideUs;
+  if (_baud == 0 || _baud > MODBUS_FIXED_T35_BAUD) return MODBUS_FIXED_T35_US;
+
+  // 3.5 characters of 11 bits each, rounded up.
+  return (uint32_t)((35UL * MODBUS_BITS_PER_CHAR * 100000UL + _baud - 1) / _baud);
+}
+
 void RS485Bus::flushInput() {
   if (!_serial) return;
   while (_serial->available() > 0) {
@@ -72,18 +134,40 @@ void RS485Bus::Request_RS485(const uint8_t reqArray[],
                              bool debug) {
   if (!_serial || !reqArray || reqSize == 0) return;
 
+  setBaud(_bauds.baudFor(reqArray[0], _defaultBaud));
+
   logPrint(F("[RS485] TX -> "), debug);
   logIO(reqArray, reqSize, debug);
 
   flushInput();
+#if defined(ARDUINO_ARCH_ESP32)
+  if (_uart.active()) {
+    _uart.write(reqArray, reqSize);
+  } else {
+    writeWithDirection(reqArray, reqSize);
+  }
+#else
+  writeWithDirection(reqArray, reqSize);
+#endif
+  _txEndUs = micros();
+  _txEndValid = true;
+
+  if (_trace) _trace->recordTx(_traceChannel, reqArray, reqSize);
+
+  if (afterReqDelayMs > 0) {
+    delay(afterReqDelayMs);
+  }
+}
+
+void RS485Bus::writeWithDirection(const uint8_t data[], size_t len) {
   _dir.setTX(true);
 
   if (_preTxDelayUs > 0) {
     delayMicroseconds(_preTxDelayUs);
   }
 
-  for (size_t i = 0; i < reqSize; ++i) {
-    _serial->write(reqArray[i]);
+  for (size_t i = 0; i < len; ++i) {
+    _serial->write(data[i]);
   }
   _serial->flush();
 
@@ -92,38 +176,134 @@ void RS485Bus::Request_RS485(const uint8_t reqArray[],
   }
 
   _dir.setTX(false);
-
-  if (afterReqDelayMs > 0) {
-    delay(afterReqDelayMs);
-  }
 }
 
 size_t RS485Bus::Read_RS485(uint16_t readTimeoutMs, bool debug) {
+  return Read_RS485(readTimeoutMs, (size_t)0, debug);
+}
+
+size_t RS485Bus::Read_RS485(uint16_t readTimeoutMs, size_t expectedFrameLen, bool debug) {
+  memset(&_rxStats, 0, sizeof(_rxStats));
   if (!_serial) return 0;
 
-  memset(_rxBuf, 0, sizeof(_rxBuf));
+  // No clear: every reader is bounded by _rxLen.
   _rxLen = 0;
   _lastFrameOffset = (size_t)-1;
 
+  const bool frameEndMode = (_rxMode == RX_MODE_FRAME_END);
+  const uint32_t gapUs = getFrameGapUs();
+
   logPrint(F("[RS485] RX wait started, timeout="), debug);
   logPrintDec(readTimeoutMs, debug);
-  logPrintln(F(" ms"), debug);
-
-  const unsigned long startTime = millis();
+  logPrint(F(" ms"), debug);
+  if (frameEndMode) {
+    logPrint(F(", expected="), debug);
+    logPrintDec((unsigned long)expectedFrameLen, debug);
+    logPrint(F(" B, t3.5="), debug);
+    logPrintDec(gapUs, debug);
+    logPrint(F(" us"), debug);
+  }
+  logNewLine(debug);
 
-  while ((millis() - startTime) < readTimeoutMs && _rxLen < RX_BUFFER_SIZE) {
+  const unsigned long startUs = micros();
+  const unsigned long refUs = _txEndValid ? _txEndUs : startUs;
+  const unsigned long timeoutUs = (unsigned long)readTimeoutMs * 1000UL;
+  _txEndValid = false;
+
+  // Poll fast enough to resolve t3.5 without hammering the UART driver.
+  uint32_t pollUs = gapUs / 8;
+  if (pollUs < 50) pollUs = 50;
+  if (pollUs > 500) pollUs = 500;
+
+  unsigned long lastByteAtUs = startUs;
+  bool gotAnyByte = false;
+  bool gapChecked = false;
+  bool lineIdle = false;
+  RxEndReason reason = RX_END_TIMEOUT;
+
+  while (true) {
+    bool gotByte = false;
+    const size_t lenBefore = _rxLen;
     while (_serial->available() > 0 && _rxLen < RX_BUFFER_SIZE) {
-      int value = _serial->read();
+      const int value = _serial->read();
       if (value >= 0) {
         _rxBuf[_rxLen++] = (uint8_t)value;
+        gotByte = true;
       }
     }
-    delay(1);
+
+    const unsigned long nowUs = micros();
+
+    if (gotByte) {
+      unsigned long byteAtUs = nowUs;
+      unsigned long burstStartUs = nowUs;
+      if (lineIdle) {
+        // Woken by the UART idle event: the burst ended one idle interval
+        // ago and took one character time per byte.
+        byteAtUs = backdate(nowUs, idleDelayUs(), gotAnyByte ? lastByteAtUs : startUs);
+        burstStartUs = backdate(byteAtUs,
+                                (uint32_t)(_rxLen - lenBefore - 1) * charTimeUs(),
+                                gotAnyByte ? lastByteAtUs : startUs);
+      }
+
+      if (!gotAnyByte) {
+        _rxStats.firstByteUs = (uint32_t)(burstStartUs - refUs);
+        gotAnyByte = true;
+      } else if (_trace && (burstStartUs - lastByteAtUs) >= gapUs) {
+        _trace->recordGap(_traceChannel, (uint32_t)(burstStartUs - lastByteAtUs), (uint16_t)lenBefore);
+      }
+      lastByteAtUs = byteAtUs;
+      gapChecked = false;
+
+      if (frameEndMode && rxTailIsFrame(expectedFrameLen)) {
+        reason = RX_END_FRAME_COMPLETE;
+        break;
+      }
+      if (frameEndMode && rxTailIsException()) {
+        reason = RX_END_EXCEPTION;
+        break;
+      }
+    }
+
+    if (_rxLen >= RX_BUFFER_SIZE) {
+      reason = RX_END_BUFFER_FULL;
+      break;
+    }
+
+    if (frameEndMode && gotAnyByte && !gapChecked && (nowUs - lastByteAtUs) >= gapUs) {
+      // A silence only ends the read when what we have is usable; an echo or
+      // a noise burst is followed by the real reply, so keep listening then.
+      gapChecked = true;
+      if (expectedFrameLen == 0 || rxContainsFrame(expectedFrameLen) ||
+          rxExceptionOffset() != ModbusFrameLocator::NOT_FOUND) {
+        reason = RX_END_FRAME_GAP;
+        break;
+      }
+    }
+
+    if ((nowUs - startUs) >= timeoutUs) {
+      reason = RX_END_TIMEOUT;
+      break;
+    }
+
+    lineIdle = waitRx(timeoutUs - (nowUs - startUs), frameEndMode && gotAnyByte, pollUs);
   }
 
-  logPrint(F("[RS485] RX captured bytes="), debug);
-  logPrintDec((unsigned long)_rxLen, debug);
-  logNewLine(debug);
+  const unsigned long endUs = micros();
+  _rxStats.bytes = _rxLen;
+  _rxStats.endReason = reason;
+  _rxStats.totalUs = (uint32_t)(endUs - startUs);
+  if (gotAnyByte) {
+    _rxStats.lastByteUs = (uint32_t)(lastByteAtUs - refUs);
+    _rxStats.frameGapUs = (uint32_t)(endUs - lastByteAtUs);
+  }
+
+  if (_trace) {
+    _trace->recordRx(_traceChannel, reason, _rxStats.firstByteUs, _rxStats.lastByteUs,
+                     _rxStats.frameGapUs, _rxBuf, _rxLen);
+  }
+
+  logRxStats(debug);
 
   if (_rxLen > 0) {
     logPrint(F("[RS485] RX raw -> "), debug);
@@ -134,6 +314,69 @@ size_t RS485Bus::Read_RS485(uint16_t readTimeoutMs, bool debug) {
   return _rxLen;
 }
 
+bool RS485Bus::waitRx(unsigned long remainingUs, bool midFrame, uint32_t pollUs) {
+#if defined(ARDUINO_ARCH_ESP32)
+  if (_uart.active()) return _uart.waitIdle(remainingUs);
+#else
+  (void)remainingUs;
+#endif
+
+  if (midFrame) {
+    delayMicroseconds(pollUs);
+  } else {
+    delay(1);
+  }
+  return false;
+}
+
+uint32_t RS485Bus::idleDelayUs() const {
+#if defined(ARDUINO_ARCH_ESP32)
+  if (_uart.active()) return _uart.idleUs();
+#endif
+  return 0;
+}
+
+uint32_t RS485Bus::charTimeUs() const {
+  if (_baud == 0) return 0;
+  return (uint32_t)((MODBUS_BITS_PER_CHAR * 1000000UL + _baud - 1) / _baud);
+}
+
+unsigned long RS485Bus::backdate(unsigned long atUs, uint32_t byUs, unsigned long notBeforeUs) {
+  return (atUs - notBeforeUs > byUs) ? atUs - byUs : notBeforeUs;
+}
+
+bool RS485Bus::rxTailIsFrame(size_t frameLen) const {
+  if (frameLen < 3 || _rxLen < frameLen) return false;
+  return verifyCrc16ModbusFrame(&_rxBuf[_rxLen - frameLen], frameLen);
+}
+
+bool RS485Bus::rxContainsFrame(size_t frameLen) const {
+  return ModbusFrameLocator::findFirst(_rxBuf, _rxLen, nullptr, 0, frameLen) !=
+         ModbusFrameLocator::NOT_FOUND;
+}
+
+bool RS485Bus::rxTailIsException() const {
+  if (_exceptionPrefix[1] == 0 || _rxLen < ModbusException::FRAME_SIZE) return false;
+  const uint8_t *tail = &_rxBuf[_rxLen - ModbusException::FRAME_SIZE];
+  return tail[0] == _exceptionPrefix[0] && tail[1] == _exceptionPrefix[1] &&
+         verifyCrc16ModbusFrame(tail, ModbusException::FRAME_SIZE);
+}
+
+size_t RS485Bus::rxExceptionOffset() const {
+  if (_exceptionPrefix[1] == 0) return ModbusFrameLocator::NOT_FOUND;
+  return ModbusFrameLocator::findFirst(_rxBuf, _rxLen, _exceptionPrefix, sizeof(_exceptionPrefix),
+                                       ModbusException::FRAME_SIZE);
+}
+
+size_t RS485Bus::locateFrames(const uint8_t checkCode[],
+                              size_t checkCodeSize,
+                              size_t frameLen,
+                              ModbusFrameSpan spans[],
+                              size_t maxSpans) const {
+  return ModbusFrameLocator::find(_rxBuf, _rxLen, checkCode, checkCodeSize,
+                                  frameLen, spans, maxSpans);
+}
+
 bool RS485Bus::Check_Res(const uint8_t resArray[],
                          size_t resArraySize,
                          const uint8_t checkArray[],
@@ -198,11 +441,71 @@ bool RS485Bus::SendRequest(uint8_t request[],
                            uint16_t readTimeoutMs,
                            bool debug,
                            uint16_t afterReqDelayMs) {
-  if (!_serial || !request || !getData || !checkCode) return false;
-  if (requestSize < 2 || getDataSize < 3 || checkCodeSize == 0) return false;
+  if (!getData) return false;
+  memset(getData, 0, getDataSize);
+
+  ModbusFrameView frame;
+  if (!transact(request, requestSize, getDataSize, checkCode, checkCodeSize, frame,
+                maxRetries, readTimeoutMs, debug, afterReqDelayMs)) {
+    return false;
+  }
+
+  memcpy(getData, frame.data(), getDataSize);
+  return true;
+}
+
+bool RS485Bus::transact(uint8_t request[],
+                        size_t requestSize,
+                        size_t responseSize,
+                        const uint8_t checkCode[],
+                        size_t checkCodeSize,
+                        ModbusFrameView &frame,
+                        uint8_t maxRetries,
+                        uint16_t readTimeoutMs,
+                        bool debug,
+                        uint16_t afterReqDelayMs) {
+  // The frame is the same for every attempt: one CRC up front.
+  if (request && requestSize >= 2) CRC_Calc(request, requestSize, debug);
+  const bool ok = transactFrame(request, requestSize, responseSize, checkCode, checkCodeSize, frame,
+                                maxRetries, readTimeoutMs, debug, afterReqDelayMs);
+  if (request) _stats.recordTransaction(request[0], ok, millis());
+  return ok;
+}
+
+bool RS485Bus::transact(const ModbusRequestFrame &request,
+                        size_t responseSize,
+                        const uint8_t checkCode[],
+                        size_t checkCodeSize,
+                        ModbusFrameView &frame,
+                        uint8_t maxRetries,
+                        uint16_t readTimeoutMs,
+                        bool debug,
+                        uint16_t afterReqDelayMs) {
+  const bool ok = transactFrame(request.bytes, ModbusRequestFrame::SIZE, responseSize, checkCode,
+                                checkCodeSize, frame, maxRetries, readTimeoutMs, debug, afterReqDelayMs);
+  _stats.recordTransaction(request.address(), ok, millis());
+  return ok;
+}
+
+bool RS485Bus::transactFrame(const uint8_t request[],
+                             size_t requestSize,
+                             size_t responseSize,
+                             const uint8_t checkCode[],
+                             size_t checkCodeSize,
+                             ModbusFrameView &frame,
+                             uint8_t maxRetries,
+                             uint16_t readTimeoutMs,
+                             bool debug,
+                             uint16_t afterReqDelayMs) {
+  frame.clear();
+  memset(&_lastException, 0, sizeof(_lastException));
+  if (!_serial || !request || !checkCode) return false;
+  if (requestSize < 2 || responseSize < 3 || checkCodeSize == 0) return false;
   if (maxRetries == 0) maxRetries = 1;
 
-  memset(getData, 0, getDataSize);
+  const uint8_t address = request[0];
+  const uint8_t function = request[1];
+  bool answered = false;  // a busy / acknowledge reply, retried
 
   for (uint8_t attempt = 1; attempt <= maxRetries; ++attempt) {
     logSeparator(debug);
@@ -212,57 +515,217 @@ bool RS485Bus::SendRequest(uint8_t request[],
     logPrintDec((unsigned long)maxRetries, debug);
     logPrintln(F(" ====="), debug);
 
-    CRC_Calc(request, requestSize, debug);
-    Request_RS485(request, requestSize, afterReqDelayMs, debug);
-    const size_t bytesRead = Read_RS485(readTimeoutMs, debug);
+    if (_budget && !_budget->takeAttempt(millis())) {
+      traceVerdict(ModbusTraceRing::VERDICT_BUDGET, request, 0, attempt, 0);
+      logPrint(F("[RS485] Budget spent ("), debug);
+      logPrint(ModbusBudget::reasonName(_budget->abortReason()), debug);
+      logPrintln(F("), request skipped."), debug);
+      return false;
+    }
+
+    uint16_t timeoutMs = readTimeoutMs;
+    uint16_t afterMs = afterReqDelayMs;
+    if (_adaptiveTimeouts) {
+      timeoutMs = _latency.timeoutFor(address, readTimeoutMs);
+      if (timeoutMs != readTimeoutMs) {
+        // Learned from this address's usual replies; a longer one (a
+        // batched read) needs its own wire time on top.
+        const uint32_t wireMs = ((uint32_t)responseSize * charTimeUs() + 999UL) / 1000UL;
+        const uint32_t withWireMs = (uint32_t)timeoutMs + wireMs;
+        timeoutMs = (withWireMs < readTimeoutMs) ? (uint16_t)withWireMs : readTimeoutMs;
+      }
+      if (_rxMode == RX_MODE_FRAME_END && _latency.isLearned(address)) afterMs = 0;
+      if (timeoutMs != readTimeoutMs) {
+        logPrint(F("[RS485] Learned timeout for 0x"), debug);
+        logPrintHex(address, debug);
+        logPrint(F(": "), debug);
+        logPrintDec(timeoutMs, debug);
+        logPrintln(F(" ms"), debug);
+      }
+    }
+
+    if (_budget) afterMs = _budget->clampMs(afterMs, millis());
+
+    Request_RS485(request, requestSize, afterMs, debug);
 
-    if (bytesRead >= getDataSize) {
+    // Clamp after TX so the request's own wire time is charged too.
+    if (_budget) timeoutMs = _budget->clampMs(timeoutMs, millis());
+    _exceptionPrefix[0] = address;
+    _exceptionPrefix[1] = (uint8_t)(function | ModbusException::FUNCTION_FLAG);
+    const size_t bytesRead = Read_RS485(timeoutMs, responseSize, debug);
+    ModbusLocatorStats stats = {0, 0, 0};
+
+    if (bytesRead >= responseSize) {
       logTraceRaw(debug);
 
-      for (size_t offset = 0; offset <= (bytesRead - getDataSize); ++offset) {
-        logPrint(F("[RS485] Checking frame window at offset "), debug);
-        logPrintDec((unsigned long)offset, debug);
-        logNewLine(debug);
+      ModbusFrameSpan spans[MAX_LOCATED_FRAMES];
+      const size_t frames = ModbusFrameLocator::find(_rxBuf, _rxLen, checkCode, checkCodeSize,
+                                                     responseSize, spans, MAX_LOCATED_FRAMES, &stats);
 
-        logWindow(_rxBuf, offset, getDataSize, debug);
+      logPrint(F("[RS485] Frame locator: candidates="), debug);
+      logPrintDec((unsigned long)stats.candidates, debug);
+      logPrint(F(" crcBytes="), debug);
+      logPrintDec((unsigned long)stats.crcBytes, debug);
+      logPrint(F(" frames="), debug);
+      logPrintDec((unsigned long)frames, debug);
+      logNewLine(debug);
+
+      for (size_t i = 0; i < frames; ++i) {
+        logWindow(_rxBuf, spans[i].offset, spans[i].length, debug);
+      }
 
-        if (Check_Res(&_rxBuf[offset], getDataSize, checkCode, checkCodeSize, debug)) {
-          memcpy(getData, &_rxBuf[offset], getDataSize);
-          _lastFrameOffset = offset;
+      if (frames > 0) {
+        memset(_exceptionPrefix, 0, sizeof(_exceptionPrefix));
+        const size_t offset = spans[0].offset;
+        frame = ModbusFrameView(&_rxBuf[offset], responseSize);
+        _lastFrameOffset = offset;
+        traceVerdict(ModbusTraceRing::VERDICT_FRAME_OK, request, offset, attempt, stats.crcBytes);
+
+        logPrint(F("[RS485] Valid frame found at offset "), debug);
+        logPrintDec((unsigned long)offset, debug);
+        logPrintln(F("."), debug);
 
-          logPrint(F("[RS485] Valid frame found at offset "), debug);
-          logPrintDec((unsigned long)offset, debug);
-          logPrintln(F("."), debug);
+        logPrint(F("[RS485] Clean frame -> "), debug);
+        logIO(frame.data(), frame.length(), debug);
 
-          logPrint(F("[RS485] Clean frame -> "), debug);
-          logIO(getData, getDataSize, debug);
-          return true;
+        const bool echo = offset >= requestSize && memcmp(_rxBuf, request, requestSize) == 0;
+        _stats.recordAttempt(address, ModbusBusStats::OUTCOME_OK, requestSize, bytesRead,
+                             echo ? offset - requestSize : offset, echo, _rxStats.lastByteUs, millis());
+
+        if (_adaptiveTimeouts) {
+          _latency.recordReply(address, _rxStats.firstByteUs, _rxStats.lastByteUs);
         }
+        _bauds.noteResult(address, true);
+        return true;
       }
     }
 
-    logPrintln(F("[RS485] Valid frame not found in buffer."), debug);
-    flushInput();
-    delay(100UL * attempt);
+    // The slave answered, but with a rejection. A final one gets the same
+    // answer again, so report it instead of retrying; busy / acknowledge
+    // fall through to the backoff below.
+    const size_t exceptionOffset = rxExceptionOffset();
+    memset(_exceptionPrefix, 0, sizeof(_exceptionPrefix));
+    if (exceptionOffset != ModbusFrameLocator::NOT_FOUND) {
+      _lastException.address = address;
+      _lastException.function = function;
+      _lastException.code = _rxBuf[exceptionOffset + 2];
+      _lastFrameOffset = exceptionOffset;
+      _exceptions.record(_lastException, millis());
+      _stats.recordAttempt(address, ModbusBusStats::OUTCOME_EXCEPTION, requestSize, bytesRead,
+                           0, false, 0, millis());
+      traceVerdict(ModbusTraceRing::VERDICT_EXCEPTION, request, exceptionOffset, attempt, 0);
+
+      logPrint(F("[RS485] Exception 0x"), debug);
+      logPrintHexByte(_lastException.code, debug);
+      logPrint(F(" ("), debug);
+      logPrint(ModbusException::codeName(_lastException.code), debug);
+      logPrint(F(") from 0x"), debug);
+      logPrintHexByte(address, debug);
+
+      if (_adaptiveTimeouts) {
+        _latency.recordReply(address, _rxStats.firstByteUs, _rxStats.lastByteUs);
+      }
+      _bauds.noteResult(address, true);
+
+      if (ModbusException::isFinal(_lastException.code)) {
+        logPrintln(F(", not retrying."), debug);
+        return false;
+      }
+      logPrintln(F(", retrying."), debug);
+      answered = true;
+      flushInput();
+    } else {
+      traceVerdict(bytesRead > 0 ? ModbusTraceRing::VERDICT_NO_FRAME : ModbusTraceRing::VERDICT_SILENT,
+                   request, 0, attempt, 0);
+      _stats.recordAttempt(address, failedOutcome(bytesRead, responseSize, stats.candidates),
+                           requestSize, bytesRead, 0, false, 0, millis());
+      logPrintln(F("[RS485] Valid frame not found in buffer."), debug);
+      if (_adaptiveTimeouts) {
+        _latency.recordMiss(address);
+      }
+      flushInput();
+    }
+
+    // Back off before the next attempt only; never past the budget.
+    if (attempt < maxRetries) {
+      uint16_t backoffMs = (uint16_t)(100U * attempt);
+      if (_budget) backoffMs = _budget->clampMs(backoffMs, millis());
+      delay(backoffMs);
+    }
   }
 
   logPrintln(F("[RS485] Request failed after all retries."), debug);
+
+  // Not one reply: the device may be at another speed (see ModbusBaudTable).
+  if (!answered && !_altBaudTry && _bauds.noteResult(address, false)) {
+    return transactAtAltBaud(request, requestSize, responseSize, checkCode, checkCodeSize, frame,
+                             readTimeoutMs, debug, afterReqDelayMs);
+  }
   return false;
 }
 
-uint16_t RS485Bus::crc16Modbus(const uint8_t *data, size_t len) {
-  uint16_t crc = 0xFFFF;
-  for (size_t i = 0; i < len; ++i) {
-    crc ^= (uint16_t)data[i];
-    for (uint8_t bit = 0; bit < 8; ++bit) {
-      if (crc & 0x0001) {
-        crc = (crc >> 1) ^ 0xA001;
-      } else {
-        crc >>= 1;
-      }
-    }
+bool RS485Bus::transactAtAltBaud(const uint8_t request[],
+                                 size_t requestSize,
+                                 size_t responseSize,
+                                 const uint8_t checkCode[],
+                                 size_t checkCodeSize,
+                                 ModbusFrameView &frame,
+                                 uint16_t readTimeoutMs,
+                                 bool debug,
+                                 uint16_t afterReqDelayMs) {
+  const uint8_t address = request[0];
+  _bauds.swap(address);
+
+  logPrint(F("[RS485] No reply from 0x"), debug);
+  logPrintHexByte(address, debug);
+  logPrint(F(", trying "), debug);
+  logPrintDec(_bauds.baudFor(address, _defaultBaud), debug);
+  logPrintln(F(" baud."), debug);
+
+  // Timing learned at the other speed does not apply here.
+  const bool adaptive = _adaptiveTimeouts;
+  _adaptiveTimeouts = false;
+  _altBaudTry = true;
+  const bool ok = transactFrame(request, requestSize, responseSize, checkCode, checkCodeSize, frame,
+                                1, readTimeoutMs, debug, afterReqDelayMs);
+  _altBaudTry = false;
+  _adaptiveTimeouts = adaptive;
+
+  if (ok || _lastException.code != 0) {
+    _latency.reset(address);
+    logPrint(F("[RS485] 0x"), debug);
+    logPrintHexByte(address, debug);
+    logPrint(F(" answers at "), debug);
+    logPrintDec(_baud, debug);
+    logPrintln(F(" baud, keeping it."), debug);
+    return ok;
   }
-  return crc;
+
+  _bauds.swap(address);
+  return false;
+}
+
+ModbusBusStats::Outcome RS485Bus::failedOutcome(size_t bytesRead,
+                                                size_t responseSize,
+                                                size_t candidates) {
+  if (bytesRead == 0) return ModbusBusStats::OUTCOME_TIMEOUT;
+  if (bytesRead < responseSize) return ModbusBusStats::OUTCOME_PARTIAL;
+  // The locator only CRC-checks offsets whose prefix matched.
+  return candidates > 0 ? ModbusBusStats::OUTCOME_CRC : ModbusBusStats::OUTCOME_PREFIX;
+}
+
+void RS485Bus::traceVerdict(uint8_t verdict,
+                            const uint8_t request[],
+                            size_t frameOffset,
+                            uint8_t attempt,
+                            size_t crcBytes) {
+  if (!_trace) return;
+  _trace->recordVerdict(_traceChannel, (ModbusTraceRing::Verdict)verdict, request[0], request[1],
+                        (uint16_t)frameOffset, attempt, (uint16_t)crcBytes);
+}
+
+uint16_t RS485Bus::crc16Modbus(const uint8_t *data, size_t len) {
+  return ModbusCrc16::compute(data, len);
 }
 
 bool RS485Bus::verifyCrc16ModbusFrame(const uint8_t *frame, size_t len) {
@@ -307,6 +770,33 @@ void RS485Bus::logNewLine(bool debug) const {
   if (_log) _log->println("", debug);
 }
 
+void RS485Bus::logRxStats(bool debug) const {
+  if (!_log || !debug) return;
+
+  static const char *const reasonNames[] = {
+    "none", "timeout", "frame complete", "frame gap", "buffer full", "exception"
+  };
+  static_assert(sizeof(reasonNames) / sizeof(reasonNames[0]) == RX_END_EXCEPTION + 1,
+                "reasonNames must name every RxEndReason");
+  const uint8_t reasonIndex = (_rxStats.endReason < sizeof(reasonNames) / sizeof(reasonNames[0]))
+                                  ? (uint8_t)_rxStats.endReason
+                                  : (uint8_t)RX_END_NONE;
+
+  _log->print(F("[RS485] RX captured bytes="), true);
+  _log->print((unsigned long)_rxStats.bytes, true, "", DEC);
+  _log->print(F(" | end="), true);
+  _log->print(reasonNames[reasonIndex], true);
+  _log->print(F(" | first="), true);
+  _log->print((unsigned long)_rxStats.firstByteUs, true, " us", DEC);
+  _log->print(F(" | last="), true);
+  _log->print((unsigned long)_rxStats.lastByteUs, true, " us", DEC);
+  _log->print(F(" | gap="), true);
+  _log->print((unsigned long)_rxStats.frameGapUs, true, " us", DEC);
+  _log->print(F(" | total="), true);
+  _log->print((unsigned long)_rxStats.totalUs, true, " us", DEC);
+  _log->println("", true);
+}
+
 void RS485Bus::logSeparator(bool debug) const {
   if (!_log || !debug) return;
   _log->println(F("------------------------------------------------------------"), true);
@@ -1,6 +1,20 @@
 #pragma once
 #include <Arduino.h>
 #include <PrintController.h>
+#include "ModbusCrc16.h"
+#include "ModbusFrameLocator.h"
+#include "ModbusFrameView.h"
+#include "ModbusRequestFrame.h"
+#include "ModbusLatencyTracker.h"
+#include "ModbusBudget.h"
+#include "ModbusException.h"
+#include "ModbusBusStats.h"
+#include "ModbusBaudTable.h"
+#include "ModbusTraceRing.h"
+#include "ModbusReadPlanner.h"
+#include "ModbusRegisterMap.h"
+#include "SampleFilter.h"
+#include "RS485UartEsp32.h"
 
 class RS485Bus {
 public:
@@ -18,6 +32,41 @@ public:
   // Change this to 16 (or any value > 0) to widen the log matrix.
   static constexpr size_t LOG_BUFFER_MATRIX_COLUMNS = 16;
 
+  // How many valid frames SendRequest() reports from one RX buffer.
+  static constexpr size_t MAX_LOCATED_FRAMES = 4;
+
+  // Modbus RTU timing: t3.5 is fixed at 1750 us above 19200 baud and
+  // derived from an 11-bit character time at or below it.
+  static constexpr uint32_t MODBUS_FIXED_T35_US = 1750UL;
+  static constexpr uint32_t MODBUS_FIXED_T35_BAUD = 19200UL;
+  static constexpr uint8_t MODBUS_BITS_PER_CHAR = 11;
+
+  // Receive strategy used by Read_RS485().
+  enum RxMode : uint8_t {
+    RX_MODE_FULL_TIMEOUT = 0,  // legacy: always wait the whole read timeout
+    RX_MODE_FRAME_END    = 1   // stop on a complete frame or a t3.5 silence
+  };
+
+  // Why the last Read_RS485() call returned.
+  enum RxEndReason : uint8_t {
+    RX_END_NONE = 0,
+    RX_END_TIMEOUT,         // read timeout expired
+    RX_END_FRAME_COMPLETE,  // buffer tail holds a CRC-valid frame of expected length
+    RX_END_FRAME_GAP,       // t3.5 silence after a usable frame (or any bytes if length unknown)
+    RX_END_BUFFER_FULL,     // RX buffer filled up
+    RX_END_EXCEPTION        // buffer tail holds the exception reply transact() waits for
+  };
+
+  // Per-call receive statistics, valid after every Read_RS485().
+  struct RxStats {
+    size_t bytes;           // bytes captured into the RX buffer
+    uint32_t firstByteUs;   // end of TX (or read start) -> first byte seen, 0 if none
+    uint32_t lastByteUs;    // end of TX (or read start) -> last byte seen, 0 if none
+    uint32_t frameGapUs;    // silence observed after the last byte when the read ended
+    uint32_t totalUs;       // total time spent inside Read_RS485()
+    RxEndReason endReason;
+  };
+
   struct DirectionControl {
     int8_t pin;
     bool activeHighTX;
@@ -51,8 +100,87 @@ public:
              uint32_t config = SERIAL_8N1);
 
   void setDirectionControl(int8_t dePin, bool activeHighTX = true);
+
+#if defined(ARDUINO_ARCH_ESP32)
+  // Hands DE to the UART instead (RS485UartEsp32): hardware half-duplex
+  // mode with DE on the RTS pin, one bulk write per request and an
+  // event-driven Read_RS485() that sleeps until t3.5 of silence. Call
+  // after begin(); uartNum is the UART behind the begin() serial. Returns
+  // false (bus unchanged) if the UART rejects the mode.
+  bool setUartHalfDuplex(uint8_t uartNum, int8_t dePin, bool activeHighTX = true);
+  bool uartHalfDuplex() const { return _uart.active(); }
+#endif
   void setDebug(PrintController *logger);
   void setTimings(uint16_t preTxDelayUs, uint16_t postTxDelayUs);
+
+  // Selects the receive strategy. Default is RX_MODE_FRAME_END.
+  void setRxMode(RxMode mode) { _rxMode = mode; }
+  RxMode getRxMode() const { return _rxMode; }
+
+  // Overrides the end-of-frame silence. 0 restores the t3.5 value derived
+  // from the configured baud rate. Useful for converters that add latency.
+  void setFrameGapUs(uint32_t gapUs) { _frameGapOverrideUs = gapUs; }
+  uint32_t getFrameGapUs() const;
+  uint32_t getBaud() const { return _baud; }
+
+  // Per-address line speed (ModbusBaudTable). Request_RS485() switches the
+  // UART to the addressed device's baud before sending; addresses not in
+  // the table run at the begin() baud. A transaction that gets no reply at
+  // all is tried once more at the entry's altBaud (see ModbusBaudTable).
+  // setBaud() switches the UART directly; the next request switches it
+  // back to whatever its address needs.
+  bool setBaud(uint32_t baud);
+  uint32_t getDefaultBaud() const { return _defaultBaud; }
+  uint32_t baudSwitches() const { return _baudSwitches; }
+  const ModbusBaudTable &bauds() const { return _bauds; }
+  ModbusBaudTable &bauds() { return _bauds; }
+
+  const RxStats &lastRxStats() const { return _rxStats; }
+
+  // Per-address timeouts learned from reply latency (ModbusLatencyTracker).
+  // When enabled, SendRequest() treats readTimeoutMs as an upper bound and
+  // uses the learned timeout once a device has answered often enough. In
+  // RX_MODE_FRAME_END the read itself waits for the reply, so the fixed
+  // afterReqDelayMs is skipped for learned devices. Enabled by default.
+  void setAdaptiveTimeouts(bool enable) { _adaptiveTimeouts = enable; }
+  bool getAdaptiveTimeouts() const { return _adaptiveTimeouts; }
+  const ModbusLatencyTracker &latency() const { return _latency; }
+  ModbusLatencyTracker &latency() { return _latency; }
+
+  // Shared time/attempt budget for the current transaction (ModbusBudget).
+  // While set, every SendRequest() attempt draws from it and returns false
+  // without bus traffic once it is spent. nullptr = unlimited (default).
+  void setBudget(ModbusBudget *budget) { _budget = budget; }
+  ModbusBudget *getBudget() const { return _budget; }
+
+  // Binary traffic trace (ModbusTraceRing): TX/RX frames, gaps and frame
+  // verdicts are recorded here instead of being printed. channel tags the
+  // records (usually the port index). nullptr = off (default).
+  void setTrace(ModbusTraceRing *ring, uint8_t channel = 0) {
+    _trace = ring;
+    _traceChannel = channel;
+  }
+  ModbusTraceRing *getTrace() const { return _trace; }
+
+  // Exception reply to the last transact()/SendRequest() (ModbusException).
+  // A CRC-valid final exception from the addressed slave ends the
+  // transaction at once, without retries; busy / acknowledge are retried.
+  // code is 0 when the last call got none.
+  const ModbusException &lastException() const { return _lastException; }
+  // True when the last call ended on a final exception: callers stop
+  // retrying. A slave still busy after every retry does not count.
+  bool lastWasException() const { return ModbusException::isFinal(_lastException.code); }
+  const ModbusExceptionLog &exceptions() const { return _exceptions; }
+  ModbusExceptionLog &exceptions() { return _exceptions; }
+
+  // Health counters (ModbusBusStats): every transact() attempt classified
+  // as ok / timeout / partial / CRC / prefix / exception, plus bytes,
+  // retries and reply latency, per port and per address. They count from
+  // construction (or the last reset()), so begin() after a deep-sleep
+  // wake keeps totals restored by SleepPlanner::retain().
+  const ModbusBusStats &stats() const { return _stats; }
+  ModbusBusStats &stats() { return _stats; }
+
   void flushInput();
   PrintController* getLogger() const { return _log; }
 
@@ -65,12 +193,25 @@ public:
 
   size_t Read_RS485(uint16_t readTimeoutMs = 2000, bool debug = false);
 
+  // expectedFrameLen lets RX_MODE_FRAME_END return as soon as a CRC-valid
+  // frame of that length is in the buffer. 0 means "unknown length": the read
+  // then ends at the first t3.5 silence after any received bytes.
+  size_t Read_RS485(uint16_t readTimeoutMs, size_t expectedFrameLen, bool debug);
+
   bool Check_Res(const uint8_t resArray[],
                  size_t resArraySize,
                  const uint8_t checkArray[],
                  size_t checkArraySize,
                  bool debug = false) const;
 
+  // Locates every CRC-valid frame of frameLen bytes starting with checkCode
+  // in the last RX buffer (see ModbusFrameLocator). Returns the frame count.
+  size_t locateFrames(const uint8_t checkCode[],
+                      size_t checkCodeSize,
+                      size_t frameLen,
+                      ModbusFrameSpan spans[],
+                      size_t maxSpans) const;
+
   void ShiftArray(uint8_t array[], size_t arraySize, bool debug = false) const;
 
   bool SendRequest(uint8_t request[],
@@ -84,6 +225,32 @@ public:
                    bool debug = false,
                    uint16_t afterReqDelayMs = 10);
 
+  // Same transaction as SendRequest(), without the copy: on success frame
+  // points at the located responseSize-byte frame inside the RX buffer
+  // (see ModbusFrameView). The view is valid until the next read on this bus.
+  bool transact(uint8_t request[],
+                size_t requestSize,
+                size_t responseSize,
+                const uint8_t checkCode[],
+                size_t checkCodeSize,
+                ModbusFrameView &frame,
+                uint8_t maxRetries = 3,
+                uint16_t readTimeoutMs = 2000,
+                bool debug = false,
+                uint16_t afterReqDelayMs = 10);
+
+  // Same again for a ready-made request (ModbusRequestFrame): the frame
+  // already carries its CRC, so retries send it unchanged.
+  bool transact(const ModbusRequestFrame &request,
+                size_t responseSize,
+                const uint8_t checkCode[],
+                size_t checkCodeSize,
+                ModbusFrameView &frame,
+                uint8_t maxRetries = 3,
+                uint16_t readTimeoutMs = 2000,
+                bool debug = false,
+                uint16_t afterReqDelayMs = 10);
+
   const uint8_t *rawData() const { return _rxBuf; }
   size_t rawLength() const { return _rxLen; }
   size_t lastFrameOffset() const { return _lastFrameOffset; }
@@ -99,10 +266,70 @@ private:
   uint16_t _preTxDelayUs;
   uint16_t _postTxDelayUs;
 
+  uint32_t _baud;
+  uint32_t _defaultBaud;
+  uint32_t _serialConfig;
+  uint32_t _baudSwitches;
+  ModbusBaudTable _bauds;
+  bool _altBaudTry;           // inside the altBaud retry of transact()
+  RxMode _rxMode;
+  uint32_t _frameGapOverrideUs;
+  unsigned long _txEndUs;
+  bool _txEndValid;
+  RxStats _rxStats;
+  bool _adaptiveTimeouts;
+  ModbusLatencyTracker _latency;
+  ModbusBudget *_budget;
+  ModbusTraceRing *_trace;
+  uint8_t _traceChannel;
+  ModbusException _lastException;
+  ModbusExceptionLog _exceptions;
+  ModbusBusStats _stats;
+  uint8_t _exceptionPrefix[2];   // [addr][fn | 0x80] while transact() reads, else zeros
+#if defined(ARDUINO_ARCH_ESP32)
+  RS485UartEsp32 _uart;
+#endif
+
   uint8_t _rxBuf[RX_BUFFER_SIZE];
   size_t _rxLen;
   size_t _lastFrameOffset;
 
+  bool rxTailIsFrame(size_t frameLen) const;
+  bool rxContainsFrame(size_t frameLen) const;
+  bool rxTailIsException() const;
+  size_t rxExceptionOffset() const;
+  bool transactFrame(const uint8_t request[],
+                     size_t requestSize,
+                     size_t responseSize,
+                     const uint8_t checkCode[],
+                     size_t checkCodeSize,
+                     ModbusFrameView &frame,
+                     uint8_t maxRetries,
+                     uint16_t readTimeoutMs,
+                     bool debug,
+                     uint16_t afterReqDelayMs);
+  bool transactAtAltBaud(const uint8_t request[],
+                         size_t requestSize,
+                         size_t responseSize,
+                         const uint8_t checkCode[],
+                         size_t checkCodeSize,
+                         ModbusFrameView &frame,
+                         uint16_t readTimeoutMs,
+                         bool debug,
+                         uint16_t afterReqDelayMs);
+  static ModbusBusStats::Outcome failedOutcome(size_t bytesRead, size_t responseSize, size_t candidates);
+  void writeWithDirection(const uint8_t data[], size_t len);
+  bool waitRx(unsigned long remainingUs, bool midFrame, uint32_t pollUs);
+  uint32_t idleDelayUs() const;
+  uint32_t charTimeUs() const;
+  static unsigned long backdate(unsigned long atUs, uint32_t byUs, unsigned long notBeforeUs);
+  void logRxStats(bool debug) const;
+  void traceVerdict(uint8_t verdict,
+                    const uint8_t request[],
+                    size_t frameOffset,
+                    uint8_t attempt,
+                    size_t crcBytes);
+
   void logPrint(const __FlashStringHelper *msg, bool debug) const;
   void logPrint(const char *msg, bool debug) const;
   void logPrintDec(unsigned long value, bool debug) const;
@@ -0,0 +1,75 @@
+#include "RS485UartEsp32.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+#include <driver/uart.h>
+
+RS485UartEsp32::RS485UartEsp32()
+    : _serial(nullptr),
+      _uartNum(0),
+      _idleUs(0),
+      _idle(nullptr) {}
+
+bool RS485UartEsp32::begin(HardwareSerial &serial,
+                           uint8_t uartNum,
+                           int8_t dePin,
+                           bool activeHighTX,
+                           uint32_t baud,
+                           uint32_t gapUs) {
+  if (baud == 0 || uartNum >= SOC_UART_NUM) return false;
+
+  if (!_idle) {
+    _idle = xSemaphoreCreateBinary();
+    if (!_idle) return false;
+  }
+
+  if (dePin >= 0 && !serial.setPins(-1, -1, -1, dePin)) return false;
+  if (!serial.setMode(UART_MODE_RS485_HALF_DUPLEX)) return false;
+  uart_set_line_inverse((uart_port_t)uartNum,
+                        activeHighTX ? UART_SIGNAL_INV_DISABLE : UART_SIGNAL_RTS_INV);
+
+  if (!setIdleTimeout(serial, baud, gapUs)) return false;
+
+  SemaphoreHandle_t idle = _idle;
+  serial.onReceive([idle]() { xSemaphoreGive(idle); }, true);
+
+  _serial = &serial;
+  _uartNum = uartNum;
+  return true;
+}
+
+bool RS485UartEsp32::setBaud(uint32_t baud, uint32_t gapUs) {
+  if (!_serial || baud == 0) return false;
+  return setIdleTimeout(*_serial, baud, gapUs);
+}
+
+bool RS485UartEsp32::setIdleTimeout(HardwareSerial &serial, uint32_t baud, uint32_t gapUs) {
+  // RX timeout counts 10-bit characters at the line rate; round t3.5 up.
+  const uint32_t charUs = (10UL * 1000000UL + baud - 1) / baud;
+  uint32_t symbols = (gapUs + charUs - 1) / charUs;
+  if (symbols < 1) symbols = 1;
+  if (symbols > MAX_IDLE_SYMBOLS) symbols = MAX_IDLE_SYMBOLS;
+  if (!serial.setRxTimeout((uint8_t)symbols)) return false;
+  _idleUs = symbols * charUs;
+  return true;
+}
+
+void RS485UartEsp32::write(const uint8_t *data, size_t len) {
+  if (!_serial) return;
+
+  // Drop idle events left over from earlier traffic.
+  xSemaphoreTake(_idle, 0);
+
+  _serial->write(data, len);
+  uart_wait_tx_done((uart_port_t)_uartNum, portMAX_DELAY);
+}
+
+bool RS485UartEsp32::waitIdle(uint32_t timeoutUs) {
+  if (!_serial) return false;
+
+  TickType_t ticks = pdMS_TO_TICKS((timeoutUs + 999UL) / 1000UL);
+  if (ticks == 0) ticks = 1;
+  return xSemaphoreTake(_idle, ticks) == pdTRUE;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  RS485UartEsp32
+
+  ESP32 backend for RS485Bus that hands the bus turnaround to the UART
+  (RS485Bus::setUartHalfDuplex()).
+
+  - The UART runs in RS485 half-duplex mode with DE on its RTS pin: the
+    peripheral asserts DE for exactly the TX window, so there are no
+    digitalWrite toggles and no pre/post-TX busy-waits.
+  - A request goes out as one bulk write; the caller blocks on the
+    driver's TX-done interrupt instead of spinning in flush().
+  - The UART RX timeout is set to t3.5 in character times. Each RX-timeout
+    event gives a semaphore, so Read_RS485() sleeps until a reply has
+    gone quiet (or the read times out) instead of polling.
+
+  One instance per bus; all calls come from the task that owns the bus.
+  The onReceive() callback runs in the core's UART event task and only
+  gives the semaphore.
+*/
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+class RS485UartEsp32 {
+public:
+  // The UART limits the RX timeout threshold; 92 characters is accepted
+  // on every ESP32 variant.
+  static const uint8_t MAX_IDLE_SYMBOLS = 92;
+
+  RS485UartEsp32();
+
+  // serial must already be started (RS485Bus::begin()). dePin -1 keeps
+  // the current RTS routing (auto-direction transceivers).
+  bool begin(HardwareSerial &serial,
+             uint8_t uartNum,
+             int8_t dePin,
+             bool activeHighTX,
+             uint32_t baud,
+             uint32_t gapUs);
+
+  bool active() const { return _serial != nullptr; }
+
+  // Re-arms the idle timeout after the UART changed speed; the threshold
+  // is in character times, so t3.5 maps to a different count per baud.
+  bool setBaud(uint32_t baud, uint32_t gapUs);
+
+  // Writes the frame and returns once the last stop bit is out.
+  void write(const uint8_t *data, size_t len);
+
+  // Sleeps until the UART reports an idle line after received bytes or
+  // timeoutUs passes. Returns true when woken by the idle event.
+  bool waitIdle(uint32_t timeoutUs);
+
+  // Silence the UART waits for before raising the idle event.
+  uint32_t idleUs() const { return _idleUs; }
+
+private:
+  HardwareSerial *_serial;
+  uint8_t _uartNum;
+  uint32_t _idleUs;
+  SemaphoreHandle_t _idle;
+
+  bool setIdleTimeout(HardwareSerial &serial, uint32_t baud, uint32_t gapUs);
+};
+
+#endif
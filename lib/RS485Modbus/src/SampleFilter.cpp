@@ -0,0 +1,121 @@
+#include "SampleFilter.h"
+
+// ============================================================
+// Fault words
+// ============================================================
+
+bool SampleFilter::isFaultWord(const ModbusFieldSpec &field, int32_t raw) {
+  switch (field.type) {
+    case MODBUS_FIELD_S16:
+      return raw == 0x7FFF || raw == -0x8000L;
+    case MODBUS_FIELD_U32:
+      return raw == -1L || raw == 0x7FFFFFFFL || raw == (-0x7FFFFFFFL - 1);
+    case MODBUS_FIELD_S32:
+      return raw == 0x7FFFFFFFL || raw == (-0x7FFFFFFFL - 1);
+    case MODBUS_FIELD_U16:
+    default:
+      return raw == 0xFFFFL || raw == 0x7FFF || raw == 0x8000L;
+  }
+}
+
+// ============================================================
+// Deep sleep
+// ============================================================
+
+void SampleFilter::rebaseStates(void *states, size_t size, uint32_t shiftMs) {
+  State *s = static_cast<State *>(states);
+  for (size_t i = 0; s && i < size / sizeof(State); ++i) {
+    if (s[i].hasGood) s[i].lastGoodMs += shiftMs;
+  }
+}
+
+// ============================================================
+// Rate of change
+// ============================================================
+
+uint32_t SampleFilter::rocAllowance(uint32_t rocPerMin, uint32_t elapsedMs) {
+  // Whole seconds keep rocPerMin * seconds inside 32 bits up to the
+  // one-hour age limit for any rule below ~1.19e6 per minute.
+  uint32_t seconds = elapsedMs / 1000UL;
+  if (seconds < 60UL) seconds = 60UL;
+  return (rocPerMin * seconds) / 60UL;
+}
+
+// ============================================================
+// Filter
+// ============================================================
+
+uint8_t SampleFilter::filter(const ModbusFieldSpec &field,
+                             const SampleFilterRule *rule,
+                             State &state,
+                             int32_t raw,
+                             uint32_t nowMs,
+                             FixedSample &out) {
+  // Stuck detection looks at the raw word, accepted or not.
+  if (state.hasRaw && raw == state.lastRaw) {
+    if (state.repeats < 255) ++state.repeats;
+  } else {
+    state.repeats = 0;
+  }
+  state.lastRaw = raw;
+  state.hasRaw = true;
+
+  uint8_t quality = SAMPLE_QUALITY_OK;
+  const FixedSample value = ModbusRegisterDecoder::sample(field, raw);
+
+  if (isFaultWord(field, raw)) {
+    quality = SAMPLE_QUALITY_FAULT_WORD;
+  } else if (!ModbusRegisterDecoder::inBounds(field, value.raw)) {
+    quality = SAMPLE_QUALITY_HARD;
+  } else if (rule && rule->rocPerMin != 0 && state.hasGood &&
+             (nowMs - state.lastGoodMs) <= SAMPLE_FILTER_ROC_MAX_AGE_MS) {
+    const uint32_t allowed = rocAllowance(rule->rocPerMin, nowMs - state.lastGoodMs);
+
+    if (distance(value.raw, state.lastGood.raw) > allowed) {
+      // A real step shows up as the same new level several times in a
+      // row; a misaligned or corrupted read rarely repeats.
+      const uint32_t agree = rocAllowance(rule->rocPerMin, 0);
+      if (state.rocCount != 0 && distance(value.raw, state.rocCandidate) <= agree) {
+        if (state.rocCount < 255) ++state.rocCount;
+      } else {
+        state.rocCandidate = value.raw;
+        state.rocCount = 1;
+      }
+
+      if (rule->rocConfirm == 0 || state.rocCount < rule->rocConfirm) {
+        quality = SAMPLE_QUALITY_ROC;
+      }
+    }
+  }
+
+  if (quality & SAMPLE_QUALITY_REJECTED) {
+    if (quality != SAMPLE_QUALITY_ROC) state.rocCount = 0;
+    if (state.invalidCount < 255) ++state.invalidCount;
+
+    out = held(field, state);
+    if (state.hasGood) quality |= SAMPLE_QUALITY_HELD;
+    if (state.invalidCount >= SAMPLE_FILTER_FAULT_COUNT) quality |= SAMPLE_QUALITY_SENSOR_FAULT;
+
+    state.quality = quality;
+    return quality;
+  }
+
+  if (rule && rule->softMin <= rule->softMax &&
+      (value.raw < rule->softMin || value.raw > rule->softMax)) {
+    quality |= SAMPLE_QUALITY_SOFT;
+  }
+
+  if (rule && rule->stuckLimit != 0 && (uint16_t)state.repeats + 1U >= rule->stuckLimit) {
+    quality |= SAMPLE_QUALITY_STUCK;
+  }
+
+  state.lastGood = value;
+  state.lastGoodMs = nowMs;
+  state.hasGood = true;
+  state.rocCount = 0;
+  state.invalidCount = 0;
+  state.quality = quality;
+
+  out = value;
+  return quality;
+}
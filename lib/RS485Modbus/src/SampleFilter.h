@@ -0,0 +1,194 @@
+#pragma once
+#include <Arduino.h>
+#include "ModbusRegisterMap.h"
+
+/*
+  SampleFilter
+
+  Range protection after CRC (docs/protocols/range_protection.md): a
+  valid frame is not a valid value. Each decoded field runs through, in
+  order:
+
+    fault word   0xFFFF / 0x7FFF / 0x8000 placeholders (per field type)  rejected
+    hard bounds  the map's min/max                                       rejected
+    ROC          step from last good above rule.rocPerMin                rejected
+                 until rocConfirm samples in a row agree on the new level
+    soft bounds  rule.softMin .. softMax                                 flagged
+    stuck        same raw word stuckLimit times in a row                 flagged
+
+  A rejected field keeps its last good value (QUALITY_HELD; the -99
+  fallback if there never was one) and counts toward invalidCount;
+  SAMPLE_FILTER_FAULT_COUNT rejections in a row raise
+  QUALITY_SENSOR_FAULT until the next accepted sample. One State per
+  field, integer math only, O(1) per sample.
+
+  Drivers filter the frame they just received instead of asking the
+  sensor again: a CRC-valid frame with an impossible value almost
+  always comes back identical on the retry.
+
+    static constexpr SampleFilterRule LEAF_RULES[2] = {
+      SampleFilterRule::none(),                                      // humidity
+      SampleFilterRule::make(LEAF_MAP.fields[1], -20.0, 60.0, 10.0)  // temp, 10 C/min
+    };
+    SampleFilter::State states[2];
+    const uint32_t okMask = SampleFilter::apply(LEAF_MAP, LEAF_RULES, frame, states, values, millis());
+
+  Rules are optional (nullptr: fault words and hard bounds only). ROC is
+  scaled by the time since the last good sample, with one minute as the
+  floor, and skipped when that sample is older than
+  SAMPLE_FILTER_ROC_MAX_AGE_MS.
+
+  States are plain data: on the ESP32 deep-sleep build the drivers'
+  arrays are retained in RTC memory (SensorDriver::filterStates()), so
+  ROC, stuck and last good carry over from one wake to the next.
+*/
+
+#if !defined(SAMPLE_FILTER_FAULT_COUNT)
+  #define SAMPLE_FILTER_FAULT_COUNT 5
+#endif
+
+#if !defined(SAMPLE_FILTER_ROC_CONFIRM)
+  #define SAMPLE_FILTER_ROC_CONFIRM 3
+#endif
+
+#if !defined(SAMPLE_FILTER_ROC_MAX_AGE_MS)
+  #define SAMPLE_FILTER_ROC_MAX_AGE_MS 3600000UL
+#endif
+
+enum SampleQuality : uint8_t {
+  SAMPLE_QUALITY_OK           = 0x00,
+  SAMPLE_QUALITY_FAULT_WORD   = 0x01,  // rejected: placeholder raw word
+  SAMPLE_QUALITY_HARD         = 0x02,  // rejected: outside hard bounds
+  SAMPLE_QUALITY_ROC          = 0x04,  // rejected: step too large
+  SAMPLE_QUALITY_SOFT         = 0x08,  // accepted, outside soft bounds
+  SAMPLE_QUALITY_STUCK        = 0x10,  // accepted, raw word not changing
+  SAMPLE_QUALITY_HELD         = 0x20,  // output is the last good value
+  SAMPLE_QUALITY_SENSOR_FAULT = 0x40   // SAMPLE_FILTER_FAULT_COUNT rejections in a row
+};
+
+static const uint8_t SAMPLE_QUALITY_REJECTED =
+    SAMPLE_QUALITY_FAULT_WORD | SAMPLE_QUALITY_HARD | SAMPLE_QUALITY_ROC;
+
+struct SampleFilterRule {
+  int32_t softMin;      // field scale; softMin > softMax: no soft check
+  int32_t softMax;
+  uint32_t rocPerMin;   // field scale per minute; 0: no ROC check
+  uint8_t rocConfirm;   // agreeing out-of-ROC samples that make a real step; 0: never
+  uint8_t stuckLimit;   // identical raw words before STUCK; 0: off
+
+  // Engineering units, scaled like the field itself.
+  static constexpr SampleFilterRule make(const ModbusFieldSpec &field,
+                                         double softMin,
+                                         double softMax,
+                                         double rocPerMin = 0.0,
+                                         uint8_t rocConfirm = SAMPLE_FILTER_ROC_CONFIRM,
+                                         uint8_t stuckLimit = 0) {
+    return SampleFilterRule{
+        ModbusFieldSpec::toScaled(softMin, (double)FixedSample::pow10(field.decimals)),
+        ModbusFieldSpec::toScaled(softMax, (double)FixedSample::pow10(field.decimals)),
+        (uint32_t)ModbusFieldSpec::toScaled(rocPerMin, (double)FixedSample::pow10(field.decimals)),
+        rocConfirm,
+        stuckLimit};
+  }
+
+  // Fault words and hard bounds only.
+  static constexpr SampleFilterRule none() {
+    return SampleFilterRule{1, 0, 0, 0, 0};
+  }
+};
+
+class SampleFilter {
+public:
+  // Per-field history. Zero-initialised is the valid "nothing seen" state.
+  struct State {
+    FixedSample lastGood;
+    uint32_t lastGoodMs;
+    int32_t lastRaw;
+    int32_t rocCandidate;
+    bool hasGood;
+    bool hasRaw;
+    uint8_t repeats;       // times lastRaw came back unchanged
+    uint8_t rocCount;      // out-of-ROC samples agreeing with rocCandidate
+    uint8_t invalidCount;  // rejections since the last accepted sample
+    uint8_t quality;       // SampleQuality flags of the last sample
+
+    void reset() { *this = State(); }
+  };
+
+  // One field. raw is the sign-extended register value before offset
+  // (ModbusRegisterDecoder::rawValue). Writes the accepted or held
+  // sample to out and returns its quality flags.
+  static uint8_t filter(const ModbusFieldSpec &field,
+                        const SampleFilterRule *rule,
+                        State &state,
+                        int32_t raw,
+                        uint32_t nowMs,
+                        FixedSample &out);
+
+  // Placeholder words for the field's type: 0xFFFF, 0x7FFF and 0x8000
+  // for U16; 0x7FFF and 0x8000 for S16 (0xFFFF is -1 there); the 32-bit
+  // equivalents for U32/S32.
+  static bool isFaultWord(const ModbusFieldSpec &field, int32_t raw);
+
+  // Whole frame for map.block(). rules may be nullptr. Returns the mask
+  // of accepted fields; *quality (optional) gets all fields' flags OR'ed.
+  template <size_t N>
+  static uint32_t apply(const ModbusRegisterMap<N> &map,
+                        const SampleFilterRule rules[],
+                        const uint8_t frame[],
+                        State states[N],
+                        FixedSample out[N],
+                        uint32_t nowMs,
+                        uint8_t *quality = nullptr) {
+    uint32_t okMask = 0;
+    uint8_t all = 0;
+    for (size_t i = 0; i < N; ++i) {
+      const ModbusFieldSpec &field = map.fields[i];
+      const uint8_t q = filter(field,
+                               rules ? &rules[i] : nullptr,
+                               states[i],
+                               ModbusRegisterDecoder::rawValue(field, frame, map.start),
+                               nowMs,
+                               out[i]);
+      if ((q & SAMPLE_QUALITY_REJECTED) == 0) okMask |= (1UL << i);
+      all |= q;
+    }
+    if (quality) *quality = all;
+    return okMask;
+  }
+
+  // Same, straight from the bus RX buffer. A frame too short for the
+  // block is not a sample: every field is held, no state changes.
+  template <size_t N>
+  static uint32_t apply(const ModbusRegisterMap<N> &map,
+                        const SampleFilterRule rules[],
+                        const ModbusFrameView &frame,
+                        State states[N],
+                        FixedSample out[N],
+                        uint32_t nowMs,
+                        uint8_t *quality = nullptr) {
+    if (!frame.hasRegisters(0, map.count)) {
+      for (size_t i = 0; i < N; ++i) out[i] = held(map.fields[i], states[i]);
+      if (quality) *quality = SAMPLE_QUALITY_HELD;
+      return 0;
+    }
+    return apply(map, rules, frame.data(), states, out, nowMs, quality);
+  }
+
+  // Moves lastGoodMs of a State array copied through a deep sleep into
+  // the new boot's timebase (SleepPlanner::retain()), so ROC keeps
+  // scaling by the real time since the last good sample.
+  static void rebaseStates(void *states, size_t size, uint32_t shiftMs);
+
+  // Last good value, or the field's fallback before the first one.
+  static FixedSample held(const ModbusFieldSpec &field, const State &state) {
+    return state.hasGood ? state.lastGood : field.fallback();
+  }
+
+private:
+  static uint32_t distance(int32_t a, int32_t b) {
+    return (a > b) ? (uint32_t)a - (uint32_t)b : (uint32_t)b - (uint32_t)a;
+  }
+
+  static uint32_t rocAllowance(uint32_t rocPerMin, uint32_t elapsedMs);
+};
@@ -0,0 +1,127 @@
+#include "SampleStats.h"
+
+// ============================================================
+// Accumulate
+// ============================================================
+
+void SampleStats::reset() {
+  _ref = 0;
+  _sum = 0;
+  _sumSq = 0;
+  _count = 0;
+  _decimals = 0;
+  _unit = SAMPLE_UNIT_NONE;
+}
+
+bool SampleStats::add(const FixedSample &value) {
+  if (_count >= SAMPLE_STATS_MAX_N) return false;
+
+  if (_count == 0) {
+    _ref = value.raw;
+    _decimals = value.decimals;
+    _unit = value.unit;
+  } else if (value.decimals != _decimals) {
+    return false;
+  }
+
+  const int64_t d = (int64_t)value.raw - (int64_t)_ref;
+  if (d > MAX_SPREAD || d < -(int64_t)MAX_SPREAD) return false;
+
+  _sum += d;
+  _sumSq += d * d;
+
+  // Insertion into the sorted buffer; stable for equal values.
+  uint8_t i = _count;
+  while (i > 0 && _sorted[i - 1] > value.raw) {
+    _sorted[i] = _sorted[i - 1];
+    --i;
+  }
+  _sorted[i] = value.raw;
+  ++_count;
+  return true;
+}
+
+// ============================================================
+// Results
+// ============================================================
+
+FixedSample SampleStats::min() const {
+  return _count ? at(_sorted[0]) : FixedSample::fallback(_decimals, _unit);
+}
+
+FixedSample SampleStats::max() const {
+  return _count ? at(_sorted[_count - 1]) : FixedSample::fallback(_decimals, _unit);
+}
+
+FixedSample SampleStats::mean() const {
+  if (_count == 0) return FixedSample::fallback(_decimals, _unit);
+  return at(_ref + divRound(_sum, _count));
+}
+
+FixedSample SampleStats::median() const {
+  if (_count == 0) return FixedSample::fallback(_decimals, _unit);
+  if (_count & 1) return at(_sorted[_count / 2]);
+  return at(divRound((int64_t)_sorted[_count / 2 - 1] + (int64_t)_sorted[_count / 2], 2));
+}
+
+FixedSample SampleStats::stddev() const {
+  const uint8_t decimals = (_decimals < FIXED_SAMPLE_MAX_DECIMALS) ? (uint8_t)(_decimals + 1) : _decimals;
+  if (_count < 2) return FixedSample::make(0, decimals, _unit);
+
+  // s^2 = (n * sum(d^2) - sum(d)^2) / (n * (n - 1)), scaled by 100 when
+  // reported one decimal finer. With |d| <= MAX_SPREAD and n <= 16 the
+  // numerator stays below 2^63.
+  const int64_t n = _count;
+  uint64_t num = (uint64_t)(n * _sumSq - _sum * _sum);
+  if (decimals != _decimals) num *= 100U;
+  const uint64_t den = (uint64_t)(n * (n - 1));
+
+  return FixedSample::make((int32_t)isqrtRound((num + den / 2) / den), decimals, _unit);
+}
+
+size_t SampleStats::format(char *buf, size_t len) const {
+  if (!buf || len == 0) return 0;
+
+  char mean[16], sd[16], lo[16], hi[16], med[16];
+  this->mean().format(mean, sizeof(mean));
+  stddev().format(sd, sizeof(sd));
+  min().format(lo, sizeof(lo));
+  max().format(hi, sizeof(hi));
+  median().format(med, sizeof(med));
+
+  const int n = snprintf(buf, len, "n=%u mean=%s sd=%s min=%s max=%s med=%s",
+                         (unsigned)_count, mean, sd, lo, hi, med);
+  if (n < 0) {
+    buf[0] = '\0';
+    return 0;
+  }
+  return ((size_t)n < len) ? (size_t)n : len - 1;
+}
+
+// ============================================================
+// Integer helpers
+// ============================================================
+
+int32_t SampleStats::divRound(int64_t num, int64_t den) {
+  const int64_t half = den / 2;
+  return (int32_t)((num >= 0) ? (num + half) / den : (num - half) / den);
+}
+
+uint32_t SampleStats::isqrtRound(uint64_t value) {
+  // Bitwise square root (floor), then round: r + 0.5 < sqrt(v) exactly
+  // when v - r^2 > r.
+  uint64_t rem = value;
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+  while (bit > rem) bit >>= 2;
+  while (bit != 0) {
+    if (rem >= root + bit) {
+      rem -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)((rem > root) ? root + 1 : root);
+}
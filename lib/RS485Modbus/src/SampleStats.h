@@ -0,0 +1,77 @@
+#pragma once
+#include <Arduino.h>
+#include "FixedSample.h"
+
+/*
+  SampleStats
+
+  One-pass summary of a short run of samples of one field (a burst):
+  count, mean, standard deviation, min, max and median, in fixed memory
+  and integer math.
+
+    SampleStats st;
+    st.add(t1); st.add(t2); ...        // FixedSample, all at one scale
+    st.median();  st.mean();  st.stddev();
+
+  Mean and variance follow Welford's approach of accumulating deviations
+  from a reference instead of raw values, with the first sample as a
+  fixed reference: n, sum(d) and sum(d^2) of d = x - x0 are exact int64
+  sums, so there is no cancellation and no float math. Exact while
+  |x - x0| <= MAX_SPREAD, far wider than any hard bound in
+  the register maps; add() refuses samples beyond it.
+
+  The samples are also kept sorted (insertion on add(), at most
+  SAMPLE_STATS_MAX_N) for min, max and the median.
+*/
+
+#if !defined(SAMPLE_STATS_MAX_N)
+  #if defined(ARDUINO_ARCH_AVR)
+    #define SAMPLE_STATS_MAX_N 8
+  #else
+    #define SAMPLE_STATS_MAX_N 16
+  #endif
+#endif
+
+class SampleStats {
+public:
+  static constexpr int32_t MAX_SPREAD = 0x00FFFFFFL;
+
+  SampleStats() { reset(); }
+
+  void reset();
+
+  // False when full, when value's scale differs from the first sample's,
+  // or when it lies more than MAX_SPREAD from the first sample.
+  bool add(const FixedSample &value);
+
+  uint8_t count() const { return _count; }
+  bool empty() const { return _count == 0; }
+
+  // All at the samples' scale and unit; -99 fallback when empty.
+  FixedSample min() const;
+  FixedSample max() const;
+  FixedSample mean() const;    // rounded half away from zero
+  FixedSample median() const;  // mean of the middle two for even counts
+
+  // Sample standard deviation (n - 1), one decimal finer than the samples
+  // (up to FIXED_SAMPLE_MAX_DECIMALS). 0 below two samples.
+  FixedSample stddev() const;
+
+  // "n=5 mean=21.3 sd=0.12 min=21.1 max=21.6 med=21.3". Returns the
+  // length written.
+  size_t format(char *buf, size_t len) const;
+
+private:
+  int32_t _sorted[SAMPLE_STATS_MAX_N];
+  int32_t _ref;      // first sample, reference for the sums
+  int64_t _sum;      // sum of (x - _ref)
+  int64_t _sumSq;    // sum of (x - _ref)^2
+  uint8_t _count;
+  uint8_t _decimals;
+  uint8_t _unit;
+
+  FixedSample at(int32_t raw) const { return FixedSample::make(raw, _decimals, _unit); }
+
+  static int32_t divRound(int64_t num, int64_t den);
+  static uint32_t isqrtRound(uint64_t value);
+};
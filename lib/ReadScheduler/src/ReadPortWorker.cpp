@@ -0,0 +1,86 @@
+#include "ReadPortWorker.h"
+
+ReadPortWorker::ReadPortWorker()
+    : _state(WORKER_IDLE),
+      _sensor(nullptr),
+      _ok(false),
+      _portIndex(0)
+#if defined(ARDUINO_ARCH_ESP32)
+      , _task(nullptr)
+#endif
+{
+}
+
+bool ReadPortWorker::isConcurrent() {
+#if defined(ARDUINO_ARCH_ESP32)
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool ReadPortWorker::begin(uint8_t portIndex) {
+  _portIndex = portIndex;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  if (_task) return true;
+
+  char name[12] = "rs485_p";
+  name[7] = (char)('0' + (portIndex % 10));
+  name[8] = '\0';
+
+  return xTaskCreate(taskEntry,
+                     name,
+                     READ_PORT_WORKER_STACK_SIZE,
+                     this,
+                     READ_PORT_WORKER_PRIORITY,
+                     &_task) == pdPASS;
+#else
+  return true;
+#endif
+}
+
+bool ReadPortWorker::submit(SensorDriver* sensor) {
+  if (!sensor || _state != WORKER_IDLE) return false;
+
+  _sensor = sensor;
+  _ok = false;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  if (!_task) return false;
+  _state = WORKER_RUNNING;
+  xTaskNotifyGive(_task);
+#else
+  _state = WORKER_RUNNING;
+  _ok = sensor->readData();
+  _state = WORKER_DONE;
+#endif
+
+  return true;
+}
+
+bool ReadPortWorker::poll(bool& ok) {
+  if (_state != WORKER_DONE) return false;
+
+  // The task writes _ok before publishing WORKER_DONE.
+  __sync_synchronize();
+  ok = _ok;
+  _sensor = nullptr;
+  _state = WORKER_IDLE;
+  return true;
+}
+
+#if defined(ARDUINO_ARCH_ESP32)
+void ReadPortWorker::taskEntry(void* arg) {
+  ReadPortWorker* self = static_cast<ReadPortWorker*>(arg);
+
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    if (self->_state != WORKER_RUNNING || !self->_sensor) continue;
+
+    self->_ok = self->_sensor->readData();
+    __sync_synchronize();
+    self->_state = WORKER_DONE;
+  }
+}
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+#include <Arduino.h>
+#include "SensorDriver.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+#endif
+
+// ============================================================================
+// ReadPortWorker — runs sensor transactions for one RS485 port
+// ============================================================================
+// ReadScheduler hands one sensor at a time to the worker of the port it is
+// wired to and polls for the result on the next ticks.
+//
+// ESP32: each worker owns a FreeRTOS task. submit() wakes it, the task runs
+// readData() on its own RS485Bus and posts the result, so ports with their
+// own UART are read at the same time while loop() keeps running.
+//
+// AVR (and any target without an RTOS): submit() runs readData() inline and
+// the result is ready immediately. The scheduler then interleaves the ports,
+// one transaction per tick, instead of draining one port before the next.
+//
+// A worker must only be given sensors that use the RS485Bus of its port;
+// two workers never touch the same bus.
+//
+// Usage:
+//   worker.begin(0);
+//   if (!worker.busy()) worker.submit(&sensor);
+//   bool ok; if (worker.poll(ok)) { ...result... }
+// ============================================================================
+
+#if !defined(READ_PORT_WORKER_STACK_SIZE)
+  #define READ_PORT_WORKER_STACK_SIZE 4096
+#endif
+
+#if !defined(READ_PORT_WORKER_PRIORITY)
+  #define READ_PORT_WORKER_PRIORITY 1
+#endif
+
+class ReadPortWorker {
+public:
+  ReadPortWorker();
+
+  // Creates the worker task on ESP32. Safe to call more than once.
+  bool begin(uint8_t portIndex);
+
+  // True when transactions run in their own task (ESP32).
+  static bool isConcurrent();
+
+  // Starts a read. Returns false while a previous read is pending.
+  bool submit(SensorDriver* sensor);
+
+  // True once the submitted read finished; ok receives readData()'s result.
+  // The worker is free again after a successful poll.
+  bool poll(bool& ok);
+
+  bool busy() const { return _state != WORKER_IDLE; }
+  SensorDriver* current() const { return _sensor; }
+
+private:
+  enum WorkerState : uint8_t {
+    WORKER_IDLE = 0,
+    WORKER_RUNNING,
+    WORKER_DONE
+  };
+
+  volatile WorkerState _state;
+  SensorDriver* volatile _sensor;
+  volatile bool _ok;
+  uint8_t _portIndex;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  TaskHandle_t _task;
+  static void taskEntry(void* arg);
+#endif
+};
@@ -0,0 +1,579 @@
+#include "ReadScheduler.h"
+#include "RS485Modbus.h"
+
+ReadScheduler::ReadScheduler(const ReadSchedulerHooks& hooks)
+    : _hooks(hooks),
+      _log(nullptr),
+      _debugEnable(false),
+      _planCount(0),
+      _jobCount(0),
+      _syncReadThisTick(false),
+      _nextSyncInterface(0),
+      _cycleStartMs(0),
+      _lastCycleMs(0),
+      _projectedCycleMs(0),
+      _avgReadMs(0),
+      _inrushActive(false),
+      _inrushUntilMs(0),
+      _transactionBudgetMs(DEFAULT_TRANSACTION_BUDGET_MS),
+      _transactionAttempts(DEFAULT_TRANSACTION_ATTEMPTS),
+      _cycleBudgetMs(DEFAULT_CYCLE_BUDGET_MS),
+      _burstGapMs(DEFAULT_BURST_GAP_MS),
+      _cycleAborted(0),
+      _cycleSkipped(0),
+      _lastCycleAborted(0),
+      _lastCycleSkipped(0) {
+  for (uint8_t i = 0; i < MAX_INTERFACES; ++i) {
+    releaseLane(i);
+  }
+}
+
+void ReadScheduler::setDebug(PrintController* printer, bool enable) {
+  _log = printer;
+  _debugEnable = enable;
+}
+
+void ReadScheduler::setReadBudget(uint32_t transactionMs, uint8_t maxAttempts, uint32_t cycleMs) {
+  _transactionBudgetMs = transactionMs;
+  _transactionAttempts = maxAttempts;
+  _cycleBudgetMs = cycleMs;
+}
+
+size_t ReadScheduler::start(SensorDriver* const sensors[], size_t count, uint32_t nowMs) {
+  if (busy() || !sensors) return 0;
+
+  _planCount = 0;
+  _jobCount = 0;
+  _cycleStartMs = nowMs;
+  _inrushActive = false;
+  _cycleAborted = 0;
+  _cycleSkipped = 0;
+  for (uint8_t i = 0; i < MAX_INTERFACES; ++i) {
+    releaseLane(i);
+  }
+
+  for (size_t i = 0; i < count && _planCount < MAX_SENSORS; ++i) {
+    SensorDriver* s = sensors[i];
+    if (!s || s->getInterfaceIndex() >= MAX_INTERFACES) continue;
+
+    Job* job = nullptr;
+    for (uint8_t j = 0; j < _jobCount; ++j) {
+      if (_jobs[j].powerLine == s->getPowerLineIndex()) {
+        job = &_jobs[j];
+        break;
+      }
+    }
+
+    if (!job) {
+      if (_jobCount >= MAX_JOBS) continue;
+      job = &_jobs[_jobCount++];
+      job->powerLine = s->getPowerLineIndex();
+      job->state = JOB_POWER_ON;
+      job->dueMs = nowMs;
+      job->pendingInterfaces = 0;
+      job->warmUpMs = 0;
+      job->readCount = 0;
+      job->burstGapMs = 0;
+    }
+
+    job->pendingInterfaces |= (uint8_t)(1U << s->getInterfaceIndex());
+    if (burstsBackToBack(s)) {
+      job->readCount = (uint8_t)(job->readCount + s->getBurstReads());
+      job->burstGapMs += (uint32_t)(s->getBurstReads() - 1) * _burstGapMs;
+    } else {
+      ++job->readCount;
+    }
+    if (s->getWarmUpTimeMs() > job->warmUpMs) {
+      job->warmUpMs = s->getWarmUpTimeMs();
+    }
+
+    _plan[_planCount++] = s;
+  }
+
+  orderJobsByWarmUp();
+  orderPlanByBaud();
+  projectCycle();
+
+  return _planCount;
+}
+
+void ReadScheduler::orderJobsByWarmUp() {
+  // Insertion sort, longest warm-up first; equal due times are served in
+  // job order, so this is also the power-on order.
+  for (uint8_t i = 1; i < _jobCount; ++i) {
+    const Job key = _jobs[i];
+    int8_t j = (int8_t)i - 1;
+    while (j >= 0 && _jobs[j].warmUpMs < key.warmUpMs) {
+      _jobs[j + 1] = _jobs[j];
+      --j;
+    }
+    _jobs[j + 1] = key;
+  }
+}
+
+void ReadScheduler::orderPlanByBaud() {
+  // Lanes walk the plan in order; with sensors on one port sorted by line
+  // speed (stable, so plan order within a speed), the UART changes baud
+  // at most once per speed in use instead of once per sensor.
+  uint32_t bauds[MAX_SENSORS];
+  for (uint8_t i = 0; i < _planCount; ++i) {
+    const RS485Bus* bus = busFor(_plan[i]->getInterfaceIndex());
+    bauds[i] = bus ? bus->bauds().baudFor(_plan[i]->getAddress(), bus->getDefaultBaud()) : 0;
+  }
+
+  for (uint8_t i = 1; i < _planCount; ++i) {
+    SensorDriver* const key = _plan[i];
+    const uint32_t keyBaud = bauds[i];
+    int8_t j = (int8_t)i - 1;
+    while (j >= 0 && bauds[j] > keyBaud) {
+      _plan[j + 1] = _plan[j];
+      bauds[j + 1] = bauds[j];
+      --j;
+    }
+    _plan[j + 1] = key;
+    bauds[j + 1] = keyBaud;
+  }
+}
+
+void ReadScheduler::projectCycle() {
+  uint32_t nextSwitchOnMs = 0;
+  uint32_t projected = 0;
+  uint32_t serial = 0;
+
+  for (uint8_t j = 0; j < _jobCount; ++j) {
+    const Job& job = _jobs[j];
+    uint32_t onAtMs = 0;
+
+    if (!_hooks.powerLineIsOn(job.powerLine)) {
+      onAtMs = nextSwitchOnMs;
+      nextSwitchOnMs = onAtMs + inrushMs(job.powerLine);
+    }
+
+    const uint32_t readsMs = (uint32_t)job.readCount * _avgReadMs + job.burstGapMs;
+    const uint32_t endMs = onAtMs + job.warmUpMs + readsMs;
+    if (endMs > projected) projected = endMs;
+    serial += job.warmUpMs + readsMs;
+  }
+
+  _projectedCycleMs = projected;
+
+  if (_log && _debugEnable) {
+    _log->print(F("[SCHED] Projected cycle "), true);
+    _log->print((unsigned long)projected, true, " ms (serial ");
+    _log->print((unsigned long)serial, true, " ms, avg read ");
+    _log->print((unsigned long)_avgReadMs, true, " ms)");
+    _log->println("", true);
+  }
+}
+
+uint32_t ReadScheduler::inrushMs(uint8_t powerLine) const {
+  return _hooks.powerLineInrushMs ? _hooks.powerLineInrushMs(powerLine) : 0;
+}
+
+void ReadScheduler::tick(uint32_t nowMs) {
+  if (_jobCount == 0) return;
+
+  _syncReadThisTick = false;
+
+  // Each job gets at most one step per tick, earliest deadline first.
+  bool stepped[MAX_JOBS] = {false};
+
+  for (uint8_t pass = 0; pass < _jobCount; ++pass) {
+    int8_t pick = -1;
+    for (uint8_t j = 0; j < _jobCount; ++j) {
+      if (stepped[j]) continue;
+      if (_jobs[j].state == JOB_DONE || _jobs[j].state == JOB_IDLE) continue;
+      if (!isDue(nowMs, _jobs[j].dueMs)) continue;
+      if (pick < 0 || (int32_t)(_jobs[j].dueMs - _jobs[pick].dueMs) < 0) {
+        pick = (int8_t)j;
+      }
+    }
+    if (pick < 0) break;
+
+    stepped[pick] = true;
+    stepJob((uint8_t)pick, nowMs);
+  }
+
+  if (allJobsDone()) {
+    _jobCount = 0;
+    _lastCycleMs = nowMs - _cycleStartMs;
+    _lastCycleAborted = _cycleAborted;
+    _lastCycleSkipped = _cycleSkipped;
+
+    if (_log && _debugEnable) {
+      _log->print(F("[SCHED] Cycle done in "), true);
+      _log->print((unsigned long)_lastCycleMs, true, " ms (projected ");
+      _log->print((unsigned long)_projectedCycleMs, true, " ms)");
+      _log->println("", true);
+    }
+  }
+}
+
+uint32_t ReadScheduler::msUntilNextStep(uint32_t nowMs) const {
+  uint32_t best = 0xFFFFFFFFUL;
+
+  for (uint8_t j = 0; j < _jobCount; ++j) {
+    const Job& job = _jobs[j];
+    if (job.state == JOB_DONE || job.state == JOB_IDLE) continue;
+    if (isDue(nowMs, job.dueMs)) return 0;
+
+    const uint32_t wait = job.dueMs - nowMs;
+    if (wait < best) best = wait;
+  }
+
+  return best;
+}
+
+bool ReadScheduler::allJobsDone() const {
+  for (uint8_t j = 0; j < _jobCount; ++j) {
+    if (_jobs[j].state != JOB_DONE) return false;
+  }
+  return true;
+}
+
+void ReadScheduler::stepJob(uint8_t jobIndex, uint32_t nowMs) {
+  Job& job = _jobs[jobIndex];
+
+  switch (job.state) {
+    case JOB_POWER_ON: {
+      if (!_hooks.powerLineIsOn(job.powerLine)) {
+        // Another line is still in its inrush window; switch on after it.
+        if (_inrushActive && !isDue(nowMs, _inrushUntilMs)) {
+          job.dueMs = _inrushUntilMs;
+          break;
+        }
+
+        logStep(job, F("PowerLine is OFF -> enabling"));
+        _hooks.powerLineSet(job.powerLine, true);
+
+        const uint32_t inrush = inrushMs(job.powerLine);
+        _inrushActive = (inrush > 0);
+        _inrushUntilMs = nowMs + inrush;
+      } else {
+        logStep(job, F("PowerLine already ON"));
+      }
+
+      const uint32_t warmUpMs = job.warmUpMs;
+      if (_log && _debugEnable && warmUpMs > 0) {
+        _log->print(F("[SCHED] PowerLine "), true);
+        _log->print((unsigned int)job.powerLine, true, " warm-up = ");
+        _log->print((unsigned long)warmUpMs, true, " ms");
+        _log->println("", true);
+      }
+
+      job.state = JOB_WARM_UP;
+      job.dueMs = nowMs + warmUpMs;
+      break;
+    }
+
+    case JOB_WARM_UP:
+      job.state = JOB_READ_PORTS;
+      job.dueMs = nowMs;
+      stepJob(jobIndex, nowMs);
+      break;
+
+    case JOB_READ_PORTS:
+      stepReadPorts(jobIndex, nowMs);
+      break;
+
+    case JOB_POWER_OFF:
+      if (!_hooks.powerLineShouldStayOn(job.powerLine)) {
+        logStep(job, F("PowerLine can be turned OFF"));
+        _hooks.powerLineSet(job.powerLine, false);
+      } else {
+        logStep(job, F("PowerLine stays ON due to keepPowerOn policy"));
+      }
+      job.state = JOB_DONE;
+      break;
+
+    case JOB_IDLE:
+    case JOB_DONE:
+    default:
+      break;
+  }
+}
+
+void ReadScheduler::stepReadPorts(uint8_t jobIndex, uint32_t nowMs) {
+  Job& job = _jobs[jobIndex];
+
+  // Start with the port after the last inline read, so on AVR the ports
+  // take turns instead of draining one before the next.
+  const uint8_t first = _nextSyncInterface;
+  for (uint8_t k = 0; k < MAX_INTERFACES; ++k) {
+    const uint8_t iface = (uint8_t)((first + k) % MAX_INTERFACES);
+    if (job.pendingInterfaces & (1U << iface)) {
+      stepLane(jobIndex, iface, nowMs);
+    }
+  }
+
+  if (job.pendingInterfaces == 0) {
+    job.state = JOB_POWER_OFF;
+    job.dueMs = nowMs;
+    return;
+  }
+
+  // Poll again next tick while any lane is reading or waiting for a port;
+  // otherwise sleep until the earliest settle or burst-gap deadline.
+  uint32_t next = 0;
+  bool onlySettling = true;
+  for (uint8_t iface = 0; iface < MAX_INTERFACES; ++iface) {
+    if (!(job.pendingInterfaces & (1U << iface))) continue;
+    const Lane& lane = _lanes[iface];
+    if (lane.owner != (int8_t)jobIndex ||
+        (lane.state != LANE_SETTLE && lane.state != LANE_GAP)) {
+      onlySettling = false;
+      break;
+    }
+    if (next == 0 || (int32_t)(lane.dueMs - next) < 0) {
+      next = lane.dueMs;
+    }
+  }
+  job.dueMs = onlySettling ? next : nowMs;
+}
+
+void ReadScheduler::stepLane(uint8_t jobIndex, uint8_t iface, uint32_t nowMs) {
+  Job& job = _jobs[jobIndex];
+  Lane& lane = _lanes[iface];
+  ReadPortWorker& worker = _workers[iface];
+
+  if (lane.owner != (int8_t)jobIndex) {
+    // Another power line is using this port; retry on the next tick.
+    if (lane.owner >= 0) return;
+
+    lane.owner = (int8_t)jobIndex;
+    lane.sensorCursor = 0;
+    _hooks.interfaceSet(iface, true);
+
+    if (_log && _debugEnable) {
+      _log->print(F("[SCHED] PowerLine "), true);
+      _log->print((unsigned int)job.powerLine, true, " -> Interface ");
+      _log->println((unsigned int)iface, true);
+    }
+
+    lane.state = LANE_SETTLE;
+    lane.dueMs = nowMs + (_hooks.interfaceEnableDelayMs ? _hooks.interfaceEnableDelayMs(iface) : 0);
+  }
+
+  if (lane.state == LANE_SETTLE) {
+    if (!isDue(nowMs, lane.dueMs)) return;
+    worker.begin(iface);
+    lane.state = LANE_READY;
+  }
+
+  if (lane.state == LANE_GAP) {
+    if (!isDue(nowMs, lane.dueMs)) return;
+    lane.state = LANE_READY;
+  }
+
+  if (lane.state == LANE_BUSY) {
+    SensorDriver* s = worker.current();
+    bool ok = false;
+    if (!worker.poll(ok)) return;
+
+    lane.state = LANE_READY;
+    finishRead(iface, s, ok, nowMs - lane.startedMs, nowMs);
+  }
+
+  if (lane.state != LANE_READY) return;
+
+  const int16_t idx = findSensor(job.powerLine, iface, lane.sensorCursor);
+  if (idx < 0) {
+    _hooks.interfaceSet(iface, false);
+    releaseLane(iface);
+    job.pendingInterfaces &= (uint8_t)~(1U << iface);
+    return;
+  }
+
+  // Inline workers block for a whole transaction: one per tick in total.
+  if (!ReadPortWorker::isConcurrent()) {
+    if (_syncReadThisTick) return;
+    _syncReadThisTick = true;
+    _nextSyncInterface = (uint8_t)((iface + 1) % MAX_INTERFACES);
+  }
+
+  SensorDriver* s = _plan[idx];
+
+  if (cycleDeadlinePassed(nowMs)) {
+    skipSensor(s);
+    lane.sensorCursor = (uint8_t)(idx + 1);
+    return;
+  }
+
+  if (_log && _debugEnable) {
+    _log->print(F("[SCHED] Reading sensor: "), true);
+    _log->print(s->getSensorId(), true);
+    _log->print(F(" on interface "), true);
+    _log->print((unsigned int)iface, true);
+    if (s->getBurst() && s->getBurstReads() > 1 && s->valueCount() > 0) {
+      const SensorBurst* burst = s->getBurst();
+      const uint8_t read = burst->running() ? (uint8_t)(burst->taken() + 1) : 1;
+      _log->print(F(" (burst "), true);
+      _log->print((unsigned int)read, true, "/");
+      _log->print((unsigned int)s->getBurstReads(), true, ")");
+    }
+    _log->println("", true);
+  }
+
+  armBudget(iface, nowMs);
+
+  lane.sensorCursor = (uint8_t)(idx + 1);
+  lane.currentIndex = (uint8_t)idx;
+
+  if (!worker.submit(s)) {
+    // Worker task could not be created: read inline so the cycle completes.
+    const bool ok = s->readData();
+    finishRead(iface, s, ok, millis() - nowMs, millis());
+    return;
+  }
+
+  lane.state = LANE_BUSY;
+  lane.startedMs = nowMs;
+
+  // Inline workers finish inside submit(); report without waiting a tick.
+  bool ok = false;
+  if (worker.poll(ok)) {
+    lane.state = LANE_READY;
+    finishRead(iface, s, ok, millis() - nowMs, millis());
+  }
+}
+
+RS485Bus* ReadScheduler::busFor(uint8_t iface) const {
+  return _hooks.busForInterface ? _hooks.busForInterface(iface) : nullptr;
+}
+
+bool ReadScheduler::cycleDeadlinePassed(uint32_t nowMs) const {
+  return _cycleBudgetMs > 0 && (nowMs - _cycleStartMs) >= _cycleBudgetMs;
+}
+
+void ReadScheduler::armBudget(uint8_t iface, uint32_t nowMs) {
+  RS485Bus* bus = busFor(iface);
+  if (!bus) return;
+
+  uint32_t budgetMs = _transactionBudgetMs;
+  if (_cycleBudgetMs > 0) {
+    const uint32_t cycleLeftMs = _cycleBudgetMs - (nowMs - _cycleStartMs);
+    if (cycleLeftMs < budgetMs) budgetMs = cycleLeftMs;
+  }
+
+  _budgets[iface].start(nowMs, budgetMs, _transactionAttempts);
+  bus->setBudget(&_budgets[iface]);
+}
+
+bool ReadScheduler::burstsBackToBack(const SensorDriver* sensor) {
+  return sensor->getBurst() && sensor->getBurstReads() > 1 &&
+         sensor->valueCount() > 0 && !sensor->burstSpread();
+}
+
+void ReadScheduler::finishRead(uint8_t iface, SensorDriver* sensor, bool ok, uint32_t durationMs, uint32_t nowMs) {
+  noteReadTime(durationMs);
+
+  RS485Bus* bus = busFor(iface);
+  if (bus) {
+    bus->setBudget(nullptr);
+
+    const ModbusBudget& budget = _budgets[iface];
+    if (budget.abortReason() != ModbusBudget::ABORT_NONE) {
+      ++_cycleAborted;
+      if (_log && _debugEnable) {
+        _log->print(F("[SCHED] "), true);
+        _log->print(sensor->getSensorId(), true, " stopped by budget: ");
+        _log->print(ModbusBudget::reasonName(budget.abortReason()), true);
+        _log->print(F(" after "), true);
+        _log->print((unsigned int)budget.attemptsUsed(), true, " attempts, ");
+        _log->print((unsigned long)durationMs, true, " ms");
+        _log->println("", true);
+      }
+    }
+  }
+
+  SensorBurst* burst = sensor->getBurst();
+  if (burst && sensor->getBurstReads() > 1 && sensor->valueCount() > 0) {
+    burst->add(*sensor, ok);
+
+    if (burst->taken() < sensor->getBurstReads()) {
+      // Spread burst: the next read comes with a later cycle.
+      if (sensor->burstSpread()) return;
+
+      // Back to back: same sensor again after the gap, unless this read
+      // failed or the cycle is out of time.
+      if (ok && !cycleDeadlinePassed(nowMs)) {
+        Lane& lane = _lanes[iface];
+        lane.sensorCursor = lane.currentIndex;
+        lane.state = LANE_GAP;
+        lane.dueMs = nowMs + _burstGapMs;
+        return;
+      }
+    }
+
+    ok = burst->finish(*sensor);
+
+    if (_log && _debugEnable) {
+      _log->print(F("[SCHED] "), true);
+      _log->print(sensor->getSensorId(), true, " burst: ");
+      _log->print((unsigned int)burst->good(), true, "/");
+      _log->print((unsigned int)burst->taken(), true, " reads good");
+      _log->println("", true);
+    }
+  }
+
+  if (_hooks.onSensorRead) {
+    _hooks.onSensorRead(sensor, ok);
+  }
+}
+
+void ReadScheduler::skipSensor(SensorDriver* sensor) {
+  SensorBurst* burst = sensor->getBurst();
+  if (burst && burst->running() && burstsBackToBack(sensor)) {
+    // Out of time between two burst reads: the reads taken so far stand.
+    const bool ok = burst->finish(*sensor);
+    if (_hooks.onSensorRead) {
+      _hooks.onSensorRead(sensor, ok);
+    }
+    return;
+  }
+
+  ++_cycleSkipped;
+
+  if (_log && _debugEnable) {
+    _log->print(F("[SCHED] "), true);
+    _log->print(sensor->getSensorId(), true, " skipped: ");
+    _log->println(ModbusBudget::reasonName(ModbusBudget::ABORT_CYCLE_DEADLINE), true);
+  }
+
+  // Not the sensor's fault: no error count, and it stays due for the
+  // next cycle.
+  sensor->setFallbackValues();
+  if (_hooks.onSensorRead) {
+    _hooks.onSensorRead(sensor, false);
+  }
+}
+
+void ReadScheduler::releaseLane(uint8_t iface) {
+  _lanes[iface].owner = -1;
+  _lanes[iface].state = LANE_FREE;
+  _lanes[iface].dueMs = 0;
+  _lanes[iface].sensorCursor = 0;
+  _lanes[iface].currentIndex = 0;
+  _lanes[iface].startedMs = 0;
+}
+
+void ReadScheduler::noteReadTime(uint32_t durationMs) {
+  _avgReadMs = (_avgReadMs == 0) ? durationMs : (_avgReadMs * 3U + durationMs) / 4U;
+}
+
+int16_t ReadScheduler::findSensor(uint8_t powerLine, uint8_t interfaceIndex, uint8_t fromIndex) const {
+  for (uint8_t i = fromIndex; i < _planCount; ++i) {
+    if (_plan[i]->getPowerLineIndex() == powerLine &&
+        _plan[i]->getInterfaceIndex() == interfaceIndex) {
+      return (int16_t)i;
+    }
+  }
+  return -1;
+}
+
+void ReadScheduler::logStep(const Job& job, const __FlashStringHelper* msg) const {
+  if (!_log || !_debugEnable) return;
+  _log->print(F("[SCHED] PowerLine "), true);
+  _log->print((unsigned int)job.powerLine, true, ": ");
+  _log->println(msg, true);
+}
@@ -0,0 +1,221 @@
+#pragma once
+#include <Arduino.h>
+#include "PrintController.h"
+#include "SensorDriver.h"
+#include "ReadPortWorker.h"
+#include "ModbusBudget.h"
+#include "SensorBurst.h"
+
+class RS485Bus;
+
+// ============================================================================
+// ReadScheduler — non-blocking read cycle for powered sensor groups
+// ============================================================================
+// Replaces the delay()-based read plan execution. Every power line with due
+// sensors becomes a job that walks through:
+//
+//   POWER_ON -> WARM_UP -> READ_PORTS -> POWER_OFF
+//
+// In READ_PORTS every RS485 interface of the power line is a lane:
+//
+//   ENABLE -> SETTLE -> (READY -> BUSY)... -> DISABLE
+//
+// Lanes hand their sensors to the ReadPortWorker of that port. On ESP32 the
+// workers are FreeRTOS tasks, so all ports of a power line are polled at the
+// same time and the read phase lasts as long as the slowest port. On AVR the
+// workers run inline and tick() starts at most one transaction in total,
+// rotating over the ports, so loop latency stays bounded by one transaction.
+//
+// Each tick() performs at most one step per job whose deadline has passed,
+// then returns. Warm-ups on different power lines run in parallel, and the
+// main loop keeps servicing the CLI, rain counters and the watchdog.
+//
+// Power-on order: longest warm-up first, so a cycle with 1 s, 5 s and 30 s
+// warm-ups lasts about 30 s instead of 36 s. When the PCB declares an inrush
+// window for a line, no other line is switched on until it has passed.
+// start() prints the projected cycle time (and the strictly serial one),
+// tick() the achieved time when the cycle ends.
+//
+// An RS485 interface is owned by one job from enable to disable, so two
+// power lines sharing a port never toggle it under each other.
+//
+// Within a port, sensors are read grouped by line speed (the bus's
+// ModbusBaudTable), so the UART switches baud once per speed in use.
+//
+// Read budget: every sensor transaction runs under one ModbusBudget
+// (time + attempts) set on its port's bus, shared by the driver's and the
+// bus's retries, so a missing sensor costs at most the transaction budget.
+// The budget is also clipped to the cycle deadline; sensors not started by
+// then are skipped (fallback values, reported as failed, still due).
+//
+// Bursts (SensorBurst): a sensor with a burst on a switched line is read
+// several times in a row, setBurstGap() apart, before the lane moves on;
+// onSensorRead fires once with the reduced values. A keep-powered sensor
+// instead takes one burst read per cycle (its read interval is divided
+// by the burst size) and reports after the last one.
+//
+// Hardware access stays in main.cpp through ReadSchedulerHooks.
+//
+// Usage:
+//   scheduler.start(plan, planCount, millis());
+//   loop() { scheduler.tick(millis()); ...other work... }
+// ============================================================================
+
+struct ReadSchedulerHooks {
+  void (*powerLineSet)(uint8_t powerLine, bool on);
+  bool (*powerLineIsOn)(uint8_t powerLine);
+  bool (*powerLineShouldStayOn)(uint8_t powerLine);
+  void (*interfaceSet)(uint8_t interfaceIndex, bool on);
+  uint32_t (*interfaceEnableDelayMs)(uint8_t interfaceIndex);
+  void (*onSensorRead)(SensorDriver* sensor, bool ok);  // optional
+  uint32_t (*powerLineInrushMs)(uint8_t powerLine);     // optional, 0 = no limit
+  RS485Bus* (*busForInterface)(uint8_t interfaceIndex); // optional, enables read budgets
+};
+
+class ReadScheduler {
+public:
+  static const uint8_t MAX_JOBS = 8;         // power lines per cycle
+  static const uint8_t MAX_SENSORS = 16;     // sensors per cycle
+  static const uint8_t MAX_INTERFACES = 4;   // RS485 ports
+
+  static const uint32_t DEFAULT_TRANSACTION_BUDGET_MS = 3000;
+  static const uint8_t DEFAULT_TRANSACTION_ATTEMPTS = 6;
+  static const uint32_t DEFAULT_CYCLE_BUDGET_MS = 120000;
+  static const uint32_t DEFAULT_BURST_GAP_MS = 1000;
+
+  enum JobState : uint8_t {
+    JOB_IDLE = 0,
+    JOB_POWER_ON,
+    JOB_WARM_UP,
+    JOB_READ_PORTS,
+    JOB_POWER_OFF,
+    JOB_DONE
+  };
+
+  explicit ReadScheduler(const ReadSchedulerHooks& hooks);
+
+  void setDebug(PrintController* printer, bool enable);
+
+  // Per-sensor transaction budget and whole-cycle deadline (from start()).
+  // cycleMs = 0 disables the cycle deadline.
+  void setReadBudget(uint32_t transactionMs, uint8_t maxAttempts, uint32_t cycleMs);
+
+  // Pause between back-to-back burst reads of one sensor; the lane's
+  // other sensors wait, other lanes keep going.
+  void setBurstGap(uint32_t gapMs) { _burstGapMs = gapMs; }
+
+  // Starts a cycle over the given sensors. Ignored while a cycle is running.
+  // Returns the number of sensors accepted.
+  size_t start(SensorDriver* const sensors[], size_t count, uint32_t nowMs);
+
+  // Advances the cycle. Never blocks on ESP32; on AVR at most one sensor
+  // transaction runs inside a call.
+  void tick(uint32_t nowMs);
+
+  bool busy() const { return _jobCount > 0 && !allJobsDone(); }
+
+  // Milliseconds until the next job step is due (0 = due now).
+  // Returns 0xFFFFFFFF when idle.
+  uint32_t msUntilNextStep(uint32_t nowMs) const;
+
+  // Duration of the last finished cycle, start() to last POWER_OFF.
+  uint32_t lastCycleMs() const { return _lastCycleMs; }
+
+  // Cycle time projected by start() from warm-ups, inrush windows and the
+  // measured average transaction time.
+  uint32_t projectedCycleMs() const { return _projectedCycleMs; }
+
+  // Transactions of the last finished cycle stopped by their budget, and
+  // sensors skipped at the cycle deadline.
+  uint8_t lastCycleAborted() const { return _lastCycleAborted; }
+  uint8_t lastCycleSkipped() const { return _lastCycleSkipped; }
+
+private:
+  enum LaneState : uint8_t {
+    LANE_FREE = 0,
+    LANE_SETTLE,   // interface enabled, waiting for its stabilization delay
+    LANE_READY,    // worker idle, next sensor can be submitted
+    LANE_BUSY,     // worker is running a transaction
+    LANE_GAP       // between two burst reads of the same sensor
+  };
+
+  struct Job {
+    uint8_t powerLine;
+    JobState state;
+    uint32_t dueMs;
+    uint8_t pendingInterfaces;  // bit i: interface i still has sensors to read
+    uint32_t warmUpMs;
+    uint8_t readCount;          // transactions planned, burst reads included
+    uint32_t burstGapMs;        // planned pauses between burst reads
+  };
+
+  struct Lane {
+    int8_t owner;          // job index, -1 when the interface is free
+    LaneState state;
+    uint32_t dueMs;
+    uint8_t sensorCursor;  // next plan index to check on this interface
+    uint8_t currentIndex;  // plan index of the last submitted sensor
+    uint32_t startedMs;    // submit time of the running transaction
+  };
+
+  ReadSchedulerHooks _hooks;
+  PrintController* _log;
+  bool _debugEnable;
+
+  SensorDriver* _plan[MAX_SENSORS];
+  uint8_t _planCount;
+
+  // Deadline queue: jobs are served earliest-due first.
+  Job _jobs[MAX_JOBS];
+  uint8_t _jobCount;
+
+  Lane _lanes[MAX_INTERFACES];
+  ReadPortWorker _workers[MAX_INTERFACES];
+  bool _syncReadThisTick;
+  uint8_t _nextSyncInterface;  // AVR round-robin start
+
+  uint32_t _cycleStartMs;
+  uint32_t _lastCycleMs;
+  uint32_t _projectedCycleMs;
+  uint32_t _avgReadMs;       // moving average of one sensor transaction
+
+  bool _inrushActive;
+  uint32_t _inrushUntilMs;   // no line may switch on before this
+
+  ModbusBudget _budgets[MAX_INTERFACES];
+  uint32_t _transactionBudgetMs;
+  uint8_t _transactionAttempts;
+  uint32_t _cycleBudgetMs;
+  uint32_t _burstGapMs;
+  uint8_t _cycleAborted;
+  uint8_t _cycleSkipped;
+  uint8_t _lastCycleAborted;
+  uint8_t _lastCycleSkipped;
+
+  static bool isDue(uint32_t nowMs, uint32_t dueMs) {
+    return (int32_t)(nowMs - dueMs) >= 0;
+  }
+
+  bool allJobsDone() const;
+  void stepJob(uint8_t jobIndex, uint32_t nowMs);
+  void stepReadPorts(uint8_t jobIndex, uint32_t nowMs);
+  void stepLane(uint8_t jobIndex, uint8_t iface, uint32_t nowMs);
+  void releaseLane(uint8_t iface);
+
+  RS485Bus* busFor(uint8_t iface) const;
+  bool cycleDeadlinePassed(uint32_t nowMs) const;
+  void armBudget(uint8_t iface, uint32_t nowMs);
+  void finishRead(uint8_t iface, SensorDriver* sensor, bool ok, uint32_t durationMs, uint32_t nowMs);
+  static bool burstsBackToBack(const SensorDriver* sensor);
+  void skipSensor(SensorDriver* sensor);
+
+  void orderJobsByWarmUp();
+  void orderPlanByBaud();
+  void projectCycle();
+  uint32_t inrushMs(uint8_t powerLine) const;
+  void noteReadTime(uint32_t durationMs);
+
+  int16_t findSensor(uint8_t powerLine, uint8_t interfaceIndex, uint8_t fromIndex) const;
+
+  void logStep(const Job& job, const __FlashStringHelper* msg) const;
+};
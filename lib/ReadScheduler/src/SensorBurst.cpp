@@ -0,0 +1,67 @@
+#include "SensorBurst.h"
+
+SensorBurst::SensorBurst(Reduce reduce)
+    : _reduce(reduce),
+      _fieldCount(0),
+      _taken(0),
+      _good(0),
+      _finished(true) {}
+
+// ============================================================
+// Burst
+// ============================================================
+
+void SensorBurst::add(SensorDriver& sensor, bool ok) {
+  if (_finished) {
+    const uint8_t fields = sensor.valueCount();
+    _fieldCount = (fields < SENSOR_BURST_MAX_FIELDS) ? fields : (uint8_t)SENSOR_BURST_MAX_FIELDS;
+    for (uint8_t i = 0; i < _fieldCount; ++i) _stats[i].reset();
+    _taken = 0;
+    _good = 0;
+    _finished = false;
+  }
+
+  if (_taken < 255) ++_taken;
+  if (!ok) return;
+  ++_good;
+
+  for (uint8_t i = 0; i < _fieldCount; ++i) {
+    const FixedSample* value = sensor.valueAt(i);
+    // A field without a value this read (fallback) does not vote.
+    if (value && !value->isFallback()) _stats[i].add(*value);
+  }
+}
+
+bool SensorBurst::finish(SensorDriver& sensor) {
+  _finished = true;
+  if (_good == 0) return false;
+
+  for (uint8_t i = 0; i < _fieldCount; ++i) {
+    FixedSample* value = sensor.valueAt(i);
+    if (!value || _stats[i].empty()) continue;
+    *value = (_reduce == REDUCE_MEAN) ? _stats[i].mean() : _stats[i].median();
+  }
+  return true;
+}
+
+// ============================================================
+// Summary
+// ============================================================
+
+size_t SensorBurst::format(char* buf, size_t len) const {
+  if (!buf || len == 0) return 0;
+  buf[0] = '\0';
+
+  size_t used = 0;
+  for (uint8_t i = 0; i < _fieldCount && used + 1 < len; ++i) {
+    const int n = snprintf(buf + used, len - used, "%s%u: ", (i == 0) ? "" : "; ", (unsigned)i);
+    if (n < 0) break;
+    used += (size_t)n;
+    if (used + 1 >= len) {
+      used = len - 1;
+      break;
+    }
+    used += _stats[i].format(buf + used, len - used);
+  }
+  return used;
+}
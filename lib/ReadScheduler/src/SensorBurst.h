@@ -0,0 +1,88 @@
+#pragma once
+#include <Arduino.h>
+#include "SensorDriver.h"
+#include "SampleStats.h"
+
+// ============================================================================
+// SensorBurst — several reads per sample interval, reduced to one sample
+// ============================================================================
+// Soil EC, pH and leaf wetness scatter from one read to the next; one read
+// per interval logs that noise. With a burst a sensor is read N times and
+// every field is reduced to one value (median by default, robust against
+// a single odd read; or the mean), with its SampleStats kept for the log:
+//
+//   "0: n=5 mean=21.3 sd=0.12 min=21.1 max=21.6 med=21.3; 1: n=5 ..."
+//
+// ReadScheduler runs the reads:
+//   - switched power line: back to back in the same cycle, burstGapMs
+//     apart, while the line is still warm. A failed read or the cycle
+//     deadline ends the burst early, so an absent sensor costs one
+//     transaction budget, not N.
+//   - keep-powered sensor (shouldKeepPowerOn()): one read every
+//     interval / N, so the burst spans the whole interval. A station that
+//     deep-sleeps between those reads must retain the SensorBurst
+//     (SleepPlanner::retain(); plain data, no times) or every wake starts
+//     a new burst and none completes.
+// onSensorRead fires once per burst, after finish() has written the
+// reduced values into the driver's fields.
+//
+// Fields come from SensorDriver::valueAt(); drivers without FixedSample
+// fields (rain counters) are never burst. Reads up to SAMPLE_STATS_MAX_N,
+// fields up to SENSOR_BURST_MAX_FIELDS.
+//
+// Usage:
+//   static SensorBurst leafBurst;
+//   sensor_leaf_00.setBurst(&leafBurst, 5);
+// ============================================================================
+
+#if !defined(SENSOR_BURST_MAX_FIELDS)
+  #if defined(ARDUINO_ARCH_AVR)
+    #define SENSOR_BURST_MAX_FIELDS 4
+  #else
+    #define SENSOR_BURST_MAX_FIELDS 8
+  #endif
+#endif
+
+class SensorBurst {
+public:
+  enum Reduce : uint8_t {
+    REDUCE_MEDIAN = 0,
+    REDUCE_MEAN
+  };
+
+  explicit SensorBurst(Reduce reduce = REDUCE_MEDIAN);
+
+  Reduce getReduce() const { return _reduce; }
+  void setReduce(Reduce reduce) { _reduce = reduce; }
+
+  // One finished read of sensor. The first read of a burst clears the
+  // statistics of the previous one. Failed reads count as taken only.
+  void add(SensorDriver& sensor, bool ok);
+
+  // True from the first add() of a burst until finish().
+  bool running() const { return !_finished; }
+
+  uint8_t taken() const { return _taken; }
+  uint8_t good() const { return _good; }
+
+  // Ends the burst: writes the reduced value of every field into the
+  // driver. Fields keep the last read when no read was good. Returns true
+  // when at least one read was. Statistics stay readable until the next
+  // burst starts.
+  bool finish(SensorDriver& sensor);
+
+  uint8_t fieldCount() const { return _fieldCount; }
+  const SampleStats& stats(uint8_t field) const { return _stats[field]; }
+
+  // Summary of the last burst, one "<field index>: <stats>" group per
+  // field, "; " separated. Returns the length written.
+  size_t format(char* buf, size_t len) const;
+
+private:
+  SampleStats _stats[SENSOR_BURST_MAX_FIELDS];
+  Reduce _reduce;
+  uint8_t _fieldCount;
+  uint8_t _taken;
+  uint8_t _good;
+  bool _finished;
+};
@@ -22,7 +22,7 @@ GenericRainGauge::GenericRainGauge(const char* sensorId,
                        warmUpTimeMs,
                        maxConsecutiveErrors,
                        minUsefulPowerOffMs,
-                       MM_PER_PULSE,
+                       MM_PER_PULSE_SCALED,
                        countingMode,
                        pcf8574Address,
                        counterResetPin,
@@ -3,7 +3,7 @@
 
 class GenericRainGauge : public RainGaugeCounter {
 public:
-  static constexpr double MM_PER_PULSE = 0.2794;
+  static const uint32_t MM_PER_PULSE_SCALED = 2794;  // 0.2794 mm
 
   GenericRainGauge(const char* sensorId,
                    bool debugEnable,
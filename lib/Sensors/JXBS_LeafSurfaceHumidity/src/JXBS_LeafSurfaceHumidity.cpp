@@ -1,5 +1,4 @@
 #include "JXBS_LeafSurfaceHumidity.h"
-#include <math.h>
 
 static bool responseIsJXBSAddressChange(const uint8_t* frame,
                                         uint8_t oldAddress,
@@ -16,22 +15,38 @@ static bool responseIsJXBSAddressChange(const uint8_t* frame,
          RS485Bus::verifyCrc16ModbusFrame(frame, 8);
 }
 
-static double decodeJXBSTemperatureC(uint16_t rawTemperature) {
-  // Empirically verified for this tested sensor batch:
-  //   room raw 1961 -> 18.05 C
-  //   warm stage raw 2237 -> 31.85 C
-  //   warm water raw 2282 -> 34.10 C
-  //   cold water raw 1703 -> 5.15 C
-  double temp_corrected = rawTemperature  / 100.0;
-  return temp_corrected;
-}
+enum JXBSLeafField : uint8_t {
+  JXBS_LEAF_HUMIDITY = 0,
+  JXBS_LEAF_TEMPERATURE
+};
+
+// Temperature scaling was verified empirically for this tested sensor batch:
+//   room raw 1961 -> 18.05 C
+//   warm stage raw 2237 -> 31.85 C
+//   warm water raw 2282 -> 34.10 C
+//   cold water raw 1703 -> 5.15 C
+static constexpr ModbusRegisterMap<2> JXBS_LEAF_MAP = {
+  0x0020, 2, {
+    {0x0020, MODBUS_FIELD_U16,  10.0, 0.0,   0.0, 100.0, SAMPLE_UNIT_PERCENT_RH},  // humidity
+    {0x0021, MODBUS_FIELD_U16, 100.0, 0.0, -20.0,  80.0, SAMPLE_UNIT_CELSIUS}      // temperature
+  }
+};
+static_assert(JXBS_LEAF_MAP.isValid(), "JXBS_LEAF_MAP field outside block");
+static_assert(JXBS_LEAF_MAP.responseSize() == 9, "JXBS_LEAF_MAP does not match READ_RESPONSE_SIZE");
+
+// Same policy as the Rika leaf sensor: humidity follows dew freely,
+// temperature may not move more than 10 C per minute.
+static constexpr SampleFilterRule JXBS_LEAF_RULES[2] = {
+  SampleFilterRule::none(),                                                             // humidity
+  SampleFilterRule::make(JXBS_LEAF_MAP.fields[JXBS_LEAF_TEMPERATURE], -20.0, 60.0, 10.0)  // temperature
+};
 
 static void logParsedJXBSLeaf(PrintController* log,
                               bool debug,
                               uint16_t rawHumidity,
                               uint16_t rawTemperature,
-                              double humidity,
-                              double temperature) {
+                              const FixedSample& humidity,
+                              const FixedSample& temperature) {
   if (!log || !debug) return;
 
   log->println(F("[DRV][JXBS_LeafSurfaceHumidity] Parsed response:"), true);
@@ -39,13 +54,13 @@ static void logParsedJXBSLeaf(PrintController* log,
   log->print(F("  humidity raw = "), true);
   log->print((unsigned int)rawHumidity, true, "", DEC);
   log->print(F(" | humidity = "), true);
-  log->print(humidity, true, " %RH", 1);
+  log->printFixed(humidity.raw, humidity.decimals, true, " %RH");
   log->println("", true);
 
   log->print(F("  temperature raw = "), true);
   log->print((unsigned int)rawTemperature, true, "", DEC);
   log->print(F(" | formula = rawTemperature /100; | temperature = "), true);
-  log->print(temperature, true, " C", 2);
+  log->printFixed(temperature.raw, temperature.decimals, true, " C");
   log->println("", true);
 }
 
@@ -68,24 +83,21 @@ JXBS_LeafSurfaceHumidity::JXBS_LeafSurfaceHumidity(RS485Bus& bus,
                    warmUpTimeMs,
                    maxConsecutiveErrors,
                    minUsefulPowerOffMs),
-      leaf_humidity(0.0),
-      leaf_temperature(0.0),
+      leaf_humidity(JXBS_LEAF_MAP.fields[JXBS_LEAF_HUMIDITY].sample(0)),
+      leaf_temperature(JXBS_LEAF_MAP.fields[JXBS_LEAF_TEMPERATURE].sample(0)),
       _bus(bus),
-      _lastParsedFrame(false) {}
+      _lastParsedFrame(false),
+      _readRequest(JXBS_LEAF_MAP.request(address)),
+      _filter() {}
 
-void JXBS_LeafSurfaceHumidity::setFallbackValues() {
-  leaf_humidity = -99.0;
-  leaf_temperature = -99.0;
+void JXBS_LeafSurfaceHumidity::setAddress(uint8_t address) {
+  SensorDriver::setAddress(address);
+  _readRequest = JXBS_LEAF_MAP.request(address);
 }
 
-bool JXBS_LeafSurfaceHumidity::validateHumidityTemperature() const {
-  if (isnan(leaf_humidity) || isnan(leaf_temperature)) {
-    return false;
-  }
-
-  if (leaf_humidity < 0.0 || leaf_humidity > 100.0) return false;
-  if (leaf_temperature < -20.0 || leaf_temperature > 80.0) return false;
-  return true;
+void JXBS_LeafSurfaceHumidity::setFallbackValues() {
+  leaf_humidity = JXBS_LEAF_MAP.fields[JXBS_LEAF_HUMIDITY].fallback();
+  leaf_temperature = JXBS_LEAF_MAP.fields[JXBS_LEAF_TEMPERATURE].fallback();
 }
 
 bool JXBS_LeafSurfaceHumidity::readHumidityTemperature(uint8_t driverRetries,
@@ -94,35 +106,38 @@ bool JXBS_LeafSurfaceHumidity::readHumidityTemperature(uint8_t driverRetries,
   if (driverRetries == 0) driverRetries = 1;
   _lastParsedFrame = false;
 
-  for (uint8_t attempt = 1; attempt <= driverRetries; ++attempt) {
-    uint8_t request[READ_REQUEST_SIZE] = {
-      _address, 0x03, 0x00, 0x20, 0x00, 0x02, 0x00, 0x00
-    };
+  const uint8_t check[READ_CHECK_SIZE] = {_address, 0x03, JXBS_LEAF_MAP.byteCount()};
+  ModbusFrameView frame;
 
-    uint8_t response[READ_RESPONSE_SIZE] = {0};
-    const uint8_t check[READ_CHECK_SIZE] = {_address, 0x03, 0x04};
-
-    const bool ok = _bus.SendRequest(request,
-                                     READ_REQUEST_SIZE,
-                                     response,
-                                     READ_RESPONSE_SIZE,
-                                     check,
-                                     READ_CHECK_SIZE,
-                                     SENSOR_DEFAULT_BUS_RETRIES,
-                                     readTimeoutMs,
-                                     _debugEnable,
-                                     afterReqDelayMs);
+  for (uint8_t attempt = 1; attempt <= driverRetries; ++attempt) {
+    const bool ok = _bus.transact(_readRequest,
+                                  READ_RESPONSE_SIZE,
+                                  check,
+                                  READ_CHECK_SIZE,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  readTimeoutMs,
+                                  _debugEnable,
+                                  afterReqDelayMs);
     if (!ok) {
+      if (_bus.lastWasException()) break;
       continue;
     }
 
     _lastParsedFrame = true;
 
-    const uint16_t rawHumidity = ((uint16_t)response[3] << 8) | response[4];
-    const uint16_t rawTemperature = ((uint16_t)response[5] << 8) | response[6];
+    FixedSample values[2];
+    uint8_t quality = SAMPLE_QUALITY_OK;
+    const uint32_t okMask = SampleFilter::apply(JXBS_LEAF_MAP, JXBS_LEAF_RULES, frame,
+                                                _filter, values, millis(), &quality);
+    leaf_humidity = values[JXBS_LEAF_HUMIDITY];
+    leaf_temperature = values[JXBS_LEAF_TEMPERATURE];
+    setSampleQuality(quality);
 
-    leaf_humidity = (double)rawHumidity / 10.0;
-    leaf_temperature = decodeJXBSTemperatureC(rawTemperature);
+    const uint16_t rawHumidity =
+        (uint16_t)ModbusRegisterDecoder::rawValue(JXBS_LEAF_MAP.fields[JXBS_LEAF_HUMIDITY], frame.data(), JXBS_LEAF_MAP.start);
+    const uint16_t rawTemperature =
+        (uint16_t)ModbusRegisterDecoder::rawValue(JXBS_LEAF_MAP.fields[JXBS_LEAF_TEMPERATURE], frame.data(), JXBS_LEAF_MAP.start);
 
     logParsedJXBSLeaf(_bus.getLogger(),
                       _debugEnable,
@@ -131,15 +146,19 @@ bool JXBS_LeafSurfaceHumidity::readHumidityTemperature(uint8_t driverRetries,
                       leaf_humidity,
                       leaf_temperature);
 
-    if (validateHumidityTemperature()) {
+    if (okMask == JXBS_LEAF_MAP.allFieldsMask()) {
       return true;
     }
 
+    // Rejected values are held at their last good reading. The sensor
+    // would answer a retry with the same frame, so stop here.
     if (_bus.getLogger() && _debugEnable) {
-      _bus.getLogger()->println(
-          F("[DRV][JXBS_LeafSurfaceHumidity] Range check fail: parsed values are outside allowed range"),
-          true);
+      _bus.getLogger()->print(
+          F("[DRV][JXBS_LeafSurfaceHumidity] Range check fail, quality 0x"), true);
+      _bus.getLogger()->print((unsigned int)quality, true, "", HEX);
+      _bus.getLogger()->println("", true);
     }
+    break;
   }
 
   return false;
@@ -159,6 +178,7 @@ bool JXBS_LeafSurfaceHumidity::readData() {
 
     if (_lastParsedFrame) {
       gotAnyValidFrame = true;
+      break;
     }
   }
 
@@ -190,7 +210,7 @@ bool JXBS_LeafSurfaceHumidity::changeAddress(uint8_t newAddress,
     _bus.CRC_Calc(request, sizeof(request), _debugEnable);
     _bus.Request_RS485(request, sizeof(request), afterReqDelayMs, _debugEnable);
 
-    const size_t bytesRead = _bus.Read_RS485(readTimeoutMs, _debugEnable);
+    const size_t bytesRead = _bus.Read_RS485(readTimeoutMs, sizeof(request), _debugEnable);
     const uint8_t* raw = _bus.rawData();
 
     if (bytesRead >= 8 && raw) {
@@ -202,7 +222,7 @@ bool JXBS_LeafSurfaceHumidity::changeAddress(uint8_t newAddress,
             _bus.getLogger()->println(raw[offset] == newAddress ? F(" (new address)") : F(" (old address)"), true);
           }
 
-          _address = newAddress;
+          setAddress(newAddress);
           return true;
         }
       }
@@ -222,26 +242,25 @@ uint8_t JXBS_LeafSurfaceHumidity::scanForAddress(uint8_t startAddr,
   if (endAddr > 247) endAddr = 247;
   if (startAddr > endAddr) return 0;
 
+  ModbusFrameView frame;
   for (uint16_t addr = startAddr; addr <= endAddr; ++addr) {
     uint8_t request[READ_REQUEST_SIZE] = {
       (uint8_t)addr, 0x03, 0x00, 0x20, 0x00, 0x02, 0x00, 0x00
     };
-
-    uint8_t response[READ_RESPONSE_SIZE] = {0};
     const uint8_t check[READ_CHECK_SIZE] = {(uint8_t)addr, 0x03, 0x04};
 
-    const bool found = _bus.SendRequest(request,
-                                        READ_REQUEST_SIZE,
-                                        response,
-                                        READ_RESPONSE_SIZE,
-                                        check,
-                                        READ_CHECK_SIZE,
-                                        1,
-                                        readTimeoutMs,
-                                        _debugEnable,
-                                        afterReqDelayMs);
+    const bool found = _bus.transact(request,
+                                     READ_REQUEST_SIZE,
+                                     READ_RESPONSE_SIZE,
+                                     check,
+                                     READ_CHECK_SIZE,
+                                     frame,
+                                     1,
+                                     readTimeoutMs,
+                                     _debugEnable,
+                                     afterReqDelayMs);
     if (found) {
-      _address = (uint8_t)addr;
+      setAddress((uint8_t)addr);
       return (uint8_t)addr;
     }
 
@@ -10,7 +10,7 @@
   Driver intent:
   - RS485 Modbus RTU driver for JXBS-3001-YMSD / JXBS-style leaf surface
     humidity transmitters.
-  - Primary measurements:
+  - Primary measurements (FixedSample; humidity 1 decimal, temperature 2):
       leaf_humidity    -> %RH
       leaf_temperature -> degrees Celsius
 
@@ -20,13 +20,14 @@
   - Count: 2 registers
   - Payload map:
       reg 0x0020 = leaf surface humidity, unsigned, /10
-      reg 0x0021 = leaf temperature for this tested batch, unsigned,
-                   raw * 0.05 - 80.0
+      reg 0x0021 = leaf temperature for this tested batch, unsigned, /100
+  - Decoding and range limits live in JXBS_LEAF_MAP, range protection
+    (fault words, temperature rate of change) in JXBS_LEAF_RULES (.cpp).
+    A rejected value keeps the last good one and is not re-polled.
 
   Temperature note:
   - This sensor batch does not match the older signed int16 /10 decoding.
-  - Keep bytes [5],[6] big-endian; only the formula is different.
-  - Equivalent formula: (raw - 1600) / 20.0
+  - Keep bytes [5],[6] big-endian; only the scale is different.
 
   Configuration command:
   - Function: 0x06
@@ -34,8 +35,8 @@
 */
 class JXBS_LeafSurfaceHumidity : public SensorDriver {
 public:
-  double leaf_humidity;
-  double leaf_temperature;
+  FixedSample leaf_humidity;
+  FixedSample leaf_temperature;
 
   JXBS_LeafSurfaceHumidity(RS485Bus& bus,
                            const char* sensorId,
@@ -51,6 +52,22 @@ public:
   bool readData() override;
   void setFallbackValues() override;
 
+  // leaf_humidity, leaf_temperature, for burst statistics.
+  uint8_t valueCount() const override { return 2; }
+  FixedSample* valueAt(uint8_t index) override {
+    switch (index) {
+      case 0: return &leaf_humidity;
+      case 1: return &leaf_temperature;
+      default: return nullptr;
+    }
+  }
+
+  // _filter[], kept through deep sleep (SleepPlanner::retain()).
+  void* filterStates(size_t& bytes) override {
+    bytes = sizeof(_filter);
+    return _filter;
+  }
+
   bool readHumidityTemperature(uint8_t driverRetries = SENSOR_DEFAULT_DRIVER_RETRIES,
                                uint16_t readTimeoutMs = SENSOR_DEFAULT_READ_TIMEOUT_MS,
                                uint16_t afterReqDelayMs = SENSOR_DEFAULT_AFTER_REQ_MS);
@@ -60,6 +77,9 @@ public:
                      uint16_t readTimeoutMs = 500,
                      uint16_t afterReqDelayMs = SENSOR_DEFAULT_AFTER_REQ_MS);
 
+  // Keeps the cached read request in step with the address.
+  void setAddress(uint8_t address) override;
+
   uint8_t scanForAddress(uint8_t startAddr = 1,
                          uint8_t endAddr = 247,
                          uint16_t readTimeoutMs = 150,
@@ -68,8 +88,8 @@ public:
 private:
   RS485Bus& _bus;
   bool _lastParsedFrame;
-
-  bool validateHumidityTemperature() const;
+  ModbusRequestFrame _readRequest;  // JXBS_LEAF_MAP read for _address, CRC included
+  SampleFilter::State _filter[2];   // humidity, temperature
 
   static const uint8_t READ_REQUEST_SIZE = 8;
   static const uint8_t READ_RESPONSE_SIZE = 9;
@@ -1,5 +1,4 @@
 #include "JXBS_LiquidPH.h"
-#include <math.h>
 
 static bool responseIsJXBSLiquidPHAddressChange(const uint8_t* frame,
                                                 uint8_t oldAddress,
@@ -16,12 +15,33 @@ static bool responseIsJXBSLiquidPHAddressChange(const uint8_t* frame,
          RS485Bus::verifyCrc16ModbusFrame(frame, 8);
 }
 
+enum JXBSLiquidField : uint8_t {
+  JXBS_LIQUID_TEMPERATURE = 0,
+  JXBS_LIQUID_PH
+};
+
+static constexpr ModbusRegisterMap<2> JXBS_LIQUID_PH_MAP = {
+  0x0001, 2, {
+    {0x0001, MODBUS_FIELD_S16,  10.0, 0.0, -20.0, 80.0, SAMPLE_UNIT_CELSIUS},  // temperature
+    {0x0002, MODBUS_FIELD_U16, 100.0, 0.0,   0.0, 14.0, SAMPLE_UNIT_PH}
+  }
+};
+static_assert(JXBS_LIQUID_PH_MAP.isValid(), "JXBS_LIQUID_PH_MAP field outside block");
+
+// Soft temperature range is the protocol file's conservative -10..60 C.
+// A tank does not move 5 C or 2 pH in a minute; dosing steps that do are
+// accepted after three agreeing reads.
+static constexpr SampleFilterRule JXBS_LIQUID_PH_RULES[2] = {
+  SampleFilterRule::make(JXBS_LIQUID_PH_MAP.fields[JXBS_LIQUID_TEMPERATURE], -10.0, 60.0, 5.0),
+  SampleFilterRule::make(JXBS_LIQUID_PH_MAP.fields[JXBS_LIQUID_PH], 0.0, 14.0, 2.0)
+};
+
 static void logParsedJXBSLiquidPH(PrintController* log,
                                   bool debug,
                                   int16_t rawTemperature,
                                   uint16_t rawPH,
-                                  double temperature,
-                                  double ph) {
+                                  const FixedSample& temperature,
+                                  const FixedSample& ph) {
   if (!log || !debug) return;
 
   log->println(F("[DRV][JXBS_LiquidPH] Parsed temperature + pH:"), true);
@@ -29,41 +49,41 @@ static void logParsedJXBSLiquidPH(PrintController* log,
   log->print(F("  temperature raw = "), true);
   log->print((int)rawTemperature, true, "", DEC);
   log->print(F(" | temperature = "), true);
-  log->print(temperature, true, " C", 1);
+  log->printFixed(temperature.raw, temperature.decimals, true, " C");
   log->println("", true);
 
   log->print(F("  pH raw = "), true);
   log->print((unsigned int)rawPH, true, "", DEC);
   log->print(F(" | pH = "), true);
-  log->print(ph, true, "", 2);
+  log->printFixed(ph.raw, ph.decimals, true, "");
   log->println("", true);
 }
 
 static void logParsedJXBSLiquidTemperature(PrintController* log,
                                            bool debug,
                                            int16_t rawTemperature,
-                                           double temperature) {
+                                           const FixedSample& temperature) {
   if (!log || !debug) return;
 
   log->println(F("[DRV][JXBS_LiquidPH] Parsed temperature:"), true);
   log->print(F("  temperature raw = "), true);
   log->print((int)rawTemperature, true, "", DEC);
   log->print(F(" | temperature = "), true);
-  log->print(temperature, true, " C", 1);
+  log->printFixed(temperature.raw, temperature.decimals, true, " C");
   log->println("", true);
 }
 
 static void logParsedJXBSLiquidPHOnly(PrintController* log,
                                       bool debug,
                                       uint16_t rawPH,
-                                      double ph) {
+                                      const FixedSample& ph) {
   if (!log || !debug) return;
 
   log->println(F("[DRV][JXBS_LiquidPH] Parsed pH:"), true);
   log->print(F("  pH raw = "), true);
   log->print((unsigned int)rawPH, true, "", DEC);
   log->print(F(" | pH = "), true);
-  log->print(ph, true, "", 2);
+  log->printFixed(ph.raw, ph.decimals, true, "");
   log->println("", true);
 }
 
@@ -86,30 +106,21 @@ JXBS_LiquidPH::JXBS_LiquidPH(RS485Bus& bus,
                    warmUpTimeMs,
                    maxConsecutiveErrors,
                    minUsefulPowerOffMs),
-      liquid_temperature(0.0),
-      liquid_ph(0.0),
+      liquid_temperature(JXBS_LIQUID_PH_MAP.fields[JXBS_LIQUID_TEMPERATURE].sample(0)),
+      liquid_ph(JXBS_LIQUID_PH_MAP.fields[JXBS_LIQUID_PH].sample(0)),
       _bus(bus),
-      _lastParsedFrame(false) {}
-
-void JXBS_LiquidPH::setFallbackValues() {
-  liquid_temperature = -99.0;
-  liquid_ph = -99.0;
-}
-
-bool JXBS_LiquidPH::validateTemperaturePH() const {
-  return validateTemperature() && validatePH();
-}
+      _lastParsedFrame(false),
+      _readRequest(JXBS_LIQUID_PH_MAP.request(address)),
+      _filter() {}
 
-bool JXBS_LiquidPH::validateTemperature() const {
-  if (isnan(liquid_temperature)) return false;
-  if (liquid_temperature < -20.0 || liquid_temperature > 80.0) return false;
-  return true;
+void JXBS_LiquidPH::setAddress(uint8_t address) {
+  SensorDriver::setAddress(address);
+  _readRequest = JXBS_LIQUID_PH_MAP.request(address);
 }
 
-bool JXBS_LiquidPH::validatePH() const {
-  if (isnan(liquid_ph)) return false;
-  if (liquid_ph < 0.0 || liquid_ph > 14.0) return false;
-  return true;
+void JXBS_LiquidPH::setFallbackValues() {
+  liquid_temperature = JXBS_LIQUID_PH_MAP.fields[JXBS_LIQUID_TEMPERATURE].fallback();
+  liquid_ph = JXBS_LIQUID_PH_MAP.fields[JXBS_LIQUID_PH].fallback();
 }
 
 bool JXBS_LiquidPH::readTemperaturePH(uint8_t driverRetries,
@@ -119,34 +130,37 @@ bool JXBS_LiquidPH::readTemperaturePH(uint8_t driverRetries,
   _lastParsedFrame = false;
 
   for (uint8_t attempt = 1; attempt <= driverRetries; ++attempt) {
-    uint8_t request[READ_TWO_REQUEST_SIZE] = {
-      _address, 0x03, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00
-    };
-
-    uint8_t response[READ_TWO_RESPONSE_SIZE] = {0};
-    const uint8_t check[READ_CHECK_SIZE] = {_address, 0x03, 0x04};
-
-    const bool ok = _bus.SendRequest(request,
-                                     READ_TWO_REQUEST_SIZE,
-                                     response,
-                                     READ_TWO_RESPONSE_SIZE,
-                                     check,
-                                     READ_CHECK_SIZE,
-                                     SENSOR_DEFAULT_BUS_RETRIES,
-                                     readTimeoutMs,
-                                     _debugEnable,
-                                     afterReqDelayMs);
+    const uint8_t check[READ_CHECK_SIZE] = {_address, 0x03, JXBS_LIQUID_PH_MAP.byteCount()};
+    ModbusFrameView frame;
+
+    const bool ok = _bus.transact(_readRequest,
+                                  READ_TWO_RESPONSE_SIZE,
+                                  check,
+                                  READ_CHECK_SIZE,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  readTimeoutMs,
+                                  _debugEnable,
+                                  afterReqDelayMs);
     if (!ok) {
+      if (_bus.lastWasException()) break;
       continue;
     }
 
     _lastParsedFrame = true;
 
-    const int16_t rawTemperature = (int16_t)(((uint16_t)response[3] << 8) | response[4]);
-    const uint16_t rawPH = ((uint16_t)response[5] << 8) | response[6];
+    FixedSample values[2];
+    uint8_t quality = SAMPLE_QUALITY_OK;
+    const uint32_t okMask = SampleFilter::apply(JXBS_LIQUID_PH_MAP, JXBS_LIQUID_PH_RULES, frame,
+                                                _filter, values, millis(), &quality);
+    liquid_temperature = values[JXBS_LIQUID_TEMPERATURE];
+    liquid_ph = values[JXBS_LIQUID_PH];
+    setSampleQuality(quality);
 
-    liquid_temperature = (double)rawTemperature / 10.0;
-    liquid_ph = (double)rawPH / 100.0;
+    const int16_t rawTemperature = (int16_t)ModbusRegisterDecoder::rawValue(
+        JXBS_LIQUID_PH_MAP.fields[JXBS_LIQUID_TEMPERATURE], frame.data(), JXBS_LIQUID_PH_MAP.start);
+    const uint16_t rawPH = (uint16_t)ModbusRegisterDecoder::rawValue(
+        JXBS_LIQUID_PH_MAP.fields[JXBS_LIQUID_PH], frame.data(), JXBS_LIQUID_PH_MAP.start);
 
     logParsedJXBSLiquidPH(_bus.getLogger(),
                           _debugEnable,
@@ -155,13 +169,13 @@ bool JXBS_LiquidPH::readTemperaturePH(uint8_t driverRetries,
                           liquid_temperature,
                           liquid_ph);
 
-    if (validateTemperaturePH()) {
+    if (okMask == JXBS_LIQUID_PH_MAP.allFieldsMask()) {
       return true;
     }
 
-    if (_bus.getLogger() && _debugEnable) {
-      _bus.getLogger()->println(F("[DRV][JXBS_LiquidPH] Range check fail: temperature/pH"), true);
-    }
+    // Held at the last good values; a retry would return the same frame.
+    logRangeFail(F("temperature/pH"), quality);
+    break;
   }
 
   return false;
@@ -178,40 +192,47 @@ bool JXBS_LiquidPH::readTemperature(uint8_t driverRetries,
       _address, 0x03, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00
     };
 
-    uint8_t response[READ_ONE_RESPONSE_SIZE] = {0};
     const uint8_t check[READ_CHECK_SIZE] = {_address, 0x03, 0x02};
-
-    const bool ok = _bus.SendRequest(request,
-                                     READ_ONE_REQUEST_SIZE,
-                                     response,
-                                     READ_ONE_RESPONSE_SIZE,
-                                     check,
-                                     READ_CHECK_SIZE,
-                                     SENSOR_DEFAULT_BUS_RETRIES,
-                                     readTimeoutMs,
-                                     _debugEnable,
-                                     afterReqDelayMs);
+    ModbusFrameView frame;
+
+    const bool ok = _bus.transact(request,
+                                  READ_ONE_REQUEST_SIZE,
+                                  READ_ONE_RESPONSE_SIZE,
+                                  check,
+                                  READ_CHECK_SIZE,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  readTimeoutMs,
+                                  _debugEnable,
+                                  afterReqDelayMs);
     if (!ok) {
+      if (_bus.lastWasException()) break;
       continue;
     }
 
     _lastParsedFrame = true;
 
-    const int16_t rawTemperature = (int16_t)(((uint16_t)response[3] << 8) | response[4]);
-    liquid_temperature = (double)rawTemperature / 10.0;
+    const ModbusFieldSpec& field = JXBS_LIQUID_PH_MAP.fields[JXBS_LIQUID_TEMPERATURE];
+    const int16_t rawTemperature = (int16_t)ModbusRegisterDecoder::rawValue(field, frame.data(), field.reg);
+    const uint8_t quality = SampleFilter::filter(field,
+                                                 &JXBS_LIQUID_PH_RULES[JXBS_LIQUID_TEMPERATURE],
+                                                 _filter[JXBS_LIQUID_TEMPERATURE],
+                                                 rawTemperature,
+                                                 millis(),
+                                                 liquid_temperature);
+    setSampleQuality(quality);
 
     logParsedJXBSLiquidTemperature(_bus.getLogger(),
                                    _debugEnable,
                                    rawTemperature,
                                    liquid_temperature);
 
-    if (validateTemperature()) {
+    if ((quality & SAMPLE_QUALITY_REJECTED) == 0) {
       return true;
     }
 
-    if (_bus.getLogger() && _debugEnable) {
-      _bus.getLogger()->println(F("[DRV][JXBS_LiquidPH] Range check fail: temperature"), true);
-    }
+    logRangeFail(F("temperature"), quality);
+    break;
   }
 
   return false;
@@ -228,37 +249,44 @@ bool JXBS_LiquidPH::readPH(uint8_t driverRetries,
       _address, 0x03, 0x00, 0x02, 0x00, 0x01, 0x00, 0x00
     };
 
-    uint8_t response[READ_ONE_RESPONSE_SIZE] = {0};
     const uint8_t check[READ_CHECK_SIZE] = {_address, 0x03, 0x02};
-
-    const bool ok = _bus.SendRequest(request,
-                                     READ_ONE_REQUEST_SIZE,
-                                     response,
-                                     READ_ONE_RESPONSE_SIZE,
-                                     check,
-                                     READ_CHECK_SIZE,
-                                     SENSOR_DEFAULT_BUS_RETRIES,
-                                     readTimeoutMs,
-                                     _debugEnable,
-                                     afterReqDelayMs);
+    ModbusFrameView frame;
+
+    const bool ok = _bus.transact(request,
+                                  READ_ONE_REQUEST_SIZE,
+                                  READ_ONE_RESPONSE_SIZE,
+                                  check,
+                                  READ_CHECK_SIZE,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  readTimeoutMs,
+                                  _debugEnable,
+                                  afterReqDelayMs);
     if (!ok) {
+      if (_bus.lastWasException()) break;
       continue;
     }
 
     _lastParsedFrame = true;
 
-    const uint16_t rawPH = ((uint16_t)response[3] << 8) | response[4];
-    liquid_ph = (double)rawPH / 100.0;
+    const ModbusFieldSpec& field = JXBS_LIQUID_PH_MAP.fields[JXBS_LIQUID_PH];
+    const uint16_t rawPH = (uint16_t)ModbusRegisterDecoder::rawValue(field, frame.data(), field.reg);
+    const uint8_t quality = SampleFilter::filter(field,
+                                                 &JXBS_LIQUID_PH_RULES[JXBS_LIQUID_PH],
+                                                 _filter[JXBS_LIQUID_PH],
+                                                 rawPH,
+                                                 millis(),
+                                                 liquid_ph);
+    setSampleQuality(quality);
 
     logParsedJXBSLiquidPHOnly(_bus.getLogger(), _debugEnable, rawPH, liquid_ph);
 
-    if (validatePH()) {
+    if ((quality & SAMPLE_QUALITY_REJECTED) == 0) {
       return true;
     }
 
-    if (_bus.getLogger() && _debugEnable) {
-      _bus.getLogger()->println(F("[DRV][JXBS_LiquidPH] Range check fail: pH"), true);
-    }
+    logRangeFail(F("pH"), quality);
+    break;
   }
 
   return false;
@@ -278,6 +306,7 @@ bool JXBS_LiquidPH::readData() {
 
     if (_lastParsedFrame) {
       gotAnyValidFrame = true;
+      break;
     }
   }
 
@@ -289,6 +318,17 @@ bool JXBS_LiquidPH::readData() {
   return false;
 }
 
+void JXBS_LiquidPH::logRangeFail(const __FlashStringHelper* what, uint8_t quality) const {
+  PrintController* log = _bus.getLogger();
+  if (!log || !_debugEnable) return;
+
+  log->print(F("[DRV][JXBS_LiquidPH] Range check fail: "), true);
+  log->print(what, true);
+  log->print(F(", quality 0x"), true);
+  log->print((unsigned int)quality, true, "", HEX);
+  log->println("", true);
+}
+
 bool JXBS_LiquidPH::changeAddress(uint8_t newAddress,
                                   uint8_t maxRetries,
                                   uint16_t readTimeoutMs,
@@ -310,7 +350,7 @@ bool JXBS_LiquidPH::changeAddress(uint8_t newAddress,
     _bus.CRC_Calc(request, sizeof(request), _debugEnable);
     _bus.Request_RS485(request, sizeof(request), afterReqDelayMs, _debugEnable);
 
-    const size_t bytesRead = _bus.Read_RS485(readTimeoutMs, _debugEnable);
+    const size_t bytesRead = _bus.Read_RS485(readTimeoutMs, sizeof(request), _debugEnable);
     const uint8_t* raw = _bus.rawData();
 
     if (bytesRead >= 8 && raw) {
@@ -322,7 +362,7 @@ bool JXBS_LiquidPH::changeAddress(uint8_t newAddress,
             _bus.getLogger()->println(raw[offset] == newAddress ? F(" (new address)") : F(" (old address)"), true);
           }
 
-          _address = newAddress;
+          setAddress(newAddress);
           return true;
         }
       }
@@ -347,21 +387,21 @@ uint8_t JXBS_LiquidPH::scanForAddress(uint8_t startAddr,
       (uint8_t)addr, 0x03, 0x00, 0x02, 0x00, 0x01, 0x00, 0x00
     };
 
-    uint8_t response[READ_ONE_RESPONSE_SIZE] = {0};
     const uint8_t check[READ_CHECK_SIZE] = {(uint8_t)addr, 0x03, 0x02};
+    ModbusFrameView frame;
 
-    const bool found = _bus.SendRequest(request,
-                                        READ_ONE_REQUEST_SIZE,
-                                        response,
-                                        READ_ONE_RESPONSE_SIZE,
-                                        check,
-                                        READ_CHECK_SIZE,
-                                        1,
-                                        readTimeoutMs,
-                                        _debugEnable,
-                                        afterReqDelayMs);
+    const bool found = _bus.transact(request,
+                                     READ_ONE_REQUEST_SIZE,
+                                     READ_ONE_RESPONSE_SIZE,
+                                     check,
+                                     READ_CHECK_SIZE,
+                                     frame,
+                                     1,
+                                     readTimeoutMs,
+                                     _debugEnable,
+                                     afterReqDelayMs);
     if (found) {
-      _address = (uint8_t)addr;
+      setAddress((uint8_t)addr);
       return (uint8_t)addr;
     }
 
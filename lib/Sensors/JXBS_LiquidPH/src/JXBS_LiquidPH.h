@@ -9,7 +9,7 @@
 
   Driver intent:
   - RS485 Modbus RTU driver for the JXBS-3001-PH-RS liquid pH sensor.
-  - Primary measurements:
+  - Primary measurements (FixedSample; temperature 1 decimal, pH 2):
       liquid_temperature -> degrees Celsius
       liquid_ph          -> pH
 
@@ -39,6 +39,10 @@
   - Payload map:
       reg 0x0001 = temperature, signed/unsigned 16-bit practical raw, /10 C
       reg 0x0002 = pH, unsigned, /100 pH
+  - Decoding and range limits live in JXBS_LIQUID_PH_MAP, range protection
+    (fault words, soft bounds, rate of change) in JXBS_LIQUID_PH_RULES
+    (.cpp). Every read path shares the same per-field filter history; a
+    rejected value keeps the last good one and is not re-polled.
 
   Single-register commands:
   - Temperature only: 0x03, start 0x0001, count 1
@@ -47,12 +51,13 @@
   Configuration command:
   - Function: 0x06
   - Register 0x0100 = Modbus device address
-  - Register 0x0101 = baud rate, not implemented here.
+  - Register 0x0101 = baud rate, handled by ModbusBaudNegotiator
+    (MODBUS_BAUD_PROFILE_JXCT), not by this driver.
 */
 class JXBS_LiquidPH : public SensorDriver {
 public:
-  double liquid_temperature;
-  double liquid_ph;
+  FixedSample liquid_temperature;
+  FixedSample liquid_ph;
 
   JXBS_LiquidPH(RS485Bus& bus,
                 const char* sensorId,
@@ -68,6 +73,22 @@ public:
   bool readData() override;
   void setFallbackValues() override;
 
+  // liquid_temperature, liquid_ph, for burst statistics.
+  uint8_t valueCount() const override { return 2; }
+  FixedSample* valueAt(uint8_t index) override {
+    switch (index) {
+      case 0: return &liquid_temperature;
+      case 1: return &liquid_ph;
+      default: return nullptr;
+    }
+  }
+
+  // _filter[], kept through deep sleep (SleepPlanner::retain()).
+  void* filterStates(size_t& bytes) override {
+    bytes = sizeof(_filter);
+    return _filter;
+  }
+
   bool readTemperaturePH(uint8_t driverRetries = SENSOR_DEFAULT_DRIVER_RETRIES,
                          uint16_t readTimeoutMs = SENSOR_DEFAULT_READ_TIMEOUT_MS,
                          uint16_t afterReqDelayMs = SENSOR_DEFAULT_AFTER_REQ_MS);
@@ -85,6 +106,9 @@ public:
                      uint16_t readTimeoutMs = 500,
                      uint16_t afterReqDelayMs = SENSOR_DEFAULT_AFTER_REQ_MS);
 
+  // Keeps the cached read request in step with the address.
+  void setAddress(uint8_t address) override;
+
   uint8_t scanForAddress(uint8_t startAddr = 1,
                          uint8_t endAddr = 247,
                          uint16_t readTimeoutMs = 150,
@@ -93,14 +117,13 @@ public:
 private:
   RS485Bus& _bus;
   bool _lastParsedFrame;
+  ModbusRequestFrame _readRequest;  // JXBS_LIQUID_PH_MAP read for _address, CRC included
+  SampleFilter::State _filter[2];   // temperature, pH
 
-  bool validateTemperaturePH() const;
-  bool validateTemperature() const;
-  bool validatePH() const;
+  void logRangeFail(const __FlashStringHelper* what, uint8_t quality) const;
 
   static const uint8_t READ_ONE_REQUEST_SIZE = 8;
   static const uint8_t READ_ONE_RESPONSE_SIZE = 7;
-  static const uint8_t READ_TWO_REQUEST_SIZE = 8;
   static const uint8_t READ_TWO_RESPONSE_SIZE = 9;
   static const uint8_t READ_CHECK_SIZE = 3;
 };
@@ -8,8 +8,8 @@ static void logParsedJXBS7_MoistTemp(PrintController* log,
                                      uint8_t tempLo,
                                      uint16_t rawMoisture,
                                      int16_t rawTemp,
-                                     double moisture,
-                                     double temp) {
+                                     const FixedSample& moisture,
+                                     const FixedSample& temp) {
   if (!log || !debug) return;
 
   log->println(F("[DRV][JXBS_SoilComp7in1] Parsed moisture + temperature:"), true);
@@ -20,7 +20,7 @@ static void logParsedJXBS7_MoistTemp(PrintController* log,
   log->print(F("| combined = "), true);
   log->print((unsigned int)rawMoisture, true, "", DEC);
   log->print(F(" | moisture = "), true);
-  log->print(moisture, true, " %", 1);
+  log->printFixed(moisture.raw, moisture.decimals, true, " %");
   log->println("", true);
 
   log->print(F("  bytes [5],[6] -> temperature raw = 0x"), true);
@@ -29,7 +29,7 @@ static void logParsedJXBS7_MoistTemp(PrintController* log,
   log->print(F("| combined = "), true);
   log->print((int)rawTemp, true, "", DEC);
   log->print(F(" | temperature = "), true);
-  log->print(temp, true, " C", 1);
+  log->printFixed(temp.raw, temp.decimals, true, " C");
   log->println("", true);
 }
 
@@ -38,7 +38,7 @@ static void logParsedJXBS7_EC(PrintController* log,
                               uint8_t ecHi,
                               uint8_t ecLo,
                               uint16_t rawEc,
-                              double ec) {
+                              const FixedSample& ec) {
   if (!log || !debug) return;
 
   log->println(F("[DRV][JXBS_SoilComp7in1] Parsed conductivity:"), true);
@@ -48,7 +48,7 @@ static void logParsedJXBS7_EC(PrintController* log,
   log->print(F("| combined = "), true);
   log->print((unsigned int)rawEc, true, "", DEC);
   log->print(F(" | EC = "), true);
-  log->print(ec, true, " us/cm", 0);
+  log->printFixed(ec.raw, ec.decimals, true, " us/cm");
   log->println("", true);
 }
 
@@ -57,7 +57,7 @@ static void logParsedJXBS7_PH(PrintController* log,
                               uint8_t phHi,
                               uint8_t phLo,
                               uint16_t rawPh,
-                              double ph) {
+                              const FixedSample& ph) {
   if (!log || !debug) return;
 
   log->println(F("[DRV][JXBS_SoilComp7in1] Parsed pH:"), true);
@@ -67,7 +67,7 @@ static void logParsedJXBS7_PH(PrintController* log,
   log->print(F("| combined = "), true);
   log->print((unsigned int)rawPh, true, "", DEC);
   log->print(F(" | pH = "), true);
-  log->print(ph, true, "", 2);
+  log->printFixed(ph.raw, ph.decimals, true, "");
   log->println("", true);
 }
 
@@ -108,6 +108,90 @@ static void logParsedJXBS7_NPK(PrintController* log,
   log->println("", true);
 }
 
+enum JXBS7_Range : uint8_t {
+  JXBS7_RANGE_PH = 0,
+  JXBS7_RANGE_MOIST_TEMP,
+  JXBS7_RANGE_EC,
+  JXBS7_RANGE_NPK,
+  JXBS7_RANGE_COUNT
+};
+
+static const ModbusRegisterRange JXBS7_RANGES[JXBS7_RANGE_COUNT] = {
+  {0x0006, 1},  // pH
+  {0x0012, 2},  // moisture, temperature
+  {0x0015, 1},  // conductivity
+  {0x001E, 3}   // nitrogen, phosphorus, potassium
+};
+
+enum JXBS7_Field : uint8_t {
+  JXBS7_FIELD_PH = 0,
+  JXBS7_FIELD_MOISTURE,
+  JXBS7_FIELD_TEMPERATURE,
+  JXBS7_FIELD_EC,
+  JXBS7_FIELD_NITROGEN,
+  JXBS7_FIELD_PHOSPHORUS,
+  JXBS7_FIELD_POTASSIUM,
+  JXBS7_FIELD_COUNT
+};
+
+// Full register map of the batched read. Split reads decode the same field
+// specs relative to their own block start.
+static constexpr ModbusRegisterMap<JXBS7_FIELD_COUNT> JXBS7_MAP = {
+  0x0006, 27, {
+    {0x0006, MODBUS_FIELD_U16, 100.0, 0.0,   3.0,    9.0, SAMPLE_UNIT_PH},
+    {0x0012, MODBUS_FIELD_U16,  10.0, 0.0,   0.0,  100.0, SAMPLE_UNIT_PERCENT},    // moisture
+    {0x0013, MODBUS_FIELD_S16,  10.0, 0.0, -40.0,   80.0, SAMPLE_UNIT_CELSIUS},    // temperature
+    {0x0015, MODBUS_FIELD_U16,   1.0, 0.0,   0.0, 10000.0, SAMPLE_UNIT_US_PER_CM}, // EC
+    {0x001E, MODBUS_FIELD_U16,   1.0, 0.0,   0.0, 1999.0, SAMPLE_UNIT_MG_PER_KG},  // N
+    {0x001F, MODBUS_FIELD_U16,   1.0, 0.0,   0.0, 1999.0, SAMPLE_UNIT_MG_PER_KG},  // P
+    {0x0020, MODBUS_FIELD_U16,   1.0, 0.0,   0.0, 1999.0, SAMPLE_UNIT_MG_PER_KG}   // K
+  }
+};
+static_assert(JXBS7_MAP.isValid(), "JXBS7_MAP field outside block");
+static_assert(JXBS7_FIELD_COUNT == 7, "JXBS_SoilComp7in1::_filter is sized for 7 fields");
+
+// Soil temperature and pH drift slowly; a 5 C or 1 pH step within a minute
+// is a bad read unless three reads in a row agree on it. Moisture and EC
+// jump when irrigation arrives; N/P/K are derived from EC by the sensor.
+static constexpr SampleFilterRule JXBS7_RULES[JXBS7_FIELD_COUNT] = {
+  SampleFilterRule::make(JXBS7_MAP.fields[JXBS7_FIELD_PH], 3.0, 9.0, 1.0),
+  SampleFilterRule::none(),                                                          // moisture
+  SampleFilterRule::make(JXBS7_MAP.fields[JXBS7_FIELD_TEMPERATURE], -20.0, 60.0, 5.0),
+  SampleFilterRule::none(),                                                          // EC
+  SampleFilterRule::none(),                                                          // N
+  SampleFilterRule::none(),                                                          // P
+  SampleFilterRule::none()                                                           // K
+};
+
+// Filters one field from a response frame whose block starts at blockStart.
+// Writes the accepted or held value to out and returns its quality flags.
+static uint8_t jxbs7Filter(JXBS7_Field field,
+                           const uint8_t* frame,
+                           uint16_t blockStart,
+                           SampleFilter::State states[],
+                           FixedSample& out) {
+  const ModbusFieldSpec& spec = JXBS7_MAP.fields[field];
+  return SampleFilter::filter(spec,
+                              &JXBS7_RULES[field],
+                              states[field],
+                              ModbusRegisterDecoder::rawValue(spec, frame, blockStart),
+                              millis(),
+                              out);
+}
+
+// N/P/K are whole mg/kg (scale 1), kept as plain integers; 0xFFFF until
+// the first good value.
+static uint8_t jxbs7FilterCount(JXBS7_Field field,
+                                const uint8_t* frame,
+                                uint16_t blockStart,
+                                SampleFilter::State states[],
+                                uint16_t& out) {
+  FixedSample value;
+  const uint8_t quality = jxbs7Filter(field, frame, blockStart, states, value);
+  out = value.isFallback() ? 0xFFFF : (uint16_t)value.raw;
+  return quality;
+}
+
 JXBS_SoilComp7in1::JXBS_SoilComp7in1(RS485Bus& bus,
                                      const char* sensorId,
                                      uint8_t address,
@@ -127,47 +211,126 @@ JXBS_SoilComp7in1::JXBS_SoilComp7in1(RS485Bus& bus,
                    warmUpTimeMs,
                    maxConsecutiveErrors,
                    minUsefulPowerOffMs),
-      _bus(bus),
-      _lastParsedFrame(false),
-      soil_moisture(0.0),
-      soil_temp(0.0),
-      soil_ec(0.0),
-      soil_ph(0.0),
+      soil_moisture(JXBS7_MAP.fields[JXBS7_FIELD_MOISTURE].sample(0)),
+      soil_temp(JXBS7_MAP.fields[JXBS7_FIELD_TEMPERATURE].sample(0)),
+      soil_ec(JXBS7_MAP.fields[JXBS7_FIELD_EC].sample(0)),
+      soil_ph(JXBS7_MAP.fields[JXBS7_FIELD_PH].sample(0)),
       soil_nitrogen(0),
       soil_phosphorus(0),
-      soil_potassium(0) {}
+      soil_potassium(0),
+      _bus(bus),
+      _lastParsedFrame(false),
+      _batchReadEnabled(true),
+      _batchReadUnsupported(false),
+      _batchWideMisses(0),
+      _batchReprobeIn(0),
+      _filter() {}
 
 void JXBS_SoilComp7in1::setFallbackValues() {
-  soil_moisture = -99.0;
-  soil_temp = -99.0;
-  soil_ec = -99.0;
-  soil_ph = -99.0;
+  soil_moisture = JXBS7_MAP.fields[JXBS7_FIELD_MOISTURE].fallback();
+  soil_temp = JXBS7_MAP.fields[JXBS7_FIELD_TEMPERATURE].fallback();
+  soil_ec = JXBS7_MAP.fields[JXBS7_FIELD_EC].fallback();
+  soil_ph = JXBS7_MAP.fields[JXBS7_FIELD_PH].fallback();
   soil_nitrogen = 0xFFFF;
   soil_phosphorus = 0xFFFF;
   soil_potassium = 0xFFFF;
 }
 
-bool JXBS_SoilComp7in1::validateMoistureTemperature() const {
-  if (soil_moisture < 0.0 || soil_moisture > 100.0) return false;
-  if (soil_temp < -40.0 || soil_temp > 80.0) return false;
-  return true;
+void JXBS_SoilComp7in1::setBatchRead(bool enable) {
+  _batchReadEnabled = enable;
+  _batchReadUnsupported = false;
+  _batchWideMisses = 0;
+  _batchReprobeIn = 0;
 }
 
-bool JXBS_SoilComp7in1::validateConductivity() const {
-  if (soil_ec < 0.0 || soil_ec > 10000.0) return false;
-  return true;
+void JXBS_SoilComp7in1::noteWideAnswer() {
+  _batchWideMisses = 0;
+  if (!_batchReadUnsupported) return;
+
+  _batchReadUnsupported = false;
+  if (_bus.getLogger() && _debugEnable) {
+    _bus.getLogger()->println(F("[DRV][JXBS_SoilComp7in1] Batched read answers again, batching on"), true);
+  }
 }
 
-bool JXBS_SoilComp7in1::validatePH() const {
-  if (soil_ph < 3.0 || soil_ph > 9.0) return false;
-  return true;
+// The wide request got no answer (rejected: an exception) but the split
+// reads did.
+void JXBS_SoilComp7in1::noteWideMiss(bool rejected) {
+  if (_batchReadUnsupported) {
+    _batchReprobeIn = SENSOR_BATCH_REPROBE_READS;
+    return;
+  }
+
+  if (_batchWideMisses < 255) ++_batchWideMisses;
+  if (!rejected && _batchWideMisses < SENSOR_BATCH_LATCH_MISSES) return;
+
+  _batchReadUnsupported = true;
+  _batchWideMisses = 0;
+  _batchReprobeIn = SENSOR_BATCH_REPROBE_READS;
+  if (_bus.getLogger() && _debugEnable) {
+    _bus.getLogger()->println(F("[DRV][JXBS_SoilComp7in1] Batched read unsupported, using split reads"), true);
+  }
 }
 
-bool JXBS_SoilComp7in1::validateNPK() const {
-  if (soil_nitrogen > 1999) return false;
-  if (soil_phosphorus > 1999) return false;
-  if (soil_potassium > 1999) return false;
-  return true;
+// frame is a full response whose first data register is blockStart.
+// Returns the range's quality flags, all its fields OR'ed.
+uint8_t JXBS_SoilComp7in1::decodeRange(uint8_t rangeIndex, const uint8_t* frame, uint16_t blockStart) {
+  const uint8_t* data = ModbusReadPlanner::registerBytes(frame,
+                                                         ModbusReadBlock{blockStart, 0},
+                                                         JXBS7_RANGES[rangeIndex].start);
+
+  uint8_t quality = SAMPLE_QUALITY_OK;
+
+  switch (rangeIndex) {
+    case JXBS7_RANGE_PH:
+      quality = jxbs7Filter(JXBS7_FIELD_PH, frame, blockStart, _filter, soil_ph);
+      logParsedJXBS7_PH(_bus.getLogger(), _debugEnable, data[0], data[1],
+                        ((uint16_t)data[0] << 8) | data[1], soil_ph);
+      break;
+
+    case JXBS7_RANGE_MOIST_TEMP:
+      quality = jxbs7Filter(JXBS7_FIELD_MOISTURE, frame, blockStart, _filter, soil_moisture);
+      quality |= jxbs7Filter(JXBS7_FIELD_TEMPERATURE, frame, blockStart, _filter, soil_temp);
+      logParsedJXBS7_MoistTemp(_bus.getLogger(),
+                               _debugEnable,
+                               data[0],
+                               data[1],
+                               data[2],
+                               data[3],
+                               ((uint16_t)data[0] << 8) | data[1],
+                               (int16_t)(((uint16_t)data[2] << 8) | data[3]),
+                               soil_moisture,
+                               soil_temp);
+      break;
+
+    case JXBS7_RANGE_EC:
+      quality = jxbs7Filter(JXBS7_FIELD_EC, frame, blockStart, _filter, soil_ec);
+      logParsedJXBS7_EC(_bus.getLogger(), _debugEnable, data[0], data[1],
+                        ((uint16_t)data[0] << 8) | data[1], soil_ec);
+      break;
+
+    case JXBS7_RANGE_NPK:
+      quality = jxbs7FilterCount(JXBS7_FIELD_NITROGEN, frame, blockStart, _filter, soil_nitrogen);
+      quality |= jxbs7FilterCount(JXBS7_FIELD_PHOSPHORUS, frame, blockStart, _filter, soil_phosphorus);
+      quality |= jxbs7FilterCount(JXBS7_FIELD_POTASSIUM, frame, blockStart, _filter, soil_potassium);
+      logParsedJXBS7_NPK(_bus.getLogger(),
+                         _debugEnable,
+                         data[0],
+                         data[1],
+                         data[2],
+                         data[3],
+                         data[4],
+                         data[5],
+                         soil_nitrogen,
+                         soil_phosphorus,
+                         soil_potassium);
+      break;
+
+    default:
+      break;
+  }
+
+  return quality;
 }
 
 bool JXBS_SoilComp7in1::readMoistureTemperature(uint8_t driverRetries,
@@ -178,54 +341,35 @@ bool JXBS_SoilComp7in1::readMoistureTemperature(uint8_t driverRetries,
 
   for (uint8_t attempt = 1; attempt <= driverRetries; ++attempt) {
     uint8_t request[8] = {_address, 0x03, 0x00, 0x12, 0x00, 0x02, 0x00, 0x00};
-    uint8_t response[9] = {0};
     const uint8_t check[3] = {_address, 0x03, 0x04};
-
-    const bool ok = _bus.SendRequest(request,
-                                     8,
-                                     response,
-                                     9,
-                                     check,
-                                     3,
-                                     SENSOR_DEFAULT_BUS_RETRIES,
-                                     readTimeoutMs,
-                                     _debugEnable,
-                                     afterReqDelayMs);
+    ModbusFrameView frame;
+
+    const bool ok = _bus.transact(request,
+                                  8,
+                                  9,
+                                  check,
+                                  3,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  readTimeoutMs,
+                                  _debugEnable,
+                                  afterReqDelayMs);
     if (!ok) {
+      if (_bus.lastWasException()) break;
       continue;
     }
 
     _lastParsedFrame = true;
+    const uint8_t quality = decodeRange(JXBS7_RANGE_MOIST_TEMP, frame.data(), JXBS7_RANGES[JXBS7_RANGE_MOIST_TEMP].start);
+    setSampleQuality(quality);
 
-    const uint8_t moistHi = response[3];
-    const uint8_t moistLo = response[4];
-    const uint8_t tempHi = response[5];
-    const uint8_t tempLo = response[6];
-
-    const uint16_t rawMoisture = ((uint16_t)moistHi << 8) | moistLo;
-    const int16_t rawTemp = (int16_t)(((uint16_t)tempHi << 8) | tempLo);
-
-    soil_moisture = (double)rawMoisture / 10.0;
-    soil_temp = (double)rawTemp / 10.0;
-
-    logParsedJXBS7_MoistTemp(_bus.getLogger(),
-                             _debugEnable,
-                             moistHi,
-                             moistLo,
-                             tempHi,
-                             tempLo,
-                             rawMoisture,
-                             rawTemp,
-                             soil_moisture,
-                             soil_temp);
-
-    if (validateMoistureTemperature()) {
+    if ((quality & SAMPLE_QUALITY_REJECTED) == 0) {
       return true;
     }
 
-    if (_bus.getLogger() && _debugEnable) {
-      _bus.getLogger()->println(F("[DRV][JXBS_SoilComp7in1] Range check fail: moisture/temperature"), true);
-    }
+    // Held at the last good values; a retry would return the same frame.
+    logRangeFail(F("moisture/temperature"), quality);
+    break;
   }
 
   return false;
@@ -239,39 +383,35 @@ bool JXBS_SoilComp7in1::readConductivity(uint8_t driverRetries,
 
   for (uint8_t attempt = 1; attempt <= driverRetries; ++attempt) {
     uint8_t request[8] = {_address, 0x03, 0x00, 0x15, 0x00, 0x01, 0x00, 0x00};
-    uint8_t response[7] = {0};
     const uint8_t check[3] = {_address, 0x03, 0x02};
-
-    const bool ok = _bus.SendRequest(request,
-                                     8,
-                                     response,
-                                     7,
-                                     check,
-                                     3,
-                                     SENSOR_DEFAULT_BUS_RETRIES,
-                                     readTimeoutMs,
-                                     _debugEnable,
-                                     afterReqDelayMs);
+    ModbusFrameView frame;
+
+    const bool ok = _bus.transact(request,
+                                  8,
+                                  7,
+                                  check,
+                                  3,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  readTimeoutMs,
+                                  _debugEnable,
+                                  afterReqDelayMs);
     if (!ok) {
+      if (_bus.lastWasException()) break;
       continue;
     }
 
     _lastParsedFrame = true;
+    const uint8_t quality = decodeRange(JXBS7_RANGE_EC, frame.data(), JXBS7_RANGES[JXBS7_RANGE_EC].start);
+    setSampleQuality(quality);
 
-    const uint8_t ecHi = response[3];
-    const uint8_t ecLo = response[4];
-    const uint16_t rawEc = ((uint16_t)ecHi << 8) | ecLo;
-    soil_ec = (double)rawEc;
-
-    logParsedJXBS7_EC(_bus.getLogger(), _debugEnable, ecHi, ecLo, rawEc, soil_ec);
-
-    if (validateConductivity()) {
+    if ((quality & SAMPLE_QUALITY_REJECTED) == 0) {
       return true;
     }
 
-    if (_bus.getLogger() && _debugEnable) {
-      _bus.getLogger()->println(F("[DRV][JXBS_SoilComp7in1] Range check fail: conductivity"), true);
-    }
+    // Held at the last good values; a retry would return the same frame.
+    logRangeFail(F("conductivity"), quality);
+    break;
   }
 
   return false;
@@ -285,39 +425,35 @@ bool JXBS_SoilComp7in1::readPH(uint8_t driverRetries,
 
   for (uint8_t attempt = 1; attempt <= driverRetries; ++attempt) {
     uint8_t request[8] = {_address, 0x03, 0x00, 0x06, 0x00, 0x01, 0x00, 0x00};
-    uint8_t response[7] = {0};
     const uint8_t check[3] = {_address, 0x03, 0x02};
-
-    const bool ok = _bus.SendRequest(request,
-                                     8,
-                                     response,
-                                     7,
-                                     check,
-                                     3,
-                                     SENSOR_DEFAULT_BUS_RETRIES,
-                                     readTimeoutMs,
-                                     _debugEnable,
-                                     afterReqDelayMs);
+    ModbusFrameView frame;
+
+    const bool ok = _bus.transact(request,
+                                  8,
+                                  7,
+                                  check,
+                                  3,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  readTimeoutMs,
+                                  _debugEnable,
+                                  afterReqDelayMs);
     if (!ok) {
+      if (_bus.lastWasException()) break;
       continue;
     }
 
     _lastParsedFrame = true;
+    const uint8_t quality = decodeRange(JXBS7_RANGE_PH, frame.data(), JXBS7_RANGES[JXBS7_RANGE_PH].start);
+    setSampleQuality(quality);
 
-    const uint8_t phHi = response[3];
-    const uint8_t phLo = response[4];
-    const uint16_t rawPH = ((uint16_t)phHi << 8) | phLo;
-    soil_ph = (double)rawPH / 100.0;
-
-    logParsedJXBS7_PH(_bus.getLogger(), _debugEnable, phHi, phLo, rawPH, soil_ph);
-
-    if (validatePH()) {
+    if ((quality & SAMPLE_QUALITY_REJECTED) == 0) {
       return true;
     }
 
-    if (_bus.getLogger() && _debugEnable) {
-      _bus.getLogger()->println(F("[DRV][JXBS_SoilComp7in1] Range check fail: pH"), true);
-    }
+    // Held at the last good values; a retry would return the same frame.
+    logRangeFail(F("pH"), quality);
+    break;
   }
 
   return false;
@@ -331,93 +467,152 @@ bool JXBS_SoilComp7in1::readNPK(uint8_t driverRetries,
 
   for (uint8_t attempt = 1; attempt <= driverRetries; ++attempt) {
     uint8_t request[8] = {_address, 0x03, 0x00, 0x1E, 0x00, 0x03, 0x00, 0x00};
-    uint8_t response[11] = {0};
     const uint8_t check[3] = {_address, 0x03, 0x06};
-
-    const bool ok = _bus.SendRequest(request,
-                                     8,
-                                     response,
-                                     11,
-                                     check,
-                                     3,
-                                     SENSOR_DEFAULT_BUS_RETRIES,
-                                     readTimeoutMs,
-                                     _debugEnable,
-                                     afterReqDelayMs);
+    ModbusFrameView frame;
+
+    const bool ok = _bus.transact(request,
+                                  8,
+                                  11,
+                                  check,
+                                  3,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  readTimeoutMs,
+                                  _debugEnable,
+                                  afterReqDelayMs);
     if (!ok) {
+      if (_bus.lastWasException()) break;
       continue;
     }
 
     _lastParsedFrame = true;
+    const uint8_t quality = decodeRange(JXBS7_RANGE_NPK, frame.data(), JXBS7_RANGES[JXBS7_RANGE_NPK].start);
+    setSampleQuality(quality);
 
-    const uint8_t nHi = response[3];
-    const uint8_t nLo = response[4];
-    const uint8_t pHi = response[5];
-    const uint8_t pLo = response[6];
-    const uint8_t kHi = response[7];
-    const uint8_t kLo = response[8];
-
-    soil_nitrogen   = ((uint16_t)nHi << 8) | nLo;
-    soil_phosphorus = ((uint16_t)pHi << 8) | pLo;
-    soil_potassium  = ((uint16_t)kHi << 8) | kLo;
-
-    logParsedJXBS7_NPK(_bus.getLogger(),
-                       _debugEnable,
-                       nHi,
-                       nLo,
-                       pHi,
-                       pLo,
-                       kHi,
-                       kLo,
-                       soil_nitrogen,
-                       soil_phosphorus,
-                       soil_potassium);
-
-    if (validateNPK()) {
+    if ((quality & SAMPLE_QUALITY_REJECTED) == 0) {
       return true;
     }
 
-    if (_bus.getLogger() && _debugEnable) {
-      _bus.getLogger()->println(F("[DRV][JXBS_SoilComp7in1] Range check fail: NPK"), true);
-    }
+    // Held at the last good values; a retry would return the same frame.
+    logRangeFail(F("NPK"), quality);
+    break;
   }
 
   return false;
 }
 
+bool JXBS_SoilComp7in1::readAllRegisters(uint16_t maxGapRegs,
+                                         uint16_t readTimeoutMs,
+                                         uint16_t afterReqDelayMs,
+                                         uint8_t busRetries) {
+  _lastParsedFrame = false;
+  setSampleQuality(SAMPLE_QUALITY_OK);
+
+  ModbusReadBlock blocks[JXBS7_RANGE_COUNT];
+  const size_t blockCount = ModbusReadPlanner::plan(JXBS7_RANGES,
+                                                    JXBS7_RANGE_COUNT,
+                                                    maxGapRegs,
+                                                    SENSOR_BATCH_MAX_REGS,
+                                                    blocks,
+                                                    JXBS7_RANGE_COUNT);
+  if (blockCount == 0) return false;
+
+  if (_bus.getLogger() && _debugEnable) {
+    _bus.getLogger()->print(F("[DRV][JXBS_SoilComp7in1] Read plan: "), true);
+    _bus.getLogger()->print((unsigned long)blockCount, true, " request(s)", DEC);
+    _bus.getLogger()->println("", true);
+  }
+
+  uint8_t quality = SAMPLE_QUALITY_OK;
+
+  for (size_t b = 0; b < blockCount; ++b) {
+    // Built once per block; the bus resends it unchanged on retries.
+    const ModbusRequestFrame request = ModbusRequestFrame::read(_address, blocks[b].start, blocks[b].count);
+    const uint8_t check[3] = {_address, request.function(), request.readByteCount()};
+    ModbusFrameView frame;
+
+    const bool ok = _bus.transact(request,
+                                  request.readResponseSize(),
+                                  check,
+                                  3,
+                                  frame,
+                                  busRetries,
+                                  readTimeoutMs,
+                                  _debugEnable,
+                                  afterReqDelayMs);
+    if (!ok) {
+      return false;
+    }
+
+    _lastParsedFrame = true;
+
+    for (uint8_t r = 0; r < JXBS7_RANGE_COUNT; ++r) {
+      if (ModbusReadPlanner::contains(blocks[b], JXBS7_RANGES[r])) {
+        quality |= decodeRange(r, frame.data(), blocks[b].start);
+      }
+    }
+  }
+
+  // Only a complete plan reports quality; readData() tells a rejected
+  // sample from a lost block by it.
+  setSampleQuality(quality);
+
+  const bool valid = (quality & SAMPLE_QUALITY_REJECTED) == 0;
+  if (!valid) {
+    logRangeFail(F("batched read"), quality);
+  }
+
+  return valid;
+}
+
 bool JXBS_SoilComp7in1::readData() {
   markReadTime(millis());
 
   const uint8_t driverRetries = SENSOR_DEFAULT_DRIVER_RETRIES;
   bool gotAnyValidFrame = false;
 
-  for (uint8_t attempt = 1; attempt <= driverRetries; ++attempt) {
-    if (!readMoistureTemperature(1, SENSOR_DEFAULT_READ_TIMEOUT_MS, SENSOR_DEFAULT_AFTER_REQ_MS)) {
-      if (_lastParsedFrame) gotAnyValidFrame = true;
-      continue;
+  // Batching switched off: probe the wide request now and then.
+  bool reprobe = false;
+  if (_batchReadEnabled && _batchReadUnsupported) {
+    if (_batchReprobeIn > 0) {
+      --_batchReprobeIn;
+    } else {
+      reprobe = true;
     }
-    if (_lastParsedFrame) gotAnyValidFrame = true;
+  }
 
-    if (!readConductivity(1, SENSOR_DEFAULT_READ_TIMEOUT_MS, SENSOR_DEFAULT_AFTER_REQ_MS)) {
-      if (_lastParsedFrame) gotAnyValidFrame = true;
-      continue;
+  for (uint8_t attempt = 1; attempt <= driverRetries; ++attempt) {
+    bool ok = false;
+
+    if (isBatchReadActive() || (reprobe && attempt == 1)) {
+      // One bus attempt: the split plan below is the retry.
+      ok = readAllRegisters(SENSOR_BATCH_MAX_GAP_REGS, SENSOR_DEFAULT_READ_TIMEOUT_MS, SENSOR_DEFAULT_AFTER_REQ_MS, 1);
+
+      if (_lastParsedFrame) {
+        noteWideAnswer();
+      } else if (!ok) {
+        // No answer to the wide request: retry with one request per range.
+        // If that works, the device may reject reads across its gaps.
+        const bool rejected = _bus.lastWasException();
+        ok = readAllRegisters(0, SENSOR_DEFAULT_READ_TIMEOUT_MS, SENSOR_DEFAULT_AFTER_REQ_MS);
+        if (_lastParsedFrame) noteWideMiss(rejected);
+      }
+    } else {
+      ok = readAllRegisters(0, SENSOR_DEFAULT_READ_TIMEOUT_MS, SENSOR_DEFAULT_AFTER_REQ_MS);
     }
-    if (_lastParsedFrame) gotAnyValidFrame = true;
 
-    if (!readPH(1, SENSOR_DEFAULT_READ_TIMEOUT_MS, SENSOR_DEFAULT_AFTER_REQ_MS)) {
-      if (_lastParsedFrame) gotAnyValidFrame = true;
-      continue;
-    }
     if (_lastParsedFrame) gotAnyValidFrame = true;
 
-    if (!readNPK(1, SENSOR_DEFAULT_READ_TIMEOUT_MS, SENSOR_DEFAULT_AFTER_REQ_MS)) {
-      if (_lastParsedFrame) gotAnyValidFrame = true;
-      continue;
+    if (ok) {
+      markSuccess();
+      return true;
     }
-    if (_lastParsedFrame) gotAnyValidFrame = true;
 
-    markSuccess();
-    return true;
+    // Every block arrived but a value was rejected and is held at its
+    // last good reading. Polling again would only repeat the frame.
+    if (getSampleQuality() & SAMPLE_QUALITY_REJECTED) {
+      break;
+    }
   }
 
   if (!gotAnyValidFrame) {
@@ -428,6 +623,17 @@ bool JXBS_SoilComp7in1::readData() {
   return false;
 }
 
+void JXBS_SoilComp7in1::logRangeFail(const __FlashStringHelper* what, uint8_t quality) const {
+  PrintController* log = _bus.getLogger();
+  if (!log || !_debugEnable) return;
+
+  log->print(F("[DRV][JXBS_SoilComp7in1] Range check fail: "), true);
+  log->print(what, true);
+  log->print(F(", quality 0x"), true);
+  log->print((unsigned int)quality, true, "", HEX);
+  log->println("", true);
+}
+
 bool JXBS_SoilComp7in1::changeAddress(uint8_t newAddress,
                                       uint8_t maxRetries,
                                       uint16_t readTimeoutMs,
@@ -475,19 +681,19 @@ uint8_t JXBS_SoilComp7in1::scanForAddress(uint8_t startAddr,
 
   for (uint16_t addr = startAddr; addr <= endAddr; ++addr) {
     uint8_t request[8] = {(uint8_t)addr, 0x03, 0x00, 0x12, 0x00, 0x02, 0x00, 0x00};
-    uint8_t response[9] = {0};
     const uint8_t check[3] = {(uint8_t)addr, 0x03, 0x04};
+    ModbusFrameView frame;
 
-    const bool found = _bus.SendRequest(request,
-                                        8,
-                                        response,
-                                        9,
-                                        check,
-                                        3,
-                                        1,
-                                        readTimeoutMs,
-                                        _debugEnable,
-                                        afterReqDelayMs);
+    const bool found = _bus.transact(request,
+                                     8,
+                                     9,
+                                     check,
+                                     3,
+                                     frame,
+                                     1,
+                                     readTimeoutMs,
+                                     _debugEnable,
+                                     afterReqDelayMs);
     if (found) {
       _address = (uint8_t)addr;
       return (uint8_t)addr;
@@ -4,12 +4,42 @@
 #include "SensorDriver.h"
 #include "Configuration_System.h"
 
+/*
+  JXBS_SoilComp7in1
+
+  Registers used (function 0x03):
+    0x0006        pH x100
+    0x0012/0x0013 moisture x10, temperature x10 (signed)
+    0x0015        conductivity us/cm
+    0x001E..0x20  N, P, K mg/kg
+
+  readData() coalesces these ranges with ModbusReadPlanner and reads them
+  in a single 27-register request; when that gets no answer the same
+  cycle falls back to one request per range. The wide request gets one
+  bus attempt: the split reads are its retry, and both fit the
+  transaction budget (1 + 4 of SENSOR_TRANSACTION_MAX_ATTEMPTS). Batching is switched off
+  when the device rejects the wide request with an exception, or misses
+  it SENSOR_BATCH_LATCH_MISSES reads in a row while answering the split
+  reads (one miss is noise or a collision). While off, every
+  SENSOR_BATCH_REPROBE_READS-th read tries the wide request again and
+  switches batching back on when it answers.
+
+  Moisture, temperature, EC and pH are FixedSample at the register's own
+  resolution (pH 2 decimals, moisture/temperature 1, EC 0); -99 after a
+  cycle with no answer.
+
+  Every field passes a SampleFilter (JXBS7_RULES: hard bounds, fault
+  words, pH and temperature rate of change). A rejected field keeps its
+  last good value and the cycle fails without polling again;
+  getSampleQuality() holds the flags.
+*/
+
 class JXBS_SoilComp7in1 : public SensorDriver {
 public:
-  double soil_moisture;
-  double soil_temp;
-  double soil_ec;
-  double soil_ph;
+  FixedSample soil_moisture;
+  FixedSample soil_temp;
+  FixedSample soil_ec;
+  FixedSample soil_ph;
   uint16_t soil_nitrogen;
   uint16_t soil_phosphorus;
   uint16_t soil_potassium;
@@ -28,6 +58,24 @@ public:
   bool readData() override;
   void setFallbackValues() override;
 
+  // soil_moisture, soil_temp, soil_ec, soil_ph (N/P/K are plain counts), for burst statistics.
+  uint8_t valueCount() const override { return 4; }
+  FixedSample* valueAt(uint8_t index) override {
+    switch (index) {
+      case 0: return &soil_moisture;
+      case 1: return &soil_temp;
+      case 2: return &soil_ec;
+      case 3: return &soil_ph;
+      default: return nullptr;
+    }
+  }
+
+  // _filter[], kept through deep sleep (SleepPlanner::retain()).
+  void* filterStates(size_t& bytes) override {
+    bytes = sizeof(_filter);
+    return _filter;
+  }
+
   bool readMoistureTemperature(uint8_t driverRetries = SENSOR_DEFAULT_DRIVER_RETRIES,
                                uint16_t readTimeoutMs = SENSOR_DEFAULT_READ_TIMEOUT_MS,
                                uint16_t afterReqDelayMs = SENSOR_DEFAULT_AFTER_REQ_MS);
@@ -44,6 +92,17 @@ public:
                uint16_t readTimeoutMs = SENSOR_DEFAULT_READ_TIMEOUT_MS,
                uint16_t afterReqDelayMs = SENSOR_DEFAULT_AFTER_REQ_MS);
 
+  // Reads all seven values using the coalesced register plan.
+  // maxGapRegs = 0 forces one request per contiguous register range.
+  // busRetries is per request.
+  bool readAllRegisters(uint16_t maxGapRegs = SENSOR_BATCH_MAX_GAP_REGS,
+                        uint16_t readTimeoutMs = SENSOR_DEFAULT_READ_TIMEOUT_MS,
+                        uint16_t afterReqDelayMs = SENSOR_DEFAULT_AFTER_REQ_MS,
+                        uint8_t busRetries = SENSOR_DEFAULT_BUS_RETRIES);
+
+  void setBatchRead(bool enable);
+  bool isBatchReadActive() const { return _batchReadEnabled && !_batchReadUnsupported; }
+
   bool changeAddress(uint8_t newAddress,
                      uint8_t maxRetries = SENSOR_DEFAULT_BUS_RETRIES,
                      uint16_t readTimeoutMs = 500,
@@ -57,9 +116,16 @@ public:
 private:
   RS485Bus& _bus;
   bool _lastParsedFrame;
+  bool _batchReadEnabled;
+  bool _batchReadUnsupported;
+  uint8_t _batchWideMisses;     // wide miss + split answer, in a row
+  uint8_t _batchReprobeIn;      // reads until the next wide probe
+
+  // Range-protection history per field, in JXBS7_Field order.
+  SampleFilter::State _filter[7];
 
-  bool validateMoistureTemperature() const;
-  bool validateConductivity() const;
-  bool validatePH() const;
-  bool validateNPK() const;
+  uint8_t decodeRange(uint8_t rangeIndex, const uint8_t* frame, uint16_t blockStart);
+  void noteWideAnswer();
+  void noteWideMiss(bool rejected);
+  void logRangeFail(const __FlashStringHelper* what, uint8_t quality) const;
 };
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+#include <Arduino.h>
+#include "ModbusRegisterMap.h"
+#include "SampleFilter.h"
+
+/*
+  ModbusSensorMaps.h
+
+  Register maps for single-block sensors documented in docs/protocols/.
+  Use them with ModbusTableSensor<N>. Hard bounds follow
+  docs/protocols/range_protection.md; the field index enums name the
+  positions in ModbusTableSensor::values[]. Where the protocol file asks
+  for more than hard bounds (soft range, rate of change), a matching
+  *_RULES table goes next to the map.
+
+  Adding a sensor: copy the register table from its protocol file into a
+  new map here, add a field enum, and static_assert isValid().
+*/
+
+// RS485_Temperature_Humidity_Sensor_JXCT_family.md
+enum JXCT_AirTHField : uint8_t {
+  JXCT_AIR_TH_HUMIDITY = 0,
+  JXCT_AIR_TH_TEMPERATURE
+};
+
+static constexpr ModbusRegisterMap<2> JXCT_AIR_TH_MAP = {
+  0x0000, 2, {
+    {0x0000, MODBUS_FIELD_U16, 10.0, 0.0,   0.0, 100.0, SAMPLE_UNIT_PERCENT_RH},
+    {0x0001, MODBUS_FIELD_S16, 10.0, 0.0, -40.0,  80.0, SAMPLE_UNIT_CELSIUS}
+  }
+};
+static_assert(JXCT_AIR_TH_MAP.isValid(), "JXCT_AIR_TH_MAP field outside block");
+
+// Air temperature: 10 C per minute is a bad read, outside -30..50 C is flagged.
+static constexpr SampleFilterRule JXCT_AIR_TH_RULES[2] = {
+  SampleFilterRule::none(),
+  SampleFilterRule::make(JXCT_AIR_TH_MAP.fields[JXCT_AIR_TH_TEMPERATURE], -30.0, 50.0, 10.0)
+};
+
+// RS485_Wind_Speed_Sensor.md
+enum WindSpeedField : uint8_t {
+  WIND_SPEED_MS = 0
+};
+
+static constexpr ModbusRegisterMap<1> WIND_SPEED_MAP = {
+  0x0016, 1, {
+    {0x0016, MODBUS_FIELD_U16, 10.0, 0.0, 0.0, 30.0, SAMPLE_UNIT_M_PER_S}
+  }
+};
+static_assert(WIND_SPEED_MAP.isValid(), "WIND_SPEED_MAP field outside block");
+
+// Jumps above 15 m/s are rejected unless two reads in a row confirm them.
+static constexpr SampleFilterRule WIND_SPEED_RULES[1] = {
+  SampleFilterRule::make(WIND_SPEED_MAP.fields[WIND_SPEED_MS], 1.0, 0.0, 15.0, 2)
+};
+
+// RS485_Wind_Direction_Sensor.md
+enum WindDirectionField : uint8_t {
+  WIND_DIRECTION_DEG = 0
+};
+
+static constexpr ModbusRegisterMap<1> WIND_DIRECTION_MAP = {
+  0x0000, 1, {
+    {0x0000, MODBUS_FIELD_U16, 1.0, 0.0, 0.0, 360.0, SAMPLE_UNIT_DEGREE}
+  }
+};
+static_assert(WIND_DIRECTION_MAP.isValid(), "WIND_DIRECTION_MAP field outside block");
+
+// RS485_Illuminance_Sensor.md (u32, high word at 0x0007)
+enum IlluminanceField : uint8_t {
+  ILLUMINANCE_LUX = 0
+};
+
+static constexpr ModbusRegisterMap<1> ILLUMINANCE_MAP = {
+  0x0007, 2, {
+    {0x0007, MODBUS_FIELD_U32, 1.0, 0.0, 0.0, 200000.0, SAMPLE_UNIT_LUX}
+  }
+};
+static_assert(ILLUMINANCE_MAP.isValid(), "ILLUMINANCE_MAP field outside block");
+
+// RS485_Total_Solar_Radiation_Sensor.md
+enum SolarRadiationField : uint8_t {
+  SOLAR_RADIATION_WM2 = 0
+};
+
+static constexpr ModbusRegisterMap<1> SOLAR_RADIATION_MAP = {
+  0x0000, 1, {
+    {0x0000, MODBUS_FIELD_U16, 1.0, 0.0, 0.0, 1500.0, SAMPLE_UNIT_W_PER_M2}
+  }
+};
+static_assert(SOLAR_RADIATION_MAP.isValid(), "SOLAR_RADIATION_MAP field outside block");
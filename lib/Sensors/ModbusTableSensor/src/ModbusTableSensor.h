@@ -0,0 +1,240 @@
+#pragma once
+#include <Arduino.h>
+#include "RS485Modbus.h"
+#include "ModbusRegisterMap.h"
+#include "SensorDriver.h"
+#include "Configuration_System.h"
+
+/*
+  ModbusTableSensor
+
+  Driver intent:
+  - Generic RS485 Modbus RTU driver for sensors whose whole measurement is
+    one function 0x03 block. The protocol lives in a constexpr
+    ModbusRegisterMap (see ModbusSensorMaps.h); no per-sensor code.
+  - values[i] holds field i of the map after a successful readData(), as
+    a FixedSample at the field's scale and unit.
+
+  Read cycle:
+  - Request built once from map.block() (again on setAddress()), CRC
+    included; response size and byte-count prefix derived from the map.
+  - One SampleFilter pass scales every field and applies range protection
+    (hard bounds, fault words, and the optional per-field rules: soft
+    bounds, rate of change, stuck values), reading straight from the bus
+    RX buffer (ModbusFrameView), no response copy.
+  - A rejected field keeps its last good value and fails the cycle without
+    polling again; the sensor would repeat the same frame. On a failed
+    cycle with no parsed frame, setFallbackValues() writes -99 at each
+    field's scale.
+
+  Usage:
+    static ModbusTableSensor<2> airTH(rs485Bus0, JXCT_AIR_TH_MAP, JXCT_AIR_TH_RULES, "AIR_TH", 0x01);
+    airTH.readData();
+    const FixedSample& humidity = airTH.values[JXCT_AIR_TH_HUMIDITY];  // 0.1 %RH
+*/
+template <size_t N>
+class ModbusTableSensor : public SensorDriver {
+public:
+  FixedSample values[N];
+
+  // rules: N entries, or nullptr for hard bounds and fault words only.
+  ModbusTableSensor(RS485Bus& bus,
+                    const ModbusRegisterMap<N>& map,
+                    const SampleFilterRule* rules,
+                    const char* sensorId,
+                    uint8_t address,
+                    bool debugEnable = false,
+                    uint8_t powerLineIndex = 0,
+                    uint8_t interfaceIndex = 0,
+                    uint16_t sampleRateMin = 1,
+                    uint32_t warmUpTimeMs = 500,
+                    uint8_t maxConsecutiveErrors = 10,
+                    uint32_t minUsefulPowerOffMs = 60000UL)
+      : SensorDriver(sensorId,
+                     address,
+                     debugEnable,
+                     powerLineIndex,
+                     interfaceIndex,
+                     sampleRateMin,
+                     warmUpTimeMs,
+                     maxConsecutiveErrors,
+                     minUsefulPowerOffMs),
+        values(),
+        _bus(bus),
+        _map(map),
+        _rules(rules),
+        _readRequest(map.request(address)),
+        _lastValidMask(0),
+        _filter() {}
+
+  ModbusTableSensor(RS485Bus& bus,
+                    const ModbusRegisterMap<N>& map,
+                    const char* sensorId,
+                    uint8_t address,
+                    bool debugEnable = false,
+                    uint8_t powerLineIndex = 0,
+                    uint8_t interfaceIndex = 0,
+                    uint16_t sampleRateMin = 1,
+                    uint32_t warmUpTimeMs = 500,
+                    uint8_t maxConsecutiveErrors = 10,
+                    uint32_t minUsefulPowerOffMs = 60000UL)
+      : ModbusTableSensor(bus,
+                          map,
+                          nullptr,
+                          sensorId,
+                          address,
+                          debugEnable,
+                          powerLineIndex,
+                          interfaceIndex,
+                          sampleRateMin,
+                          warmUpTimeMs,
+                          maxConsecutiveErrors,
+                          minUsefulPowerOffMs) {}
+
+  void setAddress(uint8_t address) override {
+    SensorDriver::setAddress(address);
+    _readRequest = _map.request(address);
+  }
+
+  bool readData() override {
+    markReadTime(millis());
+
+    bool gotAnyValidFrame = false;
+
+    for (uint8_t attempt = 1; attempt <= SENSOR_DEFAULT_DRIVER_RETRIES; ++attempt) {
+      if (readOnce(SENSOR_DEFAULT_READ_TIMEOUT_MS, SENSOR_DEFAULT_AFTER_REQ_MS, gotAnyValidFrame)) {
+        markSuccess();
+        return true;
+      }
+      // The device rejected the table (wrong start or count): no point in
+      // asking again until the map is fixed.
+      if (_bus.lastWasException()) {
+        logException();
+        break;
+      }
+      // A frame arrived but the filter rejected a value: it is held, and
+      // another request would bring back the same frame.
+      if (gotAnyValidFrame) break;
+    }
+
+    if (!gotAnyValidFrame) {
+      setFallbackValues();
+    }
+
+    markFailure();
+    return false;
+  }
+
+  void setFallbackValues() override {
+    for (size_t i = 0; i < N; ++i) {
+      values[i] = _map.fields[i].fallback();
+    }
+  }
+
+  // values[], for burst statistics.
+  uint8_t valueCount() const override { return (uint8_t)N; }
+  FixedSample* valueAt(uint8_t index) override { return (index < N) ? &values[index] : nullptr; }
+
+  // _filter[], kept through deep sleep (SleepPlanner::retain()).
+  void* filterStates(size_t& bytes) override {
+    bytes = sizeof(_filter);
+    return _filter;
+  }
+
+  // Bit i set when field i was accepted by the filter on the last frame.
+  uint32_t lastValidMask() const { return _lastValidMask; }
+
+  // Filter history of field i (quality, last good value, invalid count).
+  const SampleFilter::State& filterState(size_t i) const { return _filter[i]; }
+
+  const ModbusRegisterMap<N>& registerMap() const { return _map; }
+
+private:
+  // Largest block a table sensor reads; fits the bus RX buffer on every target.
+  static const uint16_t MAX_TABLE_REGS = SENSOR_BATCH_MAX_REGS;
+
+  RS485Bus& _bus;
+  const ModbusRegisterMap<N>& _map;
+  const SampleFilterRule* _rules;
+  ModbusRequestFrame _readRequest;
+  uint32_t _lastValidMask;
+  SampleFilter::State _filter[N];
+
+  bool readOnce(uint16_t readTimeoutMs, uint16_t afterReqDelayMs, bool& gotFrame) {
+    if (_map.count > MAX_TABLE_REGS) return false;
+
+    const uint8_t check[3] = {_address, ModbusReadPlanner::FUNCTION_READ_HOLDING, _map.byteCount()};
+    ModbusFrameView frame;
+
+    const bool ok = _bus.transact(_readRequest,
+                                  _map.responseSize(),
+                                  check,
+                                  3,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  readTimeoutMs,
+                                  _debugEnable,
+                                  afterReqDelayMs);
+    if (!ok) {
+      return false;
+    }
+
+    gotFrame = true;
+    uint8_t quality = SAMPLE_QUALITY_OK;
+    _lastValidMask = SampleFilter::apply(_map, _rules, frame, _filter, values, millis(), &quality);
+    setSampleQuality(quality);
+    logDecoded(frame);
+
+    if (_lastValidMask == ModbusRegisterMap<N>::allFieldsMask()) {
+      return true;
+    }
+
+    if (_bus.getLogger() && _debugEnable) {
+      _bus.getLogger()->print(F("[DRV][ModbusTableSensor] Range check fail, valid mask=0x"), true);
+      _bus.getLogger()->print((unsigned long)_lastValidMask, true, ", quality 0x", HEX);
+      _bus.getLogger()->print((unsigned int)quality, true, "", HEX);
+      _bus.getLogger()->println("", true);
+    }
+    return false;
+  }
+
+  void logException() const {
+    PrintController* log = _bus.getLogger();
+    if (!log) return;
+
+    const ModbusException& ex = _bus.lastException();
+    log->print(F("[DRV][ModbusTableSensor] "), true);
+    log->print(_sensorId ? _sensorId : "", true);
+    log->print(F(" rejected reg 0x"), true);
+    log->print((unsigned int)_map.start, true, "", HEX);
+    log->print(F(": exception "), true);
+    log->print((unsigned int)ex.code, true, " (", DEC);
+    log->print(ModbusException::codeName(ex.code), true);
+    log->println(")", true);
+  }
+
+  void logDecoded(const ModbusFrameView& frame) const {
+    PrintController* log = _bus.getLogger();
+    if (!log || !_debugEnable) return;
+
+    log->print(F("[DRV][ModbusTableSensor] Parsed "), true);
+    log->println(_sensorId ? _sensorId : "", true);
+
+    for (size_t i = 0; i < N; ++i) {
+      const ModbusFieldSpec& field = _map.fields[i];
+      log->print(F("  reg 0x"), true);
+      log->print((unsigned int)field.reg, true, "", HEX);
+      log->print(F(" raw = "), true);
+      log->print((long)ModbusRegisterDecoder::rawValue(field, frame.data(), _map.start), true, "", DEC);
+      log->print(F(" | value = "), true);
+      log->printFixed(values[i].raw, values[i].decimals, true, " ");
+      log->print(FixedSample::unitName(values[i].unit), true,
+                 ((_lastValidMask >> i) & 1UL) ? "" : " (held)");
+      if (_filter[i].quality != SAMPLE_QUALITY_OK) {
+        log->print(F(" quality 0x"), true);
+        log->print((unsigned int)_filter[i].quality, true, "", HEX);
+      }
+      log->println("", true);
+    }
+  }
+};
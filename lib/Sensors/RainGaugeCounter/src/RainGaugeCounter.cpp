@@ -11,7 +11,7 @@ RainGaugeCounter::RainGaugeCounter(const char* sensorId,
                                    uint32_t warmUpTimeMs,
                                    uint8_t maxConsecutiveErrors,
                                    uint32_t minUsefulPowerOffMs,
-                                   double mmPerPulse,
+                                   uint32_t mmPerPulseScaled,
                                    CountingMode countingMode,
                                    uint8_t pcf8574Address,
                                    int8_t counterResetPin,
@@ -27,19 +27,24 @@ RainGaugeCounter::RainGaugeCounter(const char* sensorId,
                    maxConsecutiveErrors,
                    minUsefulPowerOffMs),
       pulse_count(0),
-      rainfall_mm(0.0),
+      rainfall_mm(FixedSample::make(0, RAINFALL_DECIMALS, SAMPLE_UNIT_MM)),
+      rain_rate_1m_peak(FixedSample::fallback(RainIntensity::RATE_DECIMALS, SAMPLE_UNIT_MM_PER_H)),
+      rain_rate_5m_peak(FixedSample::fallback(RainIntensity::RATE_DECIMALS, SAMPLE_UNIT_MM_PER_H)),
       _bus(nullptr),
       _wire(nullptr),
       _log(nullptr),
-      _mmPerPulse(mmPerPulse),
+      _mmPerPulseScaled(mmPerPulseScaled),
       _countingMode(countingMode),
       _pcf8574Address(pcf8574Address),
       _counterResetPin(counterResetPin),
       _interruptPin(interruptPin),
       _interruptDebounceMs(interruptDebounceMs),
       _mcuPulseCounter(0),
-      _lastInterruptMs(0),
-      _countingActive(false) {}
+      _lastInterruptUs(0),
+      _countingActive(false),
+      _intensity(mmPerPulseScaled, RAINFALL_DECIMALS),
+      _droppedPulses(0),
+      _untimedPulses(false) {}
 
 void RainGaugeCounter::begin(TwoWire* wire, RS485Bus* bus) {
   _wire = wire;
@@ -50,14 +55,22 @@ void RainGaugeCounter::begin(TwoWire* wire, RS485Bus* bus) {
     digitalWrite(_counterResetPin, LOW);
   }
 
-  if (_countingMode == MCU_INTERRUPT && _interruptPin >= 0) {
+  if ((_countingMode == MCU_INTERRUPT || _countingMode == PCNT_COUNTER) && _interruptPin >= 0) {
     pinMode(_interruptPin, INPUT_PULLUP);
   }
 }
 
 void RainGaugeCounter::setFallbackValues() {
   pulse_count = 0;
-  rainfall_mm = -99.0;
+  rainfall_mm = FixedSample::fallback(RAINFALL_DECIMALS, SAMPLE_UNIT_MM);
+  rain_rate_1m_peak = FixedSample::fallback(RainIntensity::RATE_DECIMALS, SAMPLE_UNIT_MM_PER_H);
+  rain_rate_5m_peak = FixedSample::fallback(RainIntensity::RATE_DECIMALS, SAMPLE_UNIT_MM_PER_H);
+}
+
+void RainGaugeCounter::setRainfallFromPulses() {
+  rainfall_mm = FixedSample::make((int32_t)(pulse_count * _mmPerPulseScaled),
+                                  RAINFALL_DECIMALS,
+                                  SAMPLE_UNIT_MM);
 }
 
 const char* RainGaugeCounter::countingModeToString(CountingMode mode) {
@@ -65,6 +78,8 @@ const char* RainGaugeCounter::countingModeToString(CountingMode mode) {
     case EXTERNAL_COUNTER: return "external PCF8574/4040 counter";
     case MCU_INTERRUPT: return "MCU interrupt pulse counter";
     case RS485_SENSOR: return "RS485 sensor internal counter";
+    case PCNT_COUNTER: return "ESP32 PCNT hardware pulse counter";
+    case ULP_COUNTER: return "ESP32 ULP pulse counter (counts in deep sleep)";
     default: return "unknown";
   }
 }
@@ -88,13 +103,24 @@ bool RainGaugeCounter::readData() {
       ok = readMcuCounter();
       break;
 
+    case PCNT_COUNTER:
+      ok = readPcntCounter();
+      break;
+
+    case ULP_COUNTER:
+      ok = readUlpCounter();
+      break;
+
     case RS485_SENSOR:
       if (supportsRs485SensorMode()) {
-        double value = -99.0;
+        FixedSample value = FixedSample::fallback(RAINFALL_DECIMALS, SAMPLE_UNIT_MM);
         ok = readRs485Rainfall(value);
         if (ok) {
-          rainfall_mm = value;
-          pulse_count = (uint32_t)((value / _mmPerPulse) + 0.5);
+          const int32_t scaled = value.scaledTo(RAINFALL_DECIMALS);
+          rainfall_mm = FixedSample::make(scaled, RAINFALL_DECIMALS, SAMPLE_UNIT_MM);
+          pulse_count = (scaled > 0 && _mmPerPulseScaled > 0)
+                            ? ((uint32_t)scaled + _mmPerPulseScaled / 2) / _mmPerPulseScaled
+                            : 0;
         }
       }
       break;
@@ -122,6 +148,12 @@ bool RainGaugeCounter::resetCounter() {
     case MCU_INTERRUPT:
       return resetMcuCounter();
 
+    case PCNT_COUNTER:
+      return resetPcntCounter();
+
+    case ULP_COUNTER:
+      return resetUlpCounter();
+
     case RS485_SENSOR:
       if (supportsRs485SensorMode()) {
         return resetRs485Rainfall();
@@ -151,12 +183,12 @@ bool RainGaugeCounter::readExternalCounter() {
 
   const uint8_t raw = _wire->read();
   pulse_count = raw;
-  rainfall_mm = (double)pulse_count * _mmPerPulse;
+  setRainfallFromPulses();
 
   if (_log && _debugEnable) {
     _log->print(F("[RAIN] PCF8574 raw count="), true);
     _log->print((unsigned int)raw, true, " | rainfall=");
-    _log->print(rainfall_mm, true, " mm", 4);
+    _log->printFixed(rainfall_mm.raw, rainfall_mm.decimals, true, " mm");
     _log->println("", true);
   }
 
@@ -179,21 +211,170 @@ bool RainGaugeCounter::readMcuCounter() {
   interrupts();
 
   pulse_count = count;
-  rainfall_mm = (double)pulse_count * _mmPerPulse;
+  setRainfallFromPulses();
+
+  servicePulses();
+  publishPeaks();
   return true;
 }
 
+void RainGaugeCounter::publishPeaks() {
+  rain_rate_1m_peak = _intensity.peak1m();
+  rain_rate_5m_peak = _intensity.peak5m();
+  _intensity.resetPeaks();
+
+  if (_log && _debugEnable) {
+    _log->print(F("[RAIN] Peak rate 1 min="), true);
+    _log->printFixed(rain_rate_1m_peak.raw, rain_rate_1m_peak.decimals, true, " mm/h | 5 min=");
+    _log->printFixed(rain_rate_5m_peak.raw, rain_rate_5m_peak.decimals, true, " mm/h | dropped=");
+    _log->println((unsigned long)_droppedPulses, true);
+  }
+}
+
+void RainGaugeCounter::servicePulses() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if (_countingMode == PCNT_COUNTER || _countingMode == ULP_COUNTER) {
+    const uint32_t nowMs = millis();
+    uint32_t fresh = (_countingMode == PCNT_COUNTER) ? _pcnt.poll() : _ulp.poll();
+    // No pulse times: the new pulses land in the bin of this call.
+    while (fresh > 0) {
+      const uint16_t chunk = (fresh > 0xFFFFUL) ? 0xFFFF : (uint16_t)fresh;
+      _intensity.addPulses(nowMs, chunk);
+      fresh -= chunk;
+    }
+    _intensity.advance(nowMs);
+    return;
+  }
+#endif
+
+  if (_countingMode != MCU_INTERRUPT) return;
+
+  // Pulse times are micros(); place them on the millis() timeline by
+  // their age, read against one pair of clocks.
+  const uint32_t nowUs = micros();
+  const uint32_t nowMs = millis();
+
+  uint32_t stampUs;
+  while (_pulseRing.pop(stampUs)) {
+    _intensity.addPulse(nowMs - (nowUs - stampUs) / 1000UL);
+  }
+  _droppedPulses += _pulseRing.takeOverflows();
+  _intensity.advance(nowMs);
+}
+
 bool RainGaugeCounter::resetMcuCounter() {
+  // Totals only: the intensity windows are rain rate, not accounting,
+  // and keep sliding across the reset.
   noInterrupts();
   _mcuPulseCounter = 0;
-  _lastInterruptMs = 0;
+  _lastInterruptUs = 0;
   interrupts();
   pulse_count = 0;
-  rainfall_mm = 0.0;
+  setRainfallFromPulses();
   return true;
 }
 
+bool RainGaugeCounter::readPcntCounter() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if (!_pcnt.active()) return false;
+
+  servicePulses();
+  pulse_count = _pcnt.total();
+  setRainfallFromPulses();
+  publishPeaks();
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool RainGaugeCounter::resetPcntCounter() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if (!_pcnt.active()) return false;
+
+  // Pulses since the last read go to the windows before the total clears.
+  servicePulses();
+  _pcnt.clearTotal();
+  pulse_count = 0;
+  setRainfallFromPulses();
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool RainGaugeCounter::readUlpCounter() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if (!_ulp.active()) return false;
+
+  servicePulses();
+  pulse_count = _ulp.total();
+  setRainfallFromPulses();
+
+  if (_untimedPulses) {
+    // The windows missed the pulses counted asleep: no peak to report.
+    rain_rate_1m_peak = FixedSample::fallback(RainIntensity::RATE_DECIMALS, SAMPLE_UNIT_MM_PER_H);
+    rain_rate_5m_peak = FixedSample::fallback(RainIntensity::RATE_DECIMALS, SAMPLE_UNIT_MM_PER_H);
+    _intensity.resetPeaks();
+    _untimedPulses = false;
+  } else {
+    publishPeaks();
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool RainGaugeCounter::resetUlpCounter() {
+#if defined(ARDUINO_ARCH_ESP32)
+  if (!_ulp.active()) return false;
+
+  servicePulses();
+  _ulp.clearTotal();
+  pulse_count = 0;
+  setRainfallFromPulses();
+  return true;
+#else
+  return false;
+#endif
+}
+
 bool RainGaugeCounter::activateCounting() {
+  if (_countingMode == ULP_COUNTER && _interruptPin >= 0) {
+#if defined(ARDUINO_ARCH_ESP32)
+    if (!_ulp.begin(_interruptPin, RAIN_GAUGE_ULP_PERIOD_US)) {
+      logStep(F("[RAIN] ULP counter unavailable (not an RTC GPIO, or in use)"));
+      return false;
+    }
+    _countingActive = true;
+    if (_ulp.resumed()) {
+      // Pulses counted asleep go to the total only; they have no time.
+      if (_ulp.poll() > 0) _untimedPulses = true;
+      logStep(F("[RAIN] ULP counting resumed after deep sleep"));
+    } else {
+      logStep(F("[RAIN] ULP counting activated"));
+    }
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  if (_countingMode == PCNT_COUNTER && _interruptPin >= 0) {
+#if defined(ARDUINO_ARCH_ESP32)
+    if (!_pcnt.begin(_interruptPin, RAIN_GAUGE_PCNT_FILTER_NS)) {
+      logStep(F("[RAIN] No free PCNT unit"));
+      return false;
+    }
+    _countingActive = true;
+    logStep(F("[RAIN] PCNT hardware counting activated"));
+    return true;
+#else
+    return false;
+#endif
+  }
+
   if (_countingMode != MCU_INTERRUPT || _interruptPin < 0) {
     return false;
   }
@@ -206,6 +387,28 @@ bool RainGaugeCounter::activateCounting() {
 }
 
 bool RainGaugeCounter::deactivateCounting() {
+  if (_countingMode == ULP_COUNTER && _interruptPin >= 0) {
+#if defined(ARDUINO_ARCH_ESP32)
+    _ulp.end();
+    _countingActive = false;
+    logStep(F("[RAIN] ULP counting deactivated"));
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  if (_countingMode == PCNT_COUNTER && _interruptPin >= 0) {
+#if defined(ARDUINO_ARCH_ESP32)
+    _pcnt.end();
+    _countingActive = false;
+    logStep(F("[RAIN] PCNT hardware counting deactivated"));
+    return true;
+#else
+    return false;
+#endif
+  }
+
   if (_countingMode != MCU_INTERRUPT || _interruptPin < 0) {
     return false;
   }
@@ -220,10 +423,11 @@ bool RainGaugeCounter::deactivateCounting() {
 }
 
 void RainGaugeCounter::handlePulseInterrupt() {
-  const unsigned long now = millis();
-  if ((now - _lastInterruptMs) > _interruptDebounceMs) {
+  const uint32_t nowUs = micros();
+  if ((nowUs - _lastInterruptUs) > (uint32_t)_interruptDebounceMs * 1000UL) {
     ++_mcuPulseCounter;
-    _lastInterruptMs = now;
+    _lastInterruptUs = nowUs;
+    _pulseRing.push(nowUs);
   }
 }
 
@@ -233,7 +437,7 @@ void RainGaugeCounter::handleActiveInterrupt() {
   }
 }
 
-bool RainGaugeCounter::readRs485Rainfall(double& rainfallMm) {
+bool RainGaugeCounter::readRs485Rainfall(FixedSample& rainfallMm) {
   (void)rainfallMm;
   return false;
 }
@@ -5,21 +5,59 @@
 #include "RS485Modbus.h"
 #include "SensorDriver.h"
 #include "Configuration_System.h"
+#include "RainPulseRing.h"
+#include "RainIntensity.h"
+#include "RainPulseCounterEsp32.h"
+#include "RainPulseCounterUlp.h"
 
 #define RAIN_GAUGE_COUNTING_MODE_EXTERNAL_COUNTER 0
 #define RAIN_GAUGE_COUNTING_MODE_MCU_INTERRUPT    1
 #define RAIN_GAUGE_COUNTING_MODE_RS485_SENSOR     2
+#define RAIN_GAUGE_COUNTING_MODE_PCNT_COUNTER     3
+#define RAIN_GAUGE_COUNTING_MODE_ULP_COUNTER      4
+
+// PCNT_COUNTER glitch filter; the driver clamps it to 1023 APB cycles
+// (~12.8 us). Contact bounce is left to the RC debouncer.
+#if !defined(RAIN_GAUGE_PCNT_FILTER_NS)
+  #define RAIN_GAUGE_PCNT_FILTER_NS 12000UL
+#endif
+
+// ULP_COUNTER sampling period: pulses shorter than this can be missed.
+// Tipping-bucket contacts close for tens of ms.
+#if !defined(RAIN_GAUGE_ULP_PERIOD_US)
+  #define RAIN_GAUGE_ULP_PERIOD_US 5000UL
+#endif
 
 class RainGaugeCounter : public SensorDriver {
 public:
   enum CountingMode : uint8_t {
     EXTERNAL_COUNTER = RAIN_GAUGE_COUNTING_MODE_EXTERNAL_COUNTER,
     MCU_INTERRUPT    = RAIN_GAUGE_COUNTING_MODE_MCU_INTERRUPT,
-    RS485_SENSOR     = RAIN_GAUGE_COUNTING_MODE_RS485_SENSOR
+    RS485_SENSOR     = RAIN_GAUGE_COUNTING_MODE_RS485_SENSOR,
+    // ESP32 only: the PCNT peripheral counts interruptPin in hardware,
+    // one unit per gauge, no CPU wake-up per pulse. interruptDebounceMs
+    // is unused; see RainPulseCounterEsp32.
+    PCNT_COUNTER     = RAIN_GAUGE_COUNTING_MODE_PCNT_COUNTER,
+    // ESP32 only: the ULP coprocessor samples interruptPin (an RTC GPIO)
+    // and keeps counting in light and deep sleep; one gauge per chip.
+    // interruptDebounceMs is unused; see RainPulseCounterUlp.
+    ULP_COUNTER      = RAIN_GAUGE_COUNTING_MODE_ULP_COUNTER
   };
 
+  // Rainfall is kept in 0.0001 mm so tipping-bucket resolutions such as
+  // 0.2794 mm per pulse stay exact: pulse_count * mm-per-pulse in
+  // integers, no float on the counting path.
+  static const uint8_t RAINFALL_DECIMALS = 4;
+
   uint32_t pulse_count;
-  double rainfall_mm;
+  FixedSample rainfall_mm;  // RAINFALL_DECIMALS, SAMPLE_UNIT_MM
+
+  // MCU_INTERRUPT, PCNT_COUNTER and ULP_COUNTER: peak rain rate over 1 and
+  // 5 minutes since the previous readData() (RainIntensity::RATE_DECIMALS,
+  // mm/h). Fallback in the other counting modes, which see no pulse times,
+  // and in ULP_COUNTER when pulses were counted in deep sleep.
+  FixedSample rain_rate_1m_peak;
+  FixedSample rain_rate_5m_peak;
 
   RainGaugeCounter(const char* sensorId,
                    uint8_t address,
@@ -30,7 +68,7 @@ public:
                    uint32_t warmUpTimeMs,
                    uint8_t maxConsecutiveErrors,
                    uint32_t minUsefulPowerOffMs,
-                   double mmPerPulse,
+                   uint32_t mmPerPulseScaled,  // mm * 10^RAINFALL_DECIMALS
                    CountingMode countingMode,
                    uint8_t pcf8574Address,
                    int8_t counterResetPin,
@@ -49,14 +87,29 @@ public:
   bool deactivateCounting();
   bool isCountingActive() const { return _countingActive; }
 
+  // MCU_INTERRUPT: moves the pulse times queued by the ISR into the
+  // intensity windows. PCNT_COUNTER and ULP_COUNTER: fold the hardware
+  // count into the total, the new pulses dated to this call. Call from loop();
+  // readData() calls it too.
+  void servicePulses();
+
+  // Current windows (rate1m()/rate5m()) and peaks since the last read.
+  const RainIntensity& intensity() const { return _intensity; }
+
+  // Pulse times lost to a full ring (counted in the rainfall total,
+  // missing from the intensity windows), since begin().
+  uint32_t getDroppedPulses() const { return _droppedPulses; }
+
   CountingMode getCountingMode() const { return _countingMode; }
-  double getMmPerPulse() const { return _mmPerPulse; }
+  FixedSample getMmPerPulse() const {
+    return FixedSample::make((int32_t)_mmPerPulseScaled, RAINFALL_DECIMALS, SAMPLE_UNIT_MM);
+  }
 
   static const char* countingModeToString(CountingMode mode);
 
 protected:
   virtual bool supportsRs485SensorMode() const { return false; }
-  virtual bool readRs485Rainfall(double& rainfallMm);
+  virtual bool readRs485Rainfall(FixedSample& rainfallMm);
   virtual bool resetRs485Rainfall();
 
   RS485Bus* _bus;
@@ -65,7 +118,7 @@ private:
   TwoWire* _wire;
   PrintController* _log;
 
-  double _mmPerPulse;
+  uint32_t _mmPerPulseScaled;
   CountingMode _countingMode;
   uint8_t _pcf8574Address;
   int8_t _counterResetPin;
@@ -73,15 +126,31 @@ private:
   uint16_t _interruptDebounceMs;
 
   volatile uint32_t _mcuPulseCounter;
-  volatile unsigned long _lastInterruptMs;
+  volatile uint32_t _lastInterruptUs;
   bool _countingActive;
 
+  RainPulseRing _pulseRing;    // ISR -> servicePulses()
+  RainIntensity _intensity;
+  uint32_t _droppedPulses;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  RainPulseCounterEsp32 _pcnt;
+  RainPulseCounterUlp _ulp;
+#endif
+  bool _untimedPulses;         // counted in deep sleep since the last read
+
   bool readExternalCounter();
   bool resetExternalCounter();
   bool readMcuCounter();
   bool resetMcuCounter();
+  bool readPcntCounter();
+  bool resetPcntCounter();
+  bool readUlpCounter();
+  bool resetUlpCounter();
+  void publishPeaks();
   void handlePulseInterrupt();
   void logStep(const __FlashStringHelper* message) const;
+  void setRainfallFromPulses();
 
   static RainGaugeCounter* _activeInterruptCounter;
   static void handleActiveInterrupt();
@@ -0,0 +1,90 @@
+#include "RainIntensity.h"
+
+RainIntensity::RainIntensity(uint32_t mmPerPulseScaled, uint8_t pulseDecimals)
+    : _mmPerPulseScaled(mmPerPulseScaled),
+      _pulseDecimals(pulseDecimals) {
+  reset();
+}
+
+void RainIntensity::reset() {
+  for (uint8_t i = 0; i < RAIN_INTENSITY_BINS; ++i) _bins[i] = 0;
+  _headBin = 0;
+  _started = false;
+  resetPeaks();
+}
+
+// ============================================================
+// Windows
+// ============================================================
+
+void RainIntensity::moveTo(uint32_t bin) {
+  const int32_t diff = (int32_t)(bin - _headBin);
+
+  if (_started && diff <= 0) {
+    if (diff > -(int32_t)RAIN_INTENSITY_BINS) return;  // inside the window
+    // Far behind the newest bin: millis() wrapped. Start over.
+    _started = false;
+  }
+
+  if (!_started || diff >= (int32_t)RAIN_INTENSITY_BINS) {
+    for (uint8_t i = 0; i < RAIN_INTENSITY_BINS; ++i) _bins[i] = 0;
+  } else {
+    for (int32_t k = 1; k <= diff; ++k) {
+      _bins[(_headBin + (uint32_t)k) % RAIN_INTENSITY_BINS] = 0;
+    }
+  }
+
+  _headBin = bin;
+  _started = true;
+}
+
+void RainIntensity::addPulse(uint32_t eventMs) {
+  addPulses(eventMs, 1);
+}
+
+void RainIntensity::addPulses(uint32_t eventMs, uint16_t count) {
+  if (count == 0) return;
+
+  const uint32_t bin = eventMs / RAIN_INTENSITY_BIN_MS;
+  moveTo(bin);
+
+  // A pulse from an older bin inside the window still counts there.
+  uint8_t& slot = _bins[bin % RAIN_INTENSITY_BINS];
+  slot = (count >= (uint16_t)(255 - slot)) ? 255 : (uint8_t)(slot + count);
+
+  const uint16_t sum1m = pulses1m();
+  const uint16_t sum5m = pulses5m();
+  if (sum1m > _peak1m) _peak1m = sum1m;
+  if (sum5m > _peak5m) _peak5m = sum5m;
+}
+
+void RainIntensity::advance(uint32_t nowMs) {
+  if (!_started) return;
+  moveTo(nowMs / RAIN_INTENSITY_BIN_MS);
+}
+
+uint16_t RainIntensity::windowSum(uint8_t bins) const {
+  if (!_started) return 0;
+
+  uint16_t sum = 0;
+  const uint8_t head = (uint8_t)(_headBin % RAIN_INTENSITY_BINS);
+  for (uint8_t k = 0; k < bins; ++k) {
+    sum += _bins[(head + RAIN_INTENSITY_BINS - k) % RAIN_INTENSITY_BINS];
+  }
+  return sum;
+}
+
+// ============================================================
+// Rates
+// ============================================================
+
+FixedSample RainIntensity::rate(uint16_t pulses, uint8_t bins) const {
+  // mm/h = pulses * mm per pulse * (1 h / window), rounded to
+  // RATE_DECIMALS. Below 2^64 for any saturated window.
+  const uint64_t num = (uint64_t)pulses * _mmPerPulseScaled * 3600000ULL *
+                       (uint64_t)FixedSample::pow10(RATE_DECIMALS);
+  const uint64_t den = (uint64_t)bins * RAIN_INTENSITY_BIN_MS *
+                       (uint64_t)FixedSample::pow10(_pulseDecimals);
+
+  return FixedSample::make((int32_t)((num + den / 2) / den), RATE_DECIMALS, SAMPLE_UNIT_MM_PER_H);
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <Arduino.h>
+#include "FixedSample.h"
+
+/*
+  RainIntensity
+
+  Rain rate (mm/h) over sliding 1- and 5-minute windows, from pulse
+  times, plus the peak of each since resetPeaks(). The rainfall total
+  per sample period hides a ten-minute cloudburst; runoff alerts need
+  the peak rate.
+
+    RainIntensity rate(2794, 4);     // 0.2794 mm per pulse
+    rate.addPulse(eventMs);          // in time order
+    rate.advance(millis());          // expire old bins when idle
+    rate.rate1m();  rate.peak5m();   // FixedSample, mm/h, 2 decimals
+
+  Pulses are counted in RAIN_INTENSITY_BINS bins of RAIN_INTENSITY_BIN_MS
+  (30 x 10 s = 5 min). The 1-minute window is the newest 6 bins, so the
+  windows slide in 10 s steps; rates are count * mm per pulse scaled to
+  one hour, in integers. Peaks are taken at each pulse, the moment a
+  window's count rises. Fixed memory, O(bins) per pulse.
+
+  A gap of 5 min or more empties the windows, and so does millis()
+  wrapping (every ~49.7 days: a time far behind the newest bin starts
+  the windows over). Peaks are kept until resetPeaks().
+*/
+
+#if !defined(RAIN_INTENSITY_BIN_MS)
+  #define RAIN_INTENSITY_BIN_MS 10000UL
+#endif
+
+#if !defined(RAIN_INTENSITY_BINS)
+  #define RAIN_INTENSITY_BINS 30
+#endif
+
+class RainIntensity {
+public:
+  static const uint8_t RATE_DECIMALS = 2;
+
+  // mmPerPulseScaled is mm * 10^pulseDecimals.
+  RainIntensity(uint32_t mmPerPulseScaled, uint8_t pulseDecimals);
+
+  // Empties the windows and clears the peaks.
+  void reset();
+
+  // One pulse at eventMs (millis() timebase), in time order.
+  void addPulse(uint32_t eventMs);
+
+  // count pulses in the bin of eventMs, for counters that report totals
+  // rather than pulse times (PCNT, ULP): the windows get poll resolution.
+  void addPulses(uint32_t eventMs, uint16_t count);
+
+  // Moves the windows to nowMs without a pulse, so rates fall off when
+  // the rain stops.
+  void advance(uint32_t nowMs);
+
+  uint16_t pulses1m() const { return windowSum(BINS_1MIN); }
+  uint16_t pulses5m() const { return windowSum(RAIN_INTENSITY_BINS); }
+
+  FixedSample rate1m() const { return rate(pulses1m(), BINS_1MIN); }
+  FixedSample rate5m() const { return rate(pulses5m(), RAIN_INTENSITY_BINS); }
+  FixedSample peak1m() const { return rate(_peak1m, BINS_1MIN); }
+  FixedSample peak5m() const { return rate(_peak5m, RAIN_INTENSITY_BINS); }
+
+  void resetPeaks() {
+    _peak1m = 0;
+    _peak5m = 0;
+  }
+
+private:
+  static const uint8_t BINS_1MIN = (uint8_t)(60000UL / RAIN_INTENSITY_BIN_MS);
+
+  uint32_t _mmPerPulseScaled;
+  uint8_t _pulseDecimals;
+
+  uint8_t _bins[RAIN_INTENSITY_BINS];  // pulses per bin, saturating
+  uint32_t _headBin;                   // absolute index of the newest bin
+  bool _started;
+
+  uint16_t _peak1m;  // pulses in the window at its peak
+  uint16_t _peak5m;
+
+  uint16_t windowSum(uint8_t bins) const;
+  FixedSample rate(uint16_t pulses, uint8_t bins) const;
+  void moveTo(uint32_t bin);
+};
@@ -0,0 +1,93 @@
+#include "RainPulseCounterEsp32.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+#include <driver/pcnt.h>
+#include <soc/soc.h>
+
+uint8_t RainPulseCounterEsp32::_unitsInUse = 0;
+
+RainPulseCounterEsp32::RainPulseCounterEsp32()
+    : _unit(-1),
+      _lastRaw(0),
+      _total(0) {}
+
+bool RainPulseCounterEsp32::begin(int8_t pin, uint32_t filterNs) {
+  if (pin < 0) return false;
+  if (active()) return true;
+
+  int8_t unit = -1;
+  for (uint8_t u = 0; u < (uint8_t)PCNT_UNIT_MAX && u < 8; ++u) {
+    if (!(_unitsInUse & (1U << u))) {
+      unit = (int8_t)u;
+      break;
+    }
+  }
+  if (unit < 0) return false;
+
+  const pcnt_unit_t id = (pcnt_unit_t)unit;
+
+  pcnt_config_t config = {};
+  config.pulse_gpio_num = pin;               // pulled up by the driver
+  config.ctrl_gpio_num = PCNT_PIN_NOT_USED;
+  config.lctrl_mode = PCNT_MODE_KEEP;
+  config.hctrl_mode = PCNT_MODE_KEEP;
+  config.pos_mode = PCNT_COUNT_DIS;
+  config.neg_mode = PCNT_COUNT_INC;          // falling edge, like MCU_INTERRUPT
+  config.counter_h_lim = COUNTER_LIMIT;
+  config.counter_l_lim = -COUNTER_LIMIT;
+  config.unit = id;
+  config.channel = PCNT_CHANNEL_0;
+
+  if (pcnt_unit_config(&config) != ESP_OK) return false;
+
+  // Filter length in APB cycles; the register holds 10 bits.
+  uint32_t cycles = (uint32_t)(((uint64_t)filterNs * APB_CLK_FREQ) / 1000000000ULL);
+  if (cycles > 1023) cycles = 1023;
+  if (cycles > 0) {
+    pcnt_set_filter_value(id, (uint16_t)cycles);
+    pcnt_filter_enable(id);
+  } else {
+    pcnt_filter_disable(id);
+  }
+
+  pcnt_counter_pause(id);
+  pcnt_counter_clear(id);
+  pcnt_counter_resume(id);
+
+  _unitsInUse |= (uint8_t)(1U << unit);
+  _unit = unit;
+  _lastRaw = 0;
+  return true;
+}
+
+void RainPulseCounterEsp32::end() {
+  if (!active()) return;
+
+  poll();
+  pcnt_counter_pause((pcnt_unit_t)_unit);
+  _unitsInUse &= (uint8_t)~(1U << _unit);
+  _unit = -1;
+}
+
+uint32_t RainPulseCounterEsp32::poll() {
+  if (!active()) return 0;
+
+  int16_t raw = 0;
+  if (pcnt_get_counter_value((pcnt_unit_t)_unit, &raw) != ESP_OK) return 0;
+
+  // The counter restarts at COUNTER_LIMIT.
+  int32_t delta = (int32_t)raw - (int32_t)_lastRaw;
+  if (delta < 0) delta += COUNTER_LIMIT;
+  _lastRaw = raw;
+
+  _total += (uint32_t)delta;
+  return (uint32_t)delta;
+}
+
+void RainPulseCounterEsp32::clearTotal() {
+  poll();
+  _total = 0;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  RainPulseCounterEsp32
+
+  ESP32 backend for RainGaugeCounter::PCNT_COUNTER: the pulse counter
+  peripheral counts falling edges of the gauge pin in hardware, so a
+  bucket tip costs no interrupt and no CPU wake-up.
+
+  - One PCNT unit per instance, taken from a shared pool on begin() and
+    returned on end(): several rain gauges or anemometers count at once
+    (4 units on the ESP32-S3, 8 on the ESP32), no static "active" object.
+  - The glitch filter drops pulses shorter than filterNs (at most 1023
+    APB cycles, ~12.8 us at 80 MHz). That removes EMI spikes, not reed
+    contact bounce (milliseconds): the gauge input needs the board's RC
+    debouncer, as with the 4040 counter.
+  - The hardware counter is 16-bit and restarts at COUNTER_LIMIT; poll()
+    folds the counts since the last call into a 32-bit total, so it has
+    to run at least once per COUNTER_LIMIT pulses (hours for a rain
+    gauge, ~25 min for an anemometer at 20 Hz).
+
+  The unit holds its count while the CPU idles or waits in delay(). It
+  is a digital peripheral: edges while its clock is stopped (light
+  sleep) are not seen, and deep sleep resets it. Stations that deep
+  sleep between samples use ULP_COUNTER (RainPulseCounterUlp) or the
+  4040 EXTERNAL_COUNTER, which counts through any MCU sleep.
+
+  One instance is used from one task; no ISR involved.
+*/
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+class RainPulseCounterEsp32 {
+public:
+  static const int16_t COUNTER_LIMIT = 32767;
+
+  RainPulseCounterEsp32();
+
+  // Claims a free unit and starts counting falling edges on pin, with
+  // the pin pulled up. False when no unit is free or the driver refuses.
+  bool begin(int8_t pin, uint32_t filterNs);
+
+  // Folds the last counts into the total and returns the unit to the pool.
+  void end();
+
+  bool active() const { return _unit >= 0; }
+
+  // Pulses since the previous poll(), added to total().
+  uint32_t poll();
+
+  uint32_t total() const { return _total; }
+
+  // Zeroes the total; the hardware counter keeps running.
+  void clearTotal();
+
+private:
+  int8_t _unit;       // PCNT unit, -1 when none
+  int16_t _lastRaw;   // hardware count at the last poll()
+  uint32_t _total;
+
+  static uint8_t _unitsInUse;  // bit per unit
+};
+
+#endif
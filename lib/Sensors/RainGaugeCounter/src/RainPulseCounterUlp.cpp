@@ -0,0 +1,134 @@
+#include "RainPulseCounterUlp.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+#include <esp_sleep.h>
+
+#if RAIN_PULSE_COUNTER_ULP_AVAILABLE
+  #if CONFIG_IDF_TARGET_ESP32
+    #include <esp32/ulp.h>
+  #else
+    #include <esp32s3/ulp.h>
+  #endif
+  #include <driver/rtc_io.h>
+  #include <soc/rtc_cntl_reg.h>
+  #include <soc/rtc_io_reg.h>
+#endif
+
+// RTC_SLOW_MEM words (see the header)
+#define ULP_COUNT_WORD   0
+#define ULP_LEVEL_WORD   1
+#define ULP_PROGRAM_WORD 2
+
+// Pin the running program samples, -1 when none was loaded. RTC_DATA_ATTR
+// is reloaded on every boot except a deep-sleep wake.
+RTC_DATA_ATTR static int8_t _rtcUlpPin = -1;
+RTC_DATA_ATTR static uint16_t _rtcUlpLastRaw = 0;
+RTC_DATA_ATTR static uint32_t _rtcUlpTotal = 0;
+
+RainPulseCounterUlp* RainPulseCounterUlp::_owner = nullptr;
+
+RainPulseCounterUlp::RainPulseCounterUlp() : _resumed(false) {}
+
+bool RainPulseCounterUlp::begin(int8_t pin, uint32_t periodUs) {
+#if RAIN_PULSE_COUNTER_ULP_AVAILABLE
+  if (active()) return true;
+  if (_owner || pin < 0) return false;
+
+  const gpio_num_t gpio = (gpio_num_t)pin;
+  if (!rtc_gpio_is_valid_gpio(gpio)) return false;
+
+  // Pull-up and RTC GPIO input have to stay powered in deep sleep.
+  esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_ON);
+
+  _resumed = (_rtcUlpPin == pin &&
+              esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_UNDEFINED);
+  if (_resumed) {
+    _owner = this;
+    return true;
+  }
+
+  rtc_gpio_init(gpio);
+  rtc_gpio_set_direction(gpio, RTC_GPIO_MODE_INPUT_ONLY);
+  rtc_gpio_pulldown_dis(gpio);
+  rtc_gpio_pullup_en(gpio);
+
+  const uint32_t bit = RTC_GPIO_IN_NEXT_S + (uint32_t)rtc_io_number_get(gpio);
+
+  // edge = last & (last - level): 1 on a falling edge, else 0
+  const ulp_insn_t program[] = {
+    I_RD_REG(RTC_GPIO_IN_REG, bit, bit),  // R0 = level
+    I_MOVI(R3, 0),
+    I_LD(R1, R3, ULP_LEVEL_WORD),         // R1 = last level
+    I_ST(R0, R3, ULP_LEVEL_WORD),
+    I_SUBR(R0, R1, R0),
+    I_ANDR(R0, R0, R1),
+    I_LD(R2, R3, ULP_COUNT_WORD),
+    I_ADDR(R2, R2, R0),
+    I_ST(R2, R3, ULP_COUNT_WORD),
+    I_HALT()
+  };
+
+  // Idle level is high (pull-up); a pin held low at start is no pulse.
+  RTC_SLOW_MEM[ULP_COUNT_WORD] = 0;
+  RTC_SLOW_MEM[ULP_LEVEL_WORD] = 1;
+
+  size_t size = sizeof(program) / sizeof(ulp_insn_t);
+  if (ulp_process_macros_and_load(ULP_PROGRAM_WORD, program, &size) != ESP_OK) return false;
+  if (ulp_set_wakeup_period(0, periodUs) != ESP_OK) return false;
+  if (ulp_run(ULP_PROGRAM_WORD) != ESP_OK) return false;
+
+  _rtcUlpPin = pin;
+  _rtcUlpLastRaw = 0;
+  _rtcUlpTotal = 0;
+  _owner = this;
+  return true;
+#else
+  (void)pin;
+  (void)periodUs;
+  return false;
+#endif
+}
+
+void RainPulseCounterUlp::end() {
+  if (!active()) return;
+
+  poll();
+#if RAIN_PULSE_COUNTER_ULP_AVAILABLE
+  #if CONFIG_IDF_TARGET_ESP32
+  CLEAR_PERI_REG_MASK(RTC_CNTL_STATE0_REG, RTC_CNTL_ULP_CP_SLP_TIMER_EN);
+  #else
+  CLEAR_PERI_REG_MASK(RTC_CNTL_ULP_CP_TIMER_REG, RTC_CNTL_ULP_CP_SLP_TIMER_EN);
+  #endif
+#endif
+  _rtcUlpPin = -1;
+  _resumed = false;
+  _owner = nullptr;
+}
+
+uint32_t RainPulseCounterUlp::poll() {
+  if (!active()) return 0;
+
+#if RAIN_PULSE_COUNTER_ULP_AVAILABLE
+  // The ULP writes the low 16 bits (the ESP32 puts its PC in the top).
+  const uint16_t raw = (uint16_t)(RTC_SLOW_MEM[ULP_COUNT_WORD] & 0xFFFF);
+  const uint16_t delta = (uint16_t)(raw - _rtcUlpLastRaw);
+  _rtcUlpLastRaw = raw;
+
+  _rtcUlpTotal += delta;
+  return delta;
+#else
+  return 0;
+#endif
+}
+
+uint32_t RainPulseCounterUlp::total() const {
+  return _rtcUlpTotal;
+}
+
+void RainPulseCounterUlp::clearTotal() {
+  poll();
+  _rtcUlpTotal = 0;
+}
+
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  RainPulseCounterUlp
+
+  ESP32 backend for RainGaugeCounter::ULP_COUNTER: the ULP coprocessor
+  (FSM) samples the gauge pin as an RTC GPIO every periodUs and counts
+  falling edges in RTC slow memory. The ULP and RTC memory keep running
+  in light and deep sleep, so the station can deep sleep between samples
+  without the 4040 counter and read the count back on the timer wake.
+
+  - RTC_SLOW_MEM layout, inside CONFIG_*_ULP_COPROC_RESERVE_MEM:
+      word 0  edge count, 16-bit, wraps; poll() folds it into a
+              32-bit total, so poll at least every 65535 pulses
+      word 1  pin level at the previous sample
+      word 2  program (10 instructions, no branches)
+  - The 32-bit total and the last folded count are RTC_DATA_ATTR: after
+    a deep-sleep wake begin() finds the program still running and
+    resumes (resumed() = true) instead of reloading and clearing it.
+    Any other reset starts from 0.
+  - Sampling is the only filter: a pulse must span one period to be seen,
+    and contact bounce longer than one period counts twice. The gauge
+    input needs the board's RC debouncer, as with the 4040 counter.
+  - The pin must be an RTC GPIO (GPIO0..21 on the ESP32-S3). It is not
+    touched by pinMode() in this mode: that would hand it back to the
+    digital GPIO matrix and blind the ULP.
+  - The RTC peripheral domain stays powered in deep sleep (pull-up and
+    RTC GPIO input), a few uA more than a bare timer wake.
+
+  One ULP per chip: a single instance owns it, like the interrupt owner
+  of MCU_INTERRUPT. Needs the FSM ULP enabled in sdkconfig (Arduino-ESP32
+  builds have it); begin() returns false otherwise.
+*/
+
+#if defined(ARDUINO_ARCH_ESP32)
+
+#if (defined(CONFIG_ULP_COPROC_ENABLED) || defined(CONFIG_ESP32_ULP_COPROC_ENABLED) || \
+     defined(CONFIG_ESP32S3_ULP_COPROC_ENABLED)) &&                                       \
+    !defined(CONFIG_ULP_COPROC_TYPE_RISCV) && !defined(CONFIG_ESP32S3_ULP_COPROC_RISCV)
+  #define RAIN_PULSE_COUNTER_ULP_AVAILABLE 1
+#else
+  #define RAIN_PULSE_COUNTER_ULP_AVAILABLE 0
+#endif
+
+class RainPulseCounterUlp {
+public:
+  RainPulseCounterUlp();
+
+  // Loads the program and starts sampling pin every periodUs, or resumes
+  // the one left running by the previous boot. False when the pin is not
+  // an RTC GPIO, another instance owns the ULP or the ULP is unavailable.
+  bool begin(int8_t pin, uint32_t periodUs);
+
+  // Folds the last counts into the total and stops the ULP timer.
+  void end();
+
+  bool active() const { return _owner == this; }
+
+  // True when begin() took over a program counting since before the last
+  // deep sleep: the next poll() returns the pulses counted while asleep.
+  bool resumed() const { return _resumed; }
+
+  // Pulses since the previous poll(), added to total().
+  uint32_t poll();
+
+  uint32_t total() const;
+
+  // Zeroes the total; the ULP keeps counting.
+  void clearTotal();
+
+private:
+  bool _resumed;
+
+  static RainPulseCounterUlp* _owner;
+};
+
+#endif
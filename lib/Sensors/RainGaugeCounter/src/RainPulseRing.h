@@ -0,0 +1,89 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  RainPulseRing
+
+  Tipping-bucket pulse timestamps (micros()) from the counting ISR to the
+  main loop: one producer, one consumer, no interrupt masking.
+
+  The ISR writes only _head, _overflows and the slot it is filling; the
+  loop writes only _tail. Indices are free-running bytes, which every
+  target loads and stores in one access, and the release/acquire pair
+  makes the slot visible before the index that publishes it (the
+  ESP32-S3 has two cores; on AVR it costs nothing).
+
+  A full ring drops the timestamp and counts it in a wrapping byte the
+  consumer diffs (takeOverflows()). The pulse itself is not lost: the
+  rainfall total comes from the pulse counter, only the intensity
+  windows miss it.
+
+  Capacity RAIN_PULSE_RING_SIZE, a power of two up to 128. The loop
+  drains it every few ms, so 32 (AVR) already covers minutes of
+  cloudburst.
+*/
+
+#if !defined(RAIN_PULSE_RING_SIZE)
+  #if defined(ARDUINO_ARCH_AVR)
+    #define RAIN_PULSE_RING_SIZE 32
+  #else
+    #define RAIN_PULSE_RING_SIZE 128
+  #endif
+#endif
+
+static_assert(RAIN_PULSE_RING_SIZE >= 2 && RAIN_PULSE_RING_SIZE <= 128 &&
+                  (RAIN_PULSE_RING_SIZE & (RAIN_PULSE_RING_SIZE - 1)) == 0,
+              "RAIN_PULSE_RING_SIZE must be a power of two, 2..128");
+
+class RainPulseRing {
+public:
+  RainPulseRing() : _head(0), _tail(0), _overflows(0), _overflowsSeen(0) {}
+
+  // Producer (ISR). False when the ring is full: timestamp dropped and
+  // counted.
+  bool push(uint32_t timestampUs) {
+    const uint8_t head = _head;
+    const uint8_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+    if ((uint8_t)(head - tail) >= RAIN_PULSE_RING_SIZE) {
+      __atomic_store_n(&_overflows, (uint8_t)(_overflows + 1), __ATOMIC_RELAXED);
+      return false;
+    }
+    _slots[head & MASK] = timestampUs;
+    __atomic_store_n(&_head, (uint8_t)(head + 1), __ATOMIC_RELEASE);
+    return true;
+  }
+
+  // Consumer (loop). False when empty.
+  bool pop(uint32_t& timestampUs) {
+    const uint8_t tail = _tail;
+    const uint8_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    if (head == tail) return false;
+    timestampUs = _slots[tail & MASK];
+    __atomic_store_n(&_tail, (uint8_t)(tail + 1), __ATOMIC_RELEASE);
+    return true;
+  }
+
+  // Consumer. Timestamps dropped since the previous call; call at least
+  // every 255 drops (every drain does).
+  uint8_t takeOverflows() {
+    const uint8_t seen = __atomic_load_n(&_overflows, __ATOMIC_RELAXED);
+    const uint8_t dropped = (uint8_t)(seen - _overflowsSeen);
+    _overflowsSeen = seen;
+    return dropped;
+  }
+
+  uint8_t size() const {
+    return (uint8_t)(__atomic_load_n(&_head, __ATOMIC_ACQUIRE) - _tail);
+  }
+
+  static uint8_t capacity() { return RAIN_PULSE_RING_SIZE; }
+
+private:
+  static const uint8_t MASK = RAIN_PULSE_RING_SIZE - 1;
+
+  uint32_t _slots[RAIN_PULSE_RING_SIZE];
+  volatile uint8_t _head;       // producer
+  volatile uint8_t _tail;       // consumer
+  volatile uint8_t _overflows;  // producer, wraps
+  uint8_t _overflowsSeen;       // consumer
+};
@@ -15,6 +15,27 @@
   Response:
     [addr][0x03][0x04][hum_hi][hum_lo][tmp_hi][tmp_lo][crc_lo][crc_hi]
 */
+enum RikaLeafField : uint8_t {
+  RIKA_LEAF_HUMIDITY = 0,
+  RIKA_LEAF_TEMPERATURE
+};
+
+static constexpr ModbusRegisterMap<2> RIKA_LEAF_MAP = {
+  0x0000, 2, {
+    {0x0000, MODBUS_FIELD_U16, 10.0, 0.0,   0.0, 100.0, SAMPLE_UNIT_PERCENT_RH},  // humidity
+    {0x0001, MODBUS_FIELD_S16, 10.0, 0.0, -40.0,  80.0, SAMPLE_UNIT_CELSIUS}      // temperature
+  }
+};
+static_assert(RIKA_LEAF_MAP.isValid(), "RIKA_LEAF_MAP field outside block");
+static_assert(RIKA_LEAF_MAP.byteCount() == 0x04, "RIKA_LEAF_MAP does not match the read frame");
+
+// Leaf wetness swings with dew and rain, so humidity gets no ROC limit.
+// Leaf temperature cannot move 10 C in a minute.
+static constexpr SampleFilterRule RIKA_LEAF_RULES[2] = {
+  SampleFilterRule::none(),                                                            // humidity
+  SampleFilterRule::make(RIKA_LEAF_MAP.fields[RIKA_LEAF_TEMPERATURE], -20.0, 60.0, 10.0)  // temperature
+};
+
 RikaLeafSensor::RikaLeafSensor(RS485Bus& bus,
                                const char* sensorId,
                                uint8_t address,
@@ -34,66 +55,70 @@ RikaLeafSensor::RikaLeafSensor(RS485Bus& bus,
                    warmUpTimeMs,
                    maxConsecutiveErrors,
                    minUsefulPowerOffMs),
+      leaf_temp(RIKA_LEAF_MAP.fields[RIKA_LEAF_TEMPERATURE].sample(0)),
+      leaf_humid(RIKA_LEAF_MAP.fields[RIKA_LEAF_HUMIDITY].sample(0)),
       _bus(bus),
-      leaf_temp(0.0),
-      leaf_humid(0.0) {}
+      _readRequest(RIKA_LEAF_MAP.request(address)),
+      _filter() {}
+
+void RikaLeafSensor::setAddress(uint8_t address) {
+  SensorDriver::setAddress(address);
+  _readRequest = RIKA_LEAF_MAP.request(address);
+}
 
 void RikaLeafSensor::setFallbackValues() {
   // Explicit sentinel values used by application logic to detect stale/invalid reads.
-  leaf_temp = -99.0;
-  leaf_humid = -99.0;
+  leaf_temp = RIKA_LEAF_MAP.fields[RIKA_LEAF_TEMPERATURE].fallback();
+  leaf_humid = RIKA_LEAF_MAP.fields[RIKA_LEAF_HUMIDITY].fallback();
 }
 
 bool RikaLeafSensor::readData() {
   // SensorDriver timestamp is updated at the start of each logical read cycle.
   markReadTime(millis());
 
-  // Driver-level retries sit above RS485Bus retries.
-  // Each attempt re-sends the same request and re-validates the decoded values.
+  // Driver-level retries sit above RS485Bus retries and only cover
+  // transport failures; a decoded frame is never re-requested.
   const uint8_t DRIVER_RETRIES = SENSOR_DEFAULT_DRIVER_RETRIES;
 
-  for (uint8_t driverAttempt = 1; driverAttempt <= DRIVER_RETRIES; ++driverAttempt) {
-    // Read 2 holding registers starting at 0x0000:
-    //   register 0 -> humidity * 10
-    //   register 1 -> signed temperature * 10
-    uint8_t request[READ_REQUEST_SIZE] = {
-        _address, 0x03, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00
-    };
-
-    uint8_t response[READ_RESPONSE_SIZE] = {0};
-    // Prefix check performed by RS485Bus before CRC validation.
-    const uint8_t check[READ_CHECK_SIZE] = {_address, 0x03, 0x04};
+  // Read 2 holding registers starting at 0x0000:
+  //   register 0 -> humidity * 10
+  //   register 1 -> signed temperature * 10
+  // The request is prebuilt (_readRequest), so retries cost no CRC work.
+  // Prefix check performed by RS485Bus before CRC validation.
+  const uint8_t check[READ_CHECK_SIZE] = {_address, 0x03, 0x04};
+  ModbusFrameView frame;
 
-    const bool ok = _bus.SendRequest(request,
-                                     READ_REQUEST_SIZE,
-                                     response,
-                                     READ_RESPONSE_SIZE,
-                                     check,
-                                     READ_CHECK_SIZE,
-                                     SENSOR_DEFAULT_BUS_RETRIES,
-                                     SENSOR_DEFAULT_READ_TIMEOUT_MS,
-                                     _debugEnable,
-                                     SENSOR_DEFAULT_AFTER_REQ_MS);
+  for (uint8_t driverAttempt = 1; driverAttempt <= DRIVER_RETRIES; ++driverAttempt) {
+    const bool ok = _bus.transact(_readRequest,
+                                  READ_RESPONSE_SIZE,
+                                  check,
+                                  READ_CHECK_SIZE,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  SENSOR_DEFAULT_READ_TIMEOUT_MS,
+                                  _debugEnable,
+                                  SENSOR_DEFAULT_AFTER_REQ_MS);
 
     if (!ok) {
+      if (_bus.lastWasException()) break;
       continue;
     }
 
-    // Big-endian register extraction from Modbus payload.
-    const uint16_t rawHum = ((uint16_t)response[3] << 8) | response[4];
-    const int16_t rawTemp = (int16_t)(((uint16_t)response[5] << 8) | response[6]);
-
-    // Sensor-provided fixed-point conversion.
-    leaf_humid = (double)rawHum / 10.0;
-    leaf_temp  = (double)rawTemp / 10.0;
-
-    // Defensive data sanity gates. If they fail, we retry the full transaction.
-    if (leaf_temp < -40.0 || leaf_temp > 80.0) {
-      continue;
-    }
-
-    if (leaf_humid < 0.0 || leaf_humid > 100.0) {
-      continue;
+    // Big-endian extraction, scaling and range protection come from
+    // RIKA_LEAF_MAP / RIKA_LEAF_RULES, decoded straight from the bus buffer.
+    // A rejected field keeps its last good value. Asking again would only
+    // return the same CRC-valid frame, so the cycle ends here either way.
+    FixedSample values[2];
+    uint8_t quality = SAMPLE_QUALITY_OK;
+    const uint32_t okMask = SampleFilter::apply(RIKA_LEAF_MAP, RIKA_LEAF_RULES, frame,
+                                                _filter, values, millis(), &quality);
+    leaf_humid = values[RIKA_LEAF_HUMIDITY];
+    leaf_temp  = values[RIKA_LEAF_TEMPERATURE];
+    setSampleQuality(quality);
+
+    if (okMask != RIKA_LEAF_MAP.allFieldsMask()) {
+      markFailure();
+      return false;
     }
 
     markSuccess();
@@ -138,7 +163,7 @@ bool RikaLeafSensor::changeAddress(uint8_t newAddress,
                                    afterReqDelayMs);
 
   if (ok) {
-    _address = newAddress;
+    setAddress(newAddress);
   }
 
   return ok;
@@ -153,27 +178,27 @@ uint8_t RikaLeafSensor::scanForAddress(uint8_t startAddr,
   if (endAddr > 247) endAddr = 247;
   if (startAddr > endAddr) return 0;
 
+  ModbusFrameView frame;
   for (uint16_t addr = startAddr; addr <= endAddr; ++addr) {
     // Probe candidate address using normal measurement read command.
     uint8_t request[READ_REQUEST_SIZE] = {
         (uint8_t)addr, 0x03, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00
     };
-    uint8_t response[READ_RESPONSE_SIZE] = {0};
     const uint8_t check[READ_CHECK_SIZE] = {(uint8_t)addr, 0x03, 0x04};
 
-    const bool found = _bus.SendRequest(request,
-                                        READ_REQUEST_SIZE,
-                                        response,
-                                        READ_RESPONSE_SIZE,
-                                        check,
-                                        READ_CHECK_SIZE,
-                                        1,
-                                        readTimeoutMs,
-                                        _debugEnable,
-                                        afterReqDelayMs);
+    const bool found = _bus.transact(request,
+                                     READ_REQUEST_SIZE,
+                                     READ_RESPONSE_SIZE,
+                                     check,
+                                     READ_CHECK_SIZE,
+                                     frame,
+                                     1,
+                                     readTimeoutMs,
+                                     _debugEnable,
+                                     afterReqDelayMs);
     if (found) {
       // Keep discovered address in sync with runtime driver state.
-      _address = (uint8_t)addr;
+      setAddress((uint8_t)addr);
       return (uint8_t)addr;
     }
 
@@ -8,7 +8,8 @@
 
   Driver intent:
   - Reads a Rika/JXCT-style leaf surface sensor over RS485 Modbus RTU.
-  - Exposes the latest decoded values through public fields:
+  - Exposes the latest decoded values through public FixedSample fields
+    (0.1 resolution, no float math on the read path):
       leaf_temp  -> degrees Celsius
       leaf_humid -> %RH (relative humidity)
 
@@ -30,14 +31,17 @@
 
   Reliability model:
   - Uses SensorDriver state tracking (markSuccess/markFailure).
-  - On a failed read cycle, setFallbackValues() writes sentinel -99.0.
+  - Decoded values pass a SampleFilter (hard bounds, fault words,
+    temperature rate of change). A rejected value keeps the last good
+    one and fails the cycle without re-polling; getSampleQuality() says why.
+  - When no frame arrives at all, setFallbackValues() writes sentinel -99.
 */
 class RikaLeafSensor : public SensorDriver {
 public:
   // Last decoded measurement values from the sensor.
-  // Sentinel value on failure: -99.0.
-  double leaf_temp;
-  double leaf_humid;
+  // Sentinel value on failure: -99 (FixedSample::isFallback()).
+  FixedSample leaf_temp;
+  FixedSample leaf_humid;
 
   // Construct a driver bound to one RS485 bus and one sensor address.
   RikaLeafSensor(RS485Bus& bus,
@@ -52,12 +56,28 @@ public:
                  uint32_t minUsefulPowerOffMs = 60000UL);
 
   // Performs one logical sampling attempt (with internal driver retries).
-  // Returns true only when frame, CRC, and range validation pass.
+  // Returns true only when frame, CRC, and range protection pass.
   bool readData() override;
 
   // Writes explicit fallback sentinels when a full read cycle fails.
   void setFallbackValues() override;
 
+  // leaf_temp, leaf_humid, for burst statistics.
+  uint8_t valueCount() const override { return 2; }
+  FixedSample* valueAt(uint8_t index) override {
+    switch (index) {
+      case 0: return &leaf_temp;
+      case 1: return &leaf_humid;
+      default: return nullptr;
+    }
+  }
+
+  // _filter[], kept through deep sleep (SleepPlanner::retain()).
+  void* filterStates(size_t& bytes) override {
+    bytes = sizeof(_filter);
+    return _filter;
+  }
+
   // Writes a new Modbus node address to sensor register 0x0200.
   // Hardware condition: connect white wire to V+ before calling.
   // For normal readData()/scanForAddress(), connect white wire to V- / GND.
@@ -67,6 +87,9 @@ public:
                      uint16_t readTimeoutMs = 500,
                      uint16_t afterReqDelayMs = 20);
 
+  // Keeps the cached read request in step with the address.
+  void setAddress(uint8_t address) override;
+
   // Probes [startAddr, endAddr] and returns the first responsive address.
   // Returns 0 when no valid response is found.
   uint8_t scanForAddress(uint8_t startAddr = 1,
@@ -77,6 +100,12 @@ public:
 private:
   RS485Bus& _bus;
 
+  // readData() request for _address, CRC included; rebuilt by setAddress().
+  ModbusRequestFrame _readRequest;
+
+  // Range-protection history per field (humidity, temperature).
+  SampleFilter::State _filter[2];
+
   // Request and response frame sizes used by readData()/scanForAddress().
   static const uint8_t READ_REQUEST_SIZE = 8;
   static const uint8_t READ_RESPONSE_SIZE = 9;
@@ -24,36 +24,40 @@ RikaRainGauge::RikaRainGauge(RS485Bus& bus,
                        warmUpTimeMs,
                        maxConsecutiveErrors,
                        minUsefulPowerOffMs,
-                       MM_PER_PULSE,
+                       MM_PER_PULSE_SCALED,
                        countingMode,
                        pcf8574Address,
                        counterResetPin,
                        interruptPin,
-                       interruptDebounceMs) {
+                       interruptDebounceMs),
+      _rainfallRequest(ModbusRequestFrame::read(address, 0x0000, 1)) {
   _bus = &bus;
 }
 
-bool RikaRainGauge::readRs485Rainfall(double& rainfallMm) {
+void RikaRainGauge::setAddress(uint8_t address) {
+  RainGaugeCounter::setAddress(address);
+  _rainfallRequest = ModbusRequestFrame::read(address, 0x0000, 1);
+}
+
+bool RikaRainGauge::readRs485Rainfall(FixedSample& rainfallMm) {
   if (!_bus) return false;
 
-  uint8_t request[8] = {_address, 0x03, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00};
-  uint8_t response[7] = {0};
   const uint8_t check[3] = {_address, 0x03, 0x02};
+  ModbusFrameView frame;
 
-  const bool ok = _bus->SendRequest(request,
-                                    8,
-                                    response,
-                                    7,
-                                    check,
-                                    3,
-                                    SENSOR_DEFAULT_BUS_RETRIES,
-                                    SENSOR_DEFAULT_READ_TIMEOUT_MS,
-                                    _debugEnable,
-                                    SENSOR_DEFAULT_AFTER_REQ_MS);
+  const bool ok = _bus->transact(_rainfallRequest,
+                                 _rainfallRequest.readResponseSize(),
+                                 check,
+                                 3,
+                                 frame,
+                                 SENSOR_DEFAULT_BUS_RETRIES,
+                                 SENSOR_DEFAULT_READ_TIMEOUT_MS,
+                                 _debugEnable,
+                                 SENSOR_DEFAULT_AFTER_REQ_MS);
   if (!ok) return false;
 
-  const uint16_t raw = ((uint16_t)response[3] << 8) | response[4];
-  rainfallMm = (double)raw / 10.0;
+  const uint16_t raw = frame.u16(0);
+  rainfallMm = FixedSample::make(raw, 1, SAMPLE_UNIT_MM);  // 0.1 mm
   return true;
 }
 
@@ -97,7 +101,7 @@ bool RikaRainGauge::changeAddress(uint8_t newAddress,
                                     _debugEnable,
                                     afterReqDelayMs);
   if (ok) {
-    _address = newAddress;
+    setAddress(newAddress);
   }
   return ok;
 }
@@ -3,7 +3,7 @@
 
 class RikaRainGauge : public RainGaugeCounter {
 public:
-  static constexpr double MM_PER_PULSE = 0.2;
+  static const uint32_t MM_PER_PULSE_SCALED = 2000;  // 0.2 mm
 
   RikaRainGauge(RS485Bus& bus,
                 const char* sensorId,
@@ -26,8 +26,13 @@ public:
                      uint16_t readTimeoutMs = 500,
                      uint16_t afterReqDelayMs = SENSOR_DEFAULT_AFTER_REQ_MS);
 
+  void setAddress(uint8_t address) override;
+
 protected:
   bool supportsRs485SensorMode() const override { return true; }
-  bool readRs485Rainfall(double& rainfallMm) override;
+  bool readRs485Rainfall(FixedSample& rainfallMm) override;
   bool resetRs485Rainfall() override;
+
+private:
+  ModbusRequestFrame _rainfallRequest;  // register 0x0000 for _address, CRC included
 };
@@ -1,5 +1,40 @@
 #include "RikaSoilSensor3in1.h"
 
+enum RikaSoil3Field : uint8_t {
+  RIKA_SOIL3_TEMPERATURE = 0,
+  RIKA_SOIL3_VWC,
+  RIKA_SOIL3_EC
+};
+
+static constexpr ModbusRegisterMap<3> RIKA_SOIL3_MAP = {
+  0x0000, 3, {
+    {0x0000, MODBUS_FIELD_S16,   10.0, 0.0, -40.0,  80.0, SAMPLE_UNIT_CELSIUS},    // temperature
+    {0x0001, MODBUS_FIELD_U16,   10.0, 0.0,   0.0, 100.0, SAMPLE_UNIT_PERCENT},    // VWC
+    {0x0002, MODBUS_FIELD_U16, 1000.0, 0.0,   0.0,  50.0, SAMPLE_UNIT_MS_PER_CM}   // EC (= dS/m)
+  }
+};
+static_assert(RIKA_SOIL3_MAP.isValid(), "RIKA_SOIL3_MAP field outside block");
+static_assert(RIKA_SOIL3_MAP.byteCount() == 0x06, "RIKA_SOIL3_MAP does not match the main read frame");
+
+// Soil temperature lags the air by hours; 5 C in a minute is a bad read.
+// VWC and EC jump legitimately when irrigation reaches the probe.
+static constexpr SampleFilterRule RIKA_SOIL3_RULES[3] = {
+  SampleFilterRule::make(RIKA_SOIL3_MAP.fields[RIKA_SOIL3_TEMPERATURE], -20.0, 60.0, 5.0),  // temperature
+  SampleFilterRule::none(),                                                              // VWC
+  SampleFilterRule::none()                                                               // EC
+};
+
+// Epsilon and compensation coefficients are register value / 100.
+static const uint8_t RIKA_SOIL3_HUNDREDTHS = 2;
+
+static const __FlashStringHelper* rikaSoil3FieldName(uint8_t field) {
+  switch (field) {
+    case RIKA_SOIL3_TEMPERATURE: return F("temperature");
+    case RIKA_SOIL3_VWC:         return F("VWC");
+    default:                     return F("EC");
+  }
+}
+
 static void logParsedRikaSoil3in1(PrintController* log,
                                   bool debug,
                                   uint8_t tempHi,
@@ -11,9 +46,9 @@ static void logParsedRikaSoil3in1(PrintController* log,
                                   int16_t rawTemp,
                                   uint16_t rawVwc,
                                   uint16_t rawEc,
-                                  double temp,
-                                  double vwc,
-                                  double ec) {
+                                  const FixedSample& temp,
+                                  const FixedSample& vwc,
+                                  const FixedSample& ec) {
   if (!log || !debug) return;
 
   log->println(F("[DRV][RikaSoil3in1] Parsed response:"), true);
@@ -24,7 +59,7 @@ static void logParsedRikaSoil3in1(PrintController* log,
   log->print(F("| combined = "), true);
   log->print((int)rawTemp, true, "", DEC);
   log->print(F(" | temperature = "), true);
-  log->print(temp, true, " C", 1);
+  log->printFixed(temp.raw, temp.decimals, true, " C");
   log->println("", true);
 
   log->print(F("  bytes [5],[6] -> VWC raw = 0x"), true);
@@ -33,7 +68,7 @@ static void logParsedRikaSoil3in1(PrintController* log,
   log->print(F("| combined = "), true);
   log->print((unsigned int)rawVwc, true, "", DEC);
   log->print(F(" | VWC = "), true);
-  log->print(vwc, true, " %", 1);
+  log->printFixed(vwc.raw, vwc.decimals, true, " %");
   log->println("", true);
 
   log->print(F("  bytes [7],[8] -> EC raw = 0x"), true);
@@ -42,7 +77,7 @@ static void logParsedRikaSoil3in1(PrintController* log,
   log->print(F("| combined = "), true);
   log->print((unsigned int)rawEc, true, "", DEC);
   log->print(F(" | EC = "), true);
-  log->print(ec, true, " mS/cm", 4);
+  log->printFixed(ec.raw, ec.decimals, true, " mS/cm");
   log->println("", true);
 }
 
@@ -65,18 +100,25 @@ RikaSoilSensor3in1::RikaSoilSensor3in1(RS485Bus& bus,
                    warmUpTimeMs,
                    maxConsecutiveErrors,
                    minUsefulPowerOffMs),
+      soil_temp(RIKA_SOIL3_MAP.fields[RIKA_SOIL3_TEMPERATURE].sample(0)),
+      soil_vwc(RIKA_SOIL3_MAP.fields[RIKA_SOIL3_VWC].sample(0)),
+      soil_ec(RIKA_SOIL3_MAP.fields[RIKA_SOIL3_EC].sample(0)),
+      epsilon(FixedSample::make(0, RIKA_SOIL3_HUNDREDTHS)),
+      currentSoilType(SOIL_UNKNOWN),
       _bus(bus),
-      soil_temp(0.0),
-      soil_vwc(0.0),
-      soil_ec(0.0),
-      epsilon(0.0),
-      currentSoilType(SOIL_UNKNOWN) {}
+      _readRequest(RIKA_SOIL3_MAP.request(address)),
+      _filter() {}
+
+void RikaSoilSensor3in1::setAddress(uint8_t address) {
+  SensorDriver::setAddress(address);
+  _readRequest = RIKA_SOIL3_MAP.request(address);
+}
 
 void RikaSoilSensor3in1::setFallbackValues() {
-  soil_temp = -99.0;
-  soil_vwc  = -99.0;
-  soil_ec   = -99.0;
-  epsilon   = -99.0;
+  soil_temp = RIKA_SOIL3_MAP.fields[RIKA_SOIL3_TEMPERATURE].fallback();
+  soil_vwc  = RIKA_SOIL3_MAP.fields[RIKA_SOIL3_VWC].fallback();
+  soil_ec   = RIKA_SOIL3_MAP.fields[RIKA_SOIL3_EC].fallback();
+  epsilon   = FixedSample::fallback(RIKA_SOIL3_HUNDREDTHS);
   currentSoilType = SOIL_UNKNOWN;
 }
 
@@ -86,80 +128,65 @@ bool RikaSoilSensor3in1::readData() {
   const uint8_t DRIVER_RETRIES = SENSOR_DEFAULT_DRIVER_RETRIES;
   bool gotAnyValidFrame = false;
 
-  for (uint8_t driverAttempt = 1; driverAttempt <= DRIVER_RETRIES; ++driverAttempt) {
-    uint8_t request[MAIN_REQUEST_SIZE] = {
-      _address, 0x03, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00
-    };
-
-    uint8_t response[MAIN_RESPONSE_SIZE] = {0};
-    const uint8_t check[MAIN_CHECK_SIZE] = {_address, 0x03, 0x06};
+  const uint8_t check[MAIN_CHECK_SIZE] = {_address, 0x03, 0x06};
+  ModbusFrameView frame;
 
-    const bool ok = _bus.SendRequest(request,
-                                     MAIN_REQUEST_SIZE,
-                                     response,
-                                     MAIN_RESPONSE_SIZE,
-                                     check,
-                                     MAIN_CHECK_SIZE,
-                                     SENSOR_DEFAULT_BUS_RETRIES,
-                                     SENSOR_DEFAULT_READ_TIMEOUT_MS,
-                                     _debugEnable,
-                                     SENSOR_DEFAULT_AFTER_REQ_MS);
+  for (uint8_t driverAttempt = 1; driverAttempt <= DRIVER_RETRIES; ++driverAttempt) {
+    const bool ok = _bus.transact(_readRequest,
+                                  MAIN_RESPONSE_SIZE,
+                                  check,
+                                  MAIN_CHECK_SIZE,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  SENSOR_DEFAULT_READ_TIMEOUT_MS,
+                                  _debugEnable,
+                                  SENSOR_DEFAULT_AFTER_REQ_MS);
 
     if (!ok) {
+      if (_bus.lastWasException()) break;
       continue;
     }
 
     gotAnyValidFrame = true;
 
-    const uint8_t tempHi = response[3];
-    const uint8_t tempLo = response[4];
-    const uint8_t vwcHi = response[5];
-    const uint8_t vwcLo = response[6];
-    const uint8_t ecHi = response[7];
-    const uint8_t ecLo = response[8];
-
-    const int16_t rawTemp = (int16_t)(((uint16_t)tempHi << 8) | tempLo);
-    const uint16_t rawVwc = ((uint16_t)vwcHi << 8) | vwcLo;
-    const uint16_t rawEc  = ((uint16_t)ecHi << 8) | ecLo;
-
-    soil_temp = (double)rawTemp / 10.0;
-    soil_vwc  = (double)rawVwc / 10.0;
-    soil_ec   = (double)rawEc / 1000.0;
+    // Rejected fields keep their last good value; the frame is not
+    // requested again, a retry would only repeat it.
+    FixedSample values[3];
+    uint8_t quality = SAMPLE_QUALITY_OK;
+    const uint32_t okMask = SampleFilter::apply(RIKA_SOIL3_MAP, RIKA_SOIL3_RULES, frame,
+                                                _filter, values, millis(), &quality);
+    soil_temp = values[RIKA_SOIL3_TEMPERATURE];
+    soil_vwc  = values[RIKA_SOIL3_VWC];
+    soil_ec   = values[RIKA_SOIL3_EC];
+    setSampleQuality(quality);
 
     logParsedRikaSoil3in1(_bus.getLogger(),
                           _debugEnable,
-                          tempHi,
-                          tempLo,
-                          vwcHi,
-                          vwcLo,
-                          ecHi,
-                          ecLo,
-                          rawTemp,
-                          rawVwc,
-                          rawEc,
+                          frame.byteAt(3),
+                          frame.byteAt(4),
+                          frame.byteAt(5),
+                          frame.byteAt(6),
+                          frame.byteAt(7),
+                          frame.byteAt(8),
+                          frame.s16(0),
+                          frame.u16(1),
+                          frame.u16(2),
                           soil_temp,
                           soil_vwc,
                           soil_ec);
 
-    if (soil_temp < -40.0 || soil_temp > 80.0) {
+    if (okMask != RIKA_SOIL3_MAP.allFieldsMask()) {
       if (_bus.getLogger() && _debugEnable) {
-        _bus.getLogger()->println(F("[DRV][RikaSoil3in1] Range check fail: temperature is outside allowed range"), true);
+        for (uint8_t i = 0; i < 3; ++i) {
+          if (okMask & (1UL << i)) continue;
+          _bus.getLogger()->print(F("[DRV][RikaSoil3in1] Range check fail: "), true);
+          _bus.getLogger()->print(rikaSoil3FieldName(i), true);
+          _bus.getLogger()->print(F(", quality 0x"), true);
+          _bus.getLogger()->print((unsigned int)_filter[i].quality, true, "", HEX);
+          _bus.getLogger()->println("", true);
+        }
       }
-      continue;
-    }
-
-    if (soil_vwc < 0.0 || soil_vwc > 100.0) {
-      if (_bus.getLogger() && _debugEnable) {
-        _bus.getLogger()->println(F("[DRV][RikaSoil3in1] Range check fail: VWC is outside allowed range"), true);
-      }
-      continue;
-    }
-
-    if (soil_ec < 0.0 || soil_ec > 50.0) {
-      if (_bus.getLogger() && _debugEnable) {
-        _bus.getLogger()->println(F("[DRV][RikaSoil3in1] Range check fail: EC is outside allowed range"), true);
-      }
-      continue;
+      break;
     }
 
     markSuccess();
@@ -201,7 +228,7 @@ bool RikaSoilSensor3in1::changeAddress(uint8_t newAddress,
                                    afterReqDelayMs);
 
   if (ok) {
-    _address = newAddress;
+    setAddress(newAddress);
   }
 
   return ok;
@@ -215,26 +242,25 @@ uint8_t RikaSoilSensor3in1::scanForAddress(uint8_t startAddr,
   if (endAddr > 247) endAddr = 247;
   if (startAddr > endAddr) return 0;
 
+  ModbusFrameView frame;
   for (uint16_t addr = startAddr; addr <= endAddr; ++addr) {
     uint8_t request[MAIN_REQUEST_SIZE] = {
       (uint8_t)addr, 0x03, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00
     };
-
-    uint8_t response[MAIN_RESPONSE_SIZE] = {0};
     const uint8_t check[MAIN_CHECK_SIZE] = {(uint8_t)addr, 0x03, 0x06};
 
-    const bool found = _bus.SendRequest(request,
-                                        MAIN_REQUEST_SIZE,
-                                        response,
-                                        MAIN_RESPONSE_SIZE,
-                                        check,
-                                        MAIN_CHECK_SIZE,
-                                        1,
-                                        readTimeoutMs,
-                                        _debugEnable,
-                                        afterReqDelayMs);
+    const bool found = _bus.transact(request,
+                                     MAIN_REQUEST_SIZE,
+                                     MAIN_RESPONSE_SIZE,
+                                     check,
+                                     MAIN_CHECK_SIZE,
+                                     frame,
+                                     1,
+                                     readTimeoutMs,
+                                     _debugEnable,
+                                     afterReqDelayMs);
     if (found) {
-      _address = (uint8_t)addr;
+      setAddress((uint8_t)addr);
       return (uint8_t)addr;
     }
 
@@ -250,26 +276,27 @@ bool RikaSoilSensor3in1::readSoilType(SoilType &type,
                                       uint16_t afterReqDelayMs) {
   if (driverRetries == 0) driverRetries = 1;
 
-  for (uint8_t driverAttempt = 1; driverAttempt <= driverRetries; ++driverAttempt) {
-    uint8_t request[8] = {_address, 0x03, 0x00, 0x20, 0x00, 0x01, 0x00, 0x00};
-    uint8_t response[7] = {0};
-    const uint8_t check[3] = {_address, 0x03, 0x02};
+  uint8_t request[8] = {_address, 0x03, 0x00, 0x20, 0x00, 0x01, 0x00, 0x00};
+  const uint8_t check[3] = {_address, 0x03, 0x02};
+  ModbusFrameView frame;
 
-    const bool ok = _bus.SendRequest(request,
-                                     8,
-                                     response,
-                                     7,
-                                     check,
-                                     3,
-                                     SENSOR_DEFAULT_BUS_RETRIES,
-                                     readTimeoutMs,
-                                     _debugEnable,
-                                     afterReqDelayMs);
+  for (uint8_t driverAttempt = 1; driverAttempt <= driverRetries; ++driverAttempt) {
+    const bool ok = _bus.transact(request,
+                                  8,
+                                  7,
+                                  check,
+                                  3,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  readTimeoutMs,
+                                  _debugEnable,
+                                  afterReqDelayMs);
     if (!ok) {
+      if (_bus.lastWasException()) break;
       continue;
     }
 
-    const uint16_t rawType = ((uint16_t)response[3] << 8) | response[4];
+    const uint16_t rawType = frame.u16(0);
 
     switch (rawType) {
       case 0: type = SOIL_MINERAL; break;
@@ -318,39 +345,40 @@ bool RikaSoilSensor3in1::setSoilType(SoilType type,
   return false;
 }
 
-bool RikaSoilSensor3in1::readEpsilon(double &value,
+bool RikaSoilSensor3in1::readEpsilon(FixedSample &value,
                                      uint8_t driverRetries,
                                      uint16_t readTimeoutMs,
                                      uint16_t afterReqDelayMs) {
   if (driverRetries == 0) driverRetries = 1;
 
-  for (uint8_t driverAttempt = 1; driverAttempt <= driverRetries; ++driverAttempt) {
-    uint8_t request[8] = {_address, 0x04, 0x00, 0x05, 0x00, 0x01, 0x00, 0x00};
-    uint8_t response[7] = {0};
-    const uint8_t check[3] = {_address, 0x04, 0x02};
+  uint8_t request[8] = {_address, 0x04, 0x00, 0x05, 0x00, 0x01, 0x00, 0x00};
+  const uint8_t check[3] = {_address, 0x04, 0x02};
+  ModbusFrameView frame;
 
-    const bool ok = _bus.SendRequest(request,
-                                     8,
-                                     response,
-                                     7,
-                                     check,
-                                     3,
-                                     SENSOR_DEFAULT_BUS_RETRIES,
-                                     readTimeoutMs,
-                                     _debugEnable,
-                                     afterReqDelayMs);
+  for (uint8_t driverAttempt = 1; driverAttempt <= driverRetries; ++driverAttempt) {
+    const bool ok = _bus.transact(request,
+                                  8,
+                                  7,
+                                  check,
+                                  3,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  readTimeoutMs,
+                                  _debugEnable,
+                                  afterReqDelayMs);
     if (!ok) {
+      if (_bus.lastWasException()) break;
       continue;
     }
 
-    const uint16_t raw = ((uint16_t)response[3] << 8) | response[4];
-    value = (double)raw / 100.0;
+    const uint16_t raw = frame.u16(0);
+    value = FixedSample::make(raw, RIKA_SOIL3_HUNDREDTHS);
     epsilon = value;
     return true;
   }
 
-  value = -99.0;
-  epsilon = -99.0;
+  value = FixedSample::fallback(RIKA_SOIL3_HUNDREDTHS);
+  epsilon = value;
   return false;
 }
 
@@ -394,7 +422,7 @@ bool RikaSoilSensor3in1::setCompensationCoeff(uint16_t regAddress,
 }
 
 bool RikaSoilSensor3in1::readCompensationCoeff(uint16_t regAddress,
-                                               double &coeffValue,
+                                               FixedSample &coeffValue,
                                                uint8_t driverRetries,
                                                uint16_t readTimeoutMs,
                                                uint16_t afterReqDelayMs) {
@@ -403,31 +431,32 @@ bool RikaSoilSensor3in1::readCompensationCoeff(uint16_t regAddress,
   const uint8_t regHigh = (uint8_t)((regAddress >> 8) & 0xFF);
   const uint8_t regLow  = (uint8_t)(regAddress & 0xFF);
 
-  for (uint8_t driverAttempt = 1; driverAttempt <= driverRetries; ++driverAttempt) {
-    uint8_t request[8] = {_address, 0x03, regHigh, regLow, 0x00, 0x01, 0x00, 0x00};
-    uint8_t response[7] = {0};
-    const uint8_t check[3] = {_address, 0x03, 0x02};
+  uint8_t request[8] = {_address, 0x03, regHigh, regLow, 0x00, 0x01, 0x00, 0x00};
+  const uint8_t check[3] = {_address, 0x03, 0x02};
+  ModbusFrameView frame;
 
-    const bool ok = _bus.SendRequest(request,
-                                     8,
-                                     response,
-                                     7,
-                                     check,
-                                     3,
-                                     SENSOR_DEFAULT_BUS_RETRIES,
-                                     readTimeoutMs,
-                                     _debugEnable,
-                                     afterReqDelayMs);
+  for (uint8_t driverAttempt = 1; driverAttempt <= driverRetries; ++driverAttempt) {
+    const bool ok = _bus.transact(request,
+                                  8,
+                                  7,
+                                  check,
+                                  3,
+                                  frame,
+                                  SENSOR_DEFAULT_BUS_RETRIES,
+                                  readTimeoutMs,
+                                  _debugEnable,
+                                  afterReqDelayMs);
     if (!ok) {
+      if (_bus.lastWasException()) break;
       continue;
     }
 
-    const uint16_t raw = ((uint16_t)response[3] << 8) | response[4];
-    coeffValue = (double)raw / 100.0;
+    const uint16_t raw = frame.u16(0);
+    coeffValue = FixedSample::make(raw, RIKA_SOIL3_HUNDREDTHS);
     return true;
   }
 
-  coeffValue = -99.0;
+  coeffValue = FixedSample::fallback(RIKA_SOIL3_HUNDREDTHS);
   return false;
 }
 
@@ -9,7 +9,7 @@
 
   Driver intent:
   - RS485 Modbus RTU driver for the RK520-02 / JXBS-3001-TR family.
-  - Primary measurements:
+  - Primary measurements (FixedSample, scale from the register map):
       soil_temp -> degrees Celsius
       soil_vwc  -> volumetric water content (%)
       soil_ec   -> electrical conductivity (mS/cm)
@@ -27,7 +27,11 @@
 
   Reliability model:
   - Uses SensorDriver status transitions via markSuccess/markFailure.
-  - setFallbackValues() sets sentinel values (-99.0 / SOIL_UNKNOWN) on failure.
+  - Main values pass a SampleFilter (hard bounds, fault words, soil
+    temperature rate of change). A rejected value keeps the last good one
+    and ends the cycle without re-polling; see getSampleQuality().
+  - setFallbackValues() sets sentinel values (-99 / SOIL_UNKNOWN) when no
+    frame arrives.
 */
 class RikaSoilSensor3in1 : public SensorDriver {
 public:
@@ -40,13 +44,13 @@ public:
     SOIL_UNKNOWN = 255
   };
 
-  // Last decoded values (sentinel -99.0 on failed read cycle).
-  double soil_temp;
-  double soil_vwc;
-  double soil_ec;
+  // Last decoded values (sentinel -99 on failed read cycle).
+  FixedSample soil_temp;
+  FixedSample soil_vwc;
+  FixedSample soil_ec;
 
-  // Last decoded dielectric constant from readEpsilon().
-  double epsilon;
+  // Last decoded dielectric constant from readEpsilon(), 2 decimals.
+  FixedSample epsilon;
 
   // Cached soil class from readSoilType()/setSoilType().
   SoilType currentSoilType;
@@ -69,12 +73,32 @@ public:
   // Writes fallback sentinels for all driver-exposed values.
   void setFallbackValues() override;
 
+  // soil_temp, soil_vwc, soil_ec (not epsilon: readData() does not read it), for burst statistics.
+  uint8_t valueCount() const override { return 3; }
+  FixedSample* valueAt(uint8_t index) override {
+    switch (index) {
+      case 0: return &soil_temp;
+      case 1: return &soil_vwc;
+      case 2: return &soil_ec;
+      default: return nullptr;
+    }
+  }
+
+  // _filter[], kept through deep sleep (SleepPlanner::retain()).
+  void* filterStates(size_t& bytes) override {
+    bytes = sizeof(_filter);
+    return _filter;
+  }
+
   // Writes new Modbus node address to register 0x0200.
   bool changeAddress(uint8_t newAddress,
                      uint8_t maxRetries = 3,
                      uint16_t readTimeoutMs = 500,
                      uint16_t afterReqDelayMs = 20);
 
+  // Keeps the cached read request in step with the address.
+  void setAddress(uint8_t address) override;
+
   // Scans an address range and returns first responsive node, or 0 if none.
   uint8_t scanForAddress(uint8_t startAddr = 1,
                          uint8_t endAddr = 247,
@@ -95,7 +119,7 @@ public:
                    uint16_t afterReqDelayMs = 20);
 
   // Reads dielectric constant (epsilon) from input register 0x0005 (scaled /100).
-  bool readEpsilon(double &value,
+  bool readEpsilon(FixedSample &value,
                    uint8_t driverRetries = 3,
                    uint16_t readTimeoutMs = 500,
                    uint16_t afterReqDelayMs = 20);
@@ -108,9 +132,10 @@ public:
                             uint16_t readTimeoutMs = 500,
                             uint16_t afterReqDelayMs = 20);
 
-  // Reads a calibration/compensation coefficient and converts it by /100.
+  // Reads a calibration/compensation coefficient (register value / 100,
+  // i.e. 2 decimals).
   bool readCompensationCoeff(uint16_t regAddress,
-                             double &coeffValue,
+                             FixedSample &coeffValue,
                              uint8_t driverRetries = 3,
                              uint16_t readTimeoutMs = 500,
                              uint16_t afterReqDelayMs = 20);
@@ -121,6 +146,12 @@ public:
 private:
   RS485Bus& _bus;
 
+  // Main measurement request for _address, CRC included; rebuilt by setAddress().
+  ModbusRequestFrame _readRequest;
+
+  // Range-protection history per field (temperature, VWC, EC).
+  SampleFilter::State _filter[3];
+
   // Frame sizes used by main measurement transaction.
   static const uint8_t MAIN_REQUEST_SIZE   = 8;
   static const uint8_t MAIN_RESPONSE_SIZE  = 11;
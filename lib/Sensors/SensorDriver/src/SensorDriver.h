@@ -17,8 +17,13 @@
   - last read timestamp
   - keepPowerOn policy result
   - sensor health state
+  - sample quality of the last read (SampleFilter flags, 0 = clean)
+  - optional burst (several reads reduced to one sample, SensorBurst)
 */
 
+struct FixedSample;
+class SensorBurst;
+
 enum SensorStatus {
   SENSOR_ONLINE,
   SENSOR_ERROR,
@@ -49,7 +54,10 @@ public:
         _status(SENSOR_ONLINE),
         _consecutiveErrors(0),
         _maxConsecutiveErrors(maxConsecutiveErrors),
-        _minUsefulPowerOffMs(minUsefulPowerOffMs) {
+        _minUsefulPowerOffMs(minUsefulPowerOffMs),
+        _sampleQuality(0),
+        _burst(nullptr),
+        _burstReads(1) {
     recalculateKeepPowerOn();
   }
 
@@ -84,6 +92,13 @@ public:
   }
 
   uint32_t getRequestRateMs() const { return (uint32_t)_sampleRateMin * 60000UL; }
+
+  // Time between two reads: the sample interval, or interval / reads while
+  // a burst is spread over it.
+  uint32_t getReadIntervalMs() const {
+    return burstSpread() ? getRequestRateMs() / _burstReads : getRequestRateMs();
+  }
+
   uint32_t getLastReadTime() const { return _lastReadTime; }
 
   uint32_t getMinUsefulPowerOffMs() const { return _minUsefulPowerOffMs; }
@@ -96,11 +111,19 @@ public:
     if (_lastReadTime == 0) {
       return true;
     }
-    return (nowMs - _lastReadTime) >= getRequestRateMs();
+    return (nowMs - _lastReadTime) >= getReadIntervalMs();
   }
 
   void markReadTime(uint32_t nowMs) { _lastReadTime = nowMs; }
 
+  // Reapplies schedule and health state saved before a reset or deep sleep.
+  // lastReadTime must already be in the current millis() timebase.
+  void restoreState(uint32_t lastReadTime, uint8_t consecutiveErrors, SensorStatus status) {
+    _lastReadTime = lastReadTime;
+    _consecutiveErrors = consecutiveErrors;
+    _status = status;
+  }
+
   SensorStatus getStatus() const { return _status; }
   bool isOnline() const { return _status != SENSOR_OFFLINE; }
 
@@ -128,6 +151,38 @@ public:
     }
   }
 
+  // Quality flags of the last read, OR'ed over its fields. Drivers that
+  // run a SampleFilter set it; others leave it at 0.
+  uint8_t getSampleQuality() const { return _sampleQuality; }
+
+  // Burst oversampling: reads per sample interval reduced by burst
+  // (ReadScheduler). A switched line takes them back to back while warm;
+  // a keep-powered sensor spreads them over the interval. reads <= 1 or
+  // burst == nullptr: one read per interval.
+  void setBurst(SensorBurst* burst, uint8_t reads) {
+    _burst = (reads > 1) ? burst : nullptr;
+    _burstReads = _burst ? reads : 1;
+  }
+  SensorBurst* getBurst() const { return _burst; }
+  uint8_t getBurstReads() const { return _burstReads; }
+  bool burstSpread() const { return _burstReads > 1 && _keepPowerOn; }
+
+  // Measured values as FixedSample, for code that handles any driver
+  // (burst statistics). Drivers without fixed-point fields report none.
+  virtual uint8_t valueCount() const { return 0; }
+  virtual FixedSample* valueAt(uint8_t index) {
+    (void)index;
+    return nullptr;
+  }
+
+  // SampleFilter::State array behind the range checks (ROC, stuck, last
+  // good), for SleepPlanner::retain() with SampleFilter::rebaseStates.
+  // Drivers without a filter report none.
+  virtual void* filterStates(size_t& bytes) {
+    bytes = 0;
+    return nullptr;
+  }
+
   void resetStatus() {
     _dataStatus = false;
     _consecutiveErrors = 0;
@@ -150,6 +205,8 @@ protected:
     _keepPowerOn = (offWindowMs < _minUsefulPowerOffMs);
   }
 
+  void setSampleQuality(uint8_t quality) { _sampleQuality = quality; }
+
   const char* _sensorId;
   uint8_t _address;
   bool _debugEnable;
@@ -167,4 +224,8 @@ protected:
   uint8_t _consecutiveErrors;
   uint8_t _maxConsecutiveErrors;
   uint32_t _minUsefulPowerOffMs;
+  uint8_t _sampleQuality;
+
+  SensorBurst* _burst;
+  uint8_t _burstReads;
 };
\ No newline at end of file
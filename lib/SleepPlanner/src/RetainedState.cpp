@@ -0,0 +1,72 @@
+#include "RetainedState.h"
+
+RetainedState::RetainedState(uint8_t* store, size_t storeSize)
+  : _store(store), _storeSize(store ? storeSize : 0), _count(0), _bytes(0) {}
+
+bool RetainedState::add(void* data, size_t size, RetainedRebaseFn rebase) {
+  if (!data || size == 0) return false;
+  if (_count >= MAX_REGIONS || _bytes + size > capacity()) return false;
+
+  Region& r = _regions[_count++];
+  r.data = data;
+  r.size = size;
+  r.rebase = rebase;
+  _bytes += size;
+  return true;
+}
+
+// ============================================================================
+// layout — FNV-1a over the region sizes, ties the store to this firmware
+// ============================================================================
+uint32_t RetainedState::layout() const {
+  uint32_t h = 2166136261UL;
+  h ^= _count;
+  h *= 16777619UL;
+  for (uint8_t i = 0; i < _count; ++i) {
+    uint32_t size = (uint32_t)_regions[i].size;
+    for (uint8_t b = 0; b < 4; ++b) {
+      h ^= (uint8_t)(size & 0xFF);
+      h *= 16777619UL;
+      size >>= 8;
+    }
+  }
+  // 0 is what a cold-boot store holds.
+  return h ? h : 1;
+}
+
+// ============================================================================
+// save / load
+// ============================================================================
+void RetainedState::save() {
+  if (capacity() == 0) return;
+
+  const uint32_t word = layout();
+  memcpy(_store, &word, HEADER_BYTES);
+
+  size_t offset = HEADER_BYTES;
+  for (uint8_t i = 0; i < _count; ++i) {
+    memcpy(_store + offset, _regions[i].data, _regions[i].size);
+    offset += _regions[i].size;
+  }
+}
+
+bool RetainedState::load(uint32_t shiftMs) {
+  if (capacity() == 0) return false;
+
+  uint32_t word = 0;
+  memcpy(&word, _store, HEADER_BYTES);
+  if (word != layout()) return false;
+
+  size_t offset = HEADER_BYTES;
+  for (uint8_t i = 0; i < _count; ++i) {
+    memcpy(_regions[i].data, _store + offset, _regions[i].size);
+    offset += _regions[i].size;
+    if (_regions[i].rebase) _regions[i].rebase(_regions[i].data, _regions[i].size, shiftMs);
+  }
+  return true;
+}
+
+void RetainedState::invalidate() {
+  if (capacity() == 0) return;
+  memset(_store, 0, HEADER_BYTES);
+}
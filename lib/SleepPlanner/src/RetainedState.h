@@ -0,0 +1,73 @@
+#pragma once
+#include <Arduino.h>
+
+// ============================================================================
+// RetainedState — plain-data objects copied through a deep sleep
+// ============================================================================
+// SleepPlanner keeps the schedule in RTC memory; state that makes later
+// reads better (learned timeouts, bus counters, filter history, a burst in
+// progress) lives in RAM and is lost on every deep-sleep wake. Such objects
+// register as regions:
+//
+//   retained.add(&bus.latency(), sizeof(ModbusLatencyTracker));
+//   retained.add(states, sizeof(states), SampleFilter::rebaseStates);
+//
+// save() copies every region, back to back, into the store behind a layout
+// word (region count and sizes, in order); load() copies them back only
+// when the layout matches, so a firmware whose objects changed size starts
+// clean instead of reading shifted bytes. Regions must not hold pointers.
+//
+// Times in the millis() timebase restart with the reboot: a region's
+// rebase function moves them by shiftMs (old timebase -> new) after the
+// copy.
+//
+// The store is caller memory: RTC_DATA_ATTR in SleepPlanner, any buffer in
+// the native simulation.
+// ============================================================================
+
+#if !defined(SLEEP_PLANNER_MAX_RETAINED)
+  #define SLEEP_PLANNER_MAX_RETAINED 12
+#endif
+
+typedef void (*RetainedRebaseFn)(void* data, size_t size, uint32_t shiftMs);
+
+class RetainedState {
+public:
+  static const uint8_t MAX_REGIONS = SLEEP_PLANNER_MAX_RETAINED;
+  static const size_t HEADER_BYTES = 4;
+
+  RetainedState(uint8_t* store, size_t storeSize);
+
+  // Registers a region, in the same order on every boot. False when the
+  // table or the store is full; the region is then not kept.
+  bool add(void* data, size_t size, RetainedRebaseFn rebase = nullptr);
+
+  uint8_t count() const { return _count; }
+  size_t bytes() const { return _bytes; }
+  size_t capacity() const { return _storeSize > HEADER_BYTES ? _storeSize - HEADER_BYTES : 0; }
+
+  // Regions -> store.
+  void save();
+
+  // Store -> regions, rebased by shiftMs. False, regions untouched, when
+  // the store holds another layout (or nothing).
+  bool load(uint32_t shiftMs);
+
+  // Makes the next load() fail, e.g. after a record was rejected.
+  void invalidate();
+
+private:
+  struct Region {
+    void* data;
+    size_t size;
+    RetainedRebaseFn rebase;
+  };
+
+  uint8_t* _store;
+  size_t _storeSize;
+  Region _regions[MAX_REGIONS];
+  uint8_t _count;
+  size_t _bytes;
+
+  uint32_t layout() const;
+};
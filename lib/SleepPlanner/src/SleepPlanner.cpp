@@ -0,0 +1,281 @@
+#include "SleepPlanner.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+  #include <esp_sleep.h>
+  #include <sys/time.h>
+
+  // ESP32 RTC memory survives deep sleep (not power loss)
+  #define SLEEP_RECORD_MAGIC 0x534C5031UL  // "SLP1"
+
+  struct SleepSensorRecord {
+    uint32_t lastReadAbsMs;
+    uint8_t consecutiveErrors;
+    uint8_t status;
+    bool hasRead;
+  };
+
+  RTC_DATA_ATTR static uint32_t _rtcSleepMagic = 0;
+  RTC_DATA_ATTR static uint32_t _rtcSleepHash = 0;
+  RTC_DATA_ATTR static uint8_t _rtcSleepCount = 0;
+  RTC_DATA_ATTR static SleepSensorRecord _rtcSleepSensors[SLEEP_PLANNER_MAX_SENSORS];
+  RTC_DATA_ATTR static uint32_t _rtcUploadAbsMs = 0;
+  RTC_DATA_ATTR static bool _rtcHasUpload = false;
+
+  // retain() regions, and the boot they were saved in (see restore())
+  RTC_DATA_ATTR static uint32_t _rtcRetainBootAbsMs = 0;
+  RTC_DATA_ATTR static uint8_t _rtcRetainStore[SLEEP_PLANNER_RETAIN_BYTES];
+#elif defined(ARDUINO_ARCH_AVR)
+  #include <avr/sleep.h>
+  // Longest single IDLE sleep; loop() re-plans after each one
+  #define SLEEP_PLANNER_AVR_MAX_IDLE_MS 1000UL
+#endif
+
+// Upper bound for one sleep when nothing is scheduled
+#define SLEEP_PLANNER_MAX_SLEEP_MS 3600000UL
+
+// ============================================================================
+// Constructor
+// ============================================================================
+SleepPlanner::SleepPlanner(uint32_t lightMinMs, uint32_t deepMinMs, uint32_t wakeMarginMs)
+  : _lightMinMs(lightMinMs), _deepMinMs(deepMinMs), _wakeMarginMs(wakeMarginMs),
+    _net(nullptr), _beforeDeepSleep(nullptr), _wokeFromDeepSleep(false),
+    _log(nullptr), _debugEnable(false)
+#if defined(ARDUINO_ARCH_ESP32)
+    , _retained(_rtcRetainStore, sizeof(_rtcRetainStore))
+#endif
+{}
+
+void SleepPlanner::setDebug(PrintController* printer, bool enable) {
+  _log = printer;
+  _debugEnable = enable;
+}
+
+bool SleepPlanner::retain(void* data, size_t size, RetainedRebaseFn rebase) {
+#if defined(ARDUINO_ARCH_ESP32)
+  if (_retained.add(data, size, rebase)) return true;
+  if (_log) {
+    _log->print(F("[SLEEP] Retained state full, "), _debugEnable);
+    _log->print((unsigned int)size, _debugEnable);
+    _log->println(F(" bytes not kept"), _debugEnable);
+  }
+  return false;
+#else
+  (void)data;
+  (void)size;
+  (void)rebase;
+  return true;
+#endif
+}
+
+// ============================================================================
+// absoluteMs — RTC-backed clock that keeps counting through deep sleep
+// ============================================================================
+uint32_t SleepPlanner::absoluteMs() {
+#if defined(ARDUINO_ARCH_ESP32)
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  return (uint32_t)((uint64_t)tv.tv_sec * 1000ULL + (uint64_t)(tv.tv_usec / 1000));
+#else
+  return millis();
+#endif
+}
+
+// ============================================================================
+// sensorListHash — FNV-1a over sensor IDs, ties a record to a configuration
+// ============================================================================
+uint32_t SleepPlanner::sensorListHash(SensorDriver* const sensors[], size_t count) {
+  uint32_t h = 2166136261UL;
+  for (size_t i = 0; i < count; ++i) {
+    const char* id = sensors[i] ? sensors[i]->getSensorId() : nullptr;
+    while (id && *id) {
+      h ^= (uint8_t)*id++;
+      h *= 16777619UL;
+    }
+    h ^= 0xFF;  // separator, so "ab"+"c" != "a"+"bc"
+    h *= 16777619UL;
+  }
+  return h;
+}
+
+// ============================================================================
+// restore — reload the schedule after a deep-sleep wake
+// ============================================================================
+bool SleepPlanner::restore(SensorDriver* const sensors[], size_t count) {
+#if defined(ARDUINO_ARCH_ESP32)
+  _wokeFromDeepSleep = (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_UNDEFINED);
+
+  if (!_wokeFromDeepSleep ||
+      _rtcSleepMagic != SLEEP_RECORD_MAGIC ||
+      _rtcSleepCount != count ||
+      _rtcSleepHash != sensorListHash(sensors, count)) {
+    _rtcSleepMagic = 0;
+    _retained.invalidate();
+    if (_log) {
+      _log->println(F("[SLEEP] No saved schedule, starting fresh"), _debugEnable);
+    }
+    return false;
+  }
+
+  // Absolute time at which millis() was 0 in this boot
+  const uint32_t bootAbsMs = absoluteMs() - millis();
+
+  for (size_t i = 0; i < count; ++i) {
+    const SleepSensorRecord& rec = _rtcSleepSensors[i];
+    uint32_t lastRead = 0;
+    if (rec.hasRead) {
+      // Usually "negative" (before boot); unsigned math in isDueForRead()
+      // still yields the right elapsed time. 0 is reserved for "never".
+      lastRead = rec.lastReadAbsMs - bootAbsMs;
+      if (lastRead == 0) lastRead = 1;
+    }
+    sensors[i]->restoreState(lastRead, rec.consecutiveErrors, (SensorStatus)rec.status);
+  }
+
+  if (_net && _rtcHasUpload) {
+    _net->markUploadTime(_rtcUploadAbsMs - bootAbsMs);
+  }
+
+  // Old boot's millis() + shift = this boot's millis()
+  const bool retained = _retained.load(_rtcRetainBootAbsMs - bootAbsMs);
+
+  if (_log) {
+    _log->print(F("[SLEEP] Schedule restored for "), _debugEnable);
+    _log->print((unsigned int)count, _debugEnable);
+    _log->print(F(" sensors"), _debugEnable);
+    if (_retained.count() > 0) {
+      _log->print(retained ? F(", state kept (") : F(", state layout changed ("), _debugEnable);
+      _log->print((unsigned int)_retained.bytes(), _debugEnable);
+      _log->print(F(" bytes)"), _debugEnable);
+    }
+    _log->println(F(""), _debugEnable);
+  }
+  return true;
+#else
+  (void)sensors;
+  (void)count;
+  return false;
+#endif
+}
+
+// ============================================================================
+// save — persist the schedule in RTC memory
+// ============================================================================
+void SleepPlanner::save(SensorDriver* const sensors[], size_t count) {
+#if defined(ARDUINO_ARCH_ESP32)
+  if (count > SLEEP_PLANNER_MAX_SENSORS) {
+    _rtcSleepMagic = 0;
+    _retained.invalidate();
+    return;
+  }
+
+  const uint32_t bootAbsMs = absoluteMs() - millis();
+
+  for (size_t i = 0; i < count; ++i) {
+    SleepSensorRecord& rec = _rtcSleepSensors[i];
+    const uint32_t lastRead = sensors[i]->getLastReadTime();
+    rec.hasRead = (lastRead != 0);
+    rec.lastReadAbsMs = bootAbsMs + lastRead;
+    rec.consecutiveErrors = sensors[i]->getConsecutiveErrors();
+    rec.status = (uint8_t)sensors[i]->getStatus();
+  }
+
+  _rtcHasUpload = (_net && _net->getLastUploadTime() != 0);
+  _rtcUploadAbsMs = _rtcHasUpload ? bootAbsMs + _net->getLastUploadTime() : 0;
+
+  _retained.save();
+  _rtcRetainBootAbsMs = bootAbsMs;
+
+  _rtcSleepCount = (uint8_t)count;
+  _rtcSleepHash = sensorListHash(sensors, count);
+  _rtcSleepMagic = SLEEP_RECORD_MAGIC;
+#else
+  (void)sensors;
+  (void)count;
+#endif
+}
+
+// ============================================================================
+// msUntilNextDue — earliest sensor or upload deadline
+// ============================================================================
+uint32_t SleepPlanner::msUntilNextDue(SensorDriver* const sensors[], size_t count, uint32_t nowMs) const {
+  uint32_t best = 0xFFFFFFFFUL;
+
+  for (size_t i = 0; i < count; ++i) {
+    const SensorDriver* s = sensors[i];
+    if (!s || !s->isOnline()) continue;
+    if (s->isDueForRead(nowMs)) return 0;
+
+    const uint32_t wait = s->getReadIntervalMs() - (nowMs - s->getLastReadTime());
+    if (wait < best) best = wait;
+  }
+
+  if (_net) {
+    const uint32_t wait = _net->msUntilUploadDue(nowMs);
+    if (wait < best) best = wait;
+  }
+
+  return best;
+}
+
+SleepPlanner::SleepMode SleepPlanner::modeFor(uint32_t sleepMs) const {
+  if (sleepMs >= _deepMinMs) return SLEEP_DEEP;
+  if (sleepMs >= _lightMinMs) return SLEEP_LIGHT;
+  return SLEEP_NONE;
+}
+
+// ============================================================================
+// sleepFor — light or deep sleep until the next deadline
+// ============================================================================
+SleepPlanner::SleepMode SleepPlanner::sleepFor(uint32_t sleepMs,
+                                               SensorDriver* const sensors[],
+                                               size_t count,
+                                               bool allowDeep) {
+  if (sleepMs > SLEEP_PLANNER_MAX_SLEEP_MS) sleepMs = SLEEP_PLANNER_MAX_SLEEP_MS;
+
+  SleepMode mode = modeFor(sleepMs);
+  if (mode == SLEEP_DEEP && !allowDeep) mode = SLEEP_LIGHT;
+  if (mode == SLEEP_NONE) return SLEEP_NONE;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  if (mode == SLEEP_DEEP) {
+    const uint32_t deepMs = (sleepMs > _wakeMarginMs) ? (sleepMs - _wakeMarginMs) : sleepMs;
+    save(sensors, count);
+    if (_beforeDeepSleep) _beforeDeepSleep();
+
+    if (_log) {
+      _log->print(F("[SLEEP] Deep sleep for "), _debugEnable);
+      _log->print((unsigned long)deepMs, _debugEnable);
+      _log->println(F(" ms"), _debugEnable);
+      _log->flush();
+    }
+
+    esp_sleep_enable_timer_wakeup((uint64_t)deepMs * 1000ULL);
+    esp_deep_sleep_start();  // does not return
+  }
+
+  if (_log) _log->flush();
+  esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
+  esp_light_sleep_start();
+  return SLEEP_LIGHT;
+
+#elif defined(ARDUINO_ARCH_AVR)
+  (void)sensors;
+  (void)count;
+  if (sleepMs > SLEEP_PLANNER_AVR_MAX_IDLE_MS) sleepMs = SLEEP_PLANNER_AVR_MAX_IDLE_MS;
+
+  // IDLE keeps timer0 running; every millis() tick wakes the CPU briefly.
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  const uint32_t start = millis();
+  while ((uint32_t)(millis() - start) < sleepMs) {
+    sleep_enable();
+    sleep_cpu();
+    sleep_disable();
+  }
+  return SLEEP_LIGHT;
+
+#else
+  (void)sensors;
+  (void)count;
+  return SLEEP_NONE;
+#endif
+}
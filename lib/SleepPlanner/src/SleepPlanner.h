@@ -0,0 +1,121 @@
+#pragma once
+#include <Arduino.h>
+#include "PrintController.h"
+#include "SensorDriver.h"
+#include "NetworkManager.h"
+#include "RetainedState.h"
+
+// ============================================================================
+// SleepPlanner — sleep between sample slots without losing sensor state
+// ============================================================================
+// millis() and every SensorDriver::_lastReadTime restart from zero after an
+// ESP32 deep sleep. SleepPlanner keeps the schedule alive across it:
+//
+//   - save() stores per-sensor last-read time, error counter, status and
+//     the upload timestamp in RTC_DATA_ATTR memory, as absolute times taken
+//     from the RTC-backed system clock (survives deep sleep).
+//   - restore() runs in setup() after a wake and converts them back into the
+//     new millis() timebase, so isDueForRead() keeps working unchanged.
+//   - msUntilNextDue() is the earliest sensor or upload deadline.
+//   - sleepFor() picks light sleep for short gaps and deep sleep (does not
+//     return, the board reboots into setup()) for long ones.
+//
+// The stored record is bound to the sensor ID list; changing the station
+// configuration and reflashing starts from a clean schedule.
+//
+// retain() adds other RAM state to the record (learned bus timeouts, bus
+// counters, filter history, a burst in progress; see RetainedState). It is
+// saved and restored with the schedule, in SLEEP_PLANNER_RETAIN_BYTES of
+// RTC memory. Register before restore(), in the same order on every boot.
+//
+// AVR: no RTC memory and millis() stops in power-down, so restore() and
+// save() are no-ops and sleepFor() uses IDLE sleep (timer0 keeps counting).
+// RAM survives IDLE sleep, so retain() has nothing to do there.
+//
+// Usage:
+//   planner.attachNetwork(&net);
+//   planner.retain(&bus.latency(), sizeof(ModbusLatencyTracker)); // setup()
+//   planner.restore(sensors, count);                       // setup()
+//   uint32_t ms = planner.msUntilNextDue(sensors, count, millis());
+//   planner.sleepFor(ms, sensors, count);                  // loop(), when idle
+// ============================================================================
+
+#if !defined(SLEEP_PLANNER_MAX_SENSORS)
+  #define SLEEP_PLANNER_MAX_SENSORS 20
+#endif
+
+#if !defined(SLEEP_PLANNER_RETAIN_BYTES)
+  #define SLEEP_PLANNER_RETAIN_BYTES 4096
+#endif
+
+class SleepPlanner {
+public:
+  enum SleepMode : uint8_t {
+    SLEEP_NONE = 0,   // gap too short, keep running
+    SLEEP_LIGHT,      // CPU paused, RAM and GPIO states kept
+    SLEEP_DEEP        // RTC only, wake is a reboot
+  };
+
+  // lightMinMs: shortest gap worth a light sleep
+  // deepMinMs:  shortest gap worth a deep sleep (reboot + setup() cost)
+  // wakeMarginMs: wake this much before a deadline to cover boot time
+  SleepPlanner(uint32_t lightMinMs = 100UL,
+               uint32_t deepMinMs = 30000UL,
+               uint32_t wakeMarginMs = 500UL);
+
+  void setDebug(PrintController* printer, bool enable);
+
+  // Network upload deadline taken into account (optional).
+  void attachNetwork(NetworkManager* net) { _net = net; }
+
+  // Called right before deep sleep, e.g. to latch power line GPIOs.
+  void onBeforeDeepSleep(void (*fn)()) { _beforeDeepSleep = fn; }
+
+  // Keeps a plain-data object (no pointers) through deep sleep; rebase
+  // moves its millis() times into the new timebase. False when it does not
+  // fit; the object then restarts empty after a wake.
+  bool retain(void* data, size_t size, RetainedRebaseFn rebase = nullptr);
+
+  // Restores state saved before the last deep sleep. Returns true when a
+  // matching record was applied.
+  bool restore(SensorDriver* const sensors[], size_t count);
+
+  // Persists the schedule. sleepFor() calls it before deep sleep.
+  void save(SensorDriver* const sensors[], size_t count);
+
+  // Milliseconds until the earliest online sensor or the upload is due.
+  // 0 = something is due now.
+  uint32_t msUntilNextDue(SensorDriver* const sensors[], size_t count, uint32_t nowMs) const;
+
+  SleepMode modeFor(uint32_t sleepMs) const;
+
+  // Sleeps up to sleepMs (minus the wake margin for deep sleep). Returns the
+  // mode used; SLEEP_DEEP never returns on ESP32. allowDeep = false limits
+  // it to light sleep, e.g. while a read cycle is waiting for a warm-up.
+  SleepMode sleepFor(uint32_t sleepMs,
+                     SensorDriver* const sensors[],
+                     size_t count,
+                     bool allowDeep = true);
+
+  bool wokeFromDeepSleep() const { return _wokeFromDeepSleep; }
+
+private:
+  uint32_t _lightMinMs;
+  uint32_t _deepMinMs;
+  uint32_t _wakeMarginMs;
+
+  NetworkManager* _net;
+  void (*_beforeDeepSleep)();
+  bool _wokeFromDeepSleep;
+
+  PrintController* _log;
+  bool _debugEnable;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  RetainedState _retained;
+#endif
+
+  // Absolute RTC-backed clock in ms (wraps; only differences are used).
+  static uint32_t absoluteMs();
+  static uint32_t sensorListHash(SensorDriver* const sensors[], size_t count);
+};
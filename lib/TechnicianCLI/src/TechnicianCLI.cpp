@@ -1,4 +1,6 @@
 #include "TechnicianCLI.h"
+#include "ModbusBusScanner.h"
+#include "ModbusBaudNegotiator.h"
 
 // ============================================================================
 // Constructor
@@ -6,7 +8,8 @@
 TechnicianCLI::TechnicianCLI(HardwareSerial& port)
   : _serial(port), _state(CLI_LOCKED),
     _cmdPos(0), _failedAttempts(0), _cooldownStart(0),
-    _slots(nullptr), _logger(nullptr), _memMon(nullptr), _wdt(nullptr) {
+    _slots(nullptr), _logger(nullptr), _memMon(nullptr), _wdt(nullptr),
+    _buses(nullptr), _busCount(0), _busHooks(nullptr) {
   strncpy(_passphrase, DEFAULT_CLI_PASSPHRASE, sizeof(_passphrase));
   memset(_cmdBuffer, 0, CLI_MAX_CMD_LEN);
 }
@@ -130,6 +133,31 @@ void TechnicianCLI::processCommand(const char* cmd) {
       _serial.println(F("Usage: debug <index> <0|1>"));
     }
   }
+  else if (strcmp(cmd, "scan") == 0) {
+    scanBus(0);
+  }
+  else if (strncmp(cmd, "scan ", 5) == 0) {
+    uint8_t port = atoi(cmd + 5);
+    scanBus(port);
+  }
+  else if (strcmp(cmd, "trace") == 0) {
+    traceCommand("");
+  }
+  else if (strncmp(cmd, "trace ", 6) == 0) {
+    traceCommand(cmd + 6);
+  }
+  else if (strcmp(cmd, "baud") == 0) {
+    baudCommand("");
+  }
+  else if (strncmp(cmd, "baud ", 5) == 0) {
+    baudCommand(cmd + 5);
+  }
+  else if (strcmp(cmd, "stats") == 0) {
+    statsCommand("");
+  }
+  else if (strncmp(cmd, "stats ", 6) == 0) {
+    statsCommand(cmd + 6);
+  }
   else if (strcmp(cmd, "reboot") == 0) {
     _serial.println(F("[CLI] Rebooting..."));
     delay(500);
@@ -151,6 +179,15 @@ void TechnicianCLI::processCommand(const char* cmd) {
   }
 }
 
+// ============================================================================
+// busesIdle — bus commands wait until the read cycle has finished
+// ============================================================================
+bool TechnicianCLI::busesIdle() {
+  if (!_busHooks || !_busHooks->busy || !_busHooks->busy()) return true;
+  _serial.println(F("[CLI] Read cycle in progress, try again when it ends."));
+  return false;
+}
+
 // ============================================================================
 // showHelp
 // ============================================================================
@@ -162,6 +199,11 @@ void TechnicianCLI::showHelp() {
   _serial.println(F("  reset <n>      Reset sensor n from OFFLINE to ONLINE"));
   _serial.println(F("  rate <n> <min> Change sensor n sample rate"));
   _serial.println(F("  debug <n> <0|1> Toggle debug for sensor n"));
+  _serial.println(F("  scan [port]    List devices on an RS485 port"));
+  _serial.println(F("  trace [port] [hex|bin|clear|on|off] RS485 trace"));
+  _serial.println(F("  baud [port]    Per-address RS485 line speeds"));
+  _serial.println(F("  baud <port> <addr> <rate> [rika] Negotiate speed"));
+  _serial.println(F("  stats [port] [reset] RS485 health counters"));
   _serial.println(F("  reboot         Restart the MCU"));
   _serial.println(F("  exit           Lock CLI session"));
   _serial.println(F("  help           Show this help"));
@@ -198,6 +240,7 @@ void TechnicianCLI::readSensor(uint8_t index) {
 
   SensorDriver* s = _slots->getSensor(index);
   if (!s) { _serial.println(F("[CLI] Invalid sensor index.")); return; }
+  if (!busesIdle()) return;
 
   _serial.print(F("[CLI] Reading sensor "));
   _serial.print(index);
@@ -264,6 +307,306 @@ void TechnicianCLI::toggleDebug(uint8_t index, bool enable) {
   _serial.println(enable ? F("ENABLED") : F("DISABLED"));
 }
 
+// ============================================================================
+// scanBus — one presence probe per address, family by register layout
+// ============================================================================
+void TechnicianCLI::scanBus(uint8_t port) {
+  if (!_buses) { _serial.println(F("[CLI] No RS485 buses.")); return; }
+  if (port >= _busCount) { _serial.println(F("[CLI] Invalid RS485 port.")); return; }
+  if (!busesIdle()) return;
+
+  if (!_busHooks || !_busHooks->portPowerUp || !_busHooks->portPowerRestore) {
+    _serial.println(F("[CLI] Port power unknown, scan refused."));
+    return;
+  }
+
+  // Powered-down devices would show up as missing.
+  const uint32_t warmUpMs = _busHooks->portPowerUp(port);
+  if (warmUpMs > 0) {
+    _serial.print(F("[CLI] Port powered, waiting "));
+    _serial.print(warmUpMs);
+    _serial.println(F(" ms for the devices..."));
+    const uint32_t start = millis();
+    while (millis() - start < warmUpMs) {
+      if (_wdt) _wdt->feed();
+      delay(10);
+    }
+  }
+
+  _serial.print(F("[CLI] Scanning RS485 port "));
+  _serial.print(port);
+  _serial.println(F(" (addresses 1-247)..."));
+
+  ModbusBusScanner scanner(_buses[port]);
+  scanner.begin();
+  while (scanner.step()) {
+    if (_wdt) _wdt->feed();
+  }
+  _busHooks->portPowerRestore(port);
+
+  for (size_t i = 0; i < scanner.count(); ++i) {
+    const ModbusBusScanner::Entry& e = scanner.entry(i);
+    _serial.print(F("  0x"));
+    if (e.address < 0x10) _serial.print('0');
+    _serial.print(e.address, HEX);
+    _serial.print(F(" ("));
+    _serial.print(e.address);
+    _serial.print(F(")  "));
+    _serial.print(ModbusBusScanner::familyName(e.family));
+    _serial.print(F("  reply after "));
+    _serial.print(e.firstByteUs / 1000UL);
+    _serial.println(F(" ms"));
+  }
+  if (scanner.overflow() > 0) {
+    _serial.print(F("  ... and "));
+    _serial.print((unsigned long)scanner.overflow());
+    _serial.println(F(" more"));
+  }
+
+  _serial.print(F("[CLI] Found "));
+  _serial.print((unsigned long)(scanner.count() + scanner.overflow()));
+  _serial.print(F(" device(s) in "));
+  _serial.print(scanner.lastScanMs());
+  _serial.println(F(" ms."));
+
+  if (_logger) {
+    _logger->logAction("CLI: RS485 bus scan");
+  }
+}
+
+// ============================================================================
+// traceCommand
+// ============================================================================
+void TechnicianCLI::traceCommand(const char* args) {
+  if (!_buses) { _serial.println(F("[CLI] No RS485 buses.")); return; }
+
+  if (*args == '\0') {
+    for (uint8_t port = 0; port < _busCount; ++port) {
+      showTraceStatus(port);
+    }
+    return;
+  }
+
+  const uint8_t port = atoi(args);
+  if (port >= _busCount) { _serial.println(F("[CLI] Invalid RS485 port.")); return; }
+
+  ModbusTraceRing* ring = _buses[port].getTrace();
+  if (!ring) {
+    _serial.print(F("[CLI] No trace ring on port "));
+    _serial.println(port);
+    return;
+  }
+
+  const char* space = strchr(args, ' ');
+  const char* action = space ? space + 1 : "";
+
+  if (*action == '\0') {
+    showTraceStatus(port);
+  }
+  else if (strcmp(action, "hex") == 0 || strcmp(action, "bin") == 0) {
+    // No worker appends while the ports are idle: one consistent snapshot.
+    if (!busesIdle()) return;
+    if (action[0] == 'h') {
+      ring->exportHex(_serial);
+    } else {
+      ring->exportBinary(_serial);
+      _serial.println();
+    }
+    _serial.flush();
+  }
+  else if (strcmp(action, "clear") == 0) {
+    if (!busesIdle()) return;
+    ring->clear();
+    _serial.println(F("[CLI] Trace cleared."));
+  }
+  else if (strcmp(action, "on") == 0 || strcmp(action, "off") == 0) {
+    ring->setEnabled(action[1] == 'n');
+    showTraceStatus(port);
+  }
+  else {
+    _serial.println(F("Usage: trace [port] [hex|bin|clear|on|off]"));
+  }
+}
+
+void TechnicianCLI::showTraceStatus(uint8_t port) {
+  const ModbusTraceRing* ring = _buses[port].getTrace();
+
+  _serial.print(F("[CLI] RS485 port "));
+  _serial.print(port);
+  if (!ring) {
+    _serial.println(F(": no trace"));
+    return;
+  }
+
+  _serial.print(ring->enabled() ? F(": trace on, ") : F(": trace off, "));
+  _serial.print(ring->records());
+  _serial.print(F(" records, "));
+  _serial.print((unsigned long)ring->usedBytes());
+  _serial.print(F("/"));
+  _serial.print((unsigned long)ModbusTraceRing::RING_BYTES);
+  _serial.print(F(" B, "));
+  _serial.print(ring->dropped());
+  _serial.println(F(" dropped"));
+}
+
+// ============================================================================
+// baudCommand — list the baud tables, or negotiate one device
+// ============================================================================
+void TechnicianCLI::baudCommand(const char* args) {
+  if (!_buses) { _serial.println(F("[CLI] No RS485 buses.")); return; }
+
+  if (*args == '\0') {
+    for (uint8_t port = 0; port < _busCount; ++port) {
+      showBaudTable(port);
+    }
+    return;
+  }
+
+  char* end = nullptr;
+  const unsigned long port = strtoul(args, &end, 10);
+  if (port >= _busCount) { _serial.println(F("[CLI] Invalid RS485 port.")); return; }
+
+  while (*end == ' ') ++end;
+  if (*end == '\0') {
+    showBaudTable((uint8_t)port);
+    return;
+  }
+
+  // Address accepts decimal or 0x-prefixed hex, like the scan output.
+  const unsigned long address = strtoul(end, &end, 0);
+  const unsigned long rate = strtoul(end, &end, 10);
+  while (*end == ' ') ++end;
+  if (address < 1 || address > 247 || rate == 0) {
+    _serial.println(F("Usage: baud [port] | baud <port> <addr> <rate> [rika]"));
+    return;
+  }
+
+  const ModbusBaudProfile& profile =
+      (strcmp(end, "rika") == 0) ? MODBUS_BAUD_PROFILE_RIKA : MODBUS_BAUD_PROFILE_JXCT;
+
+  // The probes pin the port's baud table, switch adaptive timeouts off
+  // and end with a register write: not while a worker reads the port.
+  if (!busesIdle()) return;
+
+  RS485Bus& bus = _buses[port];
+  if (_wdt) _wdt->feed();
+  const ModbusBaudNegotiator::Result result =
+      ModbusBaudNegotiator::negotiate(bus, (uint8_t)address, profile, rate);
+  if (_wdt) _wdt->feed();
+
+  _serial.print(F("[CLI] 0x"));
+  _serial.print((uint8_t)address, HEX);
+  _serial.print(F(": "));
+  _serial.print(ModbusBaudNegotiator::resultName(result));
+  _serial.print(F(", now at "));
+  _serial.print(bus.bauds().baudFor((uint8_t)address, bus.getDefaultBaud()));
+  _serial.println(F(" baud"));
+}
+
+void TechnicianCLI::showBaudTable(uint8_t port) {
+  const RS485Bus& bus = _buses[port];
+
+  _serial.print(F("[CLI] RS485 port "));
+  _serial.print(port);
+  _serial.print(F(": default "));
+  _serial.print(bus.getDefaultBaud());
+  _serial.print(F(" baud, now "));
+  _serial.print(bus.getBaud());
+  _serial.print(F(", "));
+  _serial.print(bus.baudSwitches());
+  _serial.println(F(" switches"));
+
+  for (uint8_t i = 0; i < ModbusBaudTable::MAX_DEVICES; ++i) {
+    const ModbusBaudTable::Entry* e = bus.bauds().entry(i);
+    if (!e) continue;
+
+    _serial.print(F("  0x"));
+    if (e->address < 0x10) _serial.print('0');
+    _serial.print(e->address, HEX);
+    _serial.print(F("  "));
+    _serial.print(e->baud);
+    if (e->altBaud) {
+      _serial.print(F(" (alt "));
+      _serial.print(e->altBaud);
+      _serial.print(F(")"));
+    }
+    if (e->target) {
+      _serial.print(F("  target "));
+      _serial.print(e->target);
+      _serial.print(F(": "));
+      _serial.print(e->settled ? ModbusBaudNegotiator::resultName(e->lastResult) : F("due"));
+    }
+    if (e->misses) {
+      _serial.print(F("  "));
+      _serial.print(e->misses);
+      _serial.print(F(" misses"));
+    }
+    _serial.println();
+  }
+}
+
+// ============================================================================
+// statsCommand — RS485 health counters, or reset them
+// ============================================================================
+void TechnicianCLI::statsCommand(const char* args) {
+  if (!_buses) { _serial.println(F("[CLI] No RS485 buses.")); return; }
+
+  if (*args == '\0') {
+    for (uint8_t port = 0; port < _busCount; ++port) {
+      showBusStats(port);
+    }
+    return;
+  }
+
+  const uint8_t port = atoi(args);
+  if (port >= _busCount) { _serial.println(F("[CLI] Invalid RS485 port.")); return; }
+
+  const char* space = strchr(args, ' ');
+  const char* action = space ? space + 1 : "";
+
+  if (*action == '\0') {
+    showBusStats(port);
+  }
+  else if (strcmp(action, "reset") == 0) {
+    if (!busesIdle()) return;
+    _buses[port].stats().reset(millis());
+    _serial.println(F("[CLI] Counters cleared."));
+    if (_logger) {
+      _logger->logAction("CLI: RS485 counters cleared");
+    }
+  }
+  else {
+    _serial.println(F("Usage: stats [port] [reset]"));
+  }
+}
+
+void TechnicianCLI::showBusStats(uint8_t port) {
+  const ModbusBusStats& stats = _buses[port].stats();
+  char line[160];
+
+  _serial.print(F("[CLI] RS485 port "));
+  _serial.print(port);
+  _serial.print(F(", last "));
+  _serial.print((unsigned long)((millis() - stats.sinceMs()) / 1000UL));
+  _serial.println(F(" s:"));
+
+  ModbusBusStats::format(stats.total(), line, sizeof(line));
+  _serial.print(F("  all   "));
+  _serial.println(line);
+
+  for (uint8_t i = 0; i < ModbusBusStats::MAX_DEVICES; ++i) {
+    const ModbusBusStats::Device* dev = stats.device(i);
+    if (!dev) continue;
+
+    ModbusBusStats::format(dev->counters, line, sizeof(line));
+    _serial.print(F("  0x"));
+    if (dev->address < 0x10) _serial.print('0');
+    _serial.print(dev->address, HEX);
+    _serial.print(F("  "));
+    _serial.println(line);
+  }
+}
+
 // ============================================================================
 // prompt
 // ============================================================================
@@ -5,6 +5,7 @@
 #include "StationLogger.h"
 #include "MemoryMonitor.h"
 #include "WatchdogManager.h"
+#include "RS485Modbus.h"
 
 // ============================================================================
 // TechnicianCLI — Authenticated Serial Command Interface
@@ -19,11 +20,25 @@
 //   reset <n> — reset sensor n from OFFLINE back to ONLINE
 //   rate <n> <mins> — change sensor n sample rate
 //   debug <n> <0|1> — toggle debug for sensor n
+//   scan [port] — inventory of the RS485 bus: addresses and sensor families
+//   trace [port] [hex|bin|clear|on|off] — RS485 trace ring status / export
+//                 (decode with tools/rs485_trace_decode.py)
+//   baud [port] — per-address line speeds and negotiation results
+//   baud <port> <addr> <rate> [rika] — negotiate a device to a new speed
+//   stats [port] [reset] — RS485 health counters per port and address
 //   logs      — list log files on SD
 //   reboot    — restart the MCU
 //   help      — show available commands
 //   exit      — lock CLI (requires re-authentication)
 //
+// Commands that use an RS485 port (read, scan, baud negotiation, trace
+// export and clear, stats reset) are refused while TechnicianBusHooks::busy
+// reports a read cycle: on ESP32 the ReadPortWorker tasks drive the same
+// RS485Bus objects, and a CLI transaction would share their UART, receive
+// buffer and read budget, or clear counters they are incrementing.
+// scan powers the port's sensors through the hooks for the duration of
+// the scan, so switched-off devices are not reported missing.
+//
 // Security:
 //   - Physical USB cable required (no wireless attack surface)
 //   - Passphrase must be typed within 30 seconds of connecting
@@ -49,6 +64,17 @@ enum CLIState {
 // Max command line length
 #define CLI_MAX_CMD_LEN 64
 
+// Station state the bus commands depend on, provided by main.cpp.
+struct TechnicianBusHooks {
+  bool (*busy)();  // a read cycle is using the RS485 ports
+
+  // Switches on the power lines of the port's sensors and the port's
+  // interface; returns ms until the devices answer (0 = already on).
+  uint32_t (*portPowerUp)(uint8_t port);
+  // Switches off what portPowerUp() switched on.
+  void (*portPowerRestore)(uint8_t port);
+};
+
 class TechnicianCLI {
 public:
   TechnicianCLI(HardwareSerial& port);
@@ -61,6 +87,8 @@ public:
   void attachLogger(StationLogger* logger)         { _logger = logger; }
   void attachMemoryMonitor(MemoryMonitor* mem)     { _memMon = mem; }
   void attachWatchdog(WatchdogManager* wdt)        { _wdt = wdt; }
+  void attachBuses(RS485Bus* buses, uint8_t count) { _buses = buses; _busCount = count; }
+  void attachBusHooks(const TechnicianBusHooks* hooks) { _busHooks = hooks; }
 
   // Call this in loop() — processes incoming serial commands
   // Non-blocking: returns immediately if no input
@@ -84,9 +112,13 @@ private:
   StationLogger*  _logger;
   MemoryMonitor*  _memMon;
   WatchdogManager* _wdt;
+  RS485Bus*       _buses;
+  uint8_t         _busCount;
+  const TechnicianBusHooks* _busHooks;
 
   // Command processing
   void processCommand(const char* cmd);
+  bool busesIdle();
   void showHelp();
   void showStatus();
   void showMemory();
@@ -94,5 +126,12 @@ private:
   void readSensor(uint8_t index);
   void changeSensorRate(uint8_t index, uint8_t newRate);
   void toggleDebug(uint8_t index, bool enable);
+  void scanBus(uint8_t port);
+  void traceCommand(const char* args);
+  void showTraceStatus(uint8_t port);
+  void baudCommand(const char* args);
+  void showBaudTable(uint8_t port);
+  void statsCommand(const char* args);
+  void showBusStats(uint8_t port);
   void prompt();
 };
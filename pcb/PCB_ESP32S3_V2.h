@@ -40,6 +40,10 @@ constexpr bool   PCB_POWERLINE_STATUS_ACTIVE_HIGH[PCB_POWERLINE_COUNT] = {true};
 
 constexpr uint8_t PCB_POWERLINE_VOLTAGES[PCB_POWERLINE_COUNT] = {12};
 
+// Inrush window after switching a line ON. No other line is switched ON
+// until it has passed. 0 = no limit.
+constexpr uint16_t PCB_POWERLINE_INRUSH_MS[PCB_POWERLINE_COUNT] = {0};
+
 // Set to true only if this PCB/hardware design allows the line
 // to remain ON through station sleep logic safely
 constexpr bool PCB_POWERLINE_CAN_STAY_ON_IN_SLEEP[PCB_POWERLINE_COUNT] = {true};
@@ -53,6 +57,10 @@ constexpr uint8_t PCB_RS485_PORT_COUNT = 1;
 // RX=17 TX=18 DE=21
 constexpr int8_t PCB_RS485_RX_PINS[PCB_RS485_PORT_COUNT] = {17};
 constexpr int8_t PCB_RS485_TX_PINS[PCB_RS485_PORT_COUNT] = {18};
+
+// Hardware UART number per port (UART0 is the debug port).
+// Every port needs its own UART to be polled in parallel.
+constexpr uint8_t PCB_RS485_UART_NUMS[PCB_RS485_PORT_COUNT] = {1};
 constexpr int8_t PCB_RS485_DE_PINS[PCB_RS485_PORT_COUNT] = {21};
 constexpr bool   PCB_RS485_DE_ACTIVE_HIGH[PCB_RS485_PORT_COUNT] = {true};
 
@@ -52,6 +52,9 @@ constexpr bool   PCB_POWERLINE_STATUS_ACTIVE_HIGH[PCB_POWERLINE_COUNT] = {true};
 
 constexpr uint8_t PCB_POWERLINE_VOLTAGES[PCB_POWERLINE_COUNT] = {12};
 
+// Inrush window after switching ON (0 = no stagger needed)
+constexpr uint16_t PCB_POWERLINE_INRUSH_MS[PCB_POWERLINE_COUNT] = {0};
+
 // Current test board has this line always ON physically
 constexpr bool PCB_POWERLINE_CAN_STAY_ON_IN_SLEEP[PCB_POWERLINE_COUNT] = {true};
 
@@ -64,6 +67,9 @@ constexpr uint8_t PCB_RS485_PORT_COUNT = 1;
 constexpr int8_t PCB_RS485_RX_PINS[PCB_RS485_PORT_COUNT] = {17};
 constexpr int8_t PCB_RS485_TX_PINS[PCB_RS485_PORT_COUNT] = {18};
 
+// Hardware UART number per port (UART0 is the debug port)
+constexpr uint8_t PCB_RS485_UART_NUMS[PCB_RS485_PORT_COUNT] = {1};
+
 // Current module uses AUTO direction switching -> no DE/RE control pin
 constexpr int8_t PCB_RS485_DE_PINS[PCB_RS485_PORT_COUNT] = {-1};
 constexpr bool   PCB_RS485_DE_ACTIVE_HIGH[PCB_RS485_PORT_COUNT] = {true};
@@ -25,6 +25,8 @@ constexpr int8_t PCB_POWERLINE_STATUS_PINS[PCB_POWERLINE_COUNT] = {-1, -1, -1};
 constexpr bool   PCB_POWERLINE_STATUS_ACTIVE_HIGH[PCB_POWERLINE_COUNT] = {true, true, true};
 
 constexpr uint8_t PCB_POWERLINE_VOLTAGES[PCB_POWERLINE_COUNT] = {0, 5, 12};
+// Inrush window after switching a line ON; the next line waits for it
+constexpr uint16_t PCB_POWERLINE_INRUSH_MS[PCB_POWERLINE_COUNT] = {0, 0, 0};
 constexpr bool PCB_POWERLINE_CAN_STAY_ON_IN_SLEEP[PCB_POWERLINE_COUNT] = {true, true, true};
 
 // ------------------------------------------------------------
@@ -35,6 +37,8 @@ constexpr uint8_t PCB_RS485_PORT_COUNT = 1;
 // Mega2560 Serial2: RX2=D17, TX2=D16. DE/RE is from the older test sketch.
 constexpr int8_t PCB_RS485_RX_PINS[PCB_RS485_PORT_COUNT] = {17};
 constexpr int8_t PCB_RS485_TX_PINS[PCB_RS485_PORT_COUNT] = {16};
+// SerialN used by each port (Serial is the debug port)
+constexpr uint8_t PCB_RS485_UART_NUMS[PCB_RS485_PORT_COUNT] = {2};
 constexpr int8_t PCB_RS485_DE_PINS[PCB_RS485_PORT_COUNT] = {25};
 constexpr bool   PCB_RS485_DE_ACTIVE_HIGH[PCB_RS485_PORT_COUNT] = {true};
 
@@ -0,0 +1,158 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdio.h>
+
+/*
+  Arduino.h (host simulation)
+
+  Minimal Arduino core for the native PlatformIO env. Only what the
+  station libraries use is provided:
+  - virtual clock: millis()/micros() return simulated time; delay() and
+    delayMicroseconds() advance it instantly (see SimClock)
+  - GPIO: pin levels are stored so tests can inspect them
+  - Print / Stream / HardwareSerial with a simulated wire (HardwareSerial.h)
+
+  Timing numbers from the simulation are therefore reproducible: they
+  depend only on the code path and the simulated bus, not on the host.
+*/
+
+#define SIM_HOST 1
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define HIGH 1
+#define LOW 0
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define SERIAL_8N1 0x06
+#define SERIAL_8E1 0x26
+#define SERIAL_8O1 0x36
+#define SERIAL_8N2 0x0E
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+// ------------------------------------------------------------
+// Virtual clock
+// ------------------------------------------------------------
+namespace SimClock {
+  uint64_t nowUs();
+  void advanceUs(uint64_t us);
+  void advanceToUs(uint64_t atUs);
+  void reset();
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+inline void yield() {}
+
+// Host entry point: main() runs setup() once, then loop() until simExit().
+void setup();
+void loop();
+void simExit(int code);
+
+// ------------------------------------------------------------
+// GPIO / interrupts
+// ------------------------------------------------------------
+#define SIM_GPIO_COUNT 64
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+// Test side: force the level seen by digitalRead() on an input pin.
+void simSetPinLevel(uint8_t pin, uint8_t value);
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline int digitalPinToInterrupt(int pin) { return pin; }
+void attachInterrupt(int interruptNum, void (*isr)(), int mode);
+void detachInterrupt(int interruptNum);
+
+// ------------------------------------------------------------
+// Print / Stream
+// ------------------------------------------------------------
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    for (size_t i = 0; i < size; ++i) n += write(buffer[i]);
+    return n;
+  }
+  virtual void flush() {}
+
+  size_t print(const char *s) { return writeText(s); }
+  size_t print(const __FlashStringHelper *s) { return writeText(reinterpret_cast<const char *>(s)); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base = DEC) { return printUnsigned(v, base); }
+  size_t print(int v, int base = DEC) { return printSigned(v, base); }
+  size_t print(unsigned int v, int base = DEC) { return printUnsigned(v, base); }
+  size_t print(long v, int base = DEC) { return printSigned(v, base); }
+  size_t print(unsigned long v, int base = DEC) { return printUnsigned(v, base); }
+  size_t print(double v, int digits = 2) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    return writeText(buf);
+  }
+
+  size_t println() { return writeText("\r\n"); }
+  template <typename T>
+  size_t println(T v) { return print(v) + println(); }
+  template <typename T>
+  size_t println(T v, int fmt) { return print(v, fmt) + println(); }
+
+private:
+  size_t writeText(const char *s) {
+    size_t n = 0;
+    while (s && *s) n += write((uint8_t)*s++);
+    return n;
+  }
+  size_t printUnsigned(unsigned long v, int base) {
+    char buf[72];
+    if (base == HEX) snprintf(buf, sizeof(buf), "%lX", v);
+    else if (base == OCT) snprintf(buf, sizeof(buf), "%lo", v);
+    else if (base == BIN) {
+      char *p = &buf[sizeof(buf) - 1];
+      *p = '\0';
+      do { *--p = (char)('0' + (v & 1UL)); v >>= 1; } while (v);
+      return writeText(p);
+    } else snprintf(buf, sizeof(buf), "%lu", v);
+    return writeText(buf);
+  }
+  size_t printSigned(long v, int base) {
+    if (base == DEC && v < 0) return write('-') + printUnsigned((unsigned long)(-v), base);
+    return printUnsigned((unsigned long)v, base);
+  }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+#include "HardwareSerial.h"
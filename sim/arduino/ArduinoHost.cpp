@@ -0,0 +1,178 @@
+#include "Arduino.h"
+
+// ============================================================================
+// Virtual clock
+// ============================================================================
+static uint64_t g_simNowUs = 0;
+
+namespace SimClock {
+  uint64_t nowUs() { return g_simNowUs; }
+  void advanceUs(uint64_t us) { g_simNowUs += us; }
+  void advanceToUs(uint64_t atUs) {
+    if (atUs > g_simNowUs) g_simNowUs = atUs;
+  }
+  void reset() { g_simNowUs = 0; }
+}
+
+unsigned long millis() { return (unsigned long)(g_simNowUs / 1000ULL); }
+unsigned long micros() { return (unsigned long)g_simNowUs; }
+void delay(unsigned long ms) { g_simNowUs += (uint64_t)ms * 1000ULL; }
+void delayMicroseconds(unsigned int us) { g_simNowUs += us; }
+
+// ============================================================================
+// Entry point
+// ============================================================================
+void simExit(int code) {
+  fflush(stdout);
+  exit(code);
+}
+
+int main() {
+  setup();
+  for (;;) {
+    loop();
+  }
+}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+static uint8_t g_pinMode[SIM_GPIO_COUNT];
+static uint8_t g_pinLevel[SIM_GPIO_COUNT];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin >= SIM_GPIO_COUNT) return;
+  g_pinMode[pin] = mode;
+  if (mode == INPUT_PULLUP) g_pinLevel[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin >= SIM_GPIO_COUNT) return;
+  g_pinLevel[pin] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= SIM_GPIO_COUNT) return LOW;
+  return g_pinLevel[pin];
+}
+
+void simSetPinLevel(uint8_t pin, uint8_t value) {
+  if (pin >= SIM_GPIO_COUNT) return;
+  g_pinLevel[pin] = value ? HIGH : LOW;
+}
+
+void attachInterrupt(int, void (*)(), int) {}
+void detachInterrupt(int) {}
+
+// ============================================================================
+// HardwareSerial
+// ============================================================================
+HardwareSerial Serial(0, true);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+HardwareSerial Serial3(3);
+
+HardwareSerial::HardwareSerial(int uartNum, bool console)
+    : _uartNum(uartNum),
+      _console(console),
+      _consoleEcho(true),
+      _outputHook(nullptr),
+      _baud(9600),
+      _config(SERIAL_8N1),
+      _device(nullptr),
+      _txBusyUntilUs(0),
+      _rxHead(0),
+      _rxCount(0),
+      _txBytes(0),
+      _rxBytes(0) {}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config) {
+  _baud = baud;
+  _config = config;
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t, int8_t) {
+  begin(baud, config);
+}
+
+uint32_t HardwareSerial::charTimeUs() const {
+  // start + 8 data + stop, plus parity or a second stop bit when configured
+  const uint32_t bits = (_config == SERIAL_8N1) ? 10U : 11U;
+  if (_baud == 0) return 0;
+  return (uint32_t)((bits * 1000000UL + _baud - 1) / _baud);
+}
+
+int HardwareSerial::available() {
+  const uint64_t now = SimClock::nowUs();
+  int n = 0;
+  for (size_t i = 0; i < _rxCount; ++i) {
+    const RxByte &b = _rx[(_rxHead + i) % RX_QUEUE_SIZE];
+    if (b.arrivalUs > now) break;
+    ++n;
+  }
+  return n;
+}
+
+int HardwareSerial::peek() {
+  if (available() == 0) return -1;
+  return _rx[_rxHead].value;
+}
+
+int HardwareSerial::read() {
+  if (available() == 0) return -1;
+  const uint8_t value = _rx[_rxHead].value;
+  _rxHead = (_rxHead + 1) % RX_QUEUE_SIZE;
+  --_rxCount;
+  ++_rxBytes;
+  return value;
+}
+
+size_t HardwareSerial::write(uint8_t value) {
+  if (_console) {
+    if (_outputHook) _outputHook((char)value);
+    if (_consoleEcho) fputc(value, stdout);
+    return 1;
+  }
+
+  const uint64_t now = SimClock::nowUs();
+  const uint64_t startUs = (_txBusyUntilUs > now) ? _txBusyUntilUs : now;
+  _txBusyUntilUs = startUs + charTimeUs();
+  ++_txBytes;
+
+  if (_device) _device->onHostByte(*this, value, _txBusyUntilUs);
+  return 1;
+}
+
+void HardwareSerial::flush() {
+  if (_console) {
+    if (_consoleEcho) fflush(stdout);
+    return;
+  }
+  SimClock::advanceToUs(_txBusyUntilUs);
+}
+
+void HardwareSerial::inject(uint8_t value, uint64_t arrivalUs) {
+  if (_rxCount >= RX_QUEUE_SIZE) return;  // overrun: byte lost, like a full FIFO
+
+  // Keep the queue ordered; devices normally inject in time order.
+  if (_rxCount > 0) {
+    const RxByte &last = _rx[(_rxHead + _rxCount - 1) % RX_QUEUE_SIZE];
+    if (arrivalUs < last.arrivalUs) arrivalUs = last.arrivalUs;
+  }
+
+  RxByte &slot = _rx[(_rxHead + _rxCount) % RX_QUEUE_SIZE];
+  slot.value = value;
+  slot.arrivalUs = arrivalUs;
+  ++_rxCount;
+}
+
+void HardwareSerial::clearRx() {
+  _rxHead = 0;
+  _rxCount = 0;
+}
+
+// ============================================================================
+// SD (no card)
+// ============================================================================
+#include "SD.h"
+SDClass SD;
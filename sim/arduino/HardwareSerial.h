@@ -0,0 +1,95 @@
+#pragma once
+// Included from Arduino.h (host simulation).
+
+class HardwareSerial;
+
+/*
+  SimSerialDevice
+
+  Whatever sits on the far side of a simulated UART (e.g. SimModbusBus).
+  onHostByte() is called for every byte the firmware writes, with the
+  simulated time at which its stop bit leaves the wire. The device answers
+  by calling HardwareSerial::inject() with future arrival times.
+*/
+class SimSerialDevice {
+public:
+  virtual ~SimSerialDevice() {}
+  virtual void onHostByte(HardwareSerial &port, uint8_t value, uint64_t doneUs) = 0;
+};
+
+/*
+  HardwareSerial (host simulation)
+
+  - write() schedules bytes at one character time each (start + data +
+    parity + stop bits at the configured baud); flush() advances the
+    virtual clock until the last byte is out, like a real TX drain.
+  - inject() queues bytes that become readable at their arrival time.
+  - A console port (Serial) prints to stdout or to an output hook.
+*/
+class HardwareSerial : public Stream {
+public:
+  static const size_t RX_QUEUE_SIZE = 2048;
+
+  explicit HardwareSerial(int uartNum = 0, bool console = false);
+
+  void begin(unsigned long baud, uint32_t config = SERIAL_8N1);
+  void begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin);
+  void end() {}
+  void setRxBufferSize(size_t) {}
+  void updateBaudRate(unsigned long baud) { _baud = baud; }
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t value) override;
+  using Print::write;
+  void flush() override;
+
+  operator bool() const { return true; }
+
+  // --- simulation side ---
+  void attach(SimSerialDevice *device) { _device = device; }
+  void inject(uint8_t value, uint64_t arrivalUs);
+  void clearRx();
+
+  void setConsoleEcho(bool enable) { _consoleEcho = enable; }
+  void setOutputHook(void (*hook)(char c)) { _outputHook = hook; }
+
+  unsigned long baud() const { return _baud; }
+  uint32_t charTimeUs() const;
+
+  uint32_t txBytes() const { return _txBytes; }
+  uint32_t rxBytes() const { return _rxBytes; }
+
+private:
+  struct RxByte {
+    uint8_t value;
+    uint64_t arrivalUs;
+  };
+
+  int _uartNum;
+  bool _console;
+  bool _consoleEcho;
+  void (*_outputHook)(char c);
+
+  unsigned long _baud;
+  uint32_t _config;
+  SimSerialDevice *_device;
+  uint64_t _txBusyUntilUs;
+
+  RxByte _rx[RX_QUEUE_SIZE];
+  size_t _rxHead;
+  size_t _rxCount;
+
+  uint32_t _txBytes;
+  uint32_t _rxBytes;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+extern HardwareSerial Serial3;
+
+#define HAVE_HWSERIAL1
+#define HAVE_HWSERIAL2
+#define HAVE_HWSERIAL3
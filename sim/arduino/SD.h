@@ -0,0 +1,33 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+  SD.h (host simulation)
+
+  Stub so StationLogger compiles in the native env. No card is present:
+  SD.begin() fails and open() returns a closed File, which is the same
+  path the logger takes on a station without an SD card.
+*/
+
+#define FILE_READ 0
+#define FILE_WRITE 1
+
+class File : public Print {
+public:
+  size_t write(uint8_t) override { return 0; }
+  using Print::write;
+  void flush() override {}
+  void close() {}
+  operator bool() const { return false; }
+};
+
+class SDClass {
+public:
+  bool begin(uint8_t = 0) { return false; }
+  File open(const char *, uint8_t = FILE_READ) { return File(); }
+  bool exists(const char *) { return false; }
+  bool remove(const char *) { return false; }
+  bool mkdir(const char *) { return false; }
+};
+
+extern SDClass SD;
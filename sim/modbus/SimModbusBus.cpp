@@ -0,0 +1,325 @@
+#include "SimModbusBus.h"
+#include "ModbusCrc16.h"
+
+// ============================================================================
+// Fault profiles
+// ============================================================================
+static SimFaults makeFaults(uint32_t latencyUs) {
+  SimFaults f;
+  memset(&f, 0, sizeof(f));
+  f.latencyUs = latencyUs;
+  return f;
+}
+
+SimFaults simFaultsClean() { return makeFaults(5000); }
+
+SimFaults simFaultsSlowSlave() {
+  SimFaults f = makeFaults(120000);
+  f.jitterUs = 80000;
+  return f;
+}
+
+SimFaults simFaultsEcho() {
+  SimFaults f = makeFaults(5000);
+  f.echo = true;
+  return f;
+}
+
+SimFaults simFaultsNoisy() {
+  SimFaults f = makeFaults(5000);
+  f.noisePercent = 30;
+  f.noiseMaxBytes = 8;
+  return f;
+}
+
+SimFaults simFaultsLossy() {
+  SimFaults f = makeFaults(5000);
+  f.dropPerMille = 10;
+  return f;
+}
+
+SimFaults simFaultsBadCrc() {
+  SimFaults f = makeFaults(5000);
+  f.badCrcPercent = 10;
+  return f;
+}
+
+SimFaults simFaultsSilent() {
+  SimFaults f = makeFaults(5000);
+  f.silentPercent = 10;
+  return f;
+}
+
+// ============================================================================
+// SimModbusSlave
+// ============================================================================
+SimModbusSlave::SimModbusSlave(uint8_t address)
+    : _address(address),
+      _maxRegsPerRead(125),
+      _silentOnError(false),
+      _online(true),
+      _busyReplies(0),
+      _processingUs(0),
+      _onRead(nullptr),
+      _baud(0),
+      _pendingBaud(0),
+      _baudProfile(nullptr),
+      _baudOnRestart(false),
+      _requests(0),
+      _exceptions(0) {
+  memset(_regs, 0, sizeof(_regs));
+  memset(_mapped, 0, sizeof(_mapped));
+}
+
+void SimModbusSlave::setRegister(uint16_t reg, uint16_t value) {
+  if (reg >= MAX_REGS) return;
+  _regs[reg] = value;
+  _mapped[reg] = true;
+}
+
+uint16_t SimModbusSlave::getRegister(uint16_t reg) const {
+  return (reg < MAX_REGS) ? _regs[reg] : 0;
+}
+
+bool SimModbusSlave::hasRegister(uint16_t reg) const {
+  return reg < MAX_REGS && _mapped[reg];
+}
+
+void SimModbusSlave::setBaudRegister(const ModbusBaudProfile *profile, bool applyOnRestart) {
+  _baudProfile = profile;
+  _baudOnRestart = applyOnRestart;
+  _pendingBaud = 0;
+
+  uint16_t code = 0;
+  if (profile && profile->valueFor(_baud, code)) setRegister(profile->reg, code);
+}
+
+void SimModbusSlave::restart() {
+  if (_pendingBaud != 0) _baud = _pendingBaud;
+  _pendingBaud = 0;
+}
+
+void SimModbusSlave::onReplySent() {
+  if (!_baudOnRestart) restart();
+}
+
+size_t SimModbusSlave::exception(uint8_t function, uint8_t code, uint8_t reply[]) {
+  ++_exceptions;
+  if (_silentOnError) return 0;
+  reply[0] = _address;
+  reply[1] = (uint8_t)(function | 0x80);
+  reply[2] = code;
+  return 3;
+}
+
+size_t SimModbusSlave::handle(const uint8_t request[], size_t requestLen, uint8_t reply[], size_t replyMax) {
+  if (requestLen < 8 || !_online) return 0;
+  ++_requests;
+
+  const uint8_t function = request[1];
+  const uint16_t reg = ((uint16_t)request[2] << 8) | request[3];
+  const uint16_t value = ((uint16_t)request[4] << 8) | request[5];
+
+  if (_busyReplies > 0) {
+    --_busyReplies;
+    return exception(function, 0x06, reply);
+  }
+
+  switch (function) {
+    case 0x03:
+    case 0x04: {
+      const uint16_t count = value;
+      if (count == 0 || count > _maxRegsPerRead || 3U + count * 2U > replyMax) {
+        return exception(function, 0x03, reply);
+      }
+      for (uint16_t i = 0; i < count; ++i) {
+        if (!hasRegister((uint16_t)(reg + i))) return exception(function, 0x02, reply);
+      }
+
+      if (_onRead) _onRead(*this);
+
+      reply[0] = _address;
+      reply[1] = function;
+      reply[2] = (uint8_t)(count * 2U);
+      for (uint16_t i = 0; i < count; ++i) {
+        const uint16_t v = _regs[reg + i];
+        reply[3 + i * 2] = (uint8_t)(v >> 8);
+        reply[4 + i * 2] = (uint8_t)(v & 0xFF);
+      }
+      return 3U + count * 2U;
+    }
+
+    case 0x06:
+      if (!hasRegister(reg)) return exception(function, 0x02, reply);
+      if (_baudProfile && reg == _baudProfile->reg) {
+        const uint32_t baud = _baudProfile->baudFor(value);
+        if (baud == 0) return exception(function, 0x03, reply);
+        _pendingBaud = baud;
+      }
+      _regs[reg] = value;
+      memcpy(reply, request, 6);
+      return 6;
+
+    default:
+      return exception(function, 0x01, reply);
+  }
+}
+
+// ============================================================================
+// SimModbusBus
+// ============================================================================
+SimModbusBus::SimModbusBus()
+    : _slaveCount(0),
+      _faults(simFaultsClean()),
+      _rng(0x12345678UL),
+      _reqLen(0),
+      _lastReqByteUs(0) {
+  memset(_slaves, 0, sizeof(_slaves));
+  resetStats();
+}
+
+void SimModbusBus::attach(HardwareSerial &port) {
+  port.attach(this);
+}
+
+bool SimModbusBus::addSlave(SimModbusSlave *slave) {
+  if (!slave || _slaveCount >= MAX_SLAVES) return false;
+  _slaves[_slaveCount++] = slave;
+  return true;
+}
+
+void SimModbusBus::resetStats() {
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+uint32_t SimModbusBus::random32() {
+  // xorshift32: fast, seedable, identical on every host
+  uint32_t x = _rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  _rng = x;
+  return x;
+}
+
+bool SimModbusBus::chance(uint32_t numerator, uint32_t denominator) {
+  if (numerator == 0) return false;
+  return (random32() % denominator) < numerator;
+}
+
+size_t SimModbusBus::expectedRequestLength(const uint8_t req[], size_t len) {
+  if (len < 2) return 0;
+  switch (req[1]) {
+    case 0x03:
+    case 0x04:
+    case 0x05:
+    case 0x06:
+      return 8;
+    case 0x10:
+    case 0x0F:
+      return (len >= 7) ? (size_t)(9 + req[6]) : 0;
+    default:
+      return 8;
+  }
+}
+
+void SimModbusBus::onHostByte(HardwareSerial &port, uint8_t value, uint64_t doneUs) {
+  if (_faults.echo) {
+    port.inject(value, doneUs);
+    ++_stats.echoedBytes;
+  }
+
+  // A t3.5 silence starts a new request.
+  const uint64_t gapUs = (uint64_t)port.charTimeUs() * 35U / 10U;
+  if (_reqLen > 0 && doneUs - _lastReqByteUs > gapUs + port.charTimeUs()) {
+    _stats.garbageBytes += (uint32_t)_reqLen;
+    _reqLen = 0;
+  }
+  _lastReqByteUs = doneUs;
+
+  if (_reqLen >= MAX_FRAME) {
+    _stats.garbageBytes += (uint32_t)_reqLen;
+    _reqLen = 0;
+  }
+  _req[_reqLen++] = value;
+
+  const size_t expected = expectedRequestLength(_req, _reqLen);
+  if (expected == 0 || _reqLen < expected) return;
+
+  const uint16_t crc = ModbusCrc16::compute(_req, expected - 2);
+  if (_req[expected - 2] == (uint8_t)(crc & 0xFF) && _req[expected - 1] == (uint8_t)(crc >> 8)) {
+    processRequest(port, expected, doneUs);
+    _reqLen = 0;
+    return;
+  }
+
+  // Not a frame: drop one byte and keep looking.
+  memmove(_req, _req + 1, _reqLen - 1);
+  --_reqLen;
+  ++_stats.garbageBytes;
+}
+
+void SimModbusBus::processRequest(HardwareSerial &port, size_t len, uint64_t doneUs) {
+  ++_stats.requests;
+
+  SimModbusSlave *slave = nullptr;
+  for (uint8_t i = 0; i < _slaveCount; ++i) {
+    if (_slaves[i]->address() == _req[0]) {
+      slave = _slaves[i];
+      break;
+    }
+  }
+
+  // At the wrong speed the slave only sees garbage.
+  if (slave && slave->baud() != 0 && slave->baud() != port.baud()) slave = nullptr;
+
+  uint8_t reply[MAX_FRAME];
+  const size_t replyLen = slave ? slave->handle(_req, len, reply, sizeof(reply) - 2) : 0;
+
+  if (replyLen == 0 || chance(_faults.silentPercent, 100)) {
+    ++_stats.unanswered;
+    return;
+  }
+
+  const uint16_t crc = ModbusCrc16::compute(reply, replyLen);
+  reply[replyLen] = (uint8_t)(crc & 0xFF);
+  reply[replyLen + 1] = (uint8_t)(crc >> 8);
+
+  if (chance(_faults.badCrcPercent, 100)) {
+    reply[replyLen + 1] ^= 0x5A;
+    ++_stats.corruptedCrcs;
+  }
+
+  uint64_t startUs = doneUs + _faults.latencyUs + slave->processingUs();
+  if (_faults.jitterUs > 0) {
+    startUs += random32() % (_faults.jitterUs + 1U);
+  }
+
+  sendReply(port, reply, replyLen + 2, startUs);
+  slave->onReplySent();
+}
+
+void SimModbusBus::sendReply(HardwareSerial &port, uint8_t reply[], size_t len, uint64_t startUs) {
+  const uint32_t charUs = port.charTimeUs();
+  uint64_t t = startUs;
+
+  if (_faults.noiseMaxBytes > 0 && chance(_faults.noisePercent, 100)) {
+    const uint32_t n = 1U + random32() % _faults.noiseMaxBytes;
+    for (uint32_t i = 0; i < n; ++i) {
+      t += charUs;
+      port.inject((uint8_t)random32(), t);
+      ++_stats.noiseBytes;
+    }
+  }
+
+  for (size_t i = 0; i < len; ++i) {
+    t += charUs;
+    if (chance(_faults.dropPerMille, 1000)) {
+      ++_stats.droppedBytes;
+      continue;
+    }
+    port.inject(reply[i], t);
+  }
+
+  ++_stats.replies;
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include <Arduino.h>
+#include "ModbusBaudTable.h"
+
+/*
+  SimModbusBus / SimModbusSlave
+
+  Scriptable Modbus RTU slaves behind a simulated UART, for the native env.
+
+    static SimModbusBus wire;
+    static SimModbusSlave leaf(0x80);
+    leaf.setRegister(0x0000, 455);      // 45.5 %RH
+    wire.addSlave(&leaf);
+    wire.attach(Serial2);               // firmware talks to Serial2 as usual
+
+  A slave can be pinned to a line speed (setBaud()): requests sent at any
+  other speed are not understood. With setBaudRegister() it also serves a
+  baud register like the real devices (ModbusBaudProfile): the write is
+  echoed at the old speed, then the slave switches, or only on restart()
+  for devices that apply it after a power cycle.
+
+  Supported functions: 0x03 / 0x04 read, 0x06 write single. Anything else,
+  an unmapped register or a read longer than maxRegsPerRead gets an
+  exception reply (or silence, if the slave is set to stay silent).
+
+  Line faults (SimFaults) are applied per reply, drawn from a seeded
+  PRNG so every run is reproducible:
+  - latency / jitter before the first reply byte
+  - echo of the request (transceiver without echo suppression)
+  - noise bytes before the reply
+  - per-byte drops
+  - wrong CRC
+  - no reply at all
+*/
+
+struct SimFaults {
+  uint32_t latencyUs;        // request end -> first reply byte
+  uint32_t jitterUs;         // extra random latency 0..jitterUs
+  bool echo;                 // request bytes are heard back
+  uint8_t noisePercent;      // chance a reply is preceded by noise
+  uint8_t noiseMaxBytes;     // 1..noiseMaxBytes random bytes
+  uint16_t dropPerMille;     // chance each reply byte is lost
+  uint8_t badCrcPercent;     // chance the reply CRC is corrupted
+  uint8_t silentPercent;     // chance the slave does not answer
+};
+
+// Ready-made fault profiles for benchmarks.
+SimFaults simFaultsClean();
+SimFaults simFaultsSlowSlave();
+SimFaults simFaultsEcho();
+SimFaults simFaultsNoisy();
+SimFaults simFaultsLossy();
+SimFaults simFaultsBadCrc();
+SimFaults simFaultsSilent();
+
+class SimModbusSlave {
+public:
+  static const uint16_t MAX_REGS = 512;
+
+  explicit SimModbusSlave(uint8_t address = 1);
+
+  uint8_t address() const { return _address; }
+  void setAddress(uint8_t address) { _address = address; }
+
+  void setRegister(uint16_t reg, uint16_t value);
+  uint16_t getRegister(uint16_t reg) const;
+  bool hasRegister(uint16_t reg) const;
+
+  // Longest 0x03/0x04 read the device accepts (default 125).
+  void setMaxRegsPerRead(uint16_t count) { _maxRegsPerRead = count; }
+  // Silent instead of an exception reply on errors.
+  void setSilentOnError(bool silent) { _silentOnError = silent; }
+  // Offline slaves ignore every request (unplugged / unpowered device).
+  void setOnline(bool online) { _online = online; }
+  bool online() const { return _online; }
+  // The next count requests get SLAVE DEVICE BUSY (0x06).
+  void setBusyReplies(uint8_t count) { _busyReplies = count; }
+
+  // Extra processing time of this device, added to the bus latency.
+  void setProcessingUs(uint32_t us) { _processingUs = us; }
+  uint32_t processingUs() const { return _processingUs; }
+
+  // Line speed the slave listens at; 0 = any (default).
+  void setBaud(uint32_t baud) { _baud = baud; }
+  uint32_t baud() const { return _baud; }
+  void setBaudRegister(const ModbusBaudProfile *profile, bool applyOnRestart = false);
+  // Power cycle: a baud written with applyOnRestart takes effect.
+  void restart();
+  // Called by SimModbusBus once a reply is on the wire.
+  void onReplySent();
+
+  // Called before each read is answered, e.g. to make values move.
+  void setOnRead(void (*hook)(SimModbusSlave &slave)) { _onRead = hook; }
+
+  // Builds the reply for one CRC-valid request. Returns its length
+  // (without CRC), 0 for no reply.
+  size_t handle(const uint8_t request[], size_t requestLen, uint8_t reply[], size_t replyMax);
+
+  uint32_t requests() const { return _requests; }
+  uint32_t exceptions() const { return _exceptions; }
+
+private:
+  uint8_t _address;
+  uint16_t _regs[MAX_REGS];
+  bool _mapped[MAX_REGS];
+  uint16_t _maxRegsPerRead;
+  bool _silentOnError;
+  bool _online;
+  uint8_t _busyReplies;
+  uint32_t _processingUs;
+  void (*_onRead)(SimModbusSlave &slave);
+  uint32_t _baud;
+  uint32_t _pendingBaud;
+  const ModbusBaudProfile *_baudProfile;
+  bool _baudOnRestart;
+
+  uint32_t _requests;
+  uint32_t _exceptions;
+
+  size_t exception(uint8_t function, uint8_t code, uint8_t reply[]);
+};
+
+class SimModbusBus : public SimSerialDevice {
+public:
+  static const uint8_t MAX_SLAVES = 16;
+  static const size_t MAX_FRAME = 260;
+
+  struct Stats {
+    uint32_t requests;      // CRC-valid requests seen
+    uint32_t replies;       // replies put on the wire
+    uint32_t unanswered;    // no slave at that address, or silent
+    uint32_t echoedBytes;
+    uint32_t noiseBytes;
+    uint32_t droppedBytes;
+    uint32_t corruptedCrcs;
+    uint32_t garbageBytes;  // request bytes that never formed a valid frame
+  };
+
+  SimModbusBus();
+
+  void attach(HardwareSerial &port);
+  bool addSlave(SimModbusSlave *slave);
+
+  void setFaults(const SimFaults &faults) { _faults = faults; }
+  const SimFaults &faults() const { return _faults; }
+  void seed(uint32_t seed) { _rng = seed ? seed : 1; }
+
+  const Stats &stats() const { return _stats; }
+  void resetStats();
+
+  void onHostByte(HardwareSerial &port, uint8_t value, uint64_t doneUs) override;
+
+private:
+  SimModbusSlave *_slaves[MAX_SLAVES];
+  uint8_t _slaveCount;
+  SimFaults _faults;
+  uint32_t _rng;
+  Stats _stats;
+
+  uint8_t _req[MAX_FRAME];
+  size_t _reqLen;
+  uint64_t _lastReqByteUs;
+
+  uint32_t random32();
+  bool chance(uint32_t numerator, uint32_t denominator);
+
+  static size_t expectedRequestLength(const uint8_t req[], size_t len);
+  void processRequest(HardwareSerial &port, size_t len, uint64_t doneUs);
+  void sendReply(HardwareSerial &port, uint8_t reply[], size_t len, uint64_t startUs);
+};
@@ -0,0 +1,60 @@
+#include "SimSensorProfiles.h"
+
+uint16_t simEncodeScaled(double value, double divisor, double offset) {
+  const double raw = (value - offset) * divisor;
+  const long rounded = (long)(raw < 0 ? raw - 0.5 : raw + 0.5);
+  return (uint16_t)(int16_t)rounded;
+}
+
+// ============================================================================
+// Rika
+// ============================================================================
+void simLoadRikaLeaf(SimModbusSlave &slave, double humidity, double temperature) {
+  slave.setRegister(0x0000, simEncodeScaled(humidity, 10.0));
+  slave.setRegister(0x0001, simEncodeScaled(temperature, 10.0));
+}
+
+void simLoadRikaSoil3in1(SimModbusSlave &slave, double temperature, double vwc, double ecDsM) {
+  slave.setRegister(0x0000, simEncodeScaled(temperature, 10.0));
+  slave.setRegister(0x0001, simEncodeScaled(vwc, 10.0));
+  slave.setRegister(0x0002, simEncodeScaled(ecDsM, 1000.0));
+  slave.setRegister(0x0005, 8000);  // epsilon x100, read with 0x04
+  slave.setRegister(0x0020, 0);     // soil type
+}
+
+// ============================================================================
+// JXBS
+// ============================================================================
+void simLoadJxbsSoil7in1(SimModbusSlave &slave,
+                         double moisture,
+                         double temperature,
+                         uint16_t ecUsCm,
+                         double ph,
+                         uint16_t nitrogen,
+                         uint16_t phosphorus,
+                         uint16_t potassium) {
+  // The batched read spans 0x0006..0x0020; the holes answer 0.
+  for (uint16_t reg = 0x0006; reg <= 0x0020; ++reg) {
+    slave.setRegister(reg, 0);
+  }
+  slave.setRegister(0x0006, simEncodeScaled(ph, 100.0));
+  slave.setRegister(0x0012, simEncodeScaled(moisture, 10.0));
+  slave.setRegister(0x0013, simEncodeScaled(temperature, 10.0));
+  slave.setRegister(0x0015, ecUsCm);
+  slave.setRegister(0x001E, nitrogen);
+  slave.setRegister(0x001F, phosphorus);
+  slave.setRegister(0x0020, potassium);
+  slave.setRegister(0x0100, slave.address());
+}
+
+void simLoadJxbsLeafSurface(SimModbusSlave &slave, double humidity, double temperature) {
+  slave.setRegister(0x0020, simEncodeScaled(humidity, 10.0));
+  slave.setRegister(0x0021, simEncodeScaled(temperature, 100.0));
+  slave.setRegister(0x0100, slave.address());
+}
+
+void simLoadJxbsLiquidPH(SimModbusSlave &slave, double temperature, double ph) {
+  slave.setRegister(0x0001, simEncodeScaled(temperature, 10.0));
+  slave.setRegister(0x0002, simEncodeScaled(ph, 100.0));
+  slave.setRegister(0x0100, slave.address());
+}
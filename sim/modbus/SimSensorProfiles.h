@@ -0,0 +1,59 @@
+#pragma once
+#include <Arduino.h>
+#include "SimModbusBus.h"
+#include "ModbusRegisterMap.h"
+
+/*
+  SimSensorProfiles
+
+  Register images of the sensors this firmware drives, in engineering
+  units. Scaling matches the drivers and docs/protocols/.
+
+    static SimModbusSlave leaf(0x80);
+    simLoadRikaLeaf(leaf, 45.5, 21.3);
+
+  simLoadMap() fills any ModbusRegisterMap (ModbusSensorMaps.h) from one
+  value per field, so ModbusTableSensor devices need no hand-written
+  profile.
+*/
+
+void simLoadRikaLeaf(SimModbusSlave &slave, double humidity, double temperature);
+void simLoadRikaSoil3in1(SimModbusSlave &slave, double temperature, double vwc, double ecDsM);
+void simLoadJxbsSoil7in1(SimModbusSlave &slave,
+                         double moisture,
+                         double temperature,
+                         uint16_t ecUsCm,
+                         double ph,
+                         uint16_t nitrogen,
+                         uint16_t phosphorus,
+                         uint16_t potassium);
+void simLoadJxbsLeafSurface(SimModbusSlave &slave, double humidity, double temperature);
+void simLoadJxbsLiquidPH(SimModbusSlave &slave, double temperature, double ph);
+
+// Raw register word for value = raw / divisor + offset.
+uint16_t simEncodeScaled(double value, double divisor, double offset = 0.0);
+
+template <size_t N>
+void simLoadMap(SimModbusSlave &slave, const ModbusRegisterMap<N> &map, const double values[N]) {
+  // Whole block readable, holes read as 0 like most devices.
+  for (uint16_t i = 0; i < map.count; ++i) {
+    slave.setRegister((uint16_t)(map.start + i), 0);
+  }
+
+  for (size_t i = 0; i < N; ++i) {
+    const ModbusFieldSpec &f = map.fields[i];
+    const double divisor = (double)FixedSample::pow10(f.decimals);
+    const double offset = (double)f.offset / divisor;
+    const double raw = (values[i] - offset) * divisor;
+
+    if (f.registerCount() == 2) {
+      const uint32_t word = (f.type == MODBUS_FIELD_S32)
+                                ? (uint32_t)(int32_t)(raw < 0 ? raw - 0.5 : raw + 0.5)
+                                : (uint32_t)(raw + 0.5);
+      slave.setRegister(f.reg, (uint16_t)(word >> 16));
+      slave.setRegister((uint16_t)(f.reg + 1), (uint16_t)(word & 0xFFFF));
+    } else {
+      slave.setRegister(f.reg, simEncodeScaled(values[i], divisor, offset));
+    }
+  }
+}
@@ -6,28 +6,56 @@
 
 #include "PrintController.h"
 #include "RS485Modbus.h"
+#include "ModbusBaudNegotiator.h"
 #include "RikaLeafSensor.h"
 #include "RikaSoilSensor3in1.h"
+#include "ReadScheduler.h"
+#include "SleepPlanner.h"
+#if TECHNICIAN_CLI_ENABLE
+  #include "TechnicianCLI.h"
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32)
+  #include <driver/gpio.h>
+#endif
 
 // ============================================================
 // Debug port
 // ============================================================
 #if defined(ARDUINO_ARCH_ESP32)
 HardwareSerial& DebugPort = Serial0;   // same UART side as upload bridge
-HardwareSerial RS485Hw0(1);
 #else
 #define DebugPort Serial
 #endif
 
 static PrintController printer(DebugPort, false);
-static RS485Bus rs485Bus0;
+
+#if TECHNICIAN_CLI_ENABLE
+static TechnicianCLI g_cli(DebugPort);
+#endif
+
+// ============================================================
+// RS485 buses: one per PCB port, each on its own UART, so the
+// scheduler can poll the ports at the same time
+// ============================================================
+static RS485Bus rs485Buses[PCB_RS485_PORT_COUNT];
+#if RS485_TRACE_ENABLE
+static ModbusTraceRing rs485Traces[PCB_RS485_PORT_COUNT];
+#endif
+
+#ifdef RIKA_LEAF_00_ENABLED
+static_assert(RIKA_LEAF_00_RS485_PORT < PCB_RS485_PORT_COUNT, "leaf_00 RS485 port not on this PCB");
+#endif
+#ifdef RIKA_SOIL3IN1_00_ENABLED
+static_assert(RIKA_SOIL3IN1_00_RS485_PORT < PCB_RS485_PORT_COUNT, "soil_00 RS485 port not on this PCB");
+#endif
 
 // ============================================================
 // Sensor object creation from station configuration
 // ============================================================
 #ifdef RIKA_LEAF_00_ENABLED
 static RikaLeafSensor sensor_leaf_00(
-    rs485Bus0,
+    rs485Buses[RIKA_LEAF_00_RS485_PORT],
     RIKA_LEAF_00_ID,
     RIKA_LEAF_00_ADDRESS,
     RIKA_LEAF_00_DEBUG,
@@ -41,7 +69,7 @@ static RikaLeafSensor sensor_leaf_00(
 
 #ifdef RIKA_SOIL3IN1_00_ENABLED
 static RikaSoilSensor3in1 sensor_soil_00(
-    rs485Bus0,
+    rs485Buses[RIKA_SOIL3IN1_00_RS485_PORT],
     RIKA_SOIL3IN1_00_ID,
     RIKA_SOIL3IN1_00_ADDRESS,
     RIKA_SOIL3IN1_00_DEBUG,
@@ -64,10 +92,34 @@ static SensorDriver* g_sensors[] = {
 
 static const size_t g_sensorCount = sizeof(g_sensors) / sizeof(g_sensors[0]);
 
+// ============================================================
+// Burst oversampling (<SENSOR>_BURST_READS > 1)
+// ============================================================
+#if defined(RIKA_LEAF_00_ENABLED) && RIKA_LEAF_00_BURST_READS > 1
+static SensorBurst burst_leaf_00;
+#endif
+#if defined(RIKA_SOIL3IN1_00_ENABLED) && RIKA_SOIL3IN1_00_BURST_READS > 1
+static SensorBurst burst_soil_00;
+#endif
+
+static void initSensorBursts() {
+#if defined(RIKA_LEAF_00_ENABLED) && RIKA_LEAF_00_BURST_READS > 1
+  sensor_leaf_00.setBurst(&burst_leaf_00, RIKA_LEAF_00_BURST_READS);
+#endif
+#if defined(RIKA_SOIL3IN1_00_ENABLED) && RIKA_SOIL3IN1_00_BURST_READS > 1
+  sensor_soil_00.setBurst(&burst_soil_00, RIKA_SOIL3IN1_00_BURST_READS);
+#endif
+}
+
 // ============================================================
 // Runtime power/interface state tracking
 // ============================================================
 static bool g_powerLineState[PCB_POWERLINE_COUNT] = {false};
+
+#if defined(ARDUINO_ARCH_ESP32)
+// Power lines latched ON through deep sleep (keepPowerOn policy)
+RTC_DATA_ATTR static bool g_rtcPowerLineHeld[PCB_POWERLINE_COUNT] = {false};
+#endif
 static bool g_rs485InterfaceState[PCB_RS485_PORT_COUNT] = {false};
 
 // ============================================================
@@ -80,6 +132,34 @@ struct ReadPlanEntry {
 static ReadPlanEntry g_readPlan[16];
 static size_t g_readPlanCount = 0;
 
+static SleepPlanner g_sleepPlanner(SLEEP_LIGHT_MIN_MS,
+                                   SLEEP_DEEP_MIN_MS,
+                                   SLEEP_WAKE_MARGIN_MS);
+
+// ============================================================
+// State kept through deep sleep, next to the schedule
+// (SleepPlanner::retain; same order on every boot)
+// ============================================================
+static void retainDeepSleepState() {
+  for (uint8_t i = 0; i < PCB_RS485_PORT_COUNT; ++i) {
+    g_sleepPlanner.retain(&rs485Buses[i].latency(), sizeof(ModbusLatencyTracker));
+    g_sleepPlanner.retain(&rs485Buses[i].stats(), sizeof(ModbusBusStats), ModbusBusStats::rebase);
+  }
+  for (size_t i = 0; i < g_sensorCount; ++i) {
+    size_t bytes = 0;
+    void* states = g_sensors[i]->filterStates(bytes);
+    if (states) g_sleepPlanner.retain(states, bytes, SampleFilter::rebaseStates);
+  }
+  // A keep-powered burst spreads its reads over the interval, with deep
+  // sleeps in between.
+#if defined(RIKA_LEAF_00_ENABLED) && RIKA_LEAF_00_BURST_READS > 1
+  g_sleepPlanner.retain(&burst_leaf_00, sizeof(burst_leaf_00));
+#endif
+#if defined(RIKA_SOIL3IN1_00_ENABLED) && RIKA_SOIL3IN1_00_BURST_READS > 1
+  g_sleepPlanner.retain(&burst_soil_00, sizeof(burst_soil_00));
+#endif
+}
+
 // ============================================================
 // Helpers
 // ============================================================
@@ -97,16 +177,46 @@ static void printBanner() {
 
 static void initPowerLines() {
   for (uint8_t i = 0; i < PCB_POWERLINE_COUNT; ++i) {
+    bool on = false;
+#if defined(ARDUINO_ARCH_ESP32)
+    // A line held through deep sleep stays ON: set the level before
+    // releasing the hold so the sensors see no glitch.
+    on = g_sleepPlanner.wokeFromDeepSleep() && g_rtcPowerLineHeld[i];
+    g_rtcPowerLineHeld[i] = false;
+#endif
+
     const int8_t pin = PCB_POWERLINE_SWITCH_PINS[i];
     if (pin >= 0) {
       pinMode(pin, OUTPUT);
       const bool activeHigh = PCB_POWERLINE_ACTIVE_HIGH[i];
-      digitalWrite(pin, activeHigh ? LOW : HIGH); // OFF state
+      digitalWrite(pin, on ? (activeHigh ? HIGH : LOW)
+                           : (activeHigh ? LOW  : HIGH));
+#if defined(ARDUINO_ARCH_ESP32)
+      gpio_hold_dis((gpio_num_t)pin);
+#endif
     }
-    g_powerLineState[i] = false;
+    g_powerLineState[i] = on;
   }
 }
 
+// Latches power lines that stay ON so deep sleep does not float their pins.
+static void holdPowerLinesForDeepSleep() {
+#if defined(ARDUINO_ARCH_ESP32)
+  bool anyHeld = false;
+  for (uint8_t i = 0; i < PCB_POWERLINE_COUNT; ++i) {
+    const int8_t pin = PCB_POWERLINE_SWITCH_PINS[i];
+    g_rtcPowerLineHeld[i] = g_powerLineState[i] && PCB_POWERLINE_CAN_STAY_ON_IN_SLEEP[i];
+    if (pin >= 0) {
+      gpio_hold_en((gpio_num_t)pin);
+      anyHeld = true;
+    }
+  }
+  if (anyHeld) {
+    gpio_deep_sleep_hold_en();
+  }
+#endif
+}
+
 static void initInterfaces() {
   for (uint8_t i = 0; i < PCB_RS485_PORT_COUNT; ++i) {
     const int8_t enPin = PCB_RS485_ENABLE_PINS[i];
@@ -119,6 +229,95 @@ static void initInterfaces() {
   }
 }
 
+static HardwareSerial* rs485SerialForUart(uint8_t uartNum) {
+#if defined(ARDUINO_ARCH_ESP32)
+  static HardwareSerial uart1(1);
+  static HardwareSerial uart2(2);
+  if (uartNum == 1) return &uart1;
+  if (uartNum == 2) return &uart2;
+#else
+#if defined(HAVE_HWSERIAL1)
+  if (uartNum == 1) return &Serial1;
+#endif
+#if defined(HAVE_HWSERIAL2)
+  if (uartNum == 2) return &Serial2;
+#endif
+#if defined(HAVE_HWSERIAL3)
+  if (uartNum == 3) return &Serial3;
+#endif
+#endif
+  return nullptr;
+}
+
+static void initRS485Buses() {
+  for (uint8_t i = 0; i < PCB_RS485_PORT_COUNT; ++i) {
+    HardwareSerial* serial = rs485SerialForUart(PCB_RS485_UART_NUMS[i]);
+    if (!serial) {
+      printer.print(F("[MAIN] No UART for RS485 port "), true);
+      printer.println((unsigned int)i, true);
+      continue;
+    }
+
+    rs485Buses[i].setDebug(&printer);
+#if RS485_TRACE_ENABLE
+    rs485Buses[i].setTrace(&rs485Traces[i], i);
+#endif
+#if defined(ARDUINO_ARCH_ESP32)
+    rs485Buses[i].begin(*serial,
+                        RS485_DEFAULT_BAUD,
+                        PCB_RS485_RX_PINS[i],
+                        PCB_RS485_TX_PINS[i],
+                        RS485_DEFAULT_SERIAL_CONFIG);
+#if RS485_UART_HALF_DUPLEX
+    if (rs485Buses[i].setUartHalfDuplex(PCB_RS485_UART_NUMS[i],
+                                        PCB_RS485_DE_PINS[i],
+                                        PCB_RS485_DE_ACTIVE_HIGH[i])) {
+      continue;
+    }
+    printer.print(F("[MAIN] UART half-duplex rejected, GPIO DE on port "), true);
+    printer.println((unsigned int)i, true);
+#endif
+    rs485Buses[i].setDirectionControl(PCB_RS485_DE_PINS[i],
+                                      PCB_RS485_DE_ACTIVE_HIGH[i]);
+#else
+    rs485Buses[i].begin(*serial, RS485_DEFAULT_BAUD, -1, -1, RS485_DEFAULT_SERIAL_CONFIG);
+#endif
+  }
+}
+
+// ============================================================
+// Per-sensor line speeds: a sensor is expected at its
+// configured baud and tried at the default when silent there,
+// so a fresh sensor is found, then upgraded after a good read
+// ============================================================
+static void configureSensorBaud(RS485Bus& bus,
+                                uint8_t address,
+                                uint32_t baud,
+                                const ModbusBaudProfile* profile) {
+  if (baud == RS485_DEFAULT_BAUD) return;
+#if RS485_BAUD_NEGOTIATE
+  const bool ok = bus.bauds().configure(address, baud, RS485_DEFAULT_BAUD, baud, profile);
+#else
+  (void)profile;
+  const bool ok = bus.bauds().configure(address, baud, RS485_DEFAULT_BAUD);
+#endif
+  if (!ok) {
+    printer.print(F("[MAIN] Baud table full, default baud for 0x"), true);
+    printer.println((unsigned char)address, true, "", HEX);
+  }
+}
+
+static void initSensorBauds() {
+#ifdef RIKA_LEAF_00_ENABLED
+  configureSensorBaud(rs485Buses[RIKA_LEAF_00_RS485_PORT], RIKA_LEAF_00_ADDRESS,
+                      RIKA_LEAF_00_BAUD, &MODBUS_BAUD_PROFILE_RIKA);
+#endif
+#ifdef RIKA_SOIL3IN1_00_ENABLED
+  configureSensorBaud(rs485Buses[RIKA_SOIL3IN1_00_RS485_PORT], RIKA_SOIL3IN1_00_ADDRESS,
+                      RIKA_SOIL3IN1_00_BAUD, &MODBUS_BAUD_PROFILE_RIKA);
+#endif
+}
+
 static void powerLineSet(uint8_t index, bool on) {
   if (index >= PCB_POWERLINE_COUNT) return;
 
@@ -160,40 +359,6 @@ static void rs485InterfaceSet(uint8_t index, bool on) {
   g_rs485InterfaceState[index] = on;
 }
 
-static bool hasPlannedSensorInGroup(uint8_t powerLine, uint8_t interfaceIndex) {
-  for (size_t i = 0; i < g_readPlanCount; ++i) {
-    if (g_readPlan[i].sensor->getPowerLineIndex() == powerLine &&
-        g_readPlan[i].sensor->getInterfaceIndex() == interfaceIndex) {
-      return true;
-    }
-  }
-  return false;
-}
-
-static bool hasPlannedSensorOnPowerLine(uint8_t powerLine) {
-  for (size_t i = 0; i < g_readPlanCount; ++i) {
-    if (g_readPlan[i].sensor->getPowerLineIndex() == powerLine) {
-      return true;
-    }
-  }
-  return false;
-}
-
-static uint32_t getMaxWarmupForPowerLine(uint8_t powerLine) {
-  uint32_t maxWarmup = 0;
-
-  for (size_t i = 0; i < g_readPlanCount; ++i) {
-    SensorDriver* sensor = g_readPlan[i].sensor;
-    if (sensor->getPowerLineIndex() == powerLine) {
-      if (sensor->getWarmUpTimeMs() > maxWarmup) {
-        maxWarmup = sensor->getWarmUpTimeMs();
-      }
-    }
-  }
-
-  return maxWarmup;
-}
-
 static bool powerLineShouldStayOn(uint8_t powerLine) {
   if (powerLine >= PCB_POWERLINE_COUNT) return false;
   if (!PCB_POWERLINE_CAN_STAY_ON_IN_SLEEP[powerLine]) return false;
@@ -225,6 +390,8 @@ static void printSensorMap() {
     printer.print((unsigned int)s->getSampleRateMin(), true, " | ");
     printer.print(F("WarmUpMs="), true);
     printer.print((unsigned long)s->getWarmUpTimeMs(), true, " | ");
+    printer.print(F("Burst="), true);
+    printer.print((unsigned int)s->getBurstReads(), true, " | ");
     printer.print(F("KeepOn="), true);
     printer.println(s->shouldKeepPowerOn() ? F("true") : F("false"), true);
   }
@@ -285,9 +452,9 @@ static void printReadResult(SensorDriver* sensor, bool ok) {
       printer.print(F("[DATA] "), true);
       printer.print(sensor_leaf_00.getSensorId(), true, " | ");
       printer.print(F("Temp="), true);
-      printer.print(sensor_leaf_00.leaf_temp, true, " C | ", 1);
+      printer.printFixed(sensor_leaf_00.leaf_temp.raw, sensor_leaf_00.leaf_temp.decimals, true, " C | ");
       printer.print(F("Hum="), true);
-      printer.print(sensor_leaf_00.leaf_humid, true, " %", 1);
+      printer.printFixed(sensor_leaf_00.leaf_humid.raw, sensor_leaf_00.leaf_humid.decimals, true, " %");
       printer.println("", true);
     } else {
       printer.print(F("[DATA] Read fail: "), true);
@@ -304,11 +471,11 @@ static void printReadResult(SensorDriver* sensor, bool ok) {
       printer.print(F("[DATA] "), true);
       printer.print(sensor_soil_00.getSensorId(), true, " | ");
       printer.print(F("Temp="), true);
-      printer.print(sensor_soil_00.soil_temp, true, " C | ", 1);
+      printer.printFixed(sensor_soil_00.soil_temp.raw, sensor_soil_00.soil_temp.decimals, true, " C | ");
       printer.print(F("VWC="), true);
-      printer.print(sensor_soil_00.soil_vwc, true, " % | ", 1);
+      printer.printFixed(sensor_soil_00.soil_vwc.raw, sensor_soil_00.soil_vwc.decimals, true, " % | ");
       printer.print(F("EC="), true);
-      printer.print(sensor_soil_00.soil_ec, true, " mS/cm", 4);
+      printer.printFixed(sensor_soil_00.soil_ec.raw, sensor_soil_00.soil_ec.decimals, true, " mS/cm");
       printer.println("", true);
     } else {
       printer.print(F("[DATA] Read fail: "), true);
@@ -320,75 +487,147 @@ static void printReadResult(SensorDriver* sensor, bool ok) {
 #endif
 }
 
-static void executeReadPlan() {
-  if (g_readPlanCount == 0) return;
+// ============================================================
+// Scheduler hooks (hardware access stays here)
+// ============================================================
+static uint32_t rs485InterfaceEnableDelayMs(uint8_t index) {
+  if (index >= PCB_RS485_PORT_COUNT) return 0;
+  return PCB_RS485_ENABLE_DELAY_MS[index];
+}
 
-  for (uint8_t powerLine = 0; powerLine < PCB_POWERLINE_COUNT; ++powerLine) {
-    if (!hasPlannedSensorOnPowerLine(powerLine)) {
-      continue;
-    }
+static void printBurstSummary(SensorDriver* sensor, bool ok) {
+  const SensorBurst* burst = sensor->getBurst();
+  if (!ok || !burst || burst->running()) return;
 
-    printer.println(F("============================================================"), true);
-    printer.print(F("[EXEC] PowerLine "), true);
-    printer.print((unsigned int)powerLine, true, " | Voltage=");
-    printer.print((unsigned int)PCB_POWERLINE_VOLTAGES[powerLine], true, " V");
-    printer.println("", true);
+  char line[SENSOR_BURST_MAX_FIELDS * 64];
+  burst->format(line, sizeof(line));
 
-    if (!powerLineReadState(powerLine)) {
-      printer.println(F("[EXEC] PowerLine is OFF -> enabling"), true);
-      powerLineSet(powerLine, true);
-    } else {
-      printer.println(F("[EXEC] PowerLine already ON"), true);
-    }
+  printer.print(F("[BURST] "), true);
+  printer.print(sensor->getSensorId(), true, " | ");
+  printer.println(line, true);
+}
 
-    const uint32_t warmupMs = getMaxWarmupForPowerLine(powerLine);
-    if (warmupMs > 0) {
-      printer.print(F("[EXEC] Warm-up on this power line = "), true);
-      printer.print((unsigned long)warmupMs, true, " ms");
-      printer.println("", true);
-      delay(warmupMs);
-    }
+static void onSensorRead(SensorDriver* sensor, bool ok) {
+  printReadResult(sensor, ok);
+  printBurstSummary(sensor, ok);
 
-    for (uint8_t iface = 0; iface < PCB_RS485_PORT_COUNT; ++iface) {
-      if (!hasPlannedSensorInGroup(powerLine, iface)) {
-        continue;
-      }
+#if RS485_BAUD_NEGOTIATE
+  // The sensor is powered and its bus idle: move it to its configured
+  // speed if it is not there yet (once per boot).
+  const uint8_t port = sensor->getInterfaceIndex();
+  if (ok && port < PCB_RS485_PORT_COUNT) {
+    ModbusBaudNegotiator::upgradeIfDue(rs485Buses[port], sensor->getAddress(), sensor->getDebug());
+  }
+#endif
+}
 
-      printer.print(F("[EXEC] Interface "), true);
-      printer.println((unsigned int)iface, true);
+static uint32_t powerLineInrushMs(uint8_t index) {
+  if (index >= PCB_POWERLINE_COUNT) return 0;
+  return PCB_POWERLINE_INRUSH_MS[index];
+}
 
-      rs485InterfaceSet(iface, true);
+static RS485Bus* busForInterface(uint8_t index) {
+  if (index >= PCB_RS485_PORT_COUNT) return nullptr;
+  return &rs485Buses[index];
+}
 
-      if (PCB_RS485_ENABLE_DELAY_MS[iface] > 0) {
-        delay(PCB_RS485_ENABLE_DELAY_MS[iface]);
-      }
+static const ReadSchedulerHooks g_schedulerHooks = {
+  powerLineSet,
+  powerLineReadState,
+  powerLineShouldStayOn,
+  rs485InterfaceSet,
+  rs485InterfaceEnableDelayMs,
+  onSensorRead,
+  powerLineInrushMs,
+  busForInterface
+};
 
-      for (size_t i = 0; i < g_readPlanCount; ++i) {
-        SensorDriver* s = g_readPlan[i].sensor;
+static ReadScheduler g_scheduler(g_schedulerHooks);
 
-        if (s->getPowerLineIndex() != powerLine) continue;
-        if (s->getInterfaceIndex() != iface) continue;
+static void startReadPlan(uint32_t nowMs) {
+  SensorDriver* sensors[sizeof(g_readPlan) / sizeof(g_readPlan[0])];
+  for (size_t i = 0; i < g_readPlanCount; ++i) {
+    sensors[i] = g_readPlan[i].sensor;
+  }
+  g_scheduler.start(sensors, g_readPlanCount, nowMs);
+}
 
-        printer.println(F("------------------------------------------------------------"), true);
-        printer.print(F("[EXEC] Reading sensor: "), true);
-        printer.println(s->getSensorId(), true);
+// ============================================================
+// Technician CLI
+// ============================================================
+#if TECHNICIAN_CLI_ENABLE
+static bool readCycleBusy() {
+  return g_scheduler.busy();
+}
 
-        const bool ok = s->readData();
-        printReadResult(s, ok);
-      }
+// Lines and interfaces the CLI switched on for a scan (bit per index)
+static uint16_t g_cliPoweredLines = 0;
+static uint8_t g_cliEnabledPorts = 0;
+static_assert(PCB_POWERLINE_COUNT <= 16 && PCB_RS485_PORT_COUNT <= 8, "CLI power masks too small");
 
-      rs485InterfaceSet(iface, false);
-    }
+static uint32_t cliPortPowerUp(uint8_t port) {
+  if (port >= PCB_RS485_PORT_COUNT) return 0;
 
-    if (!powerLineShouldStayOn(powerLine)) {
-      printer.println(F("[EXEC] PowerLine can be turned OFF"), true);
-      powerLineSet(powerLine, false);
-    } else {
-      printer.println(F("[EXEC] PowerLine stays ON due to keepPowerOn policy"), true);
+  uint32_t waitMs = 0;
+  for (size_t i = 0; i < g_sensorCount; ++i) {
+    const SensorDriver* s = g_sensors[i];
+    const uint8_t line = s->getPowerLineIndex();
+    if (s->getInterfaceIndex() != port || line >= PCB_POWERLINE_COUNT) continue;
+
+    if (!(g_cliPoweredLines & (1U << line)) && !powerLineReadState(line)) {
+      powerLineSet(line, true);
+      g_cliPoweredLines |= (uint16_t)(1U << line);
+      delay(powerLineInrushMs(line));  // one line at a time, as in a cycle
     }
+    if ((g_cliPoweredLines & (1U << line)) && s->getWarmUpTimeMs() > waitMs) {
+      waitMs = s->getWarmUpTimeMs();
+    }
+  }
 
-    printer.println(F(""), true);
+  if (!g_rs485InterfaceState[port]) {
+    rs485InterfaceSet(port, true);
+    g_cliEnabledPorts |= (uint8_t)(1U << port);
+    if (rs485InterfaceEnableDelayMs(port) > waitMs) waitMs = rs485InterfaceEnableDelayMs(port);
+  }
+  return waitMs;
+}
+
+static void cliPortPowerRestore(uint8_t port) {
+  if (port < PCB_RS485_PORT_COUNT && (g_cliEnabledPorts & (1U << port))) {
+    rs485InterfaceSet(port, false);
+    g_cliEnabledPorts &= (uint8_t)~(1U << port);
+  }
+  for (uint8_t line = 0; line < PCB_POWERLINE_COUNT; ++line) {
+    if (g_cliPoweredLines & (1U << line)) powerLineSet(line, false);
   }
+  g_cliPoweredLines = 0;
+}
+
+static const TechnicianBusHooks g_cliBusHooks = {
+  readCycleBusy,
+  cliPortPowerUp,
+  cliPortPowerRestore
+};
+#endif
+
+static void initTechnicianCLI() {
+#if TECHNICIAN_CLI_ENABLE
+  g_cli.setPassphrase(TECHNICIAN_CLI_PASSPHRASE);
+  g_cli.attachBuses(rs485Buses, PCB_RS485_PORT_COUNT);
+  g_cli.attachBusHooks(&g_cliBusHooks);
+#endif
+}
+
+// Sleep would cut the technician off: UART input is lost in ESP32 light
+// sleep, and a deep sleep reboots into a locked CLI.
+static bool technicianHoldsStationAwake(uint32_t nowMs) {
+#if TECHNICIAN_CLI_ENABLE
+  if (g_cli.isAuthenticated()) return true;
+  return !g_sleepPlanner.wokeFromDeepSleep() && nowMs < TECHNICIAN_CLI_WINDOW_MS;
+#else
+  (void)nowMs;
+  return false;
+#endif
 }
 
 void setup() {
@@ -396,32 +635,58 @@ void setup() {
   delay(300);
 
   printBanner();
+
+  g_sleepPlanner.setDebug(&printer, true);
+  g_sleepPlanner.onBeforeDeepSleep(holdPowerLinesForDeepSleep);
+  retainDeepSleepState();
+  g_sleepPlanner.restore(g_sensors, g_sensorCount);
+
   initPowerLines();
   initInterfaces();
 
-#if defined(ARDUINO_ARCH_ESP32)
-  rs485Bus0.setDebug(&printer);
-  rs485Bus0.begin(RS485Hw0,
-                  RS485_DEFAULT_BAUD,
-                  PCB_RS485_RX_PINS[RS485_PORT_INDEX_0],
-                  PCB_RS485_TX_PINS[RS485_PORT_INDEX_0],
-                  RS485_DEFAULT_SERIAL_CONFIG);
-  rs485Bus0.setDirectionControl(PCB_RS485_DE_PINS[RS485_PORT_INDEX_0],
-                                PCB_RS485_DE_ACTIVE_HIGH[RS485_PORT_INDEX_0]);
-#else
-  rs485Bus0.setDebug(&printer);
-  rs485Bus0.begin(Serial2, RS485_DEFAULT_BAUD, -1, -1, RS485_DEFAULT_SERIAL_CONFIG);
-#endif
+  initRS485Buses();
+  initSensorBauds();
+
+  g_scheduler.setDebug(&printer, true);
+  g_scheduler.setReadBudget(SENSOR_TRANSACTION_BUDGET_MS,
+                            SENSOR_TRANSACTION_MAX_ATTEMPTS,
+                            READ_CYCLE_BUDGET_MS);
+  g_scheduler.setBurstGap(SENSOR_BURST_GAP_MS);
+  initSensorBursts();
+  initTechnicianCLI();
 
   printSensorMap();
 }
 
 void loop() {
+#if TECHNICIAN_CLI_ENABLE
+  g_cli.update();
+#endif
+
   const uint32_t nowMs = millis();
 
-  buildReadPlan(nowMs);
-  printDuePlan();
-  executeReadPlan();
+  // Plan a new cycle only when the previous one has finished, so a sensor is
+  // never queued twice. Nothing here waits; tick() resumes pending steps.
+  if (!g_scheduler.busy() &&
+      g_sleepPlanner.msUntilNextDue(g_sensors, g_sensorCount, nowMs) == 0) {
+    if (buildReadPlan(nowMs) > 0) {
+      printDuePlan();
+      startReadPlan(nowMs);
+    }
+  }
+
+  g_scheduler.tick(millis());
+
+  // Sleep until the next step: light sleep inside a cycle (warm-ups, port
+  // settle), deep sleep between sample slots.
+  const uint32_t afterTickMs = millis();
+  if (technicianHoldsStationAwake(afterTickMs)) return;
 
-  delay(1000);
-}
\ No newline at end of file
+  if (g_scheduler.busy()) {
+    g_sleepPlanner.sleepFor(g_scheduler.msUntilNextStep(afterTickMs),
+                            g_sensors, g_sensorCount, false);
+  } else {
+    g_sleepPlanner.sleepFor(g_sleepPlanner.msUntilNextDue(g_sensors, g_sensorCount, afterTickMs),
+                            g_sensors, g_sensorCount, STATION_DEEP_SLEEP);
+  }
+}
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""Flash and RAM cost of the sample decode on the Mega 2560.
+
+Builds the RS485Benchmark_Example decode probe twice, once linking only
+the FixedSample decode and once only the former double decode, and
+prints avr-size of both with the difference. Everything else in the two
+builds is the same, so the difference is the decode path itself
+(soft-float routines included).
+
+Usage:
+    flash_compare.py              # pio run both envs, then compare
+    flash_compare.py --no-build   # compare the last builds
+
+Run from anywhere inside the repository; needs PlatformIO (pio) with the
+atmelavr platform installed.
+"""
+
+import os
+import shutil
+import subprocess
+import sys
+
+ENVS = (
+    ("FixedSample", "rs485_decode_probe_fixed_mega2560"),
+    ("double", "rs485_decode_probe_double_mega2560"),
+)
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def find_avr_size():
+    tool = shutil.which("avr-size")
+    if tool:
+        return tool
+    home = os.environ.get("PLATFORMIO_CORE_DIR", os.path.expanduser("~/.platformio"))
+    tool = os.path.join(home, "packages", "toolchain-atmelavr", "bin", "avr-size")
+    if os.path.exists(tool):
+        return tool
+    sys.exit("avr-size not found: install the atmelavr platform (pio pkg install -p atmelavr)")
+
+
+def build(env):
+    subprocess.run(["pio", "run", "-e", env], cwd=ROOT, check=True,
+                   stdout=subprocess.DEVNULL)
+
+
+def size(avr_size, env):
+    elf = os.path.join(ROOT, ".pio", "build", env, "firmware.elf")
+    if not os.path.exists(elf):
+        sys.exit("%s not built (run without --no-build)" % env)
+    out = subprocess.run([avr_size, "-A", elf], check=True,
+                         stdout=subprocess.PIPE, text=True).stdout
+    sections = {}
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) >= 2 and parts[0].startswith(".") and parts[1].isdigit():
+            sections[parts[0]] = int(parts[1])
+    text = sections.get(".text", 0)
+    data = sections.get(".data", 0)
+    bss = sections.get(".bss", 0)
+    # Flash holds .text and the .data initialisers; RAM holds .data and .bss.
+    return text + data, data + bss
+
+
+def main(argv):
+    avr_size = find_avr_size()
+    if "--no-build" not in argv:
+        for _, env in ENVS:
+            build(env)
+
+    results = [(name, env) + size(avr_size, env) for name, env in ENVS]
+    for name, env, flash, ram in results:
+        print("%-14s flash %6d B  ram %5d B  (%s)" % (name, flash, ram, env))
+    (_, _, flash_fixed, ram_fixed), (_, _, flash_double, ram_double) = results
+    print("%-14s flash %+6d B  ram %+5d B" % ("double - fixed",
+                                               flash_double - flash_fixed,
+                                               ram_double - ram_fixed))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
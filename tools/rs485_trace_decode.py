@@ -0,0 +1,313 @@
+#!/usr/bin/env python3
+"""Decode an RS485 trace exported by ModbusTraceRing.
+
+The firmware only stores binary records; this tool turns them into
+readable Modbus transactions.
+
+Usage:
+    rs485_trace_decode.py capture.log      # serial log with "#TRC" hex lines
+    rs485_trace_decode.py capture.bin      # raw "trace <port> bin" capture
+    rs485_trace_decode.py -                # read stdin
+
+Every export found in the input is decoded, oldest record first. Times
+are milliseconds since the first record of the export.
+"""
+
+import struct
+import sys
+
+MAGIC = b"RS485TRC"
+EXPORT_HEADER = 14          # version, flags, used, records, dropped, now
+RECORD_HEADER = 8           # type, channel, len, aux, micros
+FLAG_TRUNCATED = 0x80
+
+TRACE_TX, TRACE_RX, TRACE_GAP, TRACE_VERDICT = 1, 2, 3, 4
+
+RX_END = {
+    0: "none",
+    1: "timeout",
+    2: "frame complete",
+    3: "frame gap",
+    4: "buffer full",
+    5: "exception",
+}
+
+VERDICT = {
+    0: "FRAME OK",
+    1: "NO FRAME",
+    2: "SILENT",
+    3: "BUDGET SPENT",
+    4: "EXCEPTION",
+}
+
+EXCEPTION = {
+    0x01: "illegal function",
+    0x02: "illegal data address",
+    0x03: "illegal data value",
+    0x04: "slave device failure",
+    0x05: "acknowledge",
+    0x06: "slave device busy",
+    0x08: "memory parity error",
+    0x0A: "gateway path unavailable",
+    0x0B: "gateway target failed to respond",
+}
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return crc
+
+
+def crc_ok(frame):
+    return len(frame) >= 4 and crc16(frame[:-2]) == (frame[-2] | frame[-1] << 8)
+
+
+def hexs(data):
+    return " ".join("%02X" % b for b in data)
+
+
+# ----------------------------------------------------------------------------
+# Locating exports
+# ----------------------------------------------------------------------------
+def exports_from_hex(text):
+    """Yields the byte strings of every "#TRC" block in a text log."""
+    block = None
+    for line in text.splitlines():
+        pos = line.find("#TRC")
+        if pos < 0:
+            continue
+        body = line[pos + 4:].strip()
+        if body == "END":
+            if block is not None:
+                yield bytes(block)
+            block = None
+            continue
+        try:
+            data = bytes.fromhex(body)
+        except ValueError:
+            block = None
+            continue
+        if data.startswith(MAGIC):
+            block = bytearray()
+        if block is not None:
+            block += data
+
+
+def exports_from_binary(raw):
+    """Yields the byte strings of every binary export in a capture."""
+    pos = raw.find(MAGIC)
+    while pos >= 0:
+        start = pos + len(MAGIC)
+        if start + EXPORT_HEADER <= len(raw):
+            used = struct.unpack_from("<H", raw, start + 2)[0]
+            end = start + EXPORT_HEADER + used + 2
+            if end <= len(raw):
+                yield raw[pos:end]
+        pos = raw.find(MAGIC, pos + 1)
+
+
+# ----------------------------------------------------------------------------
+# Modbus formatting
+# ----------------------------------------------------------------------------
+def describe_request(frame):
+    if len(frame) < 4:
+        return "short request"
+    addr, fn = frame[0], frame[1]
+    crc = "" if crc_ok(frame) else "  [BAD CRC]"
+    if fn in (0x03, 0x04) and len(frame) >= 8:
+        reg, count = struct.unpack_from(">HH", frame, 2)
+        return "addr 0x%02X fn %02X read 0x%04X x%d%s" % (addr, fn, reg, count, crc)
+    if fn == 0x06 and len(frame) >= 8:
+        reg, value = struct.unpack_from(">HH", frame, 2)
+        return "addr 0x%02X fn 06 write 0x%04X = %d (0x%04X)%s" % (addr, reg, value, value, crc)
+    if fn == 0x10 and len(frame) >= 9:
+        reg, count = struct.unpack_from(">HH", frame, 2)
+        return "addr 0x%02X fn 10 write 0x%04X x%d%s" % (addr, reg, count, crc)
+    return "addr 0x%02X fn %02X%s" % (addr, fn, crc)
+
+
+def split_frames(data, addr, fn):
+    """Finds CRC-valid replies from addr/fn inside raw RX bytes.
+
+    Returns (offset, frame) pairs; bytes outside any frame are echo or
+    noise and are reported by the caller.
+    """
+    frames = []
+    i = 0
+    while i + 5 <= len(data):
+        if data[i] != addr or (data[i + 1] & 0x7F) != fn:
+            i += 1
+            continue
+        if data[i + 1] & 0x80:
+            length = 5
+        elif fn in (0x03, 0x04):
+            length = 5 + data[i + 2]
+        elif fn in (0x06, 0x10):
+            length = 8
+        else:
+            length = None
+        if length and i + length <= len(data) and crc_ok(data[i:i + length]):
+            frames.append((i, data[i:i + length]))
+            i += length
+            continue
+        i += 1
+    return frames
+
+
+def describe_reply(frame):
+    fn = frame[1]
+    if fn & 0x80:
+        code = frame[2]
+        return "exception %02X (%s)" % (code, EXCEPTION.get(code, "unknown"))
+    if fn in (0x03, 0x04):
+        words = [struct.unpack_from(">H", frame, 3 + 2 * k)[0] for k in range(frame[2] // 2)]
+        return "%d regs: %s" % (len(words), " ".join("%d" % w for w in words))
+    if fn in (0x06, 0x10):
+        reg, value = struct.unpack_from(">HH", frame, 2)
+        return "ack 0x%04X %d" % (reg, value)
+    return hexs(frame)
+
+
+# ----------------------------------------------------------------------------
+# Decoding
+# ----------------------------------------------------------------------------
+def parse_records(ring):
+    records = []
+    pos = 0
+    while pos + RECORD_HEADER <= len(ring):
+        rtype, channel, length, aux, us = struct.unpack_from("<BBBBI", ring, pos)
+        payload = ring[pos + RECORD_HEADER:pos + RECORD_HEADER + length]
+        if len(payload) != length:
+            break
+        records.append((rtype, channel, aux, us, payload))
+        pos += RECORD_HEADER + length
+    return records
+
+
+def unwrap(records):
+    """Turns 32-bit micros() stamps into a monotonic 64-bit count."""
+    out = []
+    base = 0
+    prev = None
+    for rec in records:
+        us = rec[3]
+        if prev is not None and us < prev:
+            base += 1 << 32
+        prev = us
+        out.append(base + us)
+    return out
+
+
+def decode_export(blob, out):
+    body = blob[len(MAGIC):]
+    if len(body) < EXPORT_HEADER + 2:
+        out.write("export too short\n")
+        return False
+
+    version, flags, used, count, dropped, now = struct.unpack_from("<BBHHII", body, 0)
+    if version != 1:
+        out.write("unsupported trace version %d\n" % version)
+        return False
+
+    payload = body[:EXPORT_HEADER + used]
+    expected = body[EXPORT_HEADER + used] | body[EXPORT_HEADER + used + 1] << 8
+    if crc16(payload) != expected:
+        out.write("export CRC mismatch, decoding anyway\n")
+
+    records = parse_records(body[EXPORT_HEADER:EXPORT_HEADER + used])
+    out.write("== trace: %d records (%d in header), %d bytes, %d dropped\n"
+              % (len(records), count, used, dropped))
+    if not records:
+        return True
+
+    stamps = unwrap(records)
+    t0 = stamps[0]
+    pending = {}   # channel -> last request
+
+    for rec, stamp in zip(records, stamps):
+        rtype, channel, aux, _, data = rec
+        truncated = " (truncated)" if rtype & FLAG_TRUNCATED else ""
+        rtype &= ~FLAG_TRUNCATED
+        prefix = "%10.3f ms  ch%d  " % ((stamp - t0) / 1000.0, channel)
+
+        if rtype == TRACE_TX:
+            pending[channel] = data
+            out.write("%sTX  %s%s\n" % (prefix, describe_request(data), truncated))
+            out.write("%s    %s\n" % (" " * len(prefix), hexs(data)))
+
+        elif rtype == TRACE_RX:
+            first, last, gap = struct.unpack_from("<III", data, 0)
+            rx = data[12:]
+            pad = " " * len(prefix)
+            if not rx:
+                out.write("%sRX  nothing, %s%s\n" % (prefix, RX_END.get(aux, aux), truncated))
+                continue
+            out.write("%sRX  %d bytes, first %.1f ms, last %.1f ms after TX, gap %d us, %s%s\n"
+                      % (prefix, len(rx), first / 1000.0, last / 1000.0, gap,
+                         RX_END.get(aux, aux), truncated))
+            out.write("%s    %s\n" % (pad, hexs(rx)))
+
+            request = pending.get(channel)
+            if request is None or len(request) < 2:
+                continue
+            frames = split_frames(rx, request[0], request[1])
+            covered = 0
+            for offset, frame in frames:
+                if offset > covered:
+                    out.write("%s    +%d: %d stray bytes\n" % (pad, covered, offset - covered))
+                out.write("%s    +%d: %s\n" % (pad, offset, describe_reply(frame)))
+                covered = offset + len(frame)
+            if not frames:
+                out.write("%s    no CRC-valid reply from 0x%02X\n" % (pad, request[0]))
+
+        elif rtype == TRACE_GAP:
+            silence, offset = struct.unpack_from("<IH", data, 0)
+            out.write("%sGAP %d us silence before RX byte %d\n" % (prefix, silence, offset))
+
+        elif rtype == TRACE_VERDICT:
+            addr, fn, offset, attempt, crc_bytes = struct.unpack_from("<BBHBH", data, 0)
+            verdict = VERDICT.get(aux, "verdict %d" % aux)
+            detail = ""
+            if aux in (0, 4):
+                detail = " at +%d" % offset
+            out.write("%s==> %s  addr 0x%02X fn %02X attempt %d%s, %d bytes through CRC\n"
+                      % (prefix, verdict, addr, fn, attempt, detail, crc_bytes))
+
+        else:
+            out.write("%s??? type %d, %d bytes\n" % (prefix, rtype, len(data)))
+
+    span = (stamps[-1] - t0) / 1000.0
+    age = ((now - records[-1][3]) & 0xFFFFFFFF) / 1000.0
+    out.write("== span %.3f ms, last record %.3f ms before export\n" % (span, age))
+    return True
+
+
+def main(argv):
+    if len(argv) != 2:
+        sys.stderr.write(__doc__)
+        return 2
+
+    if argv[1] == "-":
+        raw = sys.stdin.buffer.read()
+    else:
+        with open(argv[1], "rb") as f:
+            raw = f.read()
+
+    exports = list(exports_from_binary(raw))
+    if not exports:
+        exports = list(exports_from_hex(raw.decode("latin-1")))
+    if not exports:
+        sys.stderr.write("no RS485 trace found\n")
+        return 1
+
+    for blob in exports:
+        decode_export(blob, sys.stdout)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))